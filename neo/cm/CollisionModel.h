@@ -119,6 +119,11 @@ public:
 	virtual void			Translation( trace_t *results, const idVec3 &start, const idVec3 &end,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) = 0;
+	// Translates a trace model along a batch of rays and reports the first collision of each, results[i] is the
+	// trace from starts[i] to ends[i]. Point traces are traced through the model together as packets of rays.
+	virtual void			TranslationBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) = 0;
 	// Rotates a trace model and reports the first collision if any.
 	virtual void			Rotation( trace_t *results, const idVec3 &start, const idRotation &rotation,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
@@ -147,4 +152,22 @@ public:
 
 extern idCollisionModelManager *		collisionModelManager;
 
+// A batch of point traces through a single model. Point traces that do not start and end at the
+// same position only read the model, so any number of these batches can run as jobs at once.
+// Traces that start and end at the same position are position tests, which are not thread safe.
+// CM_TraceBatchJob skips them, run CM_TraceBatchPositionTests on the main thread before adding the job.
+struct cmTraceBatchParms_t {
+	trace_t *				results;
+	const idVec3 *			starts;
+	const idVec3 *			ends;
+	int						numTraces;
+	int						contentMask;
+	cmHandle_t				model;
+	idVec3					modelOrigin;
+	idMat3					modelAxis;
+};
+
+void CM_TraceBatchPositionTests( const cmTraceBatchParms_t * parms );
+void CM_TraceBatchJob( const cmTraceBatchParms_t * parms );
+
 #endif /* !__COLLISIONMODELMANAGER_H__ */
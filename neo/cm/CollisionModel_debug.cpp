@@ -487,3 +487,124 @@ void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	Mem_Free( testend );
 	testend = NULL;
 }
+
+/*
+================
+CM_TestTraceBatch_f
+
+Fires random point traces through the world collision model one at a time, as a batch, and as
+batches on the job system, and compares the results. Groups of rays share a start and aim at
+nearby points like a shotgun blast, the spread sets how far apart the end points of a group are.
+
+testTraceBatch [numRays] [spread]
+================
+*/
+CONSOLE_COMMAND( testTraceBatch, "benchmarks batched point traces through the world collision model, usage: testTraceBatch [numRays] [spread]", NULL ) {
+	idBounds bounds;
+	if ( !collisionModelManager->GetModelBounds( 0, bounds ) ) {
+		common->Printf( "testTraceBatch: no collision map loaded\n" );
+		return;
+	}
+
+	const int numRays = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 100000;
+	const float spread = ( args.Argc() > 2 ) ? Max( 0.0f, (float)atof( args.Argv( 2 ) ) ) : 64.0f;
+	const int contentMask = CONTENTS_SOLID;
+
+	idRandom random( 0 );
+	idList< idVec3 > starts;
+	idList< idVec3 > ends;
+	starts.SetNum( numRays );
+	ends.SetNum( numRays );
+	for ( int i = 0; i < numRays; i += CM_RAY_PACKET_SIZE ) {
+		idVec3 start, target;
+		for ( int j = 0; j < 3; j++ ) {
+			start[j] = bounds[0][j] + random.RandomFloat() * ( bounds[1][j] - bounds[0][j] );
+			target[j] = bounds[0][j] + random.RandomFloat() * ( bounds[1][j] - bounds[0][j] );
+		}
+		for ( int j = i; j < numRays && j < i + CM_RAY_PACKET_SIZE; j++ ) {
+			starts[j] = start;
+			ends[j] = target + idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() ) * spread;
+		}
+	}
+
+	idList< trace_t > singleResults;
+	idList< trace_t > batchResults;
+	idList< trace_t > jobResults;
+	singleResults.SetNum( numRays );
+	batchResults.SetNum( numRays );
+	jobResults.SetNum( numRays );
+
+	uint64 start = Sys_Microseconds();
+	for ( int i = 0; i < numRays; i++ ) {
+		collisionModelManager->Translation( &singleResults[i], starts[i], ends[i], NULL, mat3_identity, contentMask, 0, vec3_origin, mat3_identity );
+	}
+	const uint64 singleMicroseconds = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	collisionModelManager->TranslationBatch( batchResults.Ptr(), starts.Ptr(), ends.Ptr(), numRays, NULL, mat3_identity, contentMask, 0, vec3_origin, mat3_identity );
+	const uint64 batchMicroseconds = Sys_Microseconds() - start;
+
+	const int RAYS_PER_JOB = 1024;
+	idList< cmTraceBatchParms_t > jobParms;
+	for ( int i = 0; i < numRays; i += RAYS_PER_JOB ) {
+		cmTraceBatchParms_t & parms = jobParms.Alloc();
+		parms.results = &jobResults[i];
+		parms.starts = &starts[i];
+		parms.ends = &ends[i];
+		parms.numTraces = Min( RAYS_PER_JOB, numRays - i );
+		parms.contentMask = contentMask;
+		parms.model = 0;
+		parms.modelOrigin = vec3_origin;
+		parms.modelAxis = mat3_identity;
+	}
+
+	start = Sys_Microseconds();
+	// the position tests are not thread safe and run before the jobs
+	for ( int i = 0; i < jobParms.Num(); i++ ) {
+		CM_TraceBatchPositionTests( &jobParms[i] );
+	}
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobParms.Num(), 0, NULL );
+	for ( int i = 0; i < jobParms.Num(); i++ ) {
+		jobList->AddJob( (jobRun_t)CM_TraceBatchJob, &jobParms[i] );
+	}
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+	const uint64 jobMicroseconds = Sys_Microseconds() - start;
+
+	int numHits = 0;
+	int numMismatches = 0;
+	for ( int i = 0; i < numRays; i++ ) {
+		const trace_t & single = singleResults[i];
+		if ( single.fraction < 1.0f ) {
+			numHits++;
+		}
+		const trace_t * batched[2] = { &batchResults[i], &jobResults[i] };
+		for ( int j = 0; j < 2; j++ ) {
+			if ( idMath::Fabs( batched[j]->fraction - single.fraction ) > 1e-5f ||
+					( single.fraction < 1.0f && !batched[j]->c.normal.Compare( single.c.normal, 1e-4f ) ) ) {
+				numMismatches++;
+				break;
+			}
+		}
+	}
+
+	common->Printf( "%i rays, spread %.0f, %i hits, %i mismatches\n", numRays, spread, numHits, numMismatches );
+	common->Printf( "single:  %7i usec, %9.0f rays/sec\n", (int)singleMicroseconds, numRays * 1000000.0 / Max( singleMicroseconds, (uint64)1 ) );
+	common->Printf( "batched: %7i usec, %9.0f rays/sec\n", (int)batchMicroseconds, numRays * 1000000.0 / Max( batchMicroseconds, (uint64)1 ) );
+	common->Printf( "jobs:    %7i usec, %9.0f rays/sec\n", (int)jobMicroseconds, numRays * 1000000.0 / Max( jobMicroseconds, (uint64)1 ) );
+}
+
+/*
+================
+testCollisionModelBuild
+
+Builds the collision models of a .map on the main thread and on the job system and checks
+that the binary models are identical. Uses the loaded map if no map is given.
+
+testCollisionModelBuild [mapName]
+================
+*/
+CONSOLE_COMMAND( testCollisionModelBuild, "compares collision models built serially and on the job system, usage: testCollisionModelBuild [mapName]", idCmdSystem::ArgCompletion_MapName ) {
+	collisionModelManagerLocal.TestParallelBuild( ( args.Argc() > 1 ) ? args.Argv( 1 ) : NULL );
+}
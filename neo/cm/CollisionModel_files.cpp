@@ -272,7 +272,7 @@ bool idCollisionModelManagerLocal::WriteCollisionModelForMapEntity( const idMapE
 	cm_model_t *model;
 
 	SetupHash();
-	model = CollisionModelForMapEntity( mapEnt );
+	model = CollisionModelForMapEntity( mapEnt, false );
 	model->name = filename;
 
 	name = filename;
@@ -59,6 +59,7 @@ idCollisionModelManager *		collisionModelManager = &collisionModelManagerLocal;
 cm_windingList_t *				cm_windingList;
 cm_windingList_t *				cm_outList;
 cm_windingList_t *				cm_tmpList;
+cm_chopState_t					cm_mainChop;
 
 idHashIndex *					cm_vertexHash;
 idHashIndex *					cm_edgeHash;
@@ -68,6 +69,7 @@ int								cm_vertexShift;
 
 
 idCVar preLoad_Collision( "preLoad_Collision", "1", CVAR_SYSTEM | CVAR_BOOL, "preload collision beginlevelload" );
+idCVar cm_parallelBuild( "cm_parallelBuild", "1", CVAR_SYSTEM | CVAR_BOOL, "build the collision models of a .map on the job system" );
 
 /*
 ===============================================================================
@@ -973,7 +975,9 @@ idCollisionModelManagerLocal::ChopWindingWithBrush
   returns the least number of winding fragments outside the brush
 =============
 */
-void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *list, cm_brush_t *b ) {
+void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_chopState_t *chop, cm_windingList_t *list, cm_brush_t *b ) {
+	cm_windingList_t *outList = chop->outList;
+	cm_windingList_t *tmpList = chop->tmpList;
 	int i, k, res, startPlane, planeNum, bestNumWindings;
 	idFixedWinding back, front;
 	idPlane plane;
@@ -1010,7 +1014,7 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		}
 	}
 
-	cm_outList->numWindings = 0;
+	outList->numWindings = 0;
 	for ( k = 0; k < list->numWindings; k++ ) {
 		//
 		startPlane = 0;
@@ -1018,7 +1022,7 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		chopped = false;
 		do {
 			front = list->w[k];
-			cm_tmpList->numWindings = 0;
+			tmpList->numWindings = 0;
 			for ( planeNum = startPlane, i = 0; i < b->numPlanes; i++, planeNum++ ) {
 
 				if ( planeNum >= b->numPlanes ) {
@@ -1042,44 +1046,56 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 				}
 
 				if ( res == SIDE_BACK ) {
-					if ( cm_outList->numWindings >= MAX_WINDING_LIST ) {
-						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+					if ( outList->numWindings >= MAX_WINDING_LIST ) {
+						if ( chop->build != NULL ) {
+							chop->build->windingListOverflow = true;
+						} else {
+							common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+						}
 						return;
 					}
 					// winding and brush didn't intersect, store the original winding
-					cm_outList->w[cm_outList->numWindings] = list->w[k];
-					cm_outList->numWindings++;
+					outList->w[outList->numWindings] = list->w[k];
+					outList->numWindings++;
 					chopped = false;
 					break;
 				}
 
 				if ( res == SIDE_CROSS ) {
-					if ( cm_tmpList->numWindings >= MAX_WINDING_LIST ) {
-						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+					if ( tmpList->numWindings >= MAX_WINDING_LIST ) {
+						if ( chop->build != NULL ) {
+							chop->build->windingListOverflow = true;
+						} else {
+							common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+						}
 						return;
 					}
 					// store the front winding in the temporary list
-					cm_tmpList->w[cm_tmpList->numWindings] = back;
-					cm_tmpList->numWindings++;
+					tmpList->w[tmpList->numWindings] = back;
+					tmpList->numWindings++;
 					chopped = true;
 				}
 
 				// if already found a start plane which generates less fragments
-				if ( cm_tmpList->numWindings >= bestNumWindings ) {
+				if ( tmpList->numWindings >= bestNumWindings ) {
 					break;
 				}
 			}
 
 			// find the best start plane to get the least number of fragments outside the brush
-			if ( cm_tmpList->numWindings < bestNumWindings ) {
-				bestNumWindings = cm_tmpList->numWindings;
+			if ( tmpList->numWindings < bestNumWindings ) {
+				bestNumWindings = tmpList->numWindings;
 				// store windings from temporary list in the out list
-				for ( i = 0; i < cm_tmpList->numWindings; i++ ) {
-					if ( cm_outList->numWindings + i >= MAX_WINDING_LIST ) {
-						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+				for ( i = 0; i < tmpList->numWindings; i++ ) {
+					if ( outList->numWindings + i >= MAX_WINDING_LIST ) {
+						if ( chop->build != NULL ) {
+							chop->build->windingListOverflow = true;
+						} else {
+							common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
+						}
 						return;
 					}
-					cm_outList->w[cm_outList->numWindings+i] = cm_tmpList->w[i];
+					outList->w[outList->numWindings+i] = tmpList->w[i];
 				}
 				// if only one winding left then we can't do any better
 				if ( bestNumWindings == 1 ) {
@@ -1093,13 +1109,13 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		} while ( chopped && startPlane < b->numPlanes );
 		//
 		if ( chopped ) {
-			cm_outList->numWindings += bestNumWindings;
+			outList->numWindings += bestNumWindings;
 		}
 	}
-	for ( k = 0; k < cm_outList->numWindings; k++ ) {
-		list->w[k] = cm_outList->w[k];
+	for ( k = 0; k < outList->numWindings; k++ ) {
+		list->w[k] = outList->w[k];
 	}
-	list->numWindings = cm_outList->numWindings;
+	list->numWindings = outList->numWindings;
 }
 
 /*
@@ -1107,7 +1123,7 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes
 ============
 */
-void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingList_t *list, cm_node_t *node ) {
+void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_chopState_t *chop, cm_windingList_t *list, cm_node_t *node ) {
 	int i;
 	cm_brushRef_t *bref;
 	cm_brush_t *b;
@@ -1115,11 +1131,22 @@ void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingL
 	while( 1 ) {
 		for ( bref = node->brushes; bref; bref = bref->next ) {
 			b = bref->b;
-			// if we checked this brush already
-			if ( b->checkcount == checkCount ) {
-				continue;
+			if ( chop->brushChecks != NULL ) {
+				// build jobs can't touch the brushes so record the visit to set the checkcount later
+				if ( chop->brushChecks[b->primitiveNum] == chop->checkCount ) {
+					continue;
+				}
+				chop->brushChecks[b->primitiveNum] = chop->checkCount;
+				cm_brushCheck_t &check = chop->build->brushChecks.Alloc();
+				check.brush = b;
+				check.chopNum = chop->build->numChops;
+			} else {
+				// if we checked this brush already
+				if ( b->checkcount == checkCount ) {
+					continue;
+				}
+				b->checkcount = checkCount;
 			}
-			b->checkcount = checkCount;
 			// if the windings in the list originate from this brush
 			if ( b->primitiveNum == list->primitiveNum ) {
 				continue;
@@ -1141,7 +1168,7 @@ void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingL
 				continue;
 			}
 			// chop windings in the list with brush
-			ChopWindingListWithBrush( list, b );
+			ChopWindingListWithBrush( chop, list, b );
 			// if all windings are chopped away we're done
 			if ( !list->numWindings ) {
 				return;
@@ -1158,7 +1185,7 @@ void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingL
 			node = node->children[1];
 		}
 		else {
-			R_ChopWindingListWithTreeBrushes( list, node->children[1] );
+			R_ChopWindingListWithTreeBrushes( chop, list, node->children[1] );
 			if ( !list->numWindings ) {
 				return;
 			}
@@ -1177,34 +1204,40 @@ idCollisionModelManagerLocal::WindingOutsideBrushes
   without creating multiple winding fragments then the chopped winding is returned.
 ============
 */
-idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( idFixedWinding *w, const idPlane &plane, int contents, int primitiveNum, cm_node_t *headNode ) {
+idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( cm_chopState_t *chop, idFixedWinding *w, const idPlane &plane, int contents, int primitiveNum, cm_node_t *headNode ) {
 	int i, windingLeft;
+	cm_windingList_t *windingList = chop->windingList;
 
-	cm_windingList->bounds.Clear();
+	windingList->bounds.Clear();
 	for ( i = 0; i < w->GetNumPoints(); i++ ) {
-		cm_windingList->bounds.AddPoint( (*w)[i].ToVec3() );
+		windingList->bounds.AddPoint( (*w)[i].ToVec3() );
 	}
 
-	cm_windingList->origin = (cm_windingList->bounds[1] - cm_windingList->bounds[0]) * 0.5;
-	cm_windingList->radius = cm_windingList->origin.Length() + CHOP_EPSILON;
-	cm_windingList->origin = cm_windingList->bounds[0] + cm_windingList->origin;
-	cm_windingList->bounds[0] -= idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
-	cm_windingList->bounds[1] += idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
+	windingList->origin = (windingList->bounds[1] - windingList->bounds[0]) * 0.5;
+	windingList->radius = windingList->origin.Length() + CHOP_EPSILON;
+	windingList->origin = windingList->bounds[0] + windingList->origin;
+	windingList->bounds[0] -= idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
+	windingList->bounds[1] += idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
 
-	cm_windingList->w[0] = *w;
-	cm_windingList->numWindings = 1;
-	cm_windingList->normal = plane.Normal();
-	cm_windingList->contents = contents;
-	cm_windingList->primitiveNum = primitiveNum;
+	windingList->w[0] = *w;
+	windingList->numWindings = 1;
+	windingList->normal = plane.Normal();
+	windingList->contents = contents;
+	windingList->primitiveNum = primitiveNum;
 	//
-	checkCount++;
-	R_ChopWindingListWithTreeBrushes( cm_windingList, headNode );
+	if ( chop->brushChecks != NULL ) {
+		chop->checkCount++;
+		chop->build->numChops++;
+	} else {
+		checkCount++;
+	}
+	R_ChopWindingListWithTreeBrushes( chop, windingList, headNode );
 	//
-	if ( !cm_windingList->numWindings ) {
+	if ( !windingList->numWindings ) {
 		return NULL;
 	}
-	if ( cm_windingList->numWindings == 1 ) {
-		return &cm_windingList->w[0];
+	if ( windingList->numWindings == 1 ) {
+		return &windingList->w[0];
 	}
 	// if not the world model
 	if ( numModels != 0 ) {
@@ -1212,8 +1245,8 @@ idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( idFixedWind
 	}
 	// check if winding fragments would be chopped away by the proc BSP tree
 	windingLeft = -1;
-	for ( i = 0; i < cm_windingList->numWindings; i++ ) {
-		if ( !ChoppedAwayByProcBSP( cm_windingList->w[i], plane, contents ) ) {
+	for ( i = 0; i < windingList->numWindings; i++ ) {
+		if ( !ChoppedAwayByProcBSP( windingList->w[i], plane, contents ) ) {
 			if ( windingLeft >= 0 ) {
 				return w;
 			}
@@ -1221,7 +1254,7 @@ idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( idFixedWind
 		}
 	}
 	if ( windingLeft >= 0 ) {
-		return &cm_windingList->w[windingLeft];
+		return &windingList->w[windingLeft];
 	}
 	return NULL;
 }
@@ -1599,10 +1632,11 @@ Find internal edges
 idCollisionModelManagerLocal::PointInsidePolygon
 =============
 */
-bool idCollisionModelManagerLocal::PointInsidePolygon( cm_model_t *model, cm_polygon_t *p, idVec3 &v ) {
+bool idCollisionModelManagerLocal::PointInsidePolygon( const cm_model_t *model, const cm_polygon_t *p, const idVec3 &v ) const {
 	int i, edgeNum;
-	idVec3 *v1, *v2, dir1, dir2, vec;
-	cm_edge_t *edge;
+	const idVec3 *v1, *v2;
+	idVec3 dir1, dir2, vec;
+	const cm_edge_t *edge;
 
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
@@ -1622,34 +1656,38 @@ bool idCollisionModelManagerLocal::PointInsidePolygon( cm_model_t *model, cm_pol
 
 /*
 =============
-idCollisionModelManagerLocal::FindInternalEdgesOnPolygon
+idCollisionModelManagerLocal::TestInternalEdgesOnPolygon
+
+  Tests all edges of p1 against p2 without looking at the internal flag of the edges.
+  Edges that are already internal are skipped by SetInternalPolygonEdges, which is the only
+  state the result of a test depends on, so the tests can run before any edge is changed.
+  Returns false if the polygons are too far apart for any edge to be internal.
 =============
 */
-void idCollisionModelManagerLocal::FindInternalEdgesOnPolygon( cm_model_t *model, cm_polygon_t *p1, cm_polygon_t *p2 ) {
+bool idCollisionModelManagerLocal::TestInternalEdgesOnPolygon( const cm_model_t *model, const cm_polygon_t *p1, const cm_polygon_t *p2, cm_internalEdgeTest_t &test ) const {
 	int i, j, k, edgeNum;
-	cm_edge_t *edge;
-	idVec3 *v1, *v2, dir1, dir2;
+	const cm_edge_t *edge;
+	const idVec3 *v1, *v2;
+	idVec3 dir1, dir2;
 	float d;
 
 	// bounds of polygons should overlap or touch
 	for ( i = 0; i < 3; i++ ) {
 		if ( p1->bounds[0][i] > p2->bounds[1][i] ) {
-			return;
+			return false;
 		}
 		if ( p1->bounds[1][i] < p2->bounds[0][i] ) {
-			return;
+			return false;
 		}
 	}
+	test.internalEdges = 0;
+	test.stopEdges = 0;
 	//
 	// FIXME: doubled geometry causes problems
 	//
 	for ( i = 0; i < p1->numEdges; i++ ) {
 		edgeNum = p1->edges[i];
 		edge = model->edges + abs(edgeNum);
-		// if already an internal edge
-		if ( edge->internal ) {
-			continue;
-		}
 		//
 		v1 = &model->vertices[edge->vertexNum[INT32_SIGNBITSET(edgeNum)]].p;
 		v2 = &model->vertices[edge->vertexNum[INT32_SIGNBITNOTSET(edgeNum)]].p;
@@ -1703,8 +1741,9 @@ void idCollisionModelManagerLocal::FindInternalEdgesOnPolygon( cm_model_t *model
 		dir1 = (*v2) - (*v1);
 		dir2 = p1->plane.Normal().Cross( dir1 );
 		if ( p2->plane.Normal() * dir2 < 0 ) {
-			//continue;
-			break;
+			// no further edges are tested against p2 if this edge is not internal yet
+			test.stopEdges |= (uint64)1 << i;
+			continue;
 		}
 		// if the edge was not shared
 		if ( j >= p2->numEdges ) {
@@ -1717,19 +1756,22 @@ void idCollisionModelManagerLocal::FindInternalEdgesOnPolygon( cm_model_t *model
 			}
 		}
 		// we got another internal edge
-		edge->internal = true;
-		model->numInternalEdges++;
+		test.internalEdges |= (uint64)1 << i;
 	}
+	return ( test.internalEdges | test.stopEdges ) != 0;
 }
 
 /*
 =============
 idCollisionModelManagerLocal::FindInternalPolygonEdges
+
+  Appends the edge tests of the polygon against all polygons in the tree in the order they are applied.
 =============
 */
-void idCollisionModelManagerLocal::FindInternalPolygonEdges( cm_model_t *model, cm_node_t *node, cm_polygon_t *polygon ) {
-	cm_polygonRef_t *pref;
-	cm_polygon_t *p;
+void idCollisionModelManagerLocal::FindInternalPolygonEdges( const cm_model_t *model, const cm_node_t *node, const cm_polygon_t *polygon, idList<cm_internalEdgeTest_t> &tests ) const {
+	const cm_polygonRef_t *pref;
+	const cm_polygon_t *p;
+	cm_internalEdgeTest_t test;
 
 	if ( polygon->material->GetCullType() == CT_TWO_SIDED || polygon->material->ShouldCreateBackSides() ) {
 		return;
@@ -1749,7 +1791,9 @@ void idCollisionModelManagerLocal::FindInternalPolygonEdges( cm_model_t *model,
 			if ( p == polygon ) {
 				continue;
 			}
-			FindInternalEdgesOnPolygon( model, polygon, p );
+			if ( TestInternalEdgesOnPolygon( model, polygon, p, test ) ) {
+				tests.Append( test );
+			}
 		}
 		// if leaf node
 		if ( node->planeType == -1 ) {
@@ -1762,12 +1806,42 @@ void idCollisionModelManagerLocal::FindInternalPolygonEdges( cm_model_t *model,
 			node = node->children[1];
 		}
 		else {
-			FindInternalPolygonEdges( model, node->children[1], polygon );
+			FindInternalPolygonEdges( model, node->children[1], polygon, tests );
 			node = node->children[0];
 		}
 	}
 }
 
+/*
+=============
+idCollisionModelManagerLocal::SetInternalPolygonEdges
+=============
+*/
+void idCollisionModelManagerLocal::SetInternalPolygonEdges( cm_model_t *model, const cm_polygon_t *polygon, const cm_internalEdgeTest_t *tests, const int numTests ) {
+	int i, j;
+	uint64 bit;
+	cm_edge_t *edge;
+
+	for ( i = 0; i < numTests; i++ ) {
+		for ( j = 0; j < polygon->numEdges; j++ ) {
+			edge = model->edges + abs(polygon->edges[j]);
+			// if already an internal edge
+			if ( edge->internal ) {
+				continue;
+			}
+			bit = (uint64)1 << j;
+			if ( tests[i].stopEdges & bit ) {
+				break;
+			}
+			if ( tests[i].internalEdges & bit ) {
+				// we got another internal edge
+				edge->internal = true;
+				model->numInternalEdges++;
+			}
+		}
+	}
+}
+
 /*
 =============
 idCollisionModelManagerLocal::FindContainedEdges
@@ -1795,10 +1869,10 @@ void idCollisionModelManagerLocal::FindContainedEdges( cm_model_t *model, cm_pol
 
 /*
 =============
-idCollisionModelManagerLocal::FindInternalEdges
+idCollisionModelManagerLocal::R_GetInternalEdgePolygons
 =============
 */
-void idCollisionModelManagerLocal::FindInternalEdges( cm_model_t *model, cm_node_t *node ) {
+void idCollisionModelManagerLocal::R_GetInternalEdgePolygons( cm_node_t *node, idList<cm_polygon_t *> &polygons ) {
 	cm_polygonRef_t *pref;
 	cm_polygon_t *p;
 
@@ -1810,20 +1884,72 @@ void idCollisionModelManagerLocal::FindInternalEdges( cm_model_t *model, cm_node
 				continue;
 			}
 			p->checkcount = checkCount;
-
-			FindInternalPolygonEdges( model, model->node, p );
-
-			//FindContainedEdges( model, p );
+			polygons.Append( p );
 		}
 		// if leaf node
 		if ( node->planeType == -1 ) {
 			break;
 		}
-		FindInternalEdges( model, node->children[1] );
+		R_GetInternalEdgePolygons( node->children[1], polygons );
 		node = node->children[0];
 	}
 }
 
+/*
+=============
+idCollisionModelManagerLocal::FindInternalEdges
+
+  The edge tests only read the model so they can run on the job system, the edges
+  are always changed on the main thread in tree order to get the same internal edges.
+=============
+*/
+void idCollisionModelManagerLocal::FindInternalEdges( cm_model_t *model, bool parallel ) {
+	int i;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_internalEdgeTest_t> tests;
+
+	polygons.Resize( model->numPolygons );
+	R_GetInternalEdgePolygons( model->node, polygons );
+
+	if ( !parallel || polygons.Num() == 0 ) {
+		for ( i = 0; i < polygons.Num(); i++ ) {
+			tests.SetNum( 0 );
+			FindInternalPolygonEdges( model, model->node, polygons[i], tests );
+			SetInternalPolygonEdges( model, polygons[i], tests.Ptr(), tests.Num() );
+
+			//FindContainedEdges( model, polygons[i] );
+		}
+		return;
+	}
+
+	idSysInterlockedInteger nextPolygon;
+	idList<cm_polygonEdgeTests_t> polygonTests;
+	polygonTests.SetNum( polygons.Num() );
+
+	const int numJobs = Min( Max( parallelJobManager->GetNumProcessingUnits(), 1 ), ( polygons.Num() + CM_INTERNAL_EDGE_BATCH - 1 ) / CM_INTERNAL_EDGE_BATCH );
+	cm_buildJob_t *jobs = new (TAG_COLLISION) cm_buildJob_t[numJobs];
+	for ( i = 0; i < numJobs; i++ ) {
+		jobs[i].pass = CM_BUILD_INTERNAL_EDGES;
+		jobs[i].jobNum = i;
+		jobs[i].model = model;
+		jobs[i].nextItem = &nextPolygon;
+		jobs[i].numItems = polygons.Num();
+		jobs[i].builds = NULL;
+		jobs[i].numPrimitives = 0;
+		jobs[i].polygons = polygons.Ptr();
+		jobs[i].polygonTests = polygonTests.Ptr();
+	}
+	RunBuildJobs( jobs, numJobs );
+
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		const cm_polygonEdgeTests_t &polygonTest = polygonTests[i];
+		if ( polygonTest.numTests ) {
+			SetInternalPolygonEdges( model, polygons[i], &jobs[polygonTest.jobNum].tests[polygonTest.firstTest], polygonTest.numTests );
+		}
+	}
+	delete[] jobs;
+}
+
 /*
 ===============================================================================
 
@@ -2201,6 +2327,13 @@ void idCollisionModelManagerLocal::SetupHash() {
 	if ( !cm_tmpList ) {
 		cm_tmpList = new (TAG_COLLISION) cm_windingList_t;
 	}
+	// chopping on the main thread uses the brush checkcounts
+	cm_mainChop.windingList = cm_windingList;
+	cm_mainChop.outList = cm_outList;
+	cm_mainChop.tmpList = cm_tmpList;
+	cm_mainChop.brushChecks = NULL;
+	cm_mainChop.checkCount = 0;
+	cm_mainChop.build = NULL;
 }
 
 /*
@@ -2219,6 +2352,7 @@ void idCollisionModelManagerLocal::ShutdownHash() {
 	cm_outList = NULL;
 	delete cm_windingList;
 	cm_windingList = NULL;
+	memset( &cm_mainChop, 0, sizeof( cm_mainChop ) );
 }
 
 /*
@@ -2474,15 +2608,36 @@ void idCollisionModelManagerLocal::CreatePolygon( cm_model_t *model, idFixedWind
 	R_FilterPolygonIntoTree( model, model->node, NULL, p );
 }
 
+/*
+================
+idCollisionModelManagerLocal::CreateWindingPolygons
+================
+*/
+void idCollisionModelManagerLocal::CreateWindingPolygons( cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum ) {
+	if ( w->IsHuge() ) {
+		common->Warning( "idCollisionModelManagerLocal::PolygonFromWinding: model %s primitive %d is degenerate", model->name.c_str(), abs(primitiveNum) );
+		return;
+	}
+
+	CreatePolygon( model, w, plane, material, primitiveNum );
+
+	if ( material->GetCullType() == CT_TWO_SIDED || material->ShouldCreateBackSides() ) {
+		w->ReverseSelf();
+		CreatePolygon( model, w, -plane, material, primitiveNum );
+	}
+}
+
 /*
 ================
 idCollisionModelManagerLocal::PolygonFromWinding
 
   NOTE: for patches primitiveNum < 0 and abs(primitiveNum) is the real number
+  When the chop state has a build the remaining winding is stored for FinishPrimitiveBuild.
 ================
 */
-void idCollisionModelManagerLocal::PolygonFromWinding( cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum ) {
-	int contents;
+void idCollisionModelManagerLocal::PolygonFromWinding( cm_chopState_t *chop, cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum ) {
+	int i, contents;
+	cm_primitiveBuild_t *build = chop->build;
 
 	contents = material->GetContentFlags();
 
@@ -2490,31 +2645,41 @@ void idCollisionModelManagerLocal::PolygonFromWinding( cm_model_t *model, idFixe
 	if ( numModels == 0 ) {
 		// if the polygon is fully chopped away by the proc bsp tree
 		if ( ChoppedAwayByProcBSP( *w, plane, contents ) ) {
-			model->numRemovedPolys++;
+			if ( build != NULL ) {
+				build->numRemovedPolys++;
+			} else {
+				model->numRemovedPolys++;
+			}
 			return;
 		}
 	}
 
 	// get one winding that is not or only partly contained in brushes
-	w = WindingOutsideBrushes( w, plane, contents, primitiveNum, model->node );
+	w = WindingOutsideBrushes( chop, w, plane, contents, primitiveNum, model->node );
 
 	// if the polygon is fully contained within a brush
 	if ( !w ) {
-		model->numRemovedPolys++;
+		if ( build != NULL ) {
+			build->numRemovedPolys++;
+		} else {
+			model->numRemovedPolys++;
+		}
 		return;
 	}
 
-	if ( w->IsHuge() ) {
-		common->Warning( "idCollisionModelManagerLocal::PolygonFromWinding: model %s primitive %d is degenerate", model->name.c_str(), abs(primitiveNum) );
+	if ( build != NULL ) {
+		cm_buildPolygon_t &polygon = build->polygons.Alloc();
+		polygon.numPoints = w->GetNumPoints();
+		polygon.plane = plane;
+		polygon.material = material;
+		polygon.primitiveNum = primitiveNum;
+		for ( i = 0; i < w->GetNumPoints(); i++ ) {
+			build->points.Append( (*w)[i] );
+		}
 		return;
 	}
 
-	CreatePolygon( model, w, plane, material, primitiveNum );
-
-	if ( material->GetCullType() == CT_TWO_SIDED || material->ShouldCreateBackSides() ) {
-		w->ReverseSelf();
-		CreatePolygon( model, w, -plane, material, primitiveNum );
-	}
+	CreateWindingPolygons( model, w, plane, material, primitiveNum );
 }
 
 /*
@@ -2522,7 +2687,7 @@ void idCollisionModelManagerLocal::PolygonFromWinding( cm_model_t *model, idFixe
 idCollisionModelManagerLocal::CreatePatchPolygons
 =================
 */
-void idCollisionModelManagerLocal::CreatePatchPolygons( cm_model_t *model, idSurface_Patch &mesh, const idMaterial *material, int primitiveNum ) {
+void idCollisionModelManagerLocal::CreatePatchPolygons( cm_chopState_t *chop, cm_model_t *model, idSurface_Patch &mesh, const idMaterial *material, int primitiveNum ) {
 	int i, j;
 	float dot;
 	int v1, v2, v3, v4;
@@ -2552,7 +2717,7 @@ void idCollisionModelManagerLocal::CreatePatchPolygons( cm_model_t *model, idSur
 					w += mesh[v3].xyz;
 					w += mesh[v4].xyz;
 
-					PolygonFromWinding( model, &w, plane, material, -primitiveNum );
+					PolygonFromWinding( chop, model, &w, plane, material, -primitiveNum );
 					continue;
 				}
 				else {
@@ -2562,7 +2727,7 @@ void idCollisionModelManagerLocal::CreatePatchPolygons( cm_model_t *model, idSur
 					w += mesh[v2].xyz;
 					w += mesh[v3].xyz;
 
-					PolygonFromWinding( model, &w, plane, material, -primitiveNum );
+					PolygonFromWinding( chop, model, &w, plane, material, -primitiveNum );
 				}
 			}
 			// create the other triangle
@@ -2577,7 +2742,7 @@ void idCollisionModelManagerLocal::CreatePatchPolygons( cm_model_t *model, idSur
 				w += mesh[v3].xyz;
 				w += mesh[v4].xyz;
 
-				PolygonFromWinding( model, &w, plane, material, -primitiveNum );
+				PolygonFromWinding( chop, model, &w, plane, material, -primitiveNum );
 			}
 		}
 	}
@@ -2617,11 +2782,15 @@ static void CM_EstimateVertsAndEdges( const idMapEntity *mapEnt, int *numVerts,
 idCollisionModelManagerLocal::ConverPatch
 =================
 */
-void idCollisionModelManagerLocal::ConvertPatch( cm_model_t *model, const idMapPatch *patch, int primitiveNum ) {
+void idCollisionModelManagerLocal::ConvertPatch( cm_chopState_t *chop, cm_model_t *model, const idMapPatch *patch, int primitiveNum ) {
 	const idMaterial *material;
 	idSurface_Patch *cp;
 
-	material = declManager->FindMaterial( patch->GetMaterial() );
+	if ( chop->build != NULL ) {
+		material = chop->build->materials[0];
+	} else {
+		material = declManager->FindMaterial( patch->GetMaterial() );
+	}
 	if ( !( material->GetContentFlags() & CONTENTS_REMOVE_UTIL ) ) {
 		return;
 	}
@@ -2637,7 +2806,7 @@ void idCollisionModelManagerLocal::ConvertPatch( cm_model_t *model, const idMapP
 	}
 
 	// create collision polygons for the patch
-	CreatePatchPolygons( model, *cp, material, primitiveNum );
+	CreatePatchPolygons( chop, model, *cp, material, primitiveNum );
 
 	delete cp;
 }
@@ -2647,7 +2816,7 @@ void idCollisionModelManagerLocal::ConvertPatch( cm_model_t *model, const idMapP
 idCollisionModelManagerLocal::ConvertBrushSides
 ================
 */
-void idCollisionModelManagerLocal::ConvertBrushSides( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum ) {
+void idCollisionModelManagerLocal::ConvertBrushSides( cm_chopState_t *chop, cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum ) {
 	int i, j;
 	idMapBrushSide *mapSide;
 	idFixedWinding w;
@@ -2663,8 +2832,12 @@ void idCollisionModelManagerLocal::ConvertBrushSides( cm_model_t *model, const i
 
 	// create a collision polygon for each brush side
 	for ( i = 0; i < mapBrush->GetNumSides(); i++ ) {
-		mapSide = mapBrush->GetSide(i);
-		material = declManager->FindMaterial( mapSide->GetMaterial() );
+		if ( chop->build != NULL ) {
+			material = chop->build->materials[i];
+		} else {
+			mapSide = mapBrush->GetSide(i);
+			material = declManager->FindMaterial( mapSide->GetMaterial() );
+		}
 		if ( !( material->GetContentFlags() & CONTENTS_REMOVE_UTIL ) ) {
 			continue;
 		}
@@ -2677,21 +2850,45 @@ void idCollisionModelManagerLocal::ConvertBrushSides( cm_model_t *model, const i
 		}
 
 		if ( w.GetNumPoints() ) {
-			PolygonFromWinding( model, &w, planes[i], material, primitiveNum );
+			PolygonFromWinding( chop, model, &w, planes[i], material, primitiveNum );
 		}
 	}
 }
 
+/*
+================
+idCollisionModelManagerLocal::CreateBrush
+================
+*/
+void idCollisionModelManagerLocal::CreateBrush( cm_model_t *model, const idPlane *planes, int numPlanes, const idBounds &bounds, int contents, const idMaterial *material, int primitiveNum ) {
+	int i;
+	cm_brush_t *brush;
+
+	// create brush for position test
+	brush = AllocBrush( model, numPlanes );
+	brush->checkcount = 0;
+	brush->contents = contents;
+	brush->material = material;
+	brush->primitiveNum = primitiveNum;
+	brush->bounds = bounds;
+	brush->numPlanes = numPlanes;
+	for ( i = 0; i < numPlanes; i++ ) {
+		brush->planes[i] = planes[i];
+	}
+	AddBrushToNode( model, model->node, brush );
+}
+
 /*
 ================
 idCollisionModelManagerLocal::ConvertBrush
+
+  When a build is given the brush is stored in it instead of added to the model.
 ================
 */
-void idCollisionModelManagerLocal::ConvertBrush( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum ) {
+void idCollisionModelManagerLocal::ConvertBrush( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum, cm_primitiveBuild_t *build ) {
 	int i, j, contents;
 	idBounds bounds;
 	idMapBrushSide *mapSide;
-	cm_brush_t *brush;
 	idPlane *planes;
 	idFixedWinding w;
 	const idMaterial *material = NULL;
@@ -2709,8 +2906,12 @@ void idCollisionModelManagerLocal::ConvertBrush( cm_model_t *model, const idMapB
 	// we are only getting the bounds for the brush so there's no need
 	// to create a winding for the last brush side
 	for ( i = 0; i < mapBrush->GetNumSides() - 1; i++ ) {
-		mapSide = mapBrush->GetSide(i);
-		material = declManager->FindMaterial( mapSide->GetMaterial() );
+		if ( build != NULL ) {
+			material = build->materials[i];
+		} else {
+			mapSide = mapBrush->GetSide(i);
+			material = declManager->FindMaterial( mapSide->GetMaterial() );
+		}
 		contents |= ( material->GetContentFlags() & CONTENTS_REMOVE_UTIL );
 		w.BaseForPlane( -planes[i] );
 		for ( j = 0; j < mapBrush->GetNumSides() && w.GetNumPoints(); j++ ) {
@@ -2727,18 +2928,17 @@ void idCollisionModelManagerLocal::ConvertBrush( cm_model_t *model, const idMapB
 	if ( !contents ) {
 		return;
 	}
-	// create brush for position test
-	brush = AllocBrush( model, mapBrush->GetNumSides() );
-	brush->checkcount = 0;
-	brush->contents = contents;
-	brush->material = material;
-	brush->primitiveNum = primitiveNum;
-	brush->bounds = bounds;
-	brush->numPlanes = mapBrush->GetNumSides();
-	for (i = 0; i < mapBrush->GetNumSides(); i++) {
-		brush->planes[i] = planes[i];
+	if ( build != NULL ) {
+		build->brushPlanes.SetNum( mapBrush->GetNumSides() );
+		for ( i = 0; i < mapBrush->GetNumSides(); i++ ) {
+			build->brushPlanes[i] = planes[i];
+		}
+		build->brushBounds = bounds;
+		build->brushContents = contents;
+		build->brushMaterial = material;
+		return;
 	}
-	AddBrushToNode( model, model->node, brush );
+	CreateBrush( model, planes, mapBrush->GetNumSides(), bounds, contents, material, primitiveNum );
 }
 
 /*
@@ -2937,13 +3137,13 @@ void idCollisionModelManagerLocal::OptimizeArrays( cm_model_t *model ) {
 idCollisionModelManagerLocal::FinishModel
 ================
 */
-void idCollisionModelManagerLocal::FinishModel( cm_model_t *model ) {
+void idCollisionModelManagerLocal::FinishModel( cm_model_t *model, bool parallel ) {
 	// try to merge polygons
 	checkCount++;
 	MergeTreePolygons( model, model->node );
 	// find internal edges (no mesh can ever collide with internal edges)
 	checkCount++;
-	FindInternalEdges( model, model->node );
+	FindInternalEdges( model, parallel );
 	// calculate edge normals
 	checkCount++;
 	CalculateEdgeNormals( model, model->node );
@@ -3374,7 +3574,7 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 			w += surf->geometry->verts[ surf->geometry->indexes[ j + 0 ] ].xyz;
 			w.GetPlane( plane );
 			plane = -plane;
-			PolygonFromWinding( model, &w, plane, surf->shader, 1 );
+			PolygonFromWinding( &cm_mainChop, model, &w, plane, surf->shader, 1 );
 		}
 	}
 
@@ -3383,7 +3583,7 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 
 	model->isConvex = false;
 
-	FinishModel( model );
+	FinishModel( model, false );
 
 	// shutdown the hash
 	ShutdownHash();
@@ -3393,17 +3593,206 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 	return model;
 }
 
+/*
+===============================================================================
+
+Building models on the job system
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::SetupPrimitiveBuilds
+
+  Materials are found on the main thread because the decl manager is not thread safe.
+================
+*/
+void idCollisionModelManagerLocal::SetupPrimitiveBuilds( const idMapEntity *mapEnt, idList<cm_primitiveBuild_t> &builds ) {
+	int i, j;
+
+	builds.SetNum( mapEnt->GetNumPrimitives() );
+	for ( i = 0; i < mapEnt->GetNumPrimitives(); i++ ) {
+		const idMapPrimitive *mapPrim = mapEnt->GetPrimitive(i);
+		cm_primitiveBuild_t &build = builds[i];
+
+		build.mapPrim = mapPrim;
+		build.primitiveNum = i;
+		build.brushBounds.Clear();
+		build.brushContents = 0;
+		build.brushMaterial = NULL;
+		build.numChops = 0;
+		build.numRemovedPolys = 0;
+		build.windingListOverflow = false;
+
+		if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+			const idMapBrush *mapBrush = static_cast<const idMapBrush *>( mapPrim );
+			build.materials.SetNum( mapBrush->GetNumSides() );
+			for ( j = 0; j < mapBrush->GetNumSides(); j++ ) {
+				build.materials[j] = declManager->FindMaterial( mapBrush->GetSide(j)->GetMaterial() );
+			}
+		} else if ( mapPrim->GetType() == idMapPrimitive::TYPE_PATCH ) {
+			build.materials.SetNum( 1 );
+			build.materials[0] = declManager->FindMaterial( static_cast<const idMapPatch *>( mapPrim )->GetMaterial() );
+		}
+	}
+}
+
+/*
+================
+CM_BuildModelJob
+================
+*/
+void CM_BuildModelJob( cm_buildJob_t * job ) {
+	if ( job->pass == CM_BUILD_INTERNAL_EDGES ) {
+		collisionModelManagerLocal.RunInternalEdgeJob( job );
+	} else {
+		collisionModelManagerLocal.RunPrimitiveBuildJob( job );
+	}
+}
+
+REGISTER_PARALLEL_JOB( CM_BuildModelJob, "CM_BuildModelJob" );
+
+/*
+================
+idCollisionModelManagerLocal::RunBuildJobs
+================
+*/
+void idCollisionModelManagerLocal::RunBuildJobs( cm_buildJob_t *jobs, int numJobs ) {
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+	for ( int i = 0; i < numJobs; i++ ) {
+		jobList->AddJob( (jobRun_t)CM_BuildModelJob, &jobs[i] );
+	}
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+}
+
+/*
+================
+idCollisionModelManagerLocal::RunPrimitiveBuildJob
+
+  Only reads the model and writes the builds it takes, the brush checkcounts are
+  tracked per job with the primitive number of the brushes.
+================
+*/
+void idCollisionModelManagerLocal::RunPrimitiveBuildJob( cm_buildJob_t *job ) {
+	int index;
+	cm_chopState_t chop;
+	cm_primitiveBuild_t *build;
+	const idMapPrimitive *mapPrim;
+
+	memset( &chop, 0, sizeof( chop ) );
+	if ( job->pass == CM_BUILD_POLYGONS ) {
+		chop.windingList = new (TAG_COLLISION) cm_windingList_t;
+		chop.outList = new (TAG_COLLISION) cm_windingList_t;
+		chop.tmpList = new (TAG_COLLISION) cm_windingList_t;
+		chop.brushChecks = (int *) Mem_ClearedAlloc( job->numPrimitives * sizeof( chop.brushChecks[0] ), TAG_COLLISION );
+	}
+
+	while( 1 ) {
+		index = job->nextItem->Increment() - 1;
+		if ( index >= job->numItems ) {
+			break;
+		}
+		build = &job->builds[index];
+		mapPrim = build->mapPrim;
+
+		if ( job->pass == CM_BUILD_BRUSHES ) {
+			if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+				ConvertBrush( job->model, static_cast<const idMapBrush *>( mapPrim ), build->primitiveNum, build );
+			}
+			continue;
+		}
+
+		chop.build = build;
+		if ( mapPrim->GetType() == idMapPrimitive::TYPE_PATCH ) {
+			ConvertPatch( &chop, job->model, static_cast<const idMapPatch *>( mapPrim ), build->primitiveNum );
+		} else if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+			ConvertBrushSides( &chop, job->model, static_cast<const idMapBrush *>( mapPrim ), build->primitiveNum );
+		}
+	}
+
+	delete chop.windingList;
+	delete chop.outList;
+	delete chop.tmpList;
+	Mem_Free( chop.brushChecks );
+}
+
+/*
+================
+idCollisionModelManagerLocal::RunInternalEdgeJob
+================
+*/
+void idCollisionModelManagerLocal::RunInternalEdgeJob( cm_buildJob_t *job ) {
+	int i, first, last;
+
+	job->tests.SetGranularity( 1024 );
+	while( 1 ) {
+		first = job->nextItem->Add( CM_INTERNAL_EDGE_BATCH ) - CM_INTERNAL_EDGE_BATCH;
+		if ( first >= job->numItems ) {
+			break;
+		}
+		last = Min( first + CM_INTERNAL_EDGE_BATCH, job->numItems );
+		for ( i = first; i < last; i++ ) {
+			cm_polygonEdgeTests_t &polygonTests = job->polygonTests[i];
+			polygonTests.jobNum = job->jobNum;
+			polygonTests.firstTest = job->tests.Num();
+			FindInternalPolygonEdges( job->model, job->model->node, job->polygons[i], job->tests );
+			polygonTests.numTests = job->tests.Num() - polygonTests.firstTest;
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::FinishPrimitiveBuild
+
+  Creates the polygons of a primitive chopped by a job and replays the checkcounts
+  so the model is the same as when the primitive is converted on the main thread.
+================
+*/
+void idCollisionModelManagerLocal::FinishPrimitiveBuild( cm_model_t *model, cm_primitiveBuild_t *build ) {
+	int i, j, numPoints;
+	idFixedWinding w;
+
+	for ( i = 0; i < build->brushChecks.Num(); i++ ) {
+		build->brushChecks[i].brush->checkcount = checkCount + build->brushChecks[i].chopNum;
+	}
+	checkCount += build->numChops;
+
+	model->numRemovedPolys += build->numRemovedPolys;
+
+	if ( build->windingListOverflow ) {
+		common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", build->primitiveNum, MAX_WINDING_LIST );
+	}
+
+	numPoints = 0;
+	for ( i = 0; i < build->polygons.Num(); i++ ) {
+		const cm_buildPolygon_t &polygon = build->polygons[i];
+		w.Clear();
+		for ( j = 0; j < polygon.numPoints; j++ ) {
+			w += build->points[numPoints + j];
+		}
+		numPoints += polygon.numPoints;
+		CreateWindingPolygons( model, &w, polygon.plane, polygon.material, polygon.primitiveNum );
+	}
+}
+
 /*
 ================
 idCollisionModelManagerLocal::CollisionModelForMapEntity
 ================
 */
-cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMapEntity *mapEnt ) {
+cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMapEntity *mapEnt, bool parallel ) {
 
 	cm_model_t *model;
 	idBounds bounds;
 	const char *name;
-	int i, brushCount;
+	int i, brushCount, numJobs;
+	idList<cm_primitiveBuild_t> builds;
+	idSysInterlockedInteger nextBuild;
+	cm_buildJob_t *jobs;
 
 	// if the entity has no primitives
 	if ( mapEnt->GetNumPrimitives() < 1 ) {
@@ -3440,14 +3829,49 @@ cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMa
 	model->name = name;
 	model->isConvex = false;
 
+	// small models are not worth the job overhead
+	parallel = parallel && mapEnt->GetNumPrimitives() >= CM_PARALLEL_BUILD_PRIMITIVES;
+
+	jobs = NULL;
+	numJobs = 0;
+	if ( parallel ) {
+		SetupPrimitiveBuilds( mapEnt, builds );
+
+		numJobs = Min( Max( parallelJobManager->GetNumProcessingUnits(), 1 ), builds.Num() );
+		jobs = new (TAG_COLLISION) cm_buildJob_t[numJobs];
+		for ( i = 0; i < numJobs; i++ ) {
+			jobs[i].pass = CM_BUILD_BRUSHES;
+			jobs[i].jobNum = i;
+			jobs[i].model = model;
+			jobs[i].nextItem = &nextBuild;
+			jobs[i].numItems = builds.Num();
+			jobs[i].builds = builds.Ptr();
+			jobs[i].numPrimitives = builds.Num();
+			jobs[i].polygons = NULL;
+			jobs[i].polygonTests = NULL;
+		}
+	}
+
 	// convert brushes
-	for ( i = 0; i < mapEnt->GetNumPrimitives(); i++ ) {
-		idMapPrimitive	*mapPrim;
+	if ( parallel ) {
+		RunBuildJobs( jobs, numJobs );
+
+		// add the brushes in primitive order
+		for ( i = 0; i < builds.Num(); i++ ) {
+			const cm_primitiveBuild_t &build = builds[i];
+			if ( build.brushContents ) {
+				CreateBrush( model, build.brushPlanes.Ptr(), build.brushPlanes.Num(), build.brushBounds, build.brushContents, build.brushMaterial, build.primitiveNum );
+			}
+		}
+	} else {
+		for ( i = 0; i < mapEnt->GetNumPrimitives(); i++ ) {
+			idMapPrimitive	*mapPrim;
 
-		mapPrim = mapEnt->GetPrimitive(i);
-		if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
-			ConvertBrush( model, static_cast<idMapBrush*>(mapPrim), i );
-			continue;
+			mapPrim = mapEnt->GetPrimitive(i);
+			if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+				ConvertBrush( model, static_cast<idMapBrush*>(mapPrim), i, NULL );
+				continue;
+			}
 		}
 	}
 
@@ -3471,21 +3895,37 @@ cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMa
 	ClearHash( bounds );
 
 	// create polygons from patches and brushes
-	for ( i = 0; i < mapEnt->GetNumPrimitives(); i++ ) {
-		idMapPrimitive	*mapPrim;
+	if ( parallel ) {
+		// the jobs chop the windings, the polygons are created in primitive order
+		// because the vertex and edge numbers depend on the order
+		nextBuild.SetValue( 0 );
+		for ( i = 0; i < numJobs; i++ ) {
+			jobs[i].pass = CM_BUILD_POLYGONS;
+		}
+		RunBuildJobs( jobs, numJobs );
+		delete[] jobs;
 
-		mapPrim = mapEnt->GetPrimitive(i);
-		if ( mapPrim->GetType() == idMapPrimitive::TYPE_PATCH ) {
-			ConvertPatch( model, static_cast<idMapPatch*>(mapPrim), i );
-			continue;
+		for ( i = 0; i < builds.Num(); i++ ) {
+			FinishPrimitiveBuild( model, &builds[i] );
 		}
-		if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
-			ConvertBrushSides( model, static_cast<idMapBrush*>(mapPrim), i );
-			continue;
+		builds.Clear();
+	} else {
+		for ( i = 0; i < mapEnt->GetNumPrimitives(); i++ ) {
+			idMapPrimitive	*mapPrim;
+
+			mapPrim = mapEnt->GetPrimitive(i);
+			if ( mapPrim->GetType() == idMapPrimitive::TYPE_PATCH ) {
+				ConvertPatch( &cm_mainChop, model, static_cast<idMapPatch*>(mapPrim), i );
+				continue;
+			}
+			if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+				ConvertBrushSides( &cm_mainChop, model, static_cast<idMapBrush*>(mapPrim), i );
+				continue;
+			}
 		}
 	}
 
-	FinishModel( model );
+	FinishModel( model, parallel );
 
 	return model;
 }
@@ -3629,7 +4069,7 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile *mapFile ) {
 				common->Error( "idCollisionModelManagerLocal::BuildModels: more than %d collision models", MAX_SUBMODELS );
 				break;
 			}
-			models[numModels] = CollisionModelForMapEntity( mapEnt );
+			models[numModels] = CollisionModelForMapEntity( mapEnt, cm_parallelBuild.GetBool() );
 			if ( models[ numModels] ) {
 				numModels++;
 			}
@@ -3655,6 +4095,107 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile *mapFile ) {
 }
 
 
+/*
+================
+idCollisionModelManagerLocal::TestParallelBuild
+
+  Builds the models of all entities on the main thread and on the job system, starting with
+  the same checkcount, and compares the binary models byte for byte. The loaded map is not changed.
+================
+*/
+bool idCollisionModelManagerLocal::TestParallelBuild( const char *mapFileName ) {
+	int i, j, modelNum, numModelsBuilt, numMismatches, startCheckCount, serialCheckCount;
+	uint64 start, serialMicroseconds, parallelMicroseconds;
+	bool loadedProcBSP;
+	cm_model_t *builtModels[2];
+	idMapFile mapFile;
+
+	if ( mapFileName == NULL || !mapFileName[0] ) {
+		mapFileName = mapName.c_str();
+	}
+	if ( !mapFileName[0] ) {
+		common->Printf( "no map loaded\n" );
+		return false;
+	}
+	if ( !mapFile.Parse( mapFileName ) ) {
+		common->Printf( "couldn't load %s\n", mapFileName );
+		return false;
+	}
+
+	loadedProcBSP = false;
+	if ( procNodes == NULL ) {
+		LoadProcBSP( mapFile.GetName() );
+		loadedProcBSP = true;
+	}
+	SetupHash();
+
+	const int savedNumModels = numModels;
+
+	modelNum = 0;
+	numModelsBuilt = 0;
+	numMismatches = 0;
+	serialMicroseconds = 0;
+	parallelMicroseconds = 0;
+	for ( i = 0; i < mapFile.GetNumEntities(); i++ ) {
+		const idMapEntity *mapEnt = mapFile.GetEntity(i);
+
+		// the first model built is the world model which is also chopped with the proc BSP tree
+		numModels = modelNum;
+
+		startCheckCount = checkCount;
+		start = Sys_Microseconds();
+		builtModels[0] = CollisionModelForMapEntity( mapEnt, false );
+		serialMicroseconds += Sys_Microseconds() - start;
+		serialCheckCount = checkCount;
+
+		checkCount = startCheckCount;
+		start = Sys_Microseconds();
+		builtModels[1] = CollisionModelForMapEntity( mapEnt, true );
+		parallelMicroseconds += Sys_Microseconds() - start;
+
+		if ( checkCount != serialCheckCount ) {
+			common->Printf( "entity %d: checkcount %d != %d\n", i, checkCount, serialCheckCount );
+			checkCount = Max( checkCount, serialCheckCount );
+			numMismatches++;
+		}
+
+		if ( builtModels[0] == NULL || builtModels[1] == NULL ) {
+			for ( j = 0; j < 2; j++ ) {
+				if ( builtModels[j] != NULL ) {
+					FreeModel( builtModels[j] );
+				}
+			}
+			continue;
+		}
+
+		idFile_Memory serialFile( "serial" );
+		idFile_Memory parallelFile( "parallel" );
+		WriteBinaryModelToFile( builtModels[0], &serialFile, 0 );
+		WriteBinaryModelToFile( builtModels[1], &parallelFile, 0 );
+		if ( serialFile.Length() != parallelFile.Length() || memcmp( serialFile.GetDataPtr(), parallelFile.GetDataPtr(), serialFile.Length() ) != 0 ) {
+			common->Printf( "entity %d: model %s differs\n", i, builtModels[0]->name.c_str() );
+			numMismatches++;
+		}
+
+		FreeModel( builtModels[0] );
+		FreeModel( builtModels[1] );
+		modelNum++;
+		numModelsBuilt++;
+	}
+
+	numModels = savedNumModels;
+	if ( loadedProcBSP ) {
+		Mem_Free( procNodes );
+		procNodes = NULL;
+	}
+	ShutdownHash();
+
+	common->Printf( "%d models, %d mismatches\n", numModelsBuilt, numMismatches );
+	common->Printf( "serial:   %7d msec\n", (int)( serialMicroseconds / 1000 ) );
+	common->Printf( "parallel: %7d msec\n", (int)( parallelMicroseconds / 1000 ) );
+	return numMismatches == 0;
+}
+
 /*
 ================
 idCollisionModelManagerLocal::Preload
@@ -287,6 +287,124 @@ typedef struct cm_traceWork_s {
 /*
 ===============================================================================
 
+Data used to trace a packet of point traces at once
+
+===============================================================================
+*/
+
+#define CM_RAY_PACKET_SIZE					16		// multiple of 4 for SIMD, less than 32 for the ray masks
+
+typedef struct cm_rayPacket_s {
+	int numRays;
+	cm_model_t *model;								// model colliding with
+	int contents;									// ignore polygons that do not have any of these contents flags
+	ALIGN16( float startX[CM_RAY_PACKET_SIZE] );	// ray starts and end points for SIMD plane distances
+	ALIGN16( float startY[CM_RAY_PACKET_SIZE] );
+	ALIGN16( float startZ[CM_RAY_PACKET_SIZE] );
+	ALIGN16( float endX[CM_RAY_PACKET_SIZE] );
+	ALIGN16( float endY[CM_RAY_PACKET_SIZE] );
+	ALIGN16( float endZ[CM_RAY_PACKET_SIZE] );
+	idVec3 start[CM_RAY_PACKET_SIZE];				// start of trace
+	idVec3 endp[CM_RAY_PACKET_SIZE];				// start + dir like the trm vertex of a single point trace
+	idVec3 dir[CM_RAY_PACKET_SIZE];					// trace direction
+	idBounds bounds[CM_RAY_PACKET_SIZE];			// bounds of full trace
+	idPluecker pl[CM_RAY_PACKET_SIZE];				// pluecker coordinate for the ray
+	trace_t trace[CM_RAY_PACKET_SIZE];				// collision detection result
+} cm_rayPacket_t;
+
+typedef struct cm_raySegment_s {
+	int ray;										// index into the packet
+	float p1f;										// fractions of the trace at the start and end of the segment
+	float p2f;
+	idVec3 p1;										// start and end of the segment
+	idVec3 p2;
+} cm_raySegment_t;
+
+/*
+===============================================================================
+
+Data used to build the collision models of a .map on the job system
+
+===============================================================================
+*/
+
+#define CM_PARALLEL_BUILD_PRIMITIVES		64		// entities with fewer primitives are always built serially
+#define CM_INTERNAL_EDGE_BATCH				32		// polygons taken at once by an internal edge job
+
+typedef struct cm_brushCheck_s {
+	cm_brush_t *			brush;				// brush visited while chopping a winding
+	int						chopNum;			// number of the chop within the primitive, starting at 1
+} cm_brushCheck_t;
+
+typedef struct cm_buildPolygon_s {
+	int						numPoints;			// number of winding points in cm_primitiveBuild_t::points
+	idPlane					plane;				// polygon plane
+	const idMaterial *		material;			// polygon material
+	int						primitiveNum;		// negative for patches
+} cm_buildPolygon_t;
+
+typedef struct cm_primitiveBuild_s {
+	const idMapPrimitive *	mapPrim;			// brush or patch
+	int						primitiveNum;		// index of the primitive in the map entity
+	idList<const idMaterial *> materials;		// side materials or the patch material, found on the main thread
+	// brush for position tests
+	idList<idPlane>			brushPlanes;		// brush planes with degeneracies fixed
+	idBounds				brushBounds;		// brush bounds
+	int						brushContents;		// zero if no brush should be created
+	const idMaterial *		brushMaterial;		// brush material
+	// chopped windings to turn into polygons
+	idList<idVec5>			points;				// points of all windings
+	idList<cm_buildPolygon_t> polygons;			// windings that are not fully contained in brushes
+	idList<cm_brushCheck_t>	brushChecks;		// brushes visited while chopping to replay the checkcounts
+	int						numChops;			// number of windings chopped with the tree brushes
+	int						numRemovedPolys;	// windings chopped away completely
+	bool					windingListOverflow;// set if a chop ran out of winding list space
+} cm_primitiveBuild_t;
+
+typedef struct cm_chopState_s {
+	cm_windingList_t *		windingList;		// windings chopped with the tree brushes
+	cm_windingList_t *		outList;			// windings left after chopping with a brush
+	cm_windingList_t *		tmpList;			// fragments of a single winding
+	int *					brushChecks;		// per primitive last chop that visited the brush, NULL to use the brush checkcounts
+	int						checkCount;			// chop count for brushChecks
+	cm_primitiveBuild_t *	build;				// if set windings are stored in the build instead of turned into polygons
+} cm_chopState_t;
+
+typedef struct cm_internalEdgeTest_s {
+	uint64					internalEdges;		// edges found to be internal when tested against the other polygon
+	uint64					stopEdges;			// edges at which the test against the other polygon stops
+} cm_internalEdgeTest_t;
+
+typedef struct cm_polygonEdgeTests_s {
+	int						jobNum;				// job that stored the tests
+	int						firstTest;			// index into the tests of the job
+	int						numTests;
+} cm_polygonEdgeTests_t;
+
+enum cmBuildPass_t {
+	CM_BUILD_BRUSHES,
+	CM_BUILD_POLYGONS,
+	CM_BUILD_INTERNAL_EDGES
+};
+
+typedef struct cm_buildJob_s {
+	cmBuildPass_t			pass;
+	int						jobNum;
+	cm_model_t *			model;
+	idSysInterlockedInteger *nextItem;			// shared by all jobs of the pass
+	int						numItems;
+	cm_primitiveBuild_t *	builds;				// CM_BUILD_BRUSHES and CM_BUILD_POLYGONS
+	int						numPrimitives;
+	cm_polygon_t **			polygons;			// CM_BUILD_INTERNAL_EDGES
+	cm_polygonEdgeTests_t *	polygonTests;
+	idList<cm_internalEdgeTest_t> tests;
+} cm_buildJob_t;
+
+void CM_BuildModelJob( cm_buildJob_t * job );
+
+/*
+===============================================================================
+
 Collision Map
 
 ===============================================================================
@@ -329,6 +447,10 @@ public:
 	void			Translation( trace_t *results, const idVec3 &start, const idVec3 &end,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	// translates a trm along a batch of rays and reports the first collision of each
+	void			TranslationBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 	// rotates a trm and reports the first collision if any
 	void			Rotation( trace_t *results, const idVec3 &start, const idRotation &rotation,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
@@ -352,6 +474,15 @@ public:
 	void			ListModels();
 	// write a collision model file for the map entity
 	bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true );
+	// build the collision models of a .map serially and on the job system and compare the binary models
+	bool			TestParallelBuild( const char *mapFileName );
+	// position tests of the traces in a batch that start and end at the same position, main thread only
+	void			PositionTestBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	// point traces of a batch as packets, skips position tests and is safe to run on several threads at once
+	void			TraceRayBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+								int contentMask, cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) const;
 
 private:			// CollisionMap_translate.cpp
 	int				TranslateEdgeThroughEdge( idVec3 &cross, idPluecker &l1, idPluecker &l2, float *fraction );
@@ -400,12 +531,15 @@ private:			// CollisionMap_contents.cpp
 	int				ContentsTrm( trace_t *results, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	friend void		CM_BuildModelJob( cm_buildJob_t * job );
 
 private:			// CollisionMap_trace.cpp
 	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
+	void			TraceRayPacketThroughNode( cm_rayPacket_t *packet, const cm_node_t *node, unsigned int activeRays ) const;
+	void			TraceRayPacketThroughAxialBSPTree_r( cm_rayPacket_t *packet, const cm_node_t *node, const cm_raySegment_t *segments, const int numSegments ) const;
 
 private:			// CollisionMap_load.cpp
 	void			Clear();
@@ -426,10 +560,12 @@ private:			// CollisionMap_load.cpp
 	bool			MergePolygonWithTreePolygons( cm_model_t *model, cm_node_t *node, cm_polygon_t *polygon );
 	void			MergeTreePolygons( cm_model_t *model, cm_node_t *node );
 					// finding internal edges
-	bool			PointInsidePolygon( cm_model_t *model, cm_polygon_t *p, idVec3 &v );
-	void			FindInternalEdgesOnPolygon( cm_model_t *model, cm_polygon_t *p1, cm_polygon_t *p2 );
-	void			FindInternalPolygonEdges( cm_model_t *model, cm_node_t *node, cm_polygon_t *polygon );
-	void			FindInternalEdges( cm_model_t *model, cm_node_t *node );
+	bool			PointInsidePolygon( const cm_model_t *model, const cm_polygon_t *p, const idVec3 &v ) const;
+	bool			TestInternalEdgesOnPolygon( const cm_model_t *model, const cm_polygon_t *p1, const cm_polygon_t *p2, cm_internalEdgeTest_t &test ) const;
+	void			FindInternalPolygonEdges( const cm_model_t *model, const cm_node_t *node, const cm_polygon_t *polygon, idList<cm_internalEdgeTest_t> &tests ) const;
+	void			SetInternalPolygonEdges( cm_model_t *model, const cm_polygon_t *polygon, const cm_internalEdgeTest_t *tests, const int numTests );
+	void			R_GetInternalEdgePolygons( cm_node_t *node, idList<cm_polygon_t *> &polygons );
+	void			FindInternalEdges( cm_model_t *model, bool parallel );
 	void			FindContainedEdges( cm_model_t *model, cm_polygon_t *p );
 					// loading of proc BSP tree
 	void			ParseProcNodes( idLexer *src );
@@ -437,9 +573,9 @@ private:			// CollisionMap_load.cpp
 					// removal of contained polygons
 	int				R_ChoppedAwayByProcBSP( int nodeNum, idFixedWinding *w, const idVec3 &normal, const idVec3 &origin, const float radius );
 	int				ChoppedAwayByProcBSP( const idFixedWinding &w, const idPlane &plane, int contents );
-	void			ChopWindingListWithBrush( cm_windingList_t *list, cm_brush_t *b );
-	void			R_ChopWindingListWithTreeBrushes( cm_windingList_t *list, cm_node_t *node );
-	idFixedWinding *WindingOutsideBrushes( idFixedWinding *w, const idPlane &plane, int contents, int patch, cm_node_t *headNode );
+	void			ChopWindingListWithBrush( cm_chopState_t *chop, cm_windingList_t *list, cm_brush_t *b );
+	void			R_ChopWindingListWithTreeBrushes( cm_chopState_t *chop, cm_windingList_t *list, cm_node_t *node );
+	idFixedWinding *WindingOutsideBrushes( cm_chopState_t *chop, idFixedWinding *w, const idPlane &plane, int contents, int patch, cm_node_t *headNode );
 					// creation of axial BSP tree
 	cm_model_t *	AllocModel();
 	cm_node_t *		AllocNode( cm_model_t *model, int blockSize );
@@ -462,20 +598,27 @@ private:			// CollisionMap_load.cpp
 	int				GetVertex( cm_model_t *model, const idVec3 &v, int *vertexNum );
 	int				GetEdge( cm_model_t *model, const idVec3 &v1, const idVec3 &v2, int *edgeNum, int v1num );
 	void			CreatePolygon( cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum );
-	void			PolygonFromWinding( cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum );
+	void			CreateWindingPolygons( cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum );
+	void			PolygonFromWinding( cm_chopState_t *chop, cm_model_t *model, idFixedWinding *w, const idPlane &plane, const idMaterial *material, int primitiveNum );
 	void			CalculateEdgeNormals( cm_model_t *model, cm_node_t *node );
-	void			CreatePatchPolygons( cm_model_t *model, idSurface_Patch &mesh, const idMaterial *material, int primitiveNum );
-	void			ConvertPatch( cm_model_t *model, const idMapPatch *patch, int primitiveNum );
-	void			ConvertBrushSides( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum );
-	void			ConvertBrush( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum );
+	void			CreatePatchPolygons( cm_chopState_t *chop, cm_model_t *model, idSurface_Patch &mesh, const idMaterial *material, int primitiveNum );
+	void			ConvertPatch( cm_chopState_t *chop, cm_model_t *model, const idMapPatch *patch, int primitiveNum );
+	void			ConvertBrushSides( cm_chopState_t *chop, cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum );
+	void			CreateBrush( cm_model_t *model, const idPlane *planes, int numPlanes, const idBounds &bounds, int contents, const idMaterial *material, int primitiveNum );
+	void			ConvertBrush( cm_model_t *model, const idMapBrush *mapBrush, int primitiveNum, cm_primitiveBuild_t *build );
+	void			SetupPrimitiveBuilds( const idMapEntity *mapEnt, idList<cm_primitiveBuild_t> &builds );
+	void			RunBuildJobs( cm_buildJob_t *jobs, int numJobs );
+	void			RunPrimitiveBuildJob( cm_buildJob_t *job );
+	void			RunInternalEdgeJob( cm_buildJob_t *job );
+	void			FinishPrimitiveBuild( cm_model_t *model, cm_primitiveBuild_t *build );
 	void			PrintModelInfo( const cm_model_t *model );
 	void			AccumulateModelInfo( cm_model_t *model );
 	void			RemapEdges( cm_node_t *node, int *edgeRemap );
 	void			OptimizeArrays( cm_model_t *model );
-	void			FinishModel( cm_model_t *model );
+	void			FinishModel( cm_model_t *model, bool parallel );
 	void			BuildModels( const idMapFile *mapFile );
 	cmHandle_t		FindModel( const char *name );
-	cm_model_t *	CollisionModelForMapEntity( const idMapEntity *mapEnt );	// brush/patch model from .map
+	cm_model_t *	CollisionModelForMapEntity( const idMapEntity *mapEnt, bool parallel );	// brush/patch model from .map
 	cm_model_t *	LoadRenderModel( const char *fileName );					// ASE/LWO models
 	cm_model_t *	LoadBinaryModel( const char *fileName, ID_TIME_T sourceTimeStamp );
 	cm_model_t *	LoadBinaryModelFromFile( idFile *fileIn, ID_TIME_T sourceTimeStamp );
@@ -535,5 +678,7 @@ private:			// collision map data
 	int				numContacts;
 };
 
+extern idCollisionModelManagerLocal collisionModelManagerLocal;
+
 // for debugging
 extern idCVar cm_debugCollision;
@@ -255,3 +255,486 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
 	}
 }
+
+/*
+===============================================================================
+
+Trace packets of point traces through the spatial subdivision
+
+The rays of a packet share the walk through the axial BSP tree and each polygon
+is tested against all rays in the packet at once. Nothing is written to the model,
+so packets can be traced on several threads at the same time. The results are the
+same as tracing each point with Translation.
+
+===============================================================================
+*/
+
+/*
+================
+CM_RayPacketPlaneCrossings
+
+Calculates the distances of the ray starts and end points to the plane and returns a bit for every
+ray that approaches the plane from the front closer than the clip epsilon, the same rays for which
+CM_TranslationPlaneFraction does not return 1.
+================
+*/
+static unsigned int CM_RayPacketPlaneCrossings( const cm_rayPacket_t *packet, const idPlane &plane, float *dist1, float *dist2 ) {
+	unsigned int crossings = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const float * p = plane.ToFloatPtr();
+	const __m128 a = _mm_load1_ps( p + 0 );
+	const __m128 b = _mm_load1_ps( p + 1 );
+	const __m128 c = _mm_load1_ps( p + 2 );
+	const __m128 d = _mm_load1_ps( p + 3 );
+	const __m128 clipEpsilon = _mm_set1_ps( CM_CLIP_EPSILON );
+	const __m128 smallest = _mm_set1_ps( idMath::FLT_SMALLEST_NON_DENORMAL );
+	const __m128 zero = _mm_setzero_ps();
+
+	for ( int i = 0; i < packet->numRays; i += 4 ) {
+		// same order of operations as idPlane::Distance
+		const __m128 d1 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_load_ps( packet->startX + i ) ), _mm_mul_ps( b, _mm_load_ps( packet->startY + i ) ) ), _mm_mul_ps( c, _mm_load_ps( packet->startZ + i ) ) ), d );
+		const __m128 d2 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_load_ps( packet->endX + i ) ), _mm_mul_ps( b, _mm_load_ps( packet->endY + i ) ) ), _mm_mul_ps( c, _mm_load_ps( packet->endZ + i ) ) ), d );
+		_mm_store_ps( dist1 + i, d1 );
+		_mm_store_ps( dist2 + i, d2 );
+
+		__m128 mask = _mm_cmplt_ps( d2, clipEpsilon );
+		mask = _mm_and_ps( mask, _mm_cmpgt_ps( d1, zero ) );
+		mask = _mm_and_ps( mask, _mm_cmpge_ps( _mm_sub_ps( d1, d2 ), smallest ) );
+		crossings |= _mm_movemask_ps( mask ) << i;
+	}
+
+#else
+
+	for ( int i = 0; i < packet->numRays; i++ ) {
+		const float d1 = plane.Distance( idVec3( packet->startX[i], packet->startY[i], packet->startZ[i] ) );
+		const float d2 = plane.Distance( idVec3( packet->endX[i], packet->endY[i], packet->endZ[i] ) );
+		dist1[i] = d1;
+		dist2[i] = d2;
+		if ( d2 < CM_CLIP_EPSILON && d1 > 0.0f && d1 - d2 >= idMath::FLT_SMALLEST_NON_DENORMAL ) {
+			crossings |= 1 << i;
+		}
+	}
+
+#endif
+
+	return crossings & ( ( 1u << packet->numRays ) - 1 );
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceRayPacketThroughNode
+================
+*/
+void idCollisionModelManagerLocal::TraceRayPacketThroughNode( cm_rayPacket_t *packet, const cm_node_t *node, unsigned int activeRays ) const {
+	ALIGN16( float dist1[CM_RAY_PACKET_SIZE] );
+	ALIGN16( float dist2[CM_RAY_PACKET_SIZE] );
+	idPluecker edgePl[CM_MAX_POLYGON_EDGES];
+
+	for ( const cm_polygonRef_t * pref = node->polygons; pref != NULL && activeRays != 0; pref = pref->next ) {
+		cm_polygon_t * poly = pref->p;
+
+		// if this polygon does not have the right contents behind it
+		if ( !( poly->contents & packet->contents ) ) {
+			continue;
+		}
+
+		unsigned int rays = CM_RayPacketPlaneCrossings( packet, poly->plane, dist1, dist2 ) & activeRays;
+		if ( rays == 0 ) {
+			continue;
+		}
+
+		// the edges are the same for every ray, unlike the single point trace they are not cached in the model
+		for ( int i = 0; i < poly->numEdges; i++ ) {
+			const cm_edge_t * edge = packet->model->edges + abs( poly->edges[i] );
+			edgePl[i].FromLine( packet->model->vertices[edge->vertexNum[0]].p, packet->model->vertices[edge->vertexNum[1]].p );
+		}
+
+		for ( int r = 0; rays != 0; r++, rays >>= 1 ) {
+			if ( !( rays & 1 ) ) {
+				continue;
+			}
+			trace_t & trace = packet->trace[r];
+
+			// if the the trace bounds do not intersect the polygon bounds
+			if ( !packet->bounds[r].IntersectsBounds( poly->bounds ) ) {
+				continue;
+			}
+			// only collide with the polygon if approaching at the front
+			if ( ( poly->plane.Normal() * packet->dir[r] ) > 0.0f ) {
+				continue;
+			}
+
+			float f = ( dist1[r] - CM_CLIP_EPSILON ) / ( dist1[r] - dist2[r] );
+			if ( f >= trace.fraction ) {
+				continue;
+			}
+
+			int i;
+			for ( i = 0; i < poly->numEdges; i++ ) {
+				// if the point passes the edge at the wrong side
+				const int edgeNum = poly->edges[i];
+				const unsigned long side = ( packet->pl[r].PermutedInnerProduct( edgePl[i] ) < 0.0f );
+				if ( INT32_SIGNBITSET( edgeNum ) ^ side ) {
+					break;
+				}
+			}
+			if ( i < poly->numEdges ) {
+				continue;
+			}
+
+			if ( f < 0.0f ) {
+				f = 0.0f;
+			}
+			trace.fraction = f;
+			// collision plane is the polygon plane
+			trace.c.normal = poly->plane.Normal();
+			trace.c.dist = poly->plane.Dist();
+			trace.c.contents = poly->contents;
+			trace.c.material = poly->material;
+			trace.c.type = CONTACT_TRMVERTEX;
+			trace.c.modelFeature = *reinterpret_cast<int *>(&poly);
+			trace.c.trmFeature = 0;
+			trace.c.point = packet->start[r] + trace.fraction * ( packet->endp[r] - packet->start[r] );
+
+			// if stuck in solid
+			if ( trace.fraction == 0.0f ) {
+				activeRays &= ~( 1u << r );
+			}
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r
+
+Splits the ray segments at the node plane like TraceThroughAxialBSPTree_r does for a single point trace.
+================
+*/
+void idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( cm_rayPacket_t *packet, const cm_node_t *node, const cm_raySegment_t *segments, const int numSegments ) const {
+	if ( !node ) {
+		return;
+	}
+
+	// rays that already hit something nearer are done
+	unsigned int activeRays = 0;
+	for ( int i = 0; i < numSegments; i++ ) {
+		if ( packet->trace[segments[i].ray].fraction > segments[i].p1f ) {
+			activeRays |= 1u << segments[i].ray;
+		}
+	}
+	if ( activeRays == 0 ) {
+		return;
+	}
+
+	// if we need to test this node for collisions
+	if ( node->polygons ) {
+		TraceRayPacketThroughNode( packet, node, activeRays );
+	}
+	// if this is a leaf node
+	if ( node->planeType == -1 ) {
+		return;
+	}
+
+	// classify the segments against the node plane first, the side that most split rays start on is visited first
+	int segmentSide[CM_RAY_PACKET_SIZE];		// side the segment starts on
+	bool segmentSplit[CM_RAY_PACKET_SIZE];		// segment crosses the node plane
+	float segmentFrac[CM_RAY_PACKET_SIZE];		// fraction up to the node
+	float segmentFrac2[CM_RAY_PACKET_SIZE];		// fraction past the node
+	int numNearSide[2] = { 0, 0 };
+
+	const float offset = CM_BOX_EPSILON;
+
+	for ( int i = 0; i < numSegments; i++ ) {
+		const cm_raySegment_t & segment = segments[i];
+		segmentSplit[i] = false;
+		segmentSide[i] = -1;
+		if ( !( activeRays & ( 1u << segment.ray ) ) ) {
+			continue;
+		}
+
+		// distance from plane for trace start and end
+		const float t1 = segment.p1[node->planeType] - node->planeDist;
+		const float t2 = segment.p2[node->planeType] - node->planeDist;
+
+		// see which sides we need to consider
+		if ( t1 >= offset && t2 >= offset ) {
+			segmentSide[i] = 0;
+			continue;
+		}
+		if ( t1 < -offset && t2 < -offset ) {
+			segmentSide[i] = 1;
+			continue;
+		}
+
+		if ( t1 < t2 ) {
+			const float idist = 1.0f / ( t1 - t2 );
+			segmentSide[i] = 1;
+			segmentFrac2[i] = ( t1 + offset ) * idist;
+			segmentFrac[i] = ( t1 - offset ) * idist;
+		} else if ( t1 > t2 ) {
+			const float idist = 1.0f / ( t1 - t2 );
+			segmentSide[i] = 0;
+			segmentFrac2[i] = ( t1 - offset ) * idist;
+			segmentFrac[i] = ( t1 + offset ) * idist;
+		} else {
+			segmentSide[i] = 0;
+			segmentFrac[i] = 1.0f;
+			segmentFrac2[i] = 0.0f;
+		}
+		segmentSplit[i] = true;
+		numNearSide[segmentSide[i]]++;
+	}
+
+	// Every ray has to visit the side it starts on before the far side, like the single point trace,
+	// so a hit at the same fraction in both children resolves to the same polygon. The children are
+	// visited three times: the first side with the rays that start there, the other side with the
+	// rays that start there or cross over from the first side, and the first side again with the rays
+	// that cross over from the other side.
+	const int first = ( numNearSide[1] > numNearSide[0] ) ? 1 : 0;
+	cm_raySegment_t passSegments[3][CM_RAY_PACKET_SIZE];
+	int numPassSegments[3] = { 0, 0, 0 };
+
+	for ( int i = 0; i < numSegments; i++ ) {
+		const cm_raySegment_t & segment = segments[i];
+		const int side = segmentSide[i];
+		if ( side < 0 ) {
+			continue;
+		}
+		if ( !segmentSplit[i] ) {
+			const int pass = ( side == first ) ? 0 : 1;
+			passSegments[pass][numPassSegments[pass]++] = segment;
+			continue;
+		}
+
+		// move up to the node
+		const float frac = idMath::ClampFloat( 0.0f, 1.0f, segmentFrac[i] );
+
+		const int nearPass = ( side == first ) ? 0 : 1;
+		cm_raySegment_t & nearSegment = passSegments[nearPass][numPassSegments[nearPass]++];
+		nearSegment.ray = segment.ray;
+		nearSegment.p1f = segment.p1f;
+		nearSegment.p2f = segment.p1f + ( segment.p2f - segment.p1f ) * frac;
+		nearSegment.p1 = segment.p1;
+		nearSegment.p2[0] = segment.p1[0] + frac * ( segment.p2[0] - segment.p1[0] );
+		nearSegment.p2[1] = segment.p1[1] + frac * ( segment.p2[1] - segment.p1[1] );
+		nearSegment.p2[2] = segment.p1[2] + frac * ( segment.p2[2] - segment.p1[2] );
+
+		// go past the node
+		const float frac2 = idMath::ClampFloat( 0.0f, 1.0f, segmentFrac2[i] );
+
+		const int farPass = nearPass + 1;
+		cm_raySegment_t & farSegment = passSegments[farPass][numPassSegments[farPass]++];
+		farSegment.ray = segment.ray;
+		farSegment.p1f = segment.p1f + ( segment.p2f - segment.p1f ) * frac2;
+		farSegment.p2f = segment.p2f;
+		farSegment.p1[0] = segment.p1[0] + frac2 * ( segment.p2[0] - segment.p1[0] );
+		farSegment.p1[1] = segment.p1[1] + frac2 * ( segment.p2[1] - segment.p1[1] );
+		farSegment.p1[2] = segment.p1[2] + frac2 * ( segment.p2[2] - segment.p1[2] );
+		farSegment.p2 = segment.p2;
+	}
+
+	const int passChild[3] = { first, first ^ 1, first };
+	for ( int pass = 0; pass < 3; pass++ ) {
+		if ( numPassSegments[pass] ) {
+			TraceRayPacketThroughAxialBSPTree_r( packet, node->children[passChild[pass]], passSegments[pass], numPassSegments[pass] );
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TranslationBatch
+
+Point traces are traced as packets, anything else goes through Translation one trace at a time.
+================
+*/
+void idCollisionModelManagerLocal::TranslationBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+
+	const bool pointTrace = ( !trm || ( trm->bounds[1][0] - trm->bounds[0][0] <= 0.0f &&
+										trm->bounds[1][1] - trm->bounds[0][1] <= 0.0f &&
+										trm->bounds[1][2] - trm->bounds[0][2] <= 0.0f ) );
+
+	if ( !pointTrace || idCollisionModelManagerLocal::getContacts ) {
+		for ( int i = 0; i < numTraces; i++ ) {
+			Translation( &results[i], starts[i], ends[i], trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+		}
+		return;
+	}
+
+	PositionTestBatch( results, starts, ends, numTraces, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+	TraceRayBatch( results, starts, ends, numTraces, contentMask, model, modelOrigin, modelAxis );
+}
+
+/*
+================
+idCollisionModelManagerLocal::PositionTestBatch
+
+Runs the position tests of the traces in a batch that start and end at the same position. The
+position test uses the model caches, so this has to run on the main thread.
+================
+*/
+void idCollisionModelManagerLocal::PositionTestBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	for ( int i = 0; i < numTraces; i++ ) {
+		const idVec3 & start = starts[i];
+		const idVec3 & end = ends[i];
+		if ( start[0] == end[0] && start[1] == end[1] && start[2] == end[2] ) {
+			Translation( &results[i], start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceRayBatch
+
+Traces the point traces of a batch as packets. Traces that start and end at the same position are
+skipped and keep the results of PositionTestBatch. Only reads the model, so it is safe to run on
+any number of threads at once.
+================
+*/
+void idCollisionModelManagerLocal::TraceRayBatch( trace_t *results, const idVec3 *starts, const idVec3 *ends, const int numTraces,
+										int contentMask, cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) const {
+
+	if ( model < 0 || model > MAX_SUBMODELS || model > idCollisionModelManagerLocal::maxModels ) {
+		common->Printf("idCollisionModelManagerLocal::TraceRayBatch: invalid model handle\n");
+		memset( results, 0, numTraces * sizeof( results[0] ) );
+		return;
+	}
+	if ( !idCollisionModelManagerLocal::models[model] ) {
+		common->Printf("idCollisionModelManagerLocal::TraceRayBatch: invalid model\n");
+		memset( results, 0, numTraces * sizeof( results[0] ) );
+		return;
+	}
+
+	const bool model_rotated = modelAxis.IsRotated();
+	idMat3 invModelAxis;
+	if ( model_rotated ) {
+		invModelAxis = modelAxis.Transpose();
+	}
+
+	ALIGN16( cm_rayPacket_t packet );
+	int packetTraces[CM_RAY_PACKET_SIZE];
+	cm_raySegment_t segments[CM_RAY_PACKET_SIZE];
+
+	packet.model = idCollisionModelManagerLocal::models[model];
+	packet.contents = contentMask;
+
+	for ( int firstTrace = 0; firstTrace < numTraces; ) {
+		// gather the next packet of rays
+		memset( packet.trace, 0, sizeof( packet.trace ) );
+		packet.numRays = 0;
+		for ( ; firstTrace < numTraces && packet.numRays < CM_RAY_PACKET_SIZE; firstTrace++ ) {
+			const idVec3 & start = starts[firstTrace];
+			const idVec3 & end = ends[firstTrace];
+
+			// position tests are done by PositionTestBatch
+			if ( start[0] == end[0] && start[1] == end[1] && start[2] == end[2] ) {
+				continue;
+			}
+
+			const int r = packet.numRays++;
+			packetTraces[r] = firstTrace;
+
+			idVec3 rayStart = start - modelOrigin;
+			idVec3 rayEnd = end - modelOrigin;
+			idVec3 rayDir = end - start;
+			if ( model_rotated ) {
+				// rotate trace instead of model
+				rayStart *= invModelAxis;
+				rayEnd *= invModelAxis;
+				rayDir *= invModelAxis;
+			}
+
+			packet.start[r] = rayStart;
+			packet.dir[r] = rayDir;
+			packet.endp[r] = rayStart + rayDir;
+			packet.pl[r].FromRay( rayStart, rayDir );
+			packet.startX[r] = rayStart[0];
+			packet.startY[r] = rayStart[1];
+			packet.startZ[r] = rayStart[2];
+			packet.endX[r] = packet.endp[r][0];
+			packet.endY[r] = packet.endp[r][1];
+			packet.endZ[r] = packet.endp[r][2];
+
+			// trace bounds
+			for ( int i = 0; i < 3; i++ ) {
+				if ( rayStart[i] < rayEnd[i] ) {
+					packet.bounds[r][0][i] = rayStart[i] - CM_BOX_EPSILON;
+					packet.bounds[r][1][i] = rayEnd[i] + CM_BOX_EPSILON;
+				} else {
+					packet.bounds[r][0][i] = rayEnd[i] - CM_BOX_EPSILON;
+					packet.bounds[r][1][i] = rayStart[i] + CM_BOX_EPSILON;
+				}
+			}
+
+			packet.trace[r].fraction = 1.0f;
+			packet.trace[r].c.type = CONTACT_NONE;
+
+			cm_raySegment_t & segment = segments[r];
+			segment.ray = r;
+			segment.p1f = 0.0f;
+			segment.p2f = 1.0f;
+			segment.p1 = rayStart;
+			segment.p2 = rayEnd;
+		}
+		if ( packet.numRays == 0 ) {
+			continue;
+		}
+
+		// pad the SIMD lanes
+		for ( int r = packet.numRays; r < ALIGN( packet.numRays, 4 ); r++ ) {
+			packet.startX[r] = packet.startY[r] = packet.startZ[r] = 0.0f;
+			packet.endX[r] = packet.endY[r] = packet.endZ[r] = 0.0f;
+		}
+
+		TraceRayPacketThroughAxialBSPTree_r( &packet, packet.model->node, segments, packet.numRays );
+
+		// store results
+		for ( int r = 0; r < packet.numRays; r++ ) {
+			const int t = packetTraces[r];
+			trace_t & result = results[t];
+			result = packet.trace[r];
+			result.endpos = starts[t] + result.fraction * ( ends[t] - starts[t] );
+			result.endAxis = mat3_identity;
+
+			if ( result.fraction < 1.0f ) {
+				// rotate trace plane normal if there was a collision with a rotated model
+				if ( model_rotated ) {
+					result.c.normal *= modelAxis;
+					result.c.point *= modelAxis;
+				}
+				result.c.point += modelOrigin;
+				result.c.dist += modelOrigin * result.c.normal;
+			}
+		}
+	}
+}
+
+/*
+================
+CM_TraceBatchJob
+================
+*/
+void CM_TraceBatchJob( const cmTraceBatchParms_t * parms ) {
+	collisionModelManagerLocal.TraceRayBatch( parms->results, parms->starts, parms->ends, parms->numTraces,
+								parms->contentMask, parms->model, parms->modelOrigin, parms->modelAxis );
+}
+
+/*
+================
+CM_TraceBatchPositionTests
+================
+*/
+void CM_TraceBatchPositionTests( const cmTraceBatchParms_t * parms ) {
+	collisionModelManagerLocal.PositionTestBatch( parms->results, parms->starts, parms->ends, parms->numTraces,
+								NULL, mat3_identity, parms->contentMask, parms->model, parms->modelOrigin, parms->modelAxis );
+}
+
+REGISTER_PARALLEL_JOB( CM_TraceBatchJob, "CM_TraceBatchJob" );
@@ -216,6 +216,28 @@ void AddRenderGui( const char *name, idUserInterface **gui, const idDict *args )
 	UpdateGuiParms( *gui, args );
 }
 
+// interned keys of the render entity parms every spawned entity reads
+static const idDictKey spawnKey_model( "model" );
+static const idDictKey spawnKey_skin( "skin" );
+static const idDictKey spawnKey_shader( "shader" );
+static const idDictKey spawnKey_origin( "origin" );
+static const idDictKey spawnKey_rotation( "rotation" );
+static const idDictKey spawnKey_angle( "angle" );
+static const idDictKey spawnKey_color( "_color" );
+static const idDictKey spawnKey_shaderParm3( "shaderParm3" );
+static const idDictKey spawnKey_shaderParm4( "shaderParm4" );
+static const idDictKey spawnKey_shaderParm5( "shaderParm5" );
+static const idDictKey spawnKey_shaderParm6( "shaderParm6" );
+static const idDictKey spawnKey_shaderParm7( "shaderParm7" );
+static const idDictKey spawnKey_shaderParm8( "shaderParm8" );
+static const idDictKey spawnKey_shaderParm9( "shaderParm9" );
+static const idDictKey spawnKey_shaderParm10( "shaderParm10" );
+static const idDictKey spawnKey_shaderParm11( "shaderParm11" );
+static const idDictKey spawnKey_noDynamicInteractions( "noDynamicInteractions" );
+static const idDictKey spawnKey_noshadows( "noshadows" );
+static const idDictKey spawnKey_noselfshadows( "noselfshadows" );
+static const idDictKey spawnKey_gui[MAX_RENDERENTITY_GUI] = { idDictKey( "gui" ), idDictKey( "gui2" ), idDictKey( "gui3" ) };
+
 /*
 ================
 idGameEdit::ParseSpawnArgsToRenderEntity
@@ -234,7 +256,7 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict *args, renderEntity_
 
 	memset( renderEntity, 0, sizeof( *renderEntity ) );
 
-	temp = args->GetString( "model" );
+	temp = args->GetString( spawnKey_model );
 
 	modelDef = NULL;
 	if ( temp[0] != '\0' ) {
@@ -252,23 +274,23 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict *args, renderEntity_
 		renderEntity->bounds.Zero();
 	}
 
-	temp = args->GetString( "skin" );
+	temp = args->GetString( spawnKey_skin );
 	if ( temp[0] != '\0' ) {
 		renderEntity->customSkin = declManager->FindSkin( temp );
 	} else if ( modelDef ) {
 		renderEntity->customSkin = modelDef->GetDefaultSkin();
 	}
 
-	temp = args->GetString( "shader" );
+	temp = args->GetString( spawnKey_shader );
 	if ( temp[0] != '\0' ) {
 		renderEntity->customShader = declManager->FindMaterial( temp );
 	}
 
-	args->GetVector( "origin", "0 0 0", renderEntity->origin );
+	args->GetVector( spawnKey_origin, "0 0 0", renderEntity->origin );
 
 	// get the rotation matrix in either full form, or single angle form
-	if ( !args->GetMatrix( "rotation", "1 0 0 0 1 0 0 0 1", renderEntity->axis ) ) {
-		angle = args->GetFloat( "angle" );
+	if ( !args->GetMatrix( spawnKey_rotation, "1 0 0 0 1 0 0 0 1", renderEntity->axis ) ) {
+		angle = args->GetFloat( spawnKey_angle );
 		if ( angle != 0.0f ) {
 			renderEntity->axis = idAngles( 0.0f, angle, 0.0f ).ToMat3();
 		} else {
@@ -279,32 +301,32 @@ void idGameEdit::ParseSpawnArgsToRenderEntity( const idDict *args, renderEntity_
 	renderEntity->referenceSound = NULL;
 
 	// get shader parms
-	args->GetVector( "_color", "1 1 1", color );
+	args->GetVector( spawnKey_color, "1 1 1", color );
 	renderEntity->shaderParms[ SHADERPARM_RED ]		= color[0];
 	renderEntity->shaderParms[ SHADERPARM_GREEN ]	= color[1];
 	renderEntity->shaderParms[ SHADERPARM_BLUE ]	= color[2];
-	renderEntity->shaderParms[ 3 ]					= args->GetFloat( "shaderParm3", "1" );
-	renderEntity->shaderParms[ 4 ]					= args->GetFloat( "shaderParm4", "0" );
-	renderEntity->shaderParms[ 5 ]					= args->GetFloat( "shaderParm5", "0" );
-	renderEntity->shaderParms[ 6 ]					= args->GetFloat( "shaderParm6", "0" );
-	renderEntity->shaderParms[ 7 ]					= args->GetFloat( "shaderParm7", "0" );
-	renderEntity->shaderParms[ 8 ]					= args->GetFloat( "shaderParm8", "0" );
-	renderEntity->shaderParms[ 9 ]					= args->GetFloat( "shaderParm9", "0" );
-	renderEntity->shaderParms[ 10 ]					= args->GetFloat( "shaderParm10", "0" );
-	renderEntity->shaderParms[ 11 ]					= args->GetFloat( "shaderParm11", "0" );
+	renderEntity->shaderParms[ 3 ]					= args->GetFloat( spawnKey_shaderParm3, "1" );
+	renderEntity->shaderParms[ 4 ]					= args->GetFloat( spawnKey_shaderParm4, "0" );
+	renderEntity->shaderParms[ 5 ]					= args->GetFloat( spawnKey_shaderParm5, "0" );
+	renderEntity->shaderParms[ 6 ]					= args->GetFloat( spawnKey_shaderParm6, "0" );
+	renderEntity->shaderParms[ 7 ]					= args->GetFloat( spawnKey_shaderParm7, "0" );
+	renderEntity->shaderParms[ 8 ]					= args->GetFloat( spawnKey_shaderParm8, "0" );
+	renderEntity->shaderParms[ 9 ]					= args->GetFloat( spawnKey_shaderParm9, "0" );
+	renderEntity->shaderParms[ 10 ]					= args->GetFloat( spawnKey_shaderParm10, "0" );
+	renderEntity->shaderParms[ 11 ]					= args->GetFloat( spawnKey_shaderParm11, "0" );
 
 	// check noDynamicInteractions flag
-	renderEntity->noDynamicInteractions = args->GetBool( "noDynamicInteractions" );
+	renderEntity->noDynamicInteractions = args->GetBool( spawnKey_noDynamicInteractions );
 
 	// check noshadows flag
-	renderEntity->noShadow = args->GetBool( "noshadows" );
+	renderEntity->noShadow = args->GetBool( spawnKey_noshadows );
 
 	// check noselfshadows flag
-	renderEntity->noSelfShadow = args->GetBool( "noselfshadows" );
+	renderEntity->noSelfShadow = args->GetBool( spawnKey_noselfshadows );
 
 	// init any guis, including entity-specific states
 	for( i = 0; i < MAX_RENDERENTITY_GUI; i++ ) {
-		temp = args->GetString( i == 0 ? "gui" : va( "gui%d", i + 1 ) );
+		temp = args->GetString( spawnKey_gui[ i ] );
 		if ( temp[ 0 ] != '\0' ) {
 			AddRenderGui( temp, &renderEntity->gui[ i ], args );
 		}
@@ -467,6 +489,22 @@ void idEntity::FixupLocalizedStrings() {
 	}
 }
 
+// interned keys of the spawn args every entity reads
+static const idDictKey spawnKey_classname( "classname" );
+static const idDictKey spawnKey_noGrab( "noGrab" );
+static const idDictKey spawnKey_skin_xray( "skin_xray" );
+static const idDictKey spawnKey_cameraTarget( "cameraTarget" );
+static const idDictKey spawnKey_solidForTeam( "solidForTeam" );
+static const idDictKey spawnKey_neverDormant( "neverDormant" );
+static const idDictKey spawnKey_hide( "hide" );
+static const idDictKey spawnKey_cinematic( "cinematic" );
+static const idDictKey spawnKey_networkSync( "networkSync" );
+static const idDictKey spawnKey_name( "name" );
+static const idDictKey spawnKey_health( "health" );
+static const idDictKey spawnKey_bind( "bind" );
+static const idDictKey spawnKey_scriptobject( "scriptobject" );
+static const idDictKey spawnKey_slowmo( "slowmo" );
+
 /*
 ================
 idEntity::Spawn
@@ -483,7 +521,7 @@ void idEntity::Spawn() {
 
 	gameLocal.RegisterEntity( this, -1, gameLocal.GetSpawnArgs() );
 
-	spawnArgs.GetString( "classname", NULL, &classname );
+	spawnArgs.GetString( spawnKey_classname, NULL, &classname );
 	const idDeclEntityDef *def = gameLocal.FindEntityDef( classname, false );
 	if ( def ) {
 		entityDefNumber = def->Index();
@@ -496,13 +534,13 @@ void idEntity::Spawn() {
 
 	renderEntity.entityNum = entityNumber;
 	
-	noGrab = spawnArgs.GetBool( "noGrab", "0" );
+	noGrab = spawnArgs.GetBool( spawnKey_noGrab, "0" );
 
 	xraySkin = NULL;
 	renderEntity.xrayIndex = 1;
 
 	idStr str;
-	if ( spawnArgs.GetString( "skin_xray", "", str ) ) {
+	if ( spawnArgs.GetString( spawnKey_skin_xray, "", str ) ) {
 		xraySkin = declManager->FindSkin( str.c_str() );
 	}
 
@@ -520,7 +558,7 @@ void idEntity::Spawn() {
 	refSound.listenerId = entityNumber + 1;
 
 	cameraTarget = NULL;
-	temp = spawnArgs.GetString( "cameraTarget" );
+	temp = spawnArgs.GetString( spawnKey_cameraTarget );
 	if ( temp != NULL && temp[0] != NULL ) {
 		// update the camera taget
 		PostEventMS( &EV_UpdateCameraTarget, 0 );
@@ -530,16 +568,16 @@ void idEntity::Spawn() {
 		UpdateGuiParms( renderEntity.gui[ i ], &spawnArgs );
 	}
 
-	fl.solidForTeam = spawnArgs.GetBool( "solidForTeam", "0" );
-	fl.neverDormant = spawnArgs.GetBool( "neverDormant", "0" );
-	fl.hidden = spawnArgs.GetBool( "hide", "0" );
+	fl.solidForTeam = spawnArgs.GetBool( spawnKey_solidForTeam, "0" );
+	fl.neverDormant = spawnArgs.GetBool( spawnKey_neverDormant, "0" );
+	fl.hidden = spawnArgs.GetBool( spawnKey_hide, "0" );
 	if ( fl.hidden ) {
 		// make sure we're hidden, since a spawn function might not set it up right
 		PostEventMS( &EV_Hide, 0 );
 	}
-	cinematic = spawnArgs.GetBool( "cinematic", "0" );
+	cinematic = spawnArgs.GetBool( spawnKey_cinematic, "0" );
 
-	networkSync = spawnArgs.FindKey( "networkSync" );
+	networkSync = spawnArgs.FindKey( spawnKey_networkSync );
 	if ( networkSync ) {
 		fl.networkSync = ( atoi( networkSync->GetValue() ) != 0 );
 	}
@@ -554,7 +592,7 @@ void idEntity::Spawn() {
 #endif
 
 	// every object will have a unique name
-	temp = spawnArgs.GetString( "name", va( "%s_%s_%d", GetClassname(), spawnArgs.GetString( "classname" ), entityNumber ) );
+	temp = spawnArgs.GetString( spawnKey_name, va( "%s_%s_%d", GetClassname(), spawnArgs.GetString( spawnKey_classname ), entityNumber ) );
 	SetName( temp );
 
 	// if we have targets, wait until all entities are spawned to get them
@@ -567,19 +605,19 @@ void idEntity::Spawn() {
 		}
 	}
 
-	health = spawnArgs.GetInt( "health" );
+	health = spawnArgs.GetInt( spawnKey_health );
 
 	InitDefaultPhysics( origin, axis );
 
 	SetOrigin( origin );
 	SetAxis( axis );
 
-	temp = spawnArgs.GetString( "model" );
+	temp = spawnArgs.GetString( spawnKey_model );
 	if ( temp != NULL && *temp != NULL ) {
 		SetModel( temp );
 	}
 
-	if ( spawnArgs.GetString( "bind", "", &temp ) ) {
+	if ( spawnArgs.GetString( spawnKey_bind, "", &temp ) ) {
 		PostEventMS( &EV_SpawnBind, 0 );
 	}
 
@@ -589,7 +627,7 @@ void idEntity::Spawn() {
 	}
 
 	// setup script object
-	if ( ShouldConstructScriptObjectAtSpawn() && spawnArgs.GetString( "scriptobject", NULL, &scriptObjectName ) ) {
+	if ( ShouldConstructScriptObjectAtSpawn() && spawnArgs.GetString( spawnKey_scriptobject, NULL, &scriptObjectName ) ) {
 		if ( !scriptObject.SetType( scriptObjectName ) ) {
 			gameLocal.Error( "Script object '%s' not found on entity '%s'.", scriptObjectName, name.c_str() );
 		}
@@ -598,7 +636,7 @@ void idEntity::Spawn() {
 	}
 
 	// determine time group
-	DetermineTimeGroup( spawnArgs.GetBool( "slowmo", "1" ) );
+	DetermineTimeGroup( spawnArgs.GetBool( spawnKey_slowmo, "1" ) );
 }
 
 /*
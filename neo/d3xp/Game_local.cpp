@@ -223,6 +223,7 @@ void idGameLocal::Clear() {
 	sessionCommand.Clear();
 	locationEntities = NULL;
 	smokeParticles = NULL;
+	physicsIslandJobs = NULL;
 	editEntities = NULL;
 	entityHash.Clear( 1024, MAX_GENTITIES );
 	inCinematic = false;
@@ -340,6 +341,8 @@ void idGameLocal::Init() {
 	
 	smokeParticles = new (TAG_PARTICLE) idSmokeParticles;
 
+	physicsIslandJobs = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_PHYSICS_ISLAND_JOBS, 0, NULL );
+
 	// set up the aas
 	dict = FindEntityDefDict( "aas_types" );
 	if ( dict == NULL ) {
@@ -398,6 +401,11 @@ void idGameLocal::Shutdown() {
 	delete smokeParticles;
 	smokeParticles = NULL;
 
+	if ( physicsIslandJobs != NULL ) {
+		parallelJobManager->FreeJobList( physicsIslandJobs );
+		physicsIslandJobs = NULL;
+	}
+
 	idClass::Shutdown();
 
 	// clear list with forces
@@ -2191,6 +2199,286 @@ void idGameLocal::SortActiveEntityList() {
 	sortPushers = false;
 }
 
+/*
+===============================================================================
+
+	Physics islands
+
+	Articulated figures that don't touch any other active entity are stepped
+	before the entities think. Contacts and collisions are evaluated serially
+	because the clip traces aren't thread safe, the constraint solve of each
+	figure only touches the figure itself and runs on the job system. The
+	entity picks up the result when it runs its physics during think.
+
+	This changes the order within a frame. Serially a figure is stepped
+	inside its own think, so impulses, damage and traces from entities that
+	think earlier in the frame act on the state before the step. With islands
+	they act on the state after the step, and the SaveState/RestoreState in
+	idEntity::RunPhysics sees the stepped state. Off by default until that
+	difference has been validated in gameplay.
+
+===============================================================================
+*/
+
+idCVar g_physicsIslands( "g_physicsIslands", "0", CVAR_GAME | CVAR_BOOL, "step isolated articulated figures before the entities think and solve them on the job system" );
+
+const float PHYSICS_ISLAND_MARGIN = 8.0f;		// added to the bounds a figure may touch during a step
+
+typedef struct {
+	physicsIsland_t *			islands;
+	int							numIslands;
+	idSysInterlockedInteger *	nextIsland;
+} physicsIslandJob_t;
+
+/*
+================
+PhysicsIslandSolveJob
+================
+*/
+static void PhysicsIslandSolveJob( physicsIslandJob_t *job ) {
+	int index;
+
+	while( 1 ) {
+		index = job->nextIsland->Increment() - 1;
+		if ( index >= job->numIslands ) {
+			break;
+		}
+		job->islands[index].physics->SolveStep();
+	}
+}
+REGISTER_PARALLEL_JOB( PhysicsIslandSolveJob, "PhysicsIslandSolveJob" );
+
+/*
+================
+SetPhysicsIslandClip
+
+  Same as idEntity::RunPhysics, the team is disabled for collision detection while it moves.
+================
+*/
+static void SetPhysicsIslandClip( idEntity *master, bool enable ) {
+	idEntity *part;
+
+	for ( part = master; part != NULL; part = part->GetNextTeamEntity() ) {
+		if ( part->fl.solidForTeam ) {
+			continue;
+		}
+		if ( enable ) {
+			part->GetPhysics()->EnableClip();
+		} else {
+			part->GetPhysics()->DisableClip();
+		}
+	}
+}
+
+/*
+================
+idGameLocal::GetPhysicsIslands
+
+  Only figures whose think runs the physics before anything that could change them
+  can be stepped early. For dead monsters idAI::RunsPhysicsFirst checks that the
+  dormancy test, the script update and cinematics can't get in the way of DeadMove.
+  Returns the number of islands, at most one per active entity.
+================
+*/
+int idGameLocal::GetPhysicsIslands( physicsIsland_t *islands, int maxIslands ) {
+	int i, j, num, numIslands;
+	float speed, maxSpeed;
+	idEntity *ent, *master;
+	idPhysics_AF *physics;
+	idEntity *entityList[ MAX_GENTITIES ];
+
+	const float timeStep = MS2SEC( time - previousTime );
+
+	numIslands = 0;
+
+	for( ent = activeEntities.Next(); ent != NULL && numIslands < maxIslands; ent = ent->activeNode.Next() ) {
+		if ( ent->timeGroup != TIME_GROUP1 || !( ent->thinkFlags & TH_PHYSICS ) ) {
+			continue;
+		}
+		// team slaves are moved by their master
+		master = ent->GetTeamMaster();
+		if ( master != NULL && master != ent ) {
+			continue;
+		}
+		if ( ent->IsType( idAI::Type ) ) {
+			// dead monsters run their physics from DeadMove
+			if ( !static_cast<idAI *>( ent )->RunsPhysicsFirst() ) {
+				continue;
+			}
+		} else if ( !ent->IsType( idAFEntity_Gibbable::Type ) ) {
+			continue;
+		}
+		if ( !ent->GetPhysics()->IsType( idPhysics_AF::Type ) ) {
+			continue;
+		}
+		physics = static_cast<idPhysics_AF *>( ent->GetPhysics() );
+		if ( physics->IsAtRest() || physics->GetNumClipModels() == 0 || !physics->CanSolveOnJobThread() ) {
+			continue;
+		}
+
+		// expand the bounds with the distance the bodies may move during the step
+		maxSpeed = 0.0f;
+		for ( i = 0; i < physics->GetNumClipModels(); i++ ) {
+			speed = physics->GetLinearVelocity( i ).Length() + physics->GetAngularVelocity( i ).Length() * physics->GetBounds( i ).GetRadius();
+			if ( speed > maxSpeed ) {
+				maxSpeed = speed;
+			}
+		}
+
+		physicsIsland_t &island = islands[numIslands++];
+		island.ent = ent;
+		island.physics = physics;
+		island.bounds = physics->GetAbsBounds().Expand( maxSpeed * timeStep + PHYSICS_ISLAND_MARGIN );
+		island.serial = false;
+	}
+
+	for ( i = 0; i < numIslands; i++ ) {
+		physicsIsland_t &island = islands[i];
+
+		// figures that may touch each other are stepped in think order
+		for ( j = i + 1; j < numIslands; j++ ) {
+			if ( island.bounds.IntersectsBounds( islands[j].bounds ) ) {
+				island.serial = true;
+				islands[j].serial = true;
+			}
+		}
+		if ( island.serial ) {
+			continue;
+		}
+
+		// so are figures that may touch another active entity
+		num = clip.EntitiesTouchingBounds( island.bounds, -1, entityList, MAX_GENTITIES );
+		for ( j = 0; j < num; j++ ) {
+			if ( entityList[j] == island.ent || entityList[j]->GetTeamMaster() == island.ent ) {
+				continue;
+			}
+			if ( entityList[j]->IsActive() ) {
+				island.serial = true;
+				break;
+			}
+		}
+	}
+
+	return numIslands;
+}
+
+/*
+================
+idGameLocal::BeginPhysicsIslands
+
+  Removes the serial islands and evaluates the contacts of the others.
+  Returns the number of islands left to solve.
+================
+*/
+int idGameLocal::BeginPhysicsIslands( physicsIsland_t *islands, int numIslands ) {
+	int i, n;
+	bool moving;
+
+	for ( n = 0, i = 0; i < numIslands; i++ ) {
+		if ( islands[i].serial ) {
+			continue;
+		}
+		islands[n] = islands[i];
+
+		SetPhysicsIslandClip( islands[n].ent, false );
+		moving = islands[n].physics->BeginStep( time - previousTime, time );
+		SetPhysicsIslandClip( islands[n].ent, true );
+
+		if ( !moving ) {
+			islands[n].physics->SetIslandStepped( time, false );
+			continue;
+		}
+		n++;
+	}
+
+	return n;
+}
+
+/*
+================
+idGameLocal::SolvePhysicsIslands
+
+  A parallelism of zero solves the islands on this thread.
+================
+*/
+void idGameLocal::SolvePhysicsIslands( physicsIsland_t *islands, int numIslands, int parallelism ) {
+	int i, numJobs;
+	idSysInterlockedInteger nextIsland;
+	physicsIslandJob_t jobs[MAX_PHYSICS_ISLAND_JOBS];
+
+	if ( parallelism == 0 || numIslands < 2 || physicsIslandJobs == NULL ) {
+		for ( i = 0; i < numIslands; i++ ) {
+			islands[i].physics->SolveStep();
+		}
+		return;
+	}
+
+	numJobs = ( parallelism > 0 ) ? parallelism : parallelJobManager->GetNumProcessingUnits();
+	numJobs = Min( numJobs, Min( numIslands, MAX_PHYSICS_ISLAND_JOBS ) );
+
+	for ( i = 0; i < numJobs; i++ ) {
+		jobs[i].islands = islands;
+		jobs[i].numIslands = numIslands;
+		jobs[i].nextIsland = &nextIsland;
+		physicsIslandJobs->AddJob( (jobRun_t)PhysicsIslandSolveJob, &jobs[i] );
+	}
+	physicsIslandJobs->Submit( NULL, parallelism );
+	physicsIslandJobs->Wait();
+}
+
+/*
+================
+idGameLocal::FinishPhysicsIslands
+================
+*/
+void idGameLocal::FinishPhysicsIslands( physicsIsland_t *islands, int numIslands ) {
+	int i;
+
+	for ( i = 0; i < numIslands; i++ ) {
+		SetPhysicsIslandClip( islands[i].ent, false );
+		islands[i].physics->FinishStep();
+		SetPhysicsIslandClip( islands[i].ent, true );
+		islands[i].physics->SetIslandStepped( time, true );
+	}
+}
+
+/*
+================
+idGameLocal::RunPhysicsIslands
+================
+*/
+void idGameLocal::RunPhysicsIslands() {
+	int i, num, numIslands;
+
+	if ( !g_physicsIslands.GetBool() ) {
+		return;
+	}
+
+	// the island list is rebuilt every tick, keep it off the heap
+	idFrameArena & arena = *idFrameArena::ThreadArena();
+	idScopedFrameArenaMark arenaMark( arena );
+	const int maxIslands = activeEntities.Num();
+	physicsIsland_t *islands = arena.AllocArray< physicsIsland_t >( maxIslands );
+
+	numIslands = GetPhysicsIslands( islands, maxIslands );
+
+	// not worth changing the order the figures are stepped in for a single island
+	for ( num = 0, i = 0; i < numIslands; i++ ) {
+		if ( !islands[i].serial ) {
+			num++;
+		}
+	}
+	if ( num < 2 ) {
+		return;
+	}
+
+	numIslands = BeginPhysicsIslands( islands, numIslands );
+	if ( numIslands > 0 ) {
+		SolvePhysicsIslands( islands, numIslands, JOBLIST_PARALLELISM_MAX_CORES );
+		FinishPhysicsIslands( islands, numIslands );
+	}
+}
+
 
 
 /*
@@ -2353,6 +2641,11 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		timer_think.Clear();
 		timer_think.Start();
 
+		// step the isolated articulated figures
+		if ( !inCinematic ) {
+			RunPhysicsIslands();
+		}
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -66,6 +66,7 @@ class idThread;
 class idEditEntities;
 class idLocationEntity;
 class idMenuHandler_Shell;
+class idPhysics_AF;
 
 const int MAX_CLIENTS			= MAX_PLAYERS;
 const int MAX_CLIENTS_IN_PVS	= MAX_CLIENTS >> 3;
@@ -158,6 +159,17 @@ typedef struct {
 	int			team;			
 } spawnSpot_t;
 
+const int MAX_PHYSICS_ISLAND_JOBS = 32;
+
+// an articulated figure that does not touch any other active entity during the next step
+// so the constraint solve can run on the job system before the entities think
+typedef struct {
+	idEntity *		ent;
+	idPhysics_AF *	physics;
+	idBounds		bounds;			// bounds the figure may touch during the step
+	bool			serial;			// touches another active entity and is stepped by its think
+} physicsIsland_t;
+
 //============================================================================
 
 class idEventQueue {
@@ -453,6 +465,12 @@ public:
 
 	const idVec3 &			GetGravity() const;
 
+							// articulated figures that can be stepped before the entities think
+	int						GetPhysicsIslands( physicsIsland_t *islands, int maxIslands );
+	int						BeginPhysicsIslands( physicsIsland_t *islands, int numIslands );
+	void					SolvePhysicsIslands( physicsIsland_t *islands, int numIslands, int parallelism );
+	void					FinishPhysicsIslands( physicsIsland_t *islands, int numIslands );
+
 	// added the following to assist licensees with merge issues
 	int						GetFrameNum() const { return framenum; };
 	int						GetTime() const { return time; };
@@ -558,6 +576,7 @@ private:
 	pvsHandle_t				playerConnectedAreas;	// all areas connected to any player area
 
 	idVec3					gravity;				// global gravity vector
+	idParallelJobList *		physicsIslandJobs;		// solves the physics islands
 	gameState_t				gamestate;				// keeps track of whether we're spawning, shutting down, or normal gameplay
 	bool					influenceActive;		// true when a phantasm is happening
 	int						nextGibTime;
@@ -610,6 +629,7 @@ private:
 	void					FreePlayerPVS();
 	void					UpdateGravity();
 	void					SortActiveEntityList();
+	void					RunPhysicsIslands();
 	void					ShowTargets();
 	void					RunDebugInfo();
 
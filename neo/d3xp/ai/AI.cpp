@@ -1217,6 +1217,44 @@ void idAI::Think() {
 	}
 }
 
+/*
+=====================
+idAI::RunsPhysicsFirst
+
+  Returns true if the next Think of this dead monster does nothing before DeadMove runs
+  the physics: it doesn't go dormant, it isn't playing a cinematic and its script is waiting.
+  The physics island stage only steps these figures before the entities think.
+=====================
+*/
+bool idAI::RunsPhysicsFirst() {
+	if ( health > 0 || move.moveType != MOVETYPE_DEAD || num_cinematics != 0 ) {
+		return false;
+	}
+	if ( !ai_think.GetBool() || !( thinkFlags & TH_THINK ) || IsHidden() ) {
+		return false;
+	}
+
+	// CheckDormant must keep the monster awake without changing anything
+	if ( fl.isDormant ) {
+		return false;
+	}
+	if ( !fl.neverDormant ) {
+		if ( !gameLocal.InPlayerConnectedArea( this ) ) {
+			return false;
+		}
+		if ( !fl.hasAwakened && !gameLocal.InPlayerPVS( this ) ) {
+			return false;
+		}
+	}
+
+	// UpdateAIScript must not change state or run the script
+	if ( idealState != state || scriptThread == NULL || !scriptThread->IsWaiting() ) {
+		return false;
+	}
+
+	return true;
+}
+
 /***********************************************************************
 
 	AI script state management
@@ -445,6 +445,7 @@ protected:
 	void					Think();
 	void					Activate( idEntity *activator );
 public:
+	bool					RunsPhysicsFirst();
 	int						ReactionTo( const idEntity *ent );
 protected:
 	bool					CheckForEnemy();
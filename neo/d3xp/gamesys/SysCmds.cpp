@@ -1513,6 +1513,215 @@ static void Cmd_TestDeath_f( const idCmdArgs &args ) {
 
 }
 
+/*
+==================
+Cmd_TestPhysicsIslands_f
+
+  testPhysicsIslands spawn <classname> <count> spawns a grid of entities in front
+  of the player and kills the actors so they turn into ragdolls.
+  testPhysicsIslands solves the isolated articulated figures with an increasing
+  number of threads, compares the results with the serial solve and steps them once.
+==================
+*/
+static void Cmd_TestPhysicsIslands_f( const idCmdArgs &args ) {
+	int i, j, num, numIslands, numSerial, numThreads, numMismatches;
+	uint64 start, serialTime, time;
+	idPlayer *player;
+	idEntity *ent;
+	idDict dict;
+	idList<physicsIsland_t> islands;
+	idList<AFBodyPState_t> serialStates, states;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		if ( idStr::Icmp( args.Argv( 1 ), "spawn" ) != 0 || args.Argc() != 4 ) {
+			gameLocal.Printf( "usage: testPhysicsIslands [spawn <classname> <count>]\n" );
+			return;
+		}
+
+		num = Max( atoi( args.Argv( 3 ) ), 1 );
+		const int side = idMath::Ftoi( idMath::Ceil( idMath::Sqrt( (float) num ) ) );
+		const float yaw = player->viewAngles.yaw;
+		const idMat3 axis = idAngles( 0, yaw, 0 ).ToMat3();
+		const idVec3 corner = player->GetPhysics()->GetOrigin() + axis[0] * 128.0f - axis[1] * ( side - 1 ) * 48.0f + idVec3( 0, 0, 1 );
+
+		for ( i = 0; i < num; i++ ) {
+			dict.Clear();
+			dict.Set( "classname", args.Argv( 2 ) );
+			dict.Set( "angle", va( "%f", yaw + 180 ) );
+			dict.Set( "origin", ( corner + axis[0] * ( i / side ) * 96.0f + axis[1] * ( i % side ) * 96.0f ).ToString() );
+			if ( !gameLocal.SpawnEntityDef( dict, &ent ) || ent == NULL ) {
+				break;
+			}
+			if ( ent->IsType( idActor::Type ) ) {
+				ent->Damage( player, player, vec3_origin, "damage_suicide", 1.0f, INVALID_JOINT );
+			}
+		}
+		gameLocal.Printf( "spawned %d '%s'\n", i, args.Argv( 2 ) );
+		return;
+	}
+
+	islands.SetNum( MAX_GENTITIES );
+	num = gameLocal.GetPhysicsIslands( islands.Ptr(), islands.Num() );
+	for ( numSerial = 0, i = 0; i < num; i++ ) {
+		if ( islands[i].serial ) {
+			numSerial++;
+		}
+	}
+
+	numIslands = gameLocal.BeginPhysicsIslands( islands.Ptr(), num );
+	if ( numIslands == 0 ) {
+		gameLocal.Printf( "%d moving articulated figures, none isolated\n", num );
+		return;
+	}
+
+	start = Sys_Microseconds();
+	gameLocal.SolvePhysicsIslands( islands.Ptr(), numIslands, 0 );
+	serialTime = Sys_Microseconds() - start;
+
+	for ( i = 0; i < numIslands; i++ ) {
+		islands[i].physics->GetNextStates( serialStates );
+	}
+
+	gameLocal.Printf( "%d moving articulated figures, %d touch other entities, %d solved with %d bodies\n", num, numSerial, numIslands, serialStates.Num() );
+	gameLocal.Printf( "serial    : %6d usec\n", (int) serialTime );
+
+	numThreads = Min( parallelJobManager->GetNumProcessingUnits(), MAX_PHYSICS_ISLAND_JOBS );
+	for ( i = 1; i <= numThreads; i++ ) {
+		for ( j = 0; j < numIslands; j++ ) {
+			islands[j].physics->RestartSolveStep();
+		}
+
+		start = Sys_Microseconds();
+		gameLocal.SolvePhysicsIslands( islands.Ptr(), numIslands, i );
+		time = Sys_Microseconds() - start;
+
+		states.SetNum( 0 );
+		for ( j = 0; j < numIslands; j++ ) {
+			islands[j].physics->GetNextStates( states );
+		}
+		numMismatches = 0;
+		for ( j = 0; j < states.Num(); j++ ) {
+			if ( memcmp( &states[j], &serialStates[j], sizeof( states[j] ) ) != 0 ) {
+				numMismatches++;
+			}
+		}
+
+		gameLocal.Printf( "%2d threads: %6d usec, %5.2fx, %d bodies differ\n", i, (int) time, (float) serialTime / Max( time, (uint64) 1 ), numMismatches );
+	}
+
+	gameLocal.FinishPhysicsIslands( islands.Ptr(), numIslands );
+}
+
+/*
+==================
+Cmd_TestAFSolver_f
+
+  testAFSolver [iterations] solves the isolated articulated figures with the
+  reference and the block tree solver, compares the results and steps them once.
+  Use testPhysicsIslands spawn <classname> <count> to set up a ragdoll heavy scene.
+==================
+*/
+static void Cmd_TestAFSolver_f( const idCmdArgs &args ) {
+	int i, j, k, numIterations, numIslands, numMismatches, numRepeatMismatches;
+	uint64 start, time, referenceTime, blockTime;
+	float d, maxOriginDelta, maxVelocityDelta;
+	idList<physicsIsland_t> islands;
+	idList<AFBodyPState_t> referenceStates, firstStates, states;
+
+	if ( !gameLocal.GetLocalPlayer() || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numIterations = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 10;
+
+	islands.SetNum( MAX_GENTITIES );
+	numIslands = gameLocal.GetPhysicsIslands( islands.Ptr(), islands.Num() );
+	numIslands = gameLocal.BeginPhysicsIslands( islands.Ptr(), numIslands );
+	if ( numIslands == 0 ) {
+		gameLocal.Printf( "no isolated moving articulated figures\n" );
+		return;
+	}
+
+	const bool useBlockSolver = af_useBlockSolver.GetBool();
+	bool solved = false;
+	referenceTime = blockTime = 0;
+	numRepeatMismatches = 0;
+
+	for ( i = 0; i < 2; i++ ) {
+		af_useBlockSolver.SetBool( i != 0 );
+
+		time = 0;
+		for ( j = 0; j < numIterations; j++ ) {
+			// every solve starts from the state BeginPhysicsIslands saved
+			if ( solved ) {
+				for ( k = 0; k < numIslands; k++ ) {
+					islands[k].physics->RestartSolveStep();
+				}
+			}
+
+			start = Sys_Microseconds();
+			gameLocal.SolvePhysicsIslands( islands.Ptr(), numIslands, 0 );
+			time += Sys_Microseconds() - start;
+			solved = true;
+
+			states.SetNum( 0 );
+			for ( k = 0; k < numIslands; k++ ) {
+				islands[k].physics->GetNextStates( states );
+			}
+
+			// solving the same input again must give exactly the same result
+			if ( j == 0 ) {
+				firstStates = states;
+			} else {
+				for ( k = 0; k < states.Num(); k++ ) {
+					if ( memcmp( &states[k], &firstStates[k], sizeof( states[k] ) ) != 0 ) {
+						numRepeatMismatches++;
+						break;
+					}
+				}
+			}
+		}
+
+		if ( i == 0 ) {
+			referenceTime = time;
+			referenceStates = states;
+		} else {
+			blockTime = time;
+		}
+	}
+
+	af_useBlockSolver.SetBool( useBlockSolver );
+
+	numMismatches = 0;
+	maxOriginDelta = maxVelocityDelta = 0.0f;
+	for ( i = 0; i < states.Num(); i++ ) {
+		d = ( states[i].worldOrigin - referenceStates[i].worldOrigin ).Length();
+		maxOriginDelta = Max( maxOriginDelta, d );
+		d = ( states[i].spatialVelocity - referenceStates[i].spatialVelocity ).Length();
+		maxVelocityDelta = Max( maxVelocityDelta, d );
+		if ( !states[i].worldOrigin.Compare( referenceStates[i].worldOrigin, 0.01f ) ||
+				!states[i].worldAxis.Compare( referenceStates[i].worldAxis, 0.001f ) ||
+				!states[i].spatialVelocity.Compare( referenceStates[i].spatialVelocity, 0.1f ) ) {
+			numMismatches++;
+		}
+	}
+
+	gameLocal.Printf( "%d articulated figures with %d bodies, %d iterations\n", numIslands, states.Num(), numIterations );
+	gameLocal.Printf( "reference: %6d usec\n", (int) referenceTime );
+	gameLocal.Printf( "block    : %6d usec, %5.2fx\n", (int) blockTime, (float) referenceTime / Max( blockTime, (uint64) 1 ) );
+	gameLocal.Printf( "max origin delta %f, max velocity delta %f, %d bodies out of tolerance\n", maxOriginDelta, maxVelocityDelta, numMismatches );
+	if ( numRepeatMismatches ) {
+		gameLocal.Printf( "%d repeated solves didn't reproduce the first solve\n", numRepeatMismatches );
+	}
+
+	gameLocal.FinishPhysicsIslands( islands.Ptr(), numIslands );
+}
+
 /*
 ==================
 Cmd_WeaponSplat_f
@@ -2331,6 +2540,8 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "testPointLight",		Cmd_TestPointLight_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"tests a point light" );
 	cmdSystem->AddCommand( "popLight",				Cmd_PopLight_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"removes the last created light" );
 	cmdSystem->AddCommand( "testDeath",				Cmd_TestDeath_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests death" );
+	cmdSystem->AddCommand( "testPhysicsIslands",	Cmd_TestPhysicsIslands_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"solves the isolated articulated figures with an increasing number of threads and compares the results" );
+	cmdSystem->AddCommand( "testAFSolver",			Cmd_TestAFSolver_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"solves the isolated articulated figures with the reference and the block tree solver and compares the results" );
 	cmdSystem->AddCommand( "testSave",				Cmd_TestSave_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"writes out a test savegame" );
 	cmdSystem->AddCommand( "testModel",				idTestModel::TestModel_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a model", idTestModel::ArgCompletion_TestModel );
 	cmdSystem->AddCommand( "testSkin",				idTestModel::TestSkin_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a skin on an existing testModel", idCmdSystem::ArgCompletion_Decl<DECL_SKIN> );
@@ -2347,6 +2558,7 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
+	cmdSystem->AddCommand( "testClipTree",			idClip::TestClipTree_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"moves clip models around a private clip world and times the broadphase queries" );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
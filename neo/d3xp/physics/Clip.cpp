@@ -32,23 +32,19 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../Game_local.h"
 
-#define	MAX_SECTOR_DEPTH				12
-#define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
-
-typedef struct clipSector_s {
-	int						axis;		// -1 = leaf node
-	float					dist;
-	struct clipSector_s *	children[2];
-	struct clipLink_s *		clipLinks;
-} clipSector_t;
-
-typedef struct clipLink_s {
-	idClipModel *			clipModel;
-	struct clipSector_s *	sector;
-	struct clipLink_s *		prevInSector;
-	struct clipLink_s *		nextInSector;
-	struct clipLink_s *		nextLink;
-} clipLink_t;
+#define CLIP_TREE_NULL_NODE				-1
+#define CLIP_TREE_INITIAL_NODES			1024
+#define CLIP_TREE_STACK_SIZE			256
+#define CLIP_TREE_FAT_MARGIN			4.0f		// leaf bounds are expanded by this so small moves don't touch the tree
+#define CLIP_TREE_MAX_PREDICTION		64.0f		// moves longer than this are teleports and don't stretch the fat bounds
+
+typedef struct clipTreeNode_s {
+	idBounds				bounds;			// fat bounds for leaves, union of the children otherwise
+	int						parent;			// next free node while on the free list
+	int						children[2];	// CLIP_TREE_NULL_NODE for leaves
+	int						height;			// 0 for leaves, -1 for free nodes
+	idClipModel *			clipModel;		// clip model for leaves
+} clipTreeNode_t;
 
 typedef struct trmCache_s {
 	idTraceModel			trm;
@@ -60,8 +56,6 @@ typedef struct trmCache_s {
 
 idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
-idBlockAlloc<clipLink_t, 1024>	clipLinkAllocator;
-
 
 /*
 ===============================================================
@@ -357,8 +351,9 @@ void idClipModel::Init() {
 	collisionModelHandle = 0;
 	renderModelHandle = -1;
 	traceModelIndex = -1;
-	clipLinks = NULL;
-	touchCount = -1;
+	linkedClip = NULL;
+	clipProxy = CLIP_TREE_NULL_NODE;
+	linked = false;
 }
 
 /*
@@ -433,8 +428,9 @@ idClipModel::idClipModel( const idClipModel *model ) {
 		LoadModel( *GetCachedTraceModel( model->traceModelIndex ) );
 	}
 	renderModelHandle = model->renderModelHandle;
-	clipLinks = NULL;
-	touchCount = -1;
+	linkedClip = NULL;
+	clipProxy = CLIP_TREE_NULL_NODE;
+	linked = false;
 }
 
 /*
@@ -443,8 +439,8 @@ idClipModel::~idClipModel
 ================
 */
 idClipModel::~idClipModel() {
-	// make sure the clip model is no longer linked
-	Unlink();
+	// make sure the clip model is no longer in the clip tree
+	FreeClipProxy();
 	if ( traceModelIndex != -1 ) {
 		FreeTraceModel( traceModelIndex );
 	}
@@ -473,8 +469,8 @@ void idClipModel::Save( idSaveGame *savefile ) const {
 	}
 	savefile->WriteInt( traceModelIndex );
 	savefile->WriteInt( renderModelHandle );
-	savefile->WriteBool( clipLinks != NULL );
-	savefile->WriteInt( touchCount );
+	savefile->WriteBool( linked );
+	savefile->WriteInt( -1 );			// was the sector touch count
 }
 
 /*
@@ -484,7 +480,8 @@ idClipModel::Restore
 */
 void idClipModel::Restore( idRestoreGame *savefile ) {
 	idStr collisionModelName;
-	bool linked;
+	bool wasLinked;
+	int touchCount;
 
 	savefile->ReadBool( enabled );
 	savefile->ReadObject( reinterpret_cast<idClass *&>( entity ) );
@@ -508,15 +505,14 @@ void idClipModel::Restore( idRestoreGame *savefile ) {
 		traceModelCache[realIndex]->refCount++;
 	}
 	savefile->ReadInt( renderModelHandle );
-	savefile->ReadBool( linked );
+	savefile->ReadBool( wasLinked );
 	savefile->ReadInt( touchCount );
 
 	// the render model will be set when the clip model is linked
 	renderModelHandle = -1;
-	clipLinks = NULL;
-	touchCount = -1;
+	FreeClipProxy();
 
-	if ( linked ) {
+	if ( wasLinked ) {
 		Link( gameLocal.clip, entity, id, origin, axis, renderModelHandle );
 	}
 }
@@ -527,7 +523,7 @@ idClipModel::SetPosition
 ================
 */
 void idClipModel::SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis ) {
-	if ( clipLinks ) {
+	if ( linked ) {
 		Unlink();	// unlink from old position
 	}
 	origin = newOrigin;
@@ -571,55 +567,27 @@ void idClipModel::GetMassProperties( const float density, float &mass, idVec3 &c
 /*
 ===============
 idClipModel::Unlink
+
+  The leaf stays in the clip tree so the model can be linked again
+  without restructuring the tree, queries skip unlinked models.
 ===============
 */
 void idClipModel::Unlink() {
-	clipLink_t *link;
-
-	for ( link = clipLinks; link; link = clipLinks ) {
-		clipLinks = link->nextLink;
-		if ( link->prevInSector ) {
-			link->prevInSector->nextInSector = link->nextInSector;
-		} else {
-			link->sector->clipLinks = link->nextInSector;
-		}
-		if ( link->nextInSector ) {
-			link->nextInSector->prevInSector = link->prevInSector;
-		}
-		clipLinkAllocator.Free( link );
-	}
+	linked = false;
 }
 
 /*
 ===============
-idClipModel::Link_r
+idClipModel::FreeClipProxy
 ===============
 */
-void idClipModel::Link_r( struct clipSector_s *node ) {
-	clipLink_t *link;
-
-	while( node->axis != -1 ) {
-		if ( absBounds[0][node->axis] > node->dist ) {
-			node = node->children[0];
-		} else if ( absBounds[1][node->axis] < node->dist ) {
-			node = node->children[1];
-		} else {
-			Link_r( node->children[0] );
-			node = node->children[1];
-		}
+void idClipModel::FreeClipProxy() {
+	if ( clipProxy != CLIP_TREE_NULL_NODE ) {
+		linkedClip->DestroyClipProxy( clipProxy );
 	}
-
-	link = clipLinkAllocator.Alloc();
-	link->clipModel = this;
-	link->sector = node;
-	link->nextInSector = node->clipLinks;
-	link->prevInSector = NULL;
-	if ( node->clipLinks ) {
-		node->clipLinks->prevInSector = link;
-	}
-	node->clipLinks = link;
-	link->nextLink = clipLinks;
-	clipLinks = link;
+	linkedClip = NULL;
+	clipProxy = CLIP_TREE_NULL_NODE;
+	linked = false;
 }
 
 /*
@@ -628,13 +596,14 @@ idClipModel::Link
 ===============
 */
 void idClipModel::Link( idClip &clp ) {
+	idVec3 oldCenter;
 
 	assert( idClipModel::entity );
 	if ( !idClipModel::entity ) {
 		return;
 	}
 
-	if ( clipLinks ) {
+	if ( linked ) {
 		Unlink();	// unlink from old position
 	}
 
@@ -642,6 +611,8 @@ void idClipModel::Link( idClip &clp ) {
 		return;
 	}
 
+	oldCenter = absBounds.GetCenter();
+
 	// set the abs box
 	if ( axis.IsRotated() ) {
 		// expand for rotation
@@ -657,7 +628,18 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
-	Link_r( clp.clipSectors );
+	if ( linkedClip != &clp ) {
+		FreeClipProxy();
+	}
+
+	if ( clipProxy == CLIP_TREE_NULL_NODE ) {
+		linkedClip = &clp;
+		clipProxy = clp.CreateClipProxy( this );
+	} else {
+		clp.MoveClipProxy( clipProxy, absBounds, absBounds.GetCenter() - oldCenter );
+	}
+
+	linked = true;
 }
 
 /*
@@ -705,62 +687,15 @@ idClip::idClip
 ===============
 */
 idClip::idClip() {
-	numClipSectors = 0;
-	clipSectors = NULL;
+	treeNodes = NULL;
+	maxTreeNodes = 0;
+	treeRoot = CLIP_TREE_NULL_NODE;
+	freeTreeNode = CLIP_TREE_NULL_NODE;
+	numClipProxies = 0;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
-/*
-===============
-idClip::CreateClipSectors_r
-
-Builds a uniformly subdivided tree for the given world size
-===============
-*/
-clipSector_t *idClip::CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector ) {
-	int				i;
-	clipSector_t	*anode;
-	idVec3			size;
-	idBounds		front, back;
-
-	anode = &clipSectors[idClip::numClipSectors];
-	idClip::numClipSectors++;
-
-	if ( depth == MAX_SECTOR_DEPTH ) {
-		anode->axis = -1;
-		anode->children[0] = anode->children[1] = NULL;
-
-		for ( i = 0; i < 3; i++ ) {
-			if ( bounds[1][i] - bounds[0][i] > maxSector[i] ) {
-				maxSector[i] = bounds[1][i] - bounds[0][i];
-			}
-		}
-		return anode;
-	}
-
-	size = bounds[1] - bounds[0];
-	if ( size[0] >= size[1] && size[0] >= size[2] ) {
-		anode->axis = 0;
-	} else if ( size[1] >= size[0] && size[1] >= size[2] ) {
-		anode->axis = 1;
-	} else {
-		anode->axis = 2;
-	}
-
-	anode->dist = 0.5f * ( bounds[1][anode->axis] + bounds[0][anode->axis] );
-
-	front = bounds;
-	back = bounds;
-	
-	front[0][anode->axis] = back[1][anode->axis] = anode->dist;
-	
-	anode->children[0] = CreateClipSectors_r( depth+1, front, maxSector );
-	anode->children[1] = CreateClipSectors_r( depth+1, back, maxSector );
-
-	return anode;
-}
-
 /*
 ===============
 idClip::Init
@@ -768,22 +703,21 @@ idClip::Init
 */
 void idClip::Init() {
 	cmHandle_t h;
-	idVec3 size, maxSector = vec3_origin;
+	idVec3 size;
+
+	// clear the clip tree
+	treeNodes = NULL;
+	maxTreeNodes = 0;
+	treeRoot = CLIP_TREE_NULL_NODE;
+	freeTreeNode = CLIP_TREE_NULL_NODE;
+	numClipProxies = 0;
 
-	// clear clip sectors
-	clipSectors = new (TAG_PHYSICS_CLIP) clipSector_t[MAX_SECTORS];
-	memset( clipSectors, 0, MAX_SECTORS * sizeof( clipSector_t ) );
-	numClipSectors = 0;
-	touchCount = -1;
 	// get world map bounds
 	h = collisionModelManager->LoadModel( "worldMap" );
 	collisionModelManager->GetModelBounds( h, worldBounds );
-	// create world sectors
-	CreateClipSectors_r( 0, worldBounds, maxSector );
 
 	size = worldBounds[1] - worldBounds[0];
 	gameLocal.Printf( "map bounds are (%1.1f, %1.1f, %1.1f)\n", size[0], size[1], size[2] );
-	gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
 
 	// initialize a default clip model
 	defaultClipModel.LoadModel( idTraceModel( idBounds( idVec3( 0, 0, 0 ) ).Expand( 8 ) ) );
@@ -798,8 +732,22 @@ idClip::Shutdown
 ===============
 */
 void idClip::Shutdown() {
-	delete[] clipSectors;
-	clipSectors = NULL;
+	// clip models that outlive the clip world must not keep references into the tree
+	for ( int i = 0; i < maxTreeNodes; i++ ) {
+		clipTreeNode_t *node = &treeNodes[i];
+		if ( node->height == 0 && node->clipModel != NULL ) {
+			node->clipModel->linkedClip = NULL;
+			node->clipModel->clipProxy = CLIP_TREE_NULL_NODE;
+			node->clipModel->linked = false;
+		}
+	}
+
+	Mem_Free( treeNodes );
+	treeNodes = NULL;
+	maxTreeNodes = 0;
+	treeRoot = CLIP_TREE_NULL_NODE;
+	freeTreeNode = CLIP_TREE_NULL_NODE;
+	numClipProxies = 0;
 
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
@@ -812,73 +760,405 @@ void idClip::Shutdown() {
 		idClipModel::FreeTraceModel( defaultClipModel.traceModelIndex );
 		defaultClipModel.traceModelIndex = -1;
 	}
+}
 
-	clipLinkAllocator.Shutdown();
+/*
+===============
+ClipTree_SurfaceArea
+===============
+*/
+static ID_INLINE float ClipTree_SurfaceArea( const idBounds &bounds ) {
+	idVec3 size = bounds[1] - bounds[0];
+	return 2.0f * ( size[0] * size[1] + size[1] * size[2] + size[2] * size[0] );
 }
 
 /*
-====================
-idClip::ClipModelsTouchingBounds_r
-====================
+===============
+ClipTree_ContainsBounds
+===============
 */
-typedef struct listParms_s {
-	idBounds		bounds;
-	int				contentMask;
-	idClipModel	**	list;
-	int				count;
-	int				maxCount;
-} listParms_t;
-
-void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listParms_t &parms ) const {
-
-	while( node->axis != -1 ) {
-		if ( parms.bounds[0][node->axis] > node->dist ) {
-			node = node->children[0];
-		} else if ( parms.bounds[1][node->axis] < node->dist ) {
-			node = node->children[1];
-		} else {
-			ClipModelsTouchingBounds_r( node->children[0], parms );
-			node = node->children[1];
+static ID_INLINE bool ClipTree_ContainsBounds( const idBounds &outer, const idBounds &inner ) {
+	return (	outer[0][0] <= inner[0][0] && outer[0][1] <= inner[0][1] && outer[0][2] <= inner[0][2] &&
+				outer[1][0] >= inner[1][0] && outer[1][1] >= inner[1][1] && outer[1][2] >= inner[1][2] );
+}
+
+/*
+===============
+ClipTree_FatBounds
+
+  Expands the bounds with a margin and stretches them in the direction of motion
+  so a model moving at a steady pace keeps its leaf for several frames.
+===============
+*/
+static idBounds ClipTree_FatBounds( const idBounds &absBounds, const idVec3 &displacement ) {
+	idBounds fat = absBounds;
+	fat.ExpandSelf( CLIP_TREE_FAT_MARGIN );
+	if ( displacement.LengthSqr() < Square( CLIP_TREE_MAX_PREDICTION ) ) {
+		for ( int i = 0; i < 3; i++ ) {
+			if ( displacement[i] < 0.0f ) {
+				fat[0][i] += 2.0f * displacement[i];
+			} else {
+				fat[1][i] += 2.0f * displacement[i];
+			}
 		}
 	}
+	return fat;
+}
 
-	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
-		idClipModel	*check = link->clipModel;
+/*
+===============
+idClip::AllocTreeNode
+===============
+*/
+int idClip::AllocTreeNode() {
+	if ( freeTreeNode == CLIP_TREE_NULL_NODE ) {
+		int newMax = ( maxTreeNodes > 0 ) ? maxTreeNodes * 2 : CLIP_TREE_INITIAL_NODES;
+		clipTreeNode_t *newNodes = (clipTreeNode_t *) Mem_Alloc( newMax * sizeof( clipTreeNode_t ), TAG_PHYSICS_CLIP );
+		if ( maxTreeNodes > 0 ) {
+			memcpy( newNodes, treeNodes, maxTreeNodes * sizeof( clipTreeNode_t ) );
+		}
+		Mem_Free( treeNodes );
+		treeNodes = newNodes;
+
+		// chain the new nodes onto the free list
+		for ( int i = maxTreeNodes; i < newMax; i++ ) {
+			treeNodes[i].parent = ( i < newMax - 1 ) ? i + 1 : CLIP_TREE_NULL_NODE;
+			treeNodes[i].height = -1;
+			treeNodes[i].clipModel = NULL;
+		}
+		freeTreeNode = maxTreeNodes;
+		maxTreeNodes = newMax;
+	}
+
+	int nodeNum = freeTreeNode;
+	clipTreeNode_t *node = &treeNodes[nodeNum];
+	freeTreeNode = node->parent;
+	node->parent = CLIP_TREE_NULL_NODE;
+	node->children[0] = node->children[1] = CLIP_TREE_NULL_NODE;
+	node->height = 0;
+	node->clipModel = NULL;
+	return nodeNum;
+}
 
-		// if the clip model is enabled
-		if ( !check->enabled ) {
-			continue;
+/*
+===============
+idClip::FreeTreeNode
+===============
+*/
+void idClip::FreeTreeNode( int nodeNum ) {
+	assert( nodeNum >= 0 && nodeNum < maxTreeNodes );
+	treeNodes[nodeNum].parent = freeTreeNode;
+	treeNodes[nodeNum].height = -1;
+	treeNodes[nodeNum].clipModel = NULL;
+	freeTreeNode = nodeNum;
+}
+
+/*
+===============
+idClip::InsertTreeLeaf
+
+  Descends to the sibling that adds the least surface area to the tree,
+  then refits and rebalances the ancestors on the way back up.
+===============
+*/
+void idClip::InsertTreeLeaf( int leaf ) {
+	if ( treeRoot == CLIP_TREE_NULL_NODE ) {
+		treeRoot = leaf;
+		treeNodes[leaf].parent = CLIP_TREE_NULL_NODE;
+		return;
+	}
+
+	const idBounds leafBounds = treeNodes[leaf].bounds;
+
+	int index = treeRoot;
+	while ( treeNodes[index].height > 0 ) {
+		const clipTreeNode_t &node = treeNodes[index];
+
+		idBounds combined = node.bounds;
+		combined.AddBounds( leafBounds );
+		const float area = ClipTree_SurfaceArea( node.bounds );
+		const float combinedArea = ClipTree_SurfaceArea( combined );
+
+		// cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * ( combinedArea - area );
+
+		float childCost[2];
+		for ( int i = 0; i < 2; i++ ) {
+			const clipTreeNode_t &child = treeNodes[node.children[i]];
+			idBounds childCombined = child.bounds;
+			childCombined.AddBounds( leafBounds );
+			if ( child.height == 0 ) {
+				childCost[i] = ClipTree_SurfaceArea( childCombined ) + inheritanceCost;
+			} else {
+				childCost[i] = ClipTree_SurfaceArea( childCombined ) - ClipTree_SurfaceArea( child.bounds ) + inheritanceCost;
+			}
 		}
 
-		// avoid duplicates in the list
-		if ( check->touchCount == touchCount ) {
-			continue;
+		if ( cost < childCost[0] && cost < childCost[1] ) {
+			break;
 		}
 
-		// if the clip model does not have any contents we are looking for
-		if ( !( check->contents & parms.contentMask ) ) {
-			continue;
+		index = ( childCost[0] < childCost[1] ) ? node.children[0] : node.children[1];
+	}
+
+	const int sibling = index;
+	const int oldParent = treeNodes[sibling].parent;
+	const int newParent = AllocTreeNode();		// may move the node array
+
+	treeNodes[newParent].parent = oldParent;
+	treeNodes[newParent].bounds = leafBounds;
+	treeNodes[newParent].bounds.AddBounds( treeNodes[sibling].bounds );
+	treeNodes[newParent].height = treeNodes[sibling].height + 1;
+	treeNodes[newParent].children[0] = sibling;
+	treeNodes[newParent].children[1] = leaf;
+	treeNodes[sibling].parent = newParent;
+	treeNodes[leaf].parent = newParent;
+
+	if ( oldParent != CLIP_TREE_NULL_NODE ) {
+		if ( treeNodes[oldParent].children[0] == sibling ) {
+			treeNodes[oldParent].children[0] = newParent;
+		} else {
+			treeNodes[oldParent].children[1] = newParent;
 		}
+	} else {
+		treeRoot = newParent;
+	}
 
-		// if the bounds really do overlap
-		if (	check->absBounds[0][0] > parms.bounds[1][0] ||
-				check->absBounds[1][0] < parms.bounds[0][0] ||
-				check->absBounds[0][1] > parms.bounds[1][1] ||
-				check->absBounds[1][1] < parms.bounds[0][1] ||
-				check->absBounds[0][2] > parms.bounds[1][2] ||
-				check->absBounds[1][2] < parms.bounds[0][2] ) {
-			continue;
+	for ( index = treeNodes[leaf].parent; index != CLIP_TREE_NULL_NODE; index = treeNodes[index].parent ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		const clipTreeNode_t &child0 = treeNodes[node.children[0]];
+		const clipTreeNode_t &child1 = treeNodes[node.children[1]];
+		node.height = 1 + Max( child0.height, child1.height );
+		node.bounds = child0.bounds;
+		node.bounds.AddBounds( child1.bounds );
+	}
+}
+
+/*
+===============
+idClip::RemoveTreeLeaf
+===============
+*/
+void idClip::RemoveTreeLeaf( int leaf ) {
+	if ( leaf == treeRoot ) {
+		treeRoot = CLIP_TREE_NULL_NODE;
+		return;
+	}
+
+	const int parent = treeNodes[leaf].parent;
+	const int grandParent = treeNodes[parent].parent;
+	const int sibling = ( treeNodes[parent].children[0] == leaf ) ? treeNodes[parent].children[1] : treeNodes[parent].children[0];
+
+	FreeTreeNode( parent );
+
+	if ( grandParent == CLIP_TREE_NULL_NODE ) {
+		treeRoot = sibling;
+		treeNodes[sibling].parent = CLIP_TREE_NULL_NODE;
+		return;
+	}
+
+	// replace the parent with the sibling
+	if ( treeNodes[grandParent].children[0] == parent ) {
+		treeNodes[grandParent].children[0] = sibling;
+	} else {
+		treeNodes[grandParent].children[1] = sibling;
+	}
+	treeNodes[sibling].parent = grandParent;
+
+	// refit the ancestors
+	for ( int index = grandParent; index != CLIP_TREE_NULL_NODE; index = treeNodes[index].parent ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		const clipTreeNode_t &child0 = treeNodes[node.children[0]];
+		const clipTreeNode_t &child1 = treeNodes[node.children[1]];
+		node.height = 1 + Max( child0.height, child1.height );
+		node.bounds = child0.bounds;
+		node.bounds.AddBounds( child1.bounds );
+	}
+}
+
+/*
+===============
+idClip::BalanceTreeNode
+
+  Rotates the taller child up if the subtree at nodeNum is out of balance.
+  Returns the node that now roots the subtree.
+===============
+*/
+int idClip::BalanceTreeNode( int nodeNum ) {
+	const int iA = nodeNum;
+	clipTreeNode_t &A = treeNodes[iA];
+	if ( A.height < 2 ) {
+		return iA;
+	}
+
+	const int iB = A.children[0];
+	const int iC = A.children[1];
+	clipTreeNode_t &B = treeNodes[iB];
+	clipTreeNode_t &C = treeNodes[iC];
+
+	const int balance = C.height - B.height;
+
+	if ( balance > 1 ) {
+		// rotate C up
+		const int iF = C.children[0];
+		const int iG = C.children[1];
+		clipTreeNode_t &F = treeNodes[iF];
+		clipTreeNode_t &G = treeNodes[iG];
+
+		C.children[0] = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if ( C.parent != CLIP_TREE_NULL_NODE ) {
+			if ( treeNodes[C.parent].children[0] == iA ) {
+				treeNodes[C.parent].children[0] = iC;
+			} else {
+				treeNodes[C.parent].children[1] = iC;
+			}
+		} else {
+			treeRoot = iC;
 		}
 
-		if ( parms.count >= parms.maxCount ) {
-			gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
-			return;
+		if ( F.height > G.height ) {
+			C.children[1] = iF;
+			A.children[1] = iG;
+			G.parent = iA;
+			A.bounds = B.bounds;
+			A.bounds.AddBounds( G.bounds );
+			C.bounds = A.bounds;
+			C.bounds.AddBounds( F.bounds );
+			A.height = 1 + Max( B.height, G.height );
+			C.height = 1 + Max( A.height, F.height );
+		} else {
+			C.children[1] = iG;
+			A.children[1] = iF;
+			F.parent = iA;
+			A.bounds = B.bounds;
+			A.bounds.AddBounds( F.bounds );
+			C.bounds = A.bounds;
+			C.bounds.AddBounds( G.bounds );
+			A.height = 1 + Max( B.height, F.height );
+			C.height = 1 + Max( A.height, G.height );
 		}
+		return iC;
+	}
+
+	if ( balance < -1 ) {
+		// rotate B up
+		const int iD = B.children[0];
+		const int iE = B.children[1];
+		clipTreeNode_t &D = treeNodes[iD];
+		clipTreeNode_t &E = treeNodes[iE];
+
+		B.children[0] = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if ( B.parent != CLIP_TREE_NULL_NODE ) {
+			if ( treeNodes[B.parent].children[0] == iA ) {
+				treeNodes[B.parent].children[0] = iB;
+			} else {
+				treeNodes[B.parent].children[1] = iB;
+			}
+		} else {
+			treeRoot = iB;
+		}
+
+		if ( D.height > E.height ) {
+			B.children[1] = iD;
+			A.children[0] = iE;
+			E.parent = iA;
+			A.bounds = C.bounds;
+			A.bounds.AddBounds( E.bounds );
+			B.bounds = A.bounds;
+			B.bounds.AddBounds( D.bounds );
+			A.height = 1 + Max( C.height, E.height );
+			B.height = 1 + Max( A.height, D.height );
+		} else {
+			B.children[1] = iE;
+			A.children[0] = iD;
+			D.parent = iA;
+			A.bounds = C.bounds;
+			A.bounds.AddBounds( D.bounds );
+			B.bounds = A.bounds;
+			B.bounds.AddBounds( E.bounds );
+			A.height = 1 + Max( C.height, D.height );
+			B.height = 1 + Max( A.height, E.height );
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+/*
+===============
+idClip::CreateClipProxy
+===============
+*/
+int idClip::CreateClipProxy( idClipModel *clipModel ) {
+	int proxy = AllocTreeNode();
+	treeNodes[proxy].bounds = ClipTree_FatBounds( clipModel->absBounds, vec3_origin );
+	treeNodes[proxy].clipModel = clipModel;
+	InsertTreeLeaf( proxy );
+	numClipProxies++;
+	return proxy;
+}
+
+/*
+===============
+idClip::MoveClipProxy
+
+  Leaves whose fat bounds still contain the model are left alone. A leaf that
+  still fits inside its parent is refit in place, only leaves that escape their
+  parent are reinserted.
+===============
+*/
+void idClip::MoveClipProxy( int proxy, const idBounds &absBounds, const idVec3 &displacement ) {
+	clipTreeNode_t &leaf = treeNodes[proxy];
+	assert( leaf.height == 0 );
 
-		check->touchCount = touchCount;
-		parms.list[parms.count] = check;
-		parms.count++;
+	if ( ClipTree_ContainsBounds( leaf.bounds, absBounds ) ) {
+		return;
 	}
+
+	const idBounds fat = ClipTree_FatBounds( absBounds, displacement );
+	if ( leaf.parent == CLIP_TREE_NULL_NODE || ClipTree_ContainsBounds( treeNodes[leaf.parent].bounds, fat ) ) {
+		leaf.bounds = fat;
+		return;
+	}
+
+	RemoveTreeLeaf( proxy );
+	treeNodes[proxy].bounds = fat;
+	InsertTreeLeaf( proxy );
+}
+
+/*
+===============
+idClip::DestroyClipProxy
+===============
+*/
+void idClip::DestroyClipProxy( int proxy ) {
+	assert( treeNodes[proxy].height == 0 );
+	RemoveTreeLeaf( proxy );
+	FreeTreeNode( proxy );
+	numClipProxies--;
+}
+
+/*
+===============
+idClip::GetTreeHeight
+===============
+*/
+int idClip::GetTreeHeight() const {
+	return ( treeRoot != CLIP_TREE_NULL_NODE ) ? treeNodes[treeRoot].height : 0;
 }
 
 /*
@@ -887,7 +1167,9 @@ idClip::ClipModelsTouchingBounds
 ================
 */
 int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, idClipModel **clipModelList, int maxCount ) const {
-	listParms_t parms;
+	idBounds		parmsBounds;
+	int				stack[CLIP_TREE_STACK_SIZE];
+	int				stackSize, count;
 
 	if (	bounds[0][0] > bounds[1][0] ||
 			bounds[0][1] > bounds[1][1] ||
@@ -897,17 +1179,69 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 		return 0;
 	}
 
-	parms.bounds[0] = bounds[0] - vec3_boxEpsilon;
-	parms.bounds[1] = bounds[1] + vec3_boxEpsilon;
-	parms.contentMask = contentMask;
-	parms.list = clipModelList;
-	parms.count = 0;
-	parms.maxCount = maxCount;
+	if ( treeRoot == CLIP_TREE_NULL_NODE ) {
+		return 0;
+	}
+
+	parmsBounds[0] = bounds[0] - vec3_boxEpsilon;
+	parmsBounds[1] = bounds[1] + vec3_boxEpsilon;
+
+	count = 0;
+	stackSize = 0;
+	stack[stackSize++] = treeRoot;
+
+	while ( stackSize > 0 ) {
+		const clipTreeNode_t &node = treeNodes[stack[--stackSize]];
+
+		if ( !node.bounds.IntersectsBounds( parmsBounds ) ) {
+			continue;
+		}
+
+		if ( node.height > 0 ) {
+			// the tree is balanced so the stack never gets close to its size
+			assert( stackSize + 2 <= CLIP_TREE_STACK_SIZE );
+			stack[stackSize++] = node.children[1];
+			stack[stackSize++] = node.children[0];
+			continue;
+		}
 
-	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+		idClipModel	*check = node.clipModel;
+
+		// the leaf is kept while the clip model is unlinked
+		if ( !check->linked ) {
+			continue;
+		}
 
-	return parms.count;
+		// if the clip model is enabled
+		if ( !check->enabled ) {
+			continue;
+		}
+
+		// if the clip model does not have any contents we are looking for
+		if ( !( check->contents & contentMask ) ) {
+			continue;
+		}
+
+		// if the bounds really do overlap
+		if (	check->absBounds[0][0] > parmsBounds[1][0] ||
+				check->absBounds[1][0] < parmsBounds[0][0] ||
+				check->absBounds[0][1] > parmsBounds[1][1] ||
+				check->absBounds[1][1] < parmsBounds[0][1] ||
+				check->absBounds[0][2] > parmsBounds[1][2] ||
+				check->absBounds[1][2] < parmsBounds[0][2] ) {
+			continue;
+		}
+
+		if ( count >= maxCount ) {
+			gameLocal.Warning( "idClip::ClipModelsTouchingBounds: max count" );
+			return count;
+		}
+
+		clipModelList[count] = check;
+		count++;
+	}
+
+	return count;
 }
 
 /*
@@ -1683,6 +2017,123 @@ bool idClip::GetModelContactFeature( const contactInfo_t &contact, const idClipM
 	return true;
 }
 
+/*
+============
+idClip::TestClipTree_f
+
+  Moves thousands of clip models around the current map in a private clip world
+  and measures how fast they relink and how fast the broadphase answers queries.
+  Every query on the first and last frame is checked against a brute force scan.
+============
+*/
+void idClip::TestClipTree_f( const idCmdArgs &args ) {
+	static const float	boxSizes[] = { 8.0f, 16.0f, 32.0f, 64.0f, 128.0f };
+	idList<idEntity *>	entities;
+	idList<idClipModel *> models;
+	idList<idVec3>		velocities;
+	idRandom			random( 0 );
+	idClip				clip;
+
+	if ( gameLocal.world == NULL ) {
+		gameLocal.Printf( "testClipTree: no map loaded\n" );
+		return;
+	}
+
+	const int numModels = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 4096;
+	const int numFrames = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 60;
+	const int numQueries = Max( numModels / 4, 1 );
+
+	for ( idEntity *ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		entities.Append( ent );
+	}
+
+	clip.Init();
+	const idBounds &worldBounds = clip.GetWorldBounds();
+	const idVec3 worldSize = worldBounds[1] - worldBounds[0];
+
+	models.SetNum( numModels );
+	velocities.SetNum( numModels );
+	for ( int i = 0; i < numModels; i++ ) {
+		const float size = boxSizes[ random.RandomInt( sizeof( boxSizes ) / sizeof( boxSizes[0] ) ) ];
+		idVec3 origin;
+		for ( int j = 0; j < 3; j++ ) {
+			origin[j] = worldBounds[0][j] + random.RandomFloat() * worldSize[j];
+			velocities[i][j] = random.CRandomFloat() * 16.0f;
+		}
+		models[i] = new (TAG_PHYSICS_CLIP) idClipModel( idTraceModel( idBounds( vec3_origin ).Expand( size * 0.5f ) ) );
+		models[i]->Link( clip, entities[ i % entities.Num() ], 0, origin, mat3_identity );
+	}
+
+	idClipModel ** clipModelList = new (TAG_PHYSICS_CLIP) idClipModel *[MAX_GENTITIES];
+	idEntity ** entityList = new (TAG_PHYSICS_CLIP) idEntity *[MAX_GENTITIES];
+	uint64 linkTime = 0, traceTime = 0, entityTime = 0;
+	int numTouched = 0, numErrors = 0;
+
+	for ( int frame = 0; frame < numFrames; frame++ ) {
+		// move everything, bouncing off the map bounds
+		uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < numModels; i++ ) {
+			idVec3 origin = models[i]->GetOrigin() + velocities[i];
+			for ( int j = 0; j < 3; j++ ) {
+				if ( origin[j] < worldBounds[0][j] || origin[j] > worldBounds[1][j] ) {
+					velocities[i][j] = -velocities[i][j];
+				}
+			}
+			models[i]->SetPosition( origin, mat3_identity );
+			models[i]->Link( clip );
+		}
+		linkTime += Sys_Microseconds() - start;
+
+		// query around random models as a trace would
+		const int firstQuery = random.RandomInt( numModels );
+		start = Sys_Microseconds();
+		for ( int q = 0; q < numQueries; q++ ) {
+			const idClipModel *mdl = models[ ( firstQuery + q ) % numModels ];
+			numTouched += clip.GetTraceClipModels( mdl->GetAbsBounds().Expand( 32.0f ), -1, NULL, clipModelList );
+		}
+		traceTime += Sys_Microseconds() - start;
+
+		start = Sys_Microseconds();
+		for ( int q = 0; q < numQueries; q++ ) {
+			const idClipModel *mdl = models[ ( firstQuery + q ) % numModels ];
+			clip.EntitiesTouchingBounds( mdl->GetAbsBounds().Expand( 32.0f ), -1, entityList, MAX_GENTITIES );
+		}
+		entityTime += Sys_Microseconds() - start;
+
+		if ( frame != 0 && frame != numFrames - 1 ) {
+			continue;
+		}
+
+		for ( int q = 0; q < numQueries; q++ ) {
+			const idClipModel *mdl = models[ ( firstQuery + q ) % numModels ];
+			const idBounds bounds = mdl->GetAbsBounds().Expand( 32.0f + CM_BOX_EPSILON );
+			int num = clip.ClipModelsTouchingBounds( mdl->GetAbsBounds().Expand( 32.0f ), -1, clipModelList, MAX_GENTITIES );
+			int expected = 0;
+			for ( int i = 0; i < numModels; i++ ) {
+				if ( models[i]->GetAbsBounds().IntersectsBounds( bounds ) ) {
+					expected++;
+				}
+			}
+			if ( num != expected ) {
+				numErrors++;
+			}
+		}
+	}
+
+	gameLocal.Printf( "%d clip models, %d frames, %d queries per frame, tree height %d, %d nodes\n",
+						numModels, numFrames, numQueries, clip.GetTreeHeight(), clip.maxTreeNodes );
+	gameLocal.Printf( "link:                   %6.1f usec per frame\n", (float)linkTime / numFrames );
+	gameLocal.Printf( "GetTraceClipModels:     %6.2f usec per query, %1.1f models per query\n",
+						(float)traceTime / ( numFrames * numQueries ), (float)numTouched / ( numFrames * numQueries ) );
+	gameLocal.Printf( "EntitiesTouchingBounds: %6.2f usec per query\n", (float)entityTime / ( numFrames * numQueries ) );
+	gameLocal.Printf( "%d queries disagree with a brute force scan\n", numErrors );
+
+	delete[] clipModelList;
+	delete[] entityList;
+	models.DeleteContents( true );
+	clip.Shutdown();
+}
+
 /*
 ============
 idClip::PrintStatistics
@@ -72,7 +72,7 @@ public:
 
 	void					Link( idClip &clp );				// must have been linked with an entity and id before
 	void					Link( idClip &clp, idEntity *ent, int newId, const idVec3 &newOrigin, const idMat3 &newAxis, int renderModelHandle = -1 );
-	void					Unlink();						// unlink from sectors
+	void					Unlink();						// unlink from the clip tree
 	void					SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis );	// unlinks the clip model
 	void					Translate( const idVec3 &translation );							// unlinks the clip model
 	void					Rotate( const idRotation &rotation );							// unlinks the clip model
@@ -123,11 +123,12 @@ private:
 	int						traceModelIndex;		// trace model used for collision detection
 	int						renderModelHandle;		// render model def handle
 
-	struct clipLink_s *		clipLinks;				// links into sectors
-	int						touchCount;
+	idClip *				linkedClip;				// clip world that owns the proxy
+	int						clipProxy;				// leaf in the clip tree, kept while unlinked so relinking is cheap
+	bool					linked;					// true if linked into the clip tree
 
 	void					Init();			// initialize
-	void					Link_r( struct clipSector_s *node );
+	void					FreeClipProxy();	// remove the leaf from the clip tree
 
 	static int				AllocTraceModel( const idTraceModel &trm, bool persistantThroughSaves = true );
 	static void				FreeTraceModel( int traceModelIndex );
@@ -221,7 +222,7 @@ ID_INLINE bool idClipModel::IsTraceModel() const {
 }
 
 ID_INLINE bool idClipModel::IsLinked() const {
-	return ( clipLinks != NULL );
+	return linked;
 }
 
 ID_INLINE bool idClipModel::IsEnabled() const {
@@ -307,13 +308,18 @@ public:
 	void					DrawClipModels( const idVec3 &eye, const float radius, const idEntity *passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 
+	static void				TestClipTree_f( const idCmdArgs &args );
+
 private:
-	int						numClipSectors;
-	struct clipSector_s *	clipSectors;
+							// dynamic bounding volume tree with a leaf per clip model
+	struct clipTreeNode_s *	treeNodes;
+	int						maxTreeNodes;
+	int						treeRoot;
+	int						freeTreeNode;
+	int						numClipProxies;
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
-	mutable int				touchCount;
 							// statistics
 	int						numTranslations;
 	int						numRotations;
@@ -323,8 +329,15 @@ private:
 	int						numContacts;
 
 private:
-	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
-	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	int						AllocTreeNode();
+	void					FreeTreeNode( int nodeNum );
+	void					InsertTreeLeaf( int leaf );
+	void					RemoveTreeLeaf( int leaf );
+	int						BalanceTreeNode( int nodeNum );
+	int						CreateClipProxy( idClipModel *clipModel );
+	void					MoveClipProxy( int proxy, const idBounds &absBounds, const idVec3 &displacement );
+	void					DestroyClipProxy( int proxy );
+	int						GetTreeHeight() const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
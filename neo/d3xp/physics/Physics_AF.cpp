@@ -4224,6 +4224,7 @@ void idAFBody::Init() {
 	numResponses				= 0;
 	maxAuxiliaryIndex			= 0;
 	maxSubTreeAuxiliaryIndex	= 0;
+	treeIndex					= 0;
 
 	memset( &fl, 0, sizeof( fl ) );
 
@@ -4474,19 +4475,169 @@ void idAFBody::Restore( idRestoreGame *saveFile ) {
 //                                                        E
 //===============================================================
 
+/*
+================
+AF_Dot6
+
+  dot product of two 16 byte aligned six dimensional rows, the padding is not read
+================
+*/
+static ID_INLINE float AF_Dot6( const float *a, const float *b ) {
+#ifdef ID_WIN_X86_SSE_INTRIN
+	__m128 sum = _mm_mul_ps( _mm_load_ps( a ), _mm_load_ps( b ) );
+	sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadl_pi( _mm_setzero_ps(), (const __m64 *)( a + 4 ) ),
+										_mm_loadl_pi( _mm_setzero_ps(), (const __m64 *)( b + 4 ) ) ) );
+	sum = _mm_add_ps( sum, _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	sum = _mm_add_ps( sum, _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	float dot;
+	_mm_store_ss( & dot, sum );
+	return dot;
+#else
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] + a[4] * b[4] + a[5] * b[5];
+#endif
+}
+
+/*
+================
+AF_Dot8
+
+  dot product of two 16 byte aligned rows padded with zeros to 8 floats
+================
+*/
+static ID_INLINE float AF_Dot8( const float *a, const float *b ) {
+#ifdef ID_WIN_X86_SSE_INTRIN
+	__m128 sum = _mm_add_ps( _mm_mul_ps( _mm_load_ps( a + 0 ), _mm_load_ps( b + 0 ) ),
+								_mm_mul_ps( _mm_load_ps( a + 4 ), _mm_load_ps( b + 4 ) ) );
+	sum = _mm_add_ps( sum, _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	sum = _mm_add_ps( sum, _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	float dot;
+	_mm_store_ss( & dot, sum );
+	return dot;
+#else
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] + a[4] * b[4] + a[5] * b[5];
+#endif
+}
+
+/*
+================
+AF_MulAdd8
+
+  dst += a * s
+================
+*/
+static ID_INLINE void AF_MulAdd8( float *dst, const float *a, const float s ) {
+#ifdef ID_WIN_X86_SSE_INTRIN
+	__m128 vs = _mm_set1_ps( s );
+	_mm_store_ps( dst + 0, _mm_add_ps( _mm_load_ps( dst + 0 ), _mm_mul_ps( _mm_load_ps( a + 0 ), vs ) ) );
+	_mm_store_ps( dst + 4, _mm_add_ps( _mm_load_ps( dst + 4 ), _mm_mul_ps( _mm_load_ps( a + 4 ), vs ) ) );
+#else
+	for ( int i = 0; i < 8; i++ ) {
+		dst[i] += a[i] * s;
+	}
+#endif
+}
+
+/*
+================
+AF_MulSub8
+
+  dst -= a * s
+================
+*/
+static ID_INLINE void AF_MulSub8( float *dst, const float *a, const float s ) {
+#ifdef ID_WIN_X86_SSE_INTRIN
+	__m128 vs = _mm_set1_ps( s );
+	_mm_store_ps( dst + 0, _mm_sub_ps( _mm_load_ps( dst + 0 ), _mm_mul_ps( _mm_load_ps( a + 0 ), vs ) ) );
+	_mm_store_ps( dst + 4, _mm_sub_ps( _mm_load_ps( dst + 4 ), _mm_mul_ps( _mm_load_ps( a + 4 ), vs ) ) );
+#else
+	for ( int i = 0; i < 8; i++ ) {
+		dst[i] -= a[i] * s;
+	}
+#endif
+}
+
+/*
+================
+AF_Zero8
+================
+*/
+static ID_INLINE void AF_Zero8( float *dst ) {
+#ifdef ID_WIN_X86_SSE_INTRIN
+	_mm_store_ps( dst + 0, _mm_setzero_ps() );
+	_mm_store_ps( dst + 4, _mm_setzero_ps() );
+#else
+	for ( int i = 0; i < 8; i++ ) {
+		dst[i] = 0.0f;
+	}
+#endif
+}
+
+/*
+================
+AF_CopyRow6
+
+  copy a six dimensional row and clear the padding
+================
+*/
+static ID_INLINE void AF_CopyRow6( float *dst, const float *src ) {
+	dst[0] = src[0];
+	dst[1] = src[1];
+	dst[2] = src[2];
+	dst[3] = src[3];
+	dst[4] = src[4];
+	dst[5] = src[5];
+	dst[6] = 0.0f;
+	dst[7] = 0.0f;
+}
+
+/*
+================
+AF_MultiplyRows6
+
+  v = m * v with a 6x6 matrix
+================
+*/
+static ID_INLINE void AF_MultiplyRows6( float *v, const float m[6][8] ) {
+	ALIGN16( float tmp[8] );
+
+	tmp[0] = AF_Dot8( m[0], v );
+	tmp[1] = AF_Dot8( m[1], v );
+	tmp[2] = AF_Dot8( m[2], v );
+	tmp[3] = AF_Dot8( m[3], v );
+	tmp[4] = AF_Dot8( m[4], v );
+	tmp[5] = AF_Dot8( m[5], v );
+	AF_CopyRow6( v, tmp );
+}
+
+/*
+================
+idAFTree::idAFTree
+================
+*/
+idAFTree::idAFTree() {
+	useBlocks = false;
+}
+
 /*
 ================
 idAFTree::Factor
 
   factor matrix for the primary constraints in the tree
+  useBlockSolver selects the block solver for this and the following solves
 ================
 */
-void idAFTree::Factor() const {
+void idAFTree::Factor( bool useBlockSolver ) const {
 	int i, j;
 	idAFBody *body;
 	idAFConstraint *child = NULL;
 	idMatX childI;
 
+	useBlocks = useBlockSolver;
+	if ( useBlocks ) {
+		FactorBlocks();
+		return;
+	}
+
 	childI.SetData( 6, 6, MATX_ALLOCA( 6 * 6 ) );
 
 	// from the leaves up towards the root
@@ -4624,6 +4775,11 @@ void idAFTree::Response( const idAFConstraint *constraint, int row, int auxiliar
 		return;
 	}
 
+	if ( useBlocks ) {
+		ResponseBlocks( constraint, row, auxiliaryIndex );
+		return;
+	}
+
 	v.SetData( 6, VECX_ALLOCA( 6 ) );
 
 	// initialize right hand side to zero
@@ -4729,6 +4885,11 @@ void idAFTree::CalculateForces( float timeStep ) const {
 		return;
 	}
 
+	if ( useBlocks ) {
+		CalculateForcesBlocks( timeStep );
+		return;
+	}
+
 	invStep = 1.0f / timeStep;
 
 	// initialize right hand side
@@ -4767,6 +4928,388 @@ void idAFTree::CalculateForces( float timeStep ) const {
 	}
 }
 
+/*
+================
+idAFTree::FactorBlocks
+
+  factor matrix for the primary constraints in the tree into the block workspace
+================
+*/
+void idAFTree::FactorBlocks() const {
+	int i, j, k, l, r;
+	idAFBody *body, *child;
+	idAFConstraint *c, *primaryConstraint;
+	idMatX inv;
+	ALIGN16( float childI[6][8] );
+	ALIGN16( float tmp[6][8] );
+
+	inv.SetData( 6, 6, MATX_ALLOCA( 6 * 6 ) );
+
+	blocks.SetNum( sortedBodies.Num() );
+
+	// from the leaves up towards the root
+	for ( i = sortedBodies.Num() - 1; i >= 0; i-- ) {
+		body = sortedBodies[i];
+		AFTreeBlock_t &b = blocks[i];
+
+		for ( j = 0; j < 6; j++ ) {
+			AF_CopyRow6( b.I[j], body->I[j] );
+		}
+
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			for ( j = 0; j < primaryConstraint->J1.GetNumRows(); j++ ) {
+				AF_CopyRow6( b.cJ1[j], primaryConstraint->J1[j] );
+				AF_CopyRow6( b.cJ2[j], primaryConstraint->J2[j] );
+			}
+		}
+
+		if ( body->children.Num() ) {
+
+			for ( j = 0; j < body->children.Num(); j++ ) {
+				child = body->children[j];
+				c = child->primaryConstraint;
+				AFTreeBlock_t &cb = blocks[child->treeIndex];
+				r = c->J1.GetNumRows();
+
+				// tmp = child J.Transpose() * child I
+				for ( k = 0; k < r; k++ ) {
+					AF_Zero8( tmp[k] );
+					for ( l = 0; l < 6; l++ ) {
+						AF_MulAdd8( tmp[k], cb.I[l], cb.J[k][l] );
+					}
+				}
+
+				// childI = - tmp * child J
+				inv.SetSize( r, r );
+				for ( k = 0; k < r; k++ ) {
+					for ( l = 0; l < r; l++ ) {
+						childI[k][l] = inv[k][l] = -AF_Dot8( tmp[k], cb.J[l] );
+					}
+				}
+
+				if ( !inv.InverseFastSelf() ) {
+					gameLocal.Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for constraint '%s'",
+									r, r, c->GetName().c_str() );
+				}
+				for ( k = 0; k < r; k++ ) {
+					AF_Zero8( cb.cInvI[k] );
+					for ( l = 0; l < r; l++ ) {
+						cb.cInvI[k][l] = inv[k][l];
+					}
+				}
+
+				// constraint J = constraint invI * constraint J2
+				for ( k = 0; k < r; k++ ) {
+					AF_Zero8( cb.cJ[k] );
+					for ( l = 0; l < r; l++ ) {
+						AF_MulAdd8( cb.cJ[k], cb.cJ2[l], cb.cInvI[k][l] );
+					}
+				}
+
+				// I -= constraint J.Transpose() * childI * constraint J
+				for ( k = 0; k < r; k++ ) {
+					AF_Zero8( tmp[k] );
+					for ( l = 0; l < r; l++ ) {
+						AF_MulAdd8( tmp[k], cb.cJ[l], childI[k][l] );
+					}
+				}
+				for ( k = 0; k < 6; k++ ) {
+					for ( l = 0; l < r; l++ ) {
+						AF_MulSub8( b.I[k], tmp[l], cb.cJ[l][k] );
+					}
+				}
+			}
+
+			inv.SetSize( 6, 6 );
+			for ( j = 0; j < 6; j++ ) {
+				for ( k = 0; k < 6; k++ ) {
+					inv[j][k] = b.I[j][k];
+				}
+			}
+			if ( !inv.InverseFastSelf() ) {
+				gameLocal.Warning( "idAFTree::Factor: couldn't invert 6x6 matrix for body %s", body->GetName().c_str() );
+			}
+			for ( j = 0; j < 6; j++ ) {
+				AF_CopyRow6( b.invI[j], inv[j] );
+			}
+		}
+		else if ( primaryConstraint ) {
+			for ( j = 0; j < 6; j++ ) {
+				AF_CopyRow6( b.invI[j], body->inverseWorldSpatialInertia[j] );
+			}
+		}
+
+		if ( primaryConstraint ) {
+			// J = invI * J, stored transposed so the rows of J1 can be used directly
+			for ( j = 0; j < primaryConstraint->J1.GetNumRows(); j++ ) {
+				for ( k = 0; k < 6; k++ ) {
+					b.J[j][k] = AF_Dot8( b.cJ1[j], b.invI[k] );
+				}
+				b.J[j][6] = b.J[j][7] = 0.0f;
+			}
+		}
+	}
+}
+
+/*
+================
+idAFTree::SolveBlocks
+
+  solve for primary constraints in the tree using the block workspace
+================
+*/
+void idAFTree::SolveBlocks( int auxiliaryIndex ) const {
+	int i, j, k, r;
+	idAFBody *body, *child;
+	idAFConstraint *primaryConstraint;
+	ALIGN16( float tmp[8] );
+
+	// from the leaves up towards the root
+	for ( i = sortedBodies.Num() - 1; i >= 0; i-- ) {
+		body = sortedBodies[i];
+		AFTreeBlock_t &b = blocks[i];
+
+		for ( j = 0; j < body->children.Num(); j++ ) {
+			child = body->children[j];
+			primaryConstraint = child->primaryConstraint;
+			AFTreeBlock_t &cb = blocks[child->treeIndex];
+			r = primaryConstraint->J1.GetNumRows();
+
+			if ( !child->fl.isZero ) {
+				for ( k = 0; k < r; k++ ) {
+					cb.cs[k] -= AF_Dot8( cb.J[k], cb.s );
+				}
+				primaryConstraint->fl.isZero = false;
+			}
+			if ( !primaryConstraint->fl.isZero ) {
+				for ( k = 0; k < r; k++ ) {
+					AF_MulSub8( b.s, cb.cJ[k], cb.cs[k] );
+				}
+				body->fl.isZero = false;
+			}
+		}
+	}
+
+	bool useSymmetry = af_useSymmetry.GetBool();
+
+	// from the root down towards the leaves
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		body = sortedBodies[i];
+		primaryConstraint = body->primaryConstraint;
+		AFTreeBlock_t &b = blocks[i];
+
+		if ( primaryConstraint ) {
+
+			if ( useSymmetry && body->parent->maxSubTreeAuxiliaryIndex < auxiliaryIndex ) {
+				continue;
+			}
+
+			r = primaryConstraint->J1.GetNumRows();
+
+			if ( !primaryConstraint->fl.isZero ) {
+				for ( k = 0; k < r; k++ ) {
+					tmp[k] = AF_Dot8( b.cInvI[k], b.cs );
+				}
+				for ( k = 0; k < r; k++ ) {
+					b.cs[k] = tmp[k];
+				}
+			}
+			const AFTreeBlock_t &pb = blocks[body->parent->treeIndex];
+			for ( k = 0; k < r; k++ ) {
+				b.cs[k] -= AF_Dot8( b.cJ[k], pb.s );
+			}
+
+			// store the constraint forces like Solve does
+			primaryConstraint->lm.SetSize( r );
+			for ( k = 0; k < r; k++ ) {
+				primaryConstraint->lm[k] = b.cs[k];
+			}
+
+			if ( useSymmetry && body->maxSubTreeAuxiliaryIndex < auxiliaryIndex ) {
+				continue;
+			}
+
+			if ( body->children.Num() ) {
+				if ( !body->fl.isZero ) {
+					AF_MultiplyRows6( b.s, b.invI );
+				}
+				for ( k = 0; k < r; k++ ) {
+					AF_MulSub8( b.s, b.J[k], b.cs[k] );
+				}
+			}
+		} else if ( body->children.Num() ) {
+			AF_MultiplyRows6( b.s, b.invI );
+		}
+	}
+}
+
+/*
+================
+idAFTree::ResponseBlocks
+
+  calculate body forces in the tree in response to a constraint force using the block workspace
+================
+*/
+void idAFTree::ResponseBlocks( const idAFConstraint *constraint, int row, int auxiliaryIndex ) const {
+	int i, j, k, r;
+	idAFBody *body, *child;
+	idAFConstraint *primaryConstraint;
+	idVecX v;
+	float *force;
+
+	v.SetData( 6, VECX_ALLOCA( 8 ) );
+	v.ToFloatPtr()[6] = v.ToFloatPtr()[7] = 0.0f;
+
+	// initialize right hand side to zero
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		body = sortedBodies[i];
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			AF_Zero8( blocks[i].cs );
+			primaryConstraint->fl.isZero = true;
+		}
+		AF_Zero8( blocks[i].s );
+		body->fl.isZero = true;
+		AF_Zero8( body->response + body->numResponses * 8 );
+	}
+
+	// set right hand side for the constrained bodies
+	for ( i = 0; i < 2; i++ ) {
+		body = ( i == 0 ) ? constraint->body1 : constraint->body2;
+		if ( !body || body->tree != this ) {
+			continue;
+		}
+		const float *J = ( i == 0 ) ? constraint->J1[row] : constraint->J2[row];
+
+		body->InverseWorldSpatialInertiaMultiply( v, J );
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			AFTreeBlock_t &b = blocks[body->treeIndex];
+			for ( k = 0; k < primaryConstraint->J1.GetNumRows(); k++ ) {
+				b.cs[k] += AF_Dot8( b.cJ1[k], v.ToFloatPtr() );
+			}
+			primaryConstraint->fl.isZero = false;
+		}
+		for ( j = 0; j < body->children.Num(); j++ ) {
+			child = body->children[j];
+			AFTreeBlock_t &cb = blocks[child->treeIndex];
+			for ( k = 0; k < child->primaryConstraint->J1.GetNumRows(); k++ ) {
+				cb.cs[k] += AF_Dot8( cb.cJ2[k], v.ToFloatPtr() );
+			}
+			child->primaryConstraint->fl.isZero = false;
+		}
+		AF_CopyRow6( body->response + body->numResponses * 8, J );
+	}
+
+	// solve for primary constraints
+	SolveBlocks( auxiliaryIndex );
+
+	bool useSymmetry = af_useSymmetry.GetBool();
+
+	// store body forces in response to the constraint force
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		body = sortedBodies[i];
+
+		if ( useSymmetry && body->maxAuxiliaryIndex < auxiliaryIndex ) {
+			continue;
+		}
+
+		force = body->response + body->numResponses * 8;
+
+		// add forces of all primary constraints acting on this body
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			const AFTreeBlock_t &b = blocks[i];
+			r = primaryConstraint->J1.GetNumRows();
+			for ( k = 0; k < r; k++ ) {
+				AF_MulAdd8( force, b.cJ1[k], b.cs[k] );
+			}
+		}
+		for ( j = 0; j < body->children.Num(); j++ ) {
+			child = body->children[j];
+			const AFTreeBlock_t &cb = blocks[child->treeIndex];
+			r = child->primaryConstraint->J1.GetNumRows();
+			for ( k = 0; k < r; k++ ) {
+				AF_MulAdd8( force, cb.cJ2[k], cb.cs[k] );
+			}
+		}
+
+		body->responseIndex[body->numResponses++] = auxiliaryIndex;
+	}
+}
+
+/*
+================
+idAFTree::CalculateForcesBlocks
+
+  calculate forces on the bodies in the tree using the block workspace
+================
+*/
+void idAFTree::CalculateForcesBlocks( float timeStep ) const {
+	int i, j, k, r;
+	float invStep;
+	idAFBody *body, *child;
+	idAFConstraint *c, *primaryConstraint;
+	ALIGN16( float force[8] );
+
+	invStep = 1.0f / timeStep;
+
+	// initialize right hand side
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		body = sortedBodies[i];
+		AFTreeBlock_t &b = blocks[i];
+
+		body->InverseWorldSpatialInertiaMultiply( body->acceleration, body->totalForce.ToFloatPtr() );
+		body->acceleration.SubVec6(0) += body->current->spatialVelocity * invStep;
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			// b = ( J * acc + c )
+			c = primaryConstraint;
+			AF_Zero8( b.cs );
+			for ( k = 0; k < c->J1.GetNumRows(); k++ ) {
+				b.cs[k] = AF_Dot6( b.cJ1[k], c->body1->acceleration.ToFloatPtr() ) +
+							AF_Dot6( b.cJ2[k], c->body2->acceleration.ToFloatPtr() ) + invStep * ( c->c1[k] + c->c2[k] );
+			}
+			c->fl.isZero = false;
+		}
+		AF_Zero8( b.s );
+		body->fl.isZero = true;
+	}
+
+	// solve for primary constraints
+	SolveBlocks( 0 );
+
+	// calculate forces on bodies after applying primary constraints
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		body = sortedBodies[i];
+
+		AF_Zero8( force );
+
+		// add forces of all primary constraints acting on this body
+		primaryConstraint = body->primaryConstraint;
+		if ( primaryConstraint ) {
+			const AFTreeBlock_t &b = blocks[i];
+			r = primaryConstraint->J1.GetNumRows();
+			for ( k = 0; k < r; k++ ) {
+				AF_MulAdd8( force, b.cJ1[k], b.cs[k] );
+			}
+		}
+		for ( j = 0; j < body->children.Num(); j++ ) {
+			child = body->children[j];
+			const AFTreeBlock_t &cb = blocks[child->treeIndex];
+			r = child->primaryConstraint->J1.GetNumRows();
+			for ( k = 0; k < r; k++ ) {
+				AF_MulAdd8( force, cb.cJ2[k], cb.cs[k] );
+			}
+		}
+
+		for ( k = 0; k < 6; k++ ) {
+			body->totalForce[k] += force[k];
+		}
+	}
+}
+
 /*
 ================
 idAFTree::SetMaxSubTreeAuxiliaryIndex
@@ -4832,6 +5375,10 @@ void idAFTree::SortBodies() {
 	sortedBodies.Clear();
 	sortedBodies.Append( body );
 	SortBodies_r( sortedBodies, body );
+
+	for ( i = 0; i < sortedBodies.Num(); i++ ) {
+		sortedBodies[i]->treeIndex = i;
+	}
 }
 
 /*
@@ -4873,7 +5420,9 @@ void idPhysics_AF::EvaluateConstraints( float timeStep ) {
 	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
 		c = primaryConstraints[i];
 		c->Evaluate( invTimeStep );
-		c->J = c->J2;
+		if ( !stepUseBlockSolver ) {
+			c->J = c->J2;
+		}
 	}
 	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
 		auxiliaryConstraints[i]->Evaluate( invTimeStep );
@@ -4884,6 +5433,11 @@ void idPhysics_AF::EvaluateConstraints( float timeStep ) {
 		AddFrameConstraint( contactConstraints[i] );
 	}
 
+	// the block solver copies the constraint matrices into its own workspace
+	if ( stepUseBlockSolver ) {
+		return;
+	}
+
 	// setup body primary constraint matrix
 	for ( i = 0; i < bodies.Num(); i++ ) {
 		body = bodies[i];
@@ -5023,7 +5577,7 @@ void idPhysics_AF::PrimaryFactor() {
 	int i;
 
 	for ( i = 0; i < trees.Num(); i++ ) {
-		trees[i]->Factor();
+		trees[i]->Factor( stepUseBlockSolver );
 	}
 }
 
@@ -5130,8 +5684,13 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 				while( l < m ) {
 					dstPtr[l++] = 0.0f;
 				}
-				dstPtr[l++] = j1[0] * ptr[0] + j1[1] * ptr[1] + j1[2] * ptr[2] +
-								j1[3] * ptr[3] + j1[4] * ptr[4] + j1[5] * ptr[5];
+				// the response forces are 16 byte aligned rows so the block solver uses SIMD here as well
+				if ( stepUseBlockSolver ) {
+					dstPtr[l++] = AF_Dot6( j1, ptr );
+				} else {
+					dstPtr[l++] = j1[0] * ptr[0] + j1[1] * ptr[1] + j1[2] * ptr[2] +
+									j1[3] * ptr[3] + j1[4] * ptr[4] + j1[5] * ptr[5];
+				}
 				ptr += 8;
 			}
 
@@ -5145,8 +5704,12 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 				ptr = constraint->body2->response;
 				index = constraint->body2->responseIndex;
 				for ( n = 0, m = index[n]; n < constraint->body2->numResponses && m < s; n++, m = index[n] ) {
-					dstPtr[m] += j2[0] * ptr[0] + j2[1] * ptr[1] + j2[2] * ptr[2] +
-										j2[3] * ptr[3] + j2[4] * ptr[4] + j2[5] * ptr[5];
+					if ( stepUseBlockSolver ) {
+						dstPtr[m] += AF_Dot6( j2, ptr );
+					} else {
+						dstPtr[m] += j2[0] * ptr[0] + j2[1] * ptr[1] + j2[2] * ptr[2] +
+											j2[3] * ptr[3] + j2[4] * ptr[4] + j2[5] * ptr[5];
+					}
 					ptr += 8;
 				}
 			}
@@ -5223,7 +5786,10 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Start();
+	const bool timings = idLib::IsMainThread();
+	if ( timings ) {
+		timer_lcp.Start();
+	}
 #endif
 
 	// calculate lagrange multipliers for auxiliary constraints
@@ -5232,7 +5798,9 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Stop();
+	if ( timings ) {
+		timer_lcp.Stop();
+	}
 #endif
 
 	// calculate auxiliary constraint forces
@@ -6214,10 +6782,13 @@ const idBounds &idPhysics_AF::GetAbsBounds( int id ) const {
 
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::BeginStep
+
+  Sets up the time step and the contact constraints.
+  Returns false if the simulation is suspended and no further phases should be run.
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+bool idPhysics_AF::BeginStep( int timeStepMSec, int endTimeMSec ) {
 	float timeStep;
 
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
@@ -6255,13 +6826,12 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		return false;
 	}
 
+	stepTimeStep = timeStep;
+	stepEndTime = endTimeMSec;
+
 	// move the af velocity into the frame of a pusher
 	AddPushVelocity( -current.pushVelocity );
 
-#ifdef AF_TIMINGS
-	timer_total.Start();
-#endif
-
 #ifdef AF_TIMINGS
 	timer_collision.Start();
 #endif
@@ -6276,24 +6846,53 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	timer_collision.Stop();
 #endif
 
+	stepNumFrameConstraints = frameConstraints.Num();
+
+	// save what SolveStep reads and overwrites so the solve can be restarted from the same state,
+	// the joint friction is set up from the multipliers and impulse friction changes the velocities
+	stepMultipliers.SetNum( 0 );
+	for ( int i = 0; i < constraints.Num(); i++ ) {
+		const idVecX &lm = constraints[i]->lm;
+		for ( int j = 0; j < lm.GetSize(); j++ ) {
+			stepMultipliers.Append( lm[j] );
+		}
+	}
+	stepVelocities.SetNum( bodies.Num() );
+	for ( int i = 0; i < bodies.Num(); i++ ) {
+		stepVelocities[i] = bodies[i]->current->spatialVelocity;
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SolveStep
+
+  Solves the constraint system and evolves the bodies to the next state.
+  Only touches the articulated figure itself so it may run on a job thread.
+================
+*/
+void idPhysics_AF::SolveStep() {
+	const float timeStep = stepTimeStep;
+
+	// read once so the whole solve uses the same solver even if the cvar changes meanwhile
+	stepUseBlockSolver = af_useBlockSolver.GetBool();
+
 	// evaluate constraint equations
 	EvaluateConstraints( timeStep );
 
 	// apply friction
-	ApplyFriction( timeStep, endTimeMSec );
+	ApplyFriction( timeStep, stepEndTime );
 
 	// add frame constraints
 	AddFrameConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
-	}
-	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	const bool timings = idLib::IsMainThread();
+	if ( timings ) {
+		timer_pc.Start();
 	}
-	timer_pc.Start();
 #endif
 
 	// factor matrices for primary constraints
@@ -6303,19 +6902,34 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	PrimaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
+	if ( timings ) {
+		timer_pc.Stop();
+		timer_ac.Start();
+	}
 #endif
 
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_ac.Stop();
+	if ( timings ) {
+		timer_ac.Stop();
+	}
 #endif
 
 	// evolve current state to next state
 	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::FinishStep
+
+  Checks for collisions between the current and next state and applies the collision impulses.
+================
+*/
+void idPhysics_AF::FinishStep() {
+	const float timeStep = stepTimeStep;
 
 	// debug graphics
 	DebugDraw();
@@ -6373,6 +6987,120 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 							self->name.c_str(), self->GetType()->classname, bodies[0]->current->worldOrigin.ToString(0) );
 		Rest();
 	}
+}
+
+/*
+================
+idPhysics_AF::CanSolveOnJobThread
+
+  Suspension constraints trace against the world while being evaluated.
+================
+*/
+bool idPhysics_AF::CanSolveOnJobThread() const {
+	int i;
+
+	for ( i = 0; i < constraints.Num(); i++ ) {
+		if ( constraints[i]->GetType() == CONSTRAINT_SUSPENSION ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SetIslandStepped
+
+  The physics island stage already ran the step ending at endTimeMSec,
+  the next Evaluate for that time only returns the result.
+================
+*/
+void idPhysics_AF::SetIslandStepped( int endTimeMSec, bool moved ) {
+	islandStepTime = endTimeMSec;
+	islandStepMoved = moved;
+}
+
+/*
+================
+idPhysics_AF::RestartSolveStep
+
+  Undoes the changes SolveStep makes to the constraint lists, the constraint
+  multipliers, the body velocities and the auxiliary forces so the solve can be
+  run again from the same state.
+================
+*/
+void idPhysics_AF::RestartSolveStep() {
+	int i, j, k;
+
+	auxiliaryConstraints.SetNum( auxiliaryConstraints.Num() - frameConstraints.Num() );
+	frameConstraints.SetNum( stepNumFrameConstraints );
+
+	for ( k = 0, i = 0; i < constraints.Num(); i++ ) {
+		idVecX &lm = constraints[i]->lm;
+		for ( j = 0; j < lm.GetSize(); j++, k++ ) {
+			lm[j] = stepMultipliers[k];
+		}
+	}
+	assert( k == stepMultipliers.Num() );
+
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		bodies[i]->current->spatialVelocity = stepVelocities[i];
+		bodies[i]->auxForce.Zero();
+	}
+}
+
+/*
+================
+idPhysics_AF::GetNextStates
+
+  Appends the state of the bodies calculated by SolveStep.
+================
+*/
+void idPhysics_AF::GetNextStates( idList<AFBodyPState_t> &states ) const {
+	int i;
+
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		states.Append( *bodies[i]->next );
+	}
+}
+
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+
+	if ( islandStepTime == endTimeMSec ) {
+		islandStepTime = -1;
+		return islandStepMoved;
+	}
+	islandStepTime = -1;
+
+#ifdef AF_TIMINGS
+	timer_total.Start();
+#endif
+
+	if ( !BeginStep( timeStepMSec, endTimeMSec ) ) {
+#ifdef AF_TIMINGS
+		timer_total.Stop();
+#endif
+		return false;
+	}
+
+	SolveStep();
+
+#ifdef AF_TIMINGS
+	int i, numPrimary = 0, numAuxiliary = 0;
+	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
+		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+	}
+	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	}
+#endif
+
+	FinishStep();
 
 #ifdef AF_TIMINGS
 	timer_total.Stop();
@@ -6602,6 +7330,13 @@ idPhysics_AF::idPhysics_AF() {
 
 	lcp = idLCP::AllocSymmetric();
 
+	stepTimeStep = 0.0f;
+	stepEndTime = 0;
+	stepNumFrameConstraints = 0;
+	stepUseBlockSolver = false;
+	islandStepTime = -1;
+	islandStepMoved = false;
+
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
 	current.lastTimeStep = 0.0f;
@@ -753,6 +753,7 @@ private:
 	int						numResponses;				// number of response forces
 	int						maxAuxiliaryIndex;			// largest index of an auxiliary constraint constraining this body
 	int						maxSubTreeAuxiliaryIndex;	// largest index of an auxiliary constraint constraining this body or one of it's children
+	int						treeIndex;					// index of the body in the sorted tree body list
 
 	struct bodyFlags_s {
 		bool				clipMaskSet			: 1;	// true if this body has a clip mask set
@@ -771,11 +772,27 @@ private:
 //
 //===============================================================
 
+// solver workspace for a body and the primary constraint attaching it to its parent
+// all rows are padded to 8 floats with zeros so the row operations can be done with SIMD
+typedef struct AFTreeBlock_s {
+	float					I[6][8];					// transformed inertia
+	float					invI[6][8];					// inverse transformed inertia
+	float					J[6][8];					// transformed body constraint matrix, stored transposed
+	float					s[8];						// body temp solution
+	float					cJ1[6][8];					// primary constraint matrix for this body
+	float					cJ2[6][8];					// primary constraint matrix for the parent
+	float					cInvI[6][8];				// primary constraint transformed inertia
+	float					cJ[6][8];					// primary constraint transformed matrix
+	float					cs[8];						// primary constraint temp solution
+} AFTreeBlock_t;
+
 class idAFTree {
 	friend class idPhysics_AF;
 
 public:
-	void					Factor() const;
+							idAFTree();
+
+	void					Factor( bool useBlockSolver ) const;
 	void					Solve( int auxiliaryIndex = 0 ) const;
 	void					Response( const idAFConstraint *constraint, int row, int auxiliaryIndex ) const;
 	void					CalculateForces( float timeStep ) const;
@@ -786,6 +803,15 @@ public:
 
 private:
 	idList<idAFBody *, TAG_IDLIB_LIST_PHYSICS>		sortedBodies;
+
+							// block solver, set up by Factor and reused every step
+	mutable idList<AFTreeBlock_t, TAG_IDLIB_LIST_PHYSICS> blocks;
+	mutable bool			useBlocks;					// true if the last Factor filled the blocks
+
+	void					FactorBlocks() const;
+	void					SolveBlocks( int auxiliaryIndex ) const;
+	void					ResponseBlocks( const idAFConstraint *constraint, int row, int auxiliaryIndex ) const;
+	void					CalculateForcesBlocks( float timeStep ) const;
 };
 
 
@@ -946,6 +972,16 @@ public:	// common physics interface
 
 	bool					EvaluateContacts();
 
+							// Evaluate split into phases so the constraint solve can run on a job thread,
+							// only SolveStep is thread safe, BeginStep and FinishStep trace and touch the world
+	bool					BeginStep( int timeStepMSec, int endTimeMSec );
+	void					SolveStep();
+	void					FinishStep();
+	bool					CanSolveOnJobThread() const;
+	void					SetIslandStepped( int endTimeMSec, bool moved );
+	void					RestartSolveStep();
+	void					GetNextStates( idList<AFBodyPState_t> &states ) const;
+
 	void					SetPushed( int deltaTime );
 	const idVec3 &			GetPushedLinearVelocity( const int id = 0 ) const;
 	const idVec3 &			GetPushedAngularVelocity( const int id = 0 ) const;
@@ -1016,6 +1052,15 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+	float					stepTimeStep;					// time step between BeginStep and FinishStep
+	int						stepEndTime;					// end time between BeginStep and FinishStep
+	int						stepNumFrameConstraints;		// number of frame constraints before SolveStep
+	bool					stepUseBlockSolver;				// af_useBlockSolver as read by SolveStep
+	idList<float, TAG_IDLIB_LIST_PHYSICS>	stepMultipliers;	// constraint multipliers before SolveStep
+	idList<idVec6, TAG_IDLIB_LIST_PHYSICS>	stepVelocities;		// body velocities before SolveStep
+	int						islandStepTime;					// end time of a step already run by the physics island stage
+	bool					islandStepMoved;				// result of that step
+
 private:
 	void					BuildTrees();
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
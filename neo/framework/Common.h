@@ -193,6 +193,9 @@ public:
 	virtual void				UpdateScreen( bool captureToImage ) = 0;
 
 	virtual void				UpdateLevelLoadPacifier() = 0;
+
+								// Records how long a stage of the current level load took, listed by printLevelLoadTimes.
+	virtual void				AddLevelLoadTime( const char * stage, int msec ) = 0;
 	
 
 								// Checks for and removes command line "+set var arg" constructs.
@@ -245,6 +245,9 @@ Exits with mapSpawned = false
 void idCommonLocal::UnloadMap() {
 	StopPlayingRenderDemo();
 
+	// the game unloads the map resource container
+	renderSystem->SuspendImageStreaming();
+
 	// end the current map in the game
 	if ( game ) {
 		game->MapShutdown();
@@ -423,6 +426,7 @@ void idCommonLocal::ExecuteMapChange() {
 	}
 
 	int start = Sys_Milliseconds();
+	levelLoadTimes.Clear();
 
 	for ( int i = 0; i < MAX_INPUT_DEVICES; i++ ) {
 		Sys_SetRumble( i, 0, 0 );
@@ -445,6 +449,8 @@ void idCommonLocal::ExecuteMapChange() {
 	fullMapName += currentMapName;
 	fullMapName.SetFileExtension( "map" );
 
+	renderSystem->SuspendImageStreaming();
+
 	if ( mapSpawnData.savegameFile ) {
 		fileSystem->BeginLevelLoad( currentMapName, NULL, 0 );
 	} else {
@@ -462,6 +468,7 @@ void idCommonLocal::ExecuteMapChange() {
 	UnloadMap();
 	int ms = Sys_Milliseconds() - sm;
 	common->Printf( "%6d msec to unload map\n", ms );
+	AddLevelLoadTime( "unload map", ms );
 
 	// Free media from previous level and
 	// note which media we are going to need to load
@@ -472,6 +479,7 @@ void idCommonLocal::ExecuteMapChange() {
 	uiManager->BeginLevelLoad();
 	ms = Sys_Milliseconds() - sm;
 	common->Printf( "%6d msec to free assets\n", ms );
+	AddLevelLoadTime( "free assets", ms );
 
 	//Sys_DumpMemory( true );
 
@@ -484,6 +492,7 @@ void idCommonLocal::ExecuteMapChange() {
 	ClearWipe();
 
 
+	sm = Sys_Milliseconds();
 	if ( fileSystem->UsingResourceFiles() ) {
 		idStrStatic< MAX_OSPATH > manifestName = currentMapName;
 		manifestName.Replace( "game/", "maps/" );
@@ -495,6 +504,7 @@ void idCommonLocal::ExecuteMapChange() {
 		soundSystem->Preload( manifest );
 		game->Preload( manifest );
 	}
+	AddLevelLoadTime( "preload", Sys_Milliseconds() - sm );
 
 	if ( common->IsMultiplayer() ) {
 		// In multiplayer, make sure the player is either 60Hz or 120Hz
@@ -516,15 +526,18 @@ void idCommonLocal::ExecuteMapChange() {
 	Sys_GrabMouseCursor( false );
 
 	// let the renderSystem load all the geometry
+	sm = Sys_Milliseconds();
 	if ( !renderWorld->InitFromMap( fullMapName ) ) {
 		common->Error( "couldn't load %s", fullMapName.c_str() );
 	}
+	AddLevelLoadTime( "render world", Sys_Milliseconds() - sm );
 
 	// for the synchronous networking we needed to roll the angles over from
 	// level to level, but now we can just clear everything
 	usercmdGen->InitForNewMap();
 
 	// load and spawn all other entities ( from a savegame possibly )
+	sm = Sys_Milliseconds();
 	if ( mapSpawnData.savegameFile ) {
 		if ( !game->InitFromSaveGame( fullMapName, renderWorld, soundWorld, mapSpawnData.savegameFile, mapSpawnData.stringTableFile, mapSpawnData.savegameVersion ) ) {
 			// If the loadgame failed, end the session, which will force us to go back to the main menu
@@ -541,12 +554,15 @@ void idCommonLocal::ExecuteMapChange() {
 		game->InitFromNewMap( fullMapName, renderWorld, soundWorld, matchParameters.gameMode, Sys_Milliseconds() );
 	}
 
+	AddLevelLoadTime( "game spawn", Sys_Milliseconds() - sm );
+
 	game->Shell_CreateMenu( true );
 
 	// Reset some values important to multiplayer
 	ResetNetworkingState();
 
 	// If the session state is not loading here, something went wrong.
+	sm = Sys_Milliseconds();
 	if ( session->GetState() == idSession::LOADING && session->GetLoadingID() == cachedLoadingID ) {
 		// Notify session we are done loading
 		session->LoadingFinished();
@@ -558,6 +574,7 @@ void idCommonLocal::ExecuteMapChange() {
 			Sys_Sleep( 10 );
 		}
 	}
+	AddLevelLoadTime( "session", Sys_Milliseconds() - sm );
 
 	if ( !mapSpawnData.savegameFile ) {
 		// run a single frame to catch any resources that are referenced by events posted in spawn
@@ -573,12 +590,15 @@ void idCommonLocal::ExecuteMapChange() {
 		}
 	}
 
+	sm = Sys_Milliseconds();
 	renderSystem->EndLevelLoad();
 	soundSystem->EndLevelLoad();
 	declManager->EndLevelLoad();
 	uiManager->EndLevelLoad( currentMapName );
 	fileSystem->EndLevelLoad();
+	AddLevelLoadTime( "end level load", Sys_Milliseconds() - sm );
 
+	sm = Sys_Milliseconds();
 	if ( !mapSpawnData.savegameFile && !IsMultiplayer() ) {
 		common->Printf( "----- Running initial game frames -----\n" );
 
@@ -596,11 +616,14 @@ void idCommonLocal::ExecuteMapChange() {
 		common->Printf( "----- Saving Game -----\n" );
 		SaveGame( "autosave" );
 	}
+	AddLevelLoadTime( "initial frames", Sys_Milliseconds() - sm );
 
 	common->Printf( "----- Generating Interactions -----\n" );
 
 	// let the renderSystem generate interactions now that everything is spawned
+	sm = Sys_Milliseconds();
 	renderWorld->GenerateAllInteractions();
+	AddLevelLoadTime( "interactions", Sys_Milliseconds() - sm );
 
 	{
 		int vertexMemUsedKB = vertexCache.staticData.vertexMemUsed.GetValue() / 1024;
@@ -651,12 +674,45 @@ void idCommonLocal::ExecuteMapChange() {
 
 	int	msec = Sys_Milliseconds() - start;
 	common->Printf( "%6d msec to load %s\n", msec, currentMapName.c_str() );
+	AddLevelLoadTime( "total", msec );
 	//Sys_DumpMemory( false );	
 
 	// Issue a render at the very end of the load process to update soundTime before the first frame
 	soundSystem->Render();
 }
 
+/*
+===============
+idCommonLocal::AddLevelLoadTime
+
+The stage name must be a static string, it is kept until the next level load.
+===============
+*/
+void idCommonLocal::AddLevelLoadTime( const char * stage, int msec ) {
+	levelLoadTime_t * time = levelLoadTimes.Alloc();
+	if ( time == NULL ) {
+		return;
+	}
+	time->stage = stage;
+	time->msec = msec;
+}
+
+/*
+===============
+idCommonLocal::PrintLevelLoadTimes
+===============
+*/
+void idCommonLocal::PrintLevelLoadTimes() const {
+	if ( levelLoadTimes.Num() == 0 ) {
+		common->Printf( "No level has been loaded.\n" );
+		return;
+	}
+	common->Printf( "Level load times for %s:\n", currentMapName.c_str() );
+	for ( int i = 0; i < levelLoadTimes.Num(); i++ ) {
+		common->Printf( "%6d msec %s\n", levelLoadTimes[i].msec, levelLoadTimes[i].stage );
+	}
+}
+
 /*
 ===============
 idCommonLocal::UpdateLevelLoadPacifier
@@ -1184,6 +1240,15 @@ CONSOLE_COMMAND_SHIP( netmap, "loads a map in multiplayer mode", idCmdSystem::Ar
 	commonLocal.StartNewGame( args.Argv(1), true, gameMode );
 }
 
+/*
+==================
+Common_PrintLevelLoadTimes_f
+==================
+*/
+CONSOLE_COMMAND( printLevelLoadTimes, "prints how long each stage of the last level load took", NULL ) {
+	commonLocal.PrintLevelLoadTimes();
+}
+
 /*
 ==================
 Common_TestMap_f
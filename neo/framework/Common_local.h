@@ -125,6 +125,7 @@ public:
 	virtual void				Frame();
 	virtual void				UpdateScreen( bool captureToImage );
 	virtual void				UpdateLevelLoadPacifier();
+	virtual void				AddLevelLoadTime( const char * stage, int msec );
 	virtual void				StartupVariable( const char * match );
 	virtual void				WriteConfigToFile( const char *filename );
 	virtual void				BeginRedirect( char *buffer, int buffersize, void (*flush)( const char * ) );
@@ -244,6 +245,8 @@ public:	// These are public because they are called directly by static functions
 
 	idUserCmdMgr & GetUCmdMgr() { return userCmdMgr; }
 
+	void	PrintLevelLoadTimes() const;
+
 private:
 	bool						com_fullyInitialized;
 	bool						com_refreshOnPrint;		// update the screen every print for dmap
@@ -385,6 +388,12 @@ private:
 	bool				defaultLoadscreen;
 	idStaticList<int, LOAD_TIP_COUNT>	loadTipList;
 
+	struct levelLoadTime_t {
+		const char *	stage;			// static string
+		int				msec;
+	};
+	idStaticList<levelLoadTime_t, 32>	levelLoadTimes;
+
 	const idMaterial *	splashScreen;
 
 	const idMaterial *	whiteMaterial;
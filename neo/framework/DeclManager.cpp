@@ -233,7 +233,7 @@ private:
 	idList<idDeclFolder *, TAG_IDLIB_LIST_DECL>		declFolders;
 
 	idList<idDeclFile *, TAG_IDLIB_LIST_DECL>		loadedFiles;
-	idHashIndex					hashTables[DECL_MAX_TYPES];
+	idFlatHashMap<const char *, int>				hashTables[DECL_MAX_TYPES];	// keyed on the name of the decl, indexes linearLists
 	idList<idDeclLocal *, TAG_IDLIB_LIST_DECL>		linearLists[DECL_MAX_TYPES];
 	idDeclFile					implicitDecls;	// this holds all the decls that were created because explicit
 												// text definitions were not found. Decls that became default
@@ -541,6 +541,371 @@ void ConvertPDAsToStrings_f( const idCmdArgs &args ) {
 	declManagerLocal.ConvertPDAsToStrings( args );
 }
 
+/*
+====================================================================================
+
+ Hash map benchmark
+
+====================================================================================
+*/
+
+struct hashMapTimes_t {
+	uint64		insert;
+	uint64		lookupHit;
+	uint64		lookupMiss;
+	uint64		erase;
+	bool		valid;
+};
+
+/*
+================
+HashMapTest_CollectKeys
+
+Gathers the decl names of all types, the dictionary keys of all entityDefs and the
+image, model and sound names of all map preload manifests, the largest string tables
+that are looked up at run time.
+================
+*/
+static void HashMapTest_CollectKeys( idStrList & keys ) {
+	idFlatHashMap< idStr, int > unique;
+	for ( int type = 0; type < declManager->GetNumDeclTypes(); type++ ) {
+		if ( declManagerLocal.GetDeclType( type ) == NULL ) {
+			continue;
+		}
+		const int numDecls = declManager->GetNumDecls( (declType_t)type );
+		for ( int i = 0; i < numDecls; i++ ) {
+			unique.Set( declManager->DeclByIndex( (declType_t)type, i, false )->GetName(), 0 );
+		}
+	}
+	const int numEntityDefs = declManager->GetNumDecls( DECL_ENTITYDEF );
+	for ( int i = 0; i < numEntityDefs; i++ ) {
+		const idDeclEntityDef * entityDef = static_cast<const idDeclEntityDef *>( declManager->DeclByIndex( DECL_ENTITYDEF, i, false ) );
+		for ( int j = 0; j < entityDef->dict.GetNumKeyVals(); j++ ) {
+			unique.Set( entityDef->dict.GetKeyVal( j )->GetKey(), 0 );
+		}
+	}
+	idFileList * manifests = fileSystem->ListFilesTree( "maps", ".preload" );
+	for ( int i = 0; i < manifests->GetNumFiles(); i++ ) {
+		idPreloadManifest manifest;
+		if ( !manifest.LoadManifest( manifests->GetFile( i ) ) ) {
+			continue;
+		}
+		for ( int j = 0; j < manifest.NumResources(); j++ ) {
+			unique.Set( manifest.GetResourceNameByIndex( j ), 0 );
+		}
+	}
+	fileSystem->FreeFileList( manifests );
+	keys.SetNum( 0 );
+	keys.Resize( unique.Num() );
+	for ( int i = unique.First(); i != unique.NULL_SLOT; i = unique.Next( i ) ) {
+		keys.Append( unique.GetKey( i ) );
+	}
+}
+
+/*
+================
+HashMapTest_LoadKeys
+================
+*/
+static bool HashMapTest_LoadKeys( const char * fileName, idStrList & keys ) {
+	char * buffer = NULL;
+	if ( fileSystem->ReadFile( fileName, (void **)&buffer ) < 0 ) {
+		return false;
+	}
+	idFlatHashMap< idStr, int > unique;
+	keys.SetNum( 0 );
+	for ( const char * line = buffer; *line != '\0'; ) {
+		const char * end = line;
+		while ( *end != '\0' && *end != '\n' && *end != '\r' ) {
+			end++;
+		}
+		if ( end > line ) {
+			idStr key( line, 0, (int)( end - line ) );
+			if ( !unique.Get( key ) ) {
+				unique.Set( key, 0 );
+				keys.Append( key );
+			}
+		}
+		line = ( *end != '\0' ) ? end + 1 : end;
+	}
+	fileSystem->FreeFile( buffer );
+	return true;
+}
+
+/*
+================
+HashMapTest_Run
+
+Times the key-value containers that share the Set / Get / Remove interface.
+================
+*/
+template< class _map_ >
+static void HashMapTest_Run( const idStrList & keys, const idStrList & missingKeys, const idList<int> & order, hashMapTimes_t & times ) {
+	_map_ map;
+	int found = 0;
+
+	uint64 start = Sys_Microseconds();
+	for ( int i = 0; i < keys.Num(); i++ ) {
+		map.Set( keys[i], i );
+	}
+	times.insert = Min( times.insert, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		int * value;
+		if ( map.Get( keys[order[i]], &value ) && *value == order[i] ) {
+			found++;
+		}
+	}
+	times.lookupHit = Min( times.lookupHit, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		if ( map.Get( missingKeys[order[i]] ) ) {
+			found++;
+		}
+	}
+	times.lookupMiss = Min( times.lookupMiss, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		map.Remove( keys[order[i]] );
+	}
+	times.erase = Min( times.erase, Sys_Microseconds() - start );
+
+	times.valid &= ( found == keys.Num() && map.Num() == 0 );
+}
+
+/*
+================
+HashMapTest_RunHashIndex
+
+Times the idHashIndex pattern of hashing into a separate list of keys.
+================
+*/
+static void HashMapTest_RunHashIndex( const idStrList & keys, const idStrList & missingKeys, const idList<int> & order, hashMapTimes_t & times ) {
+	idHashIndex hash;
+	int found = 0;
+
+	uint64 start = Sys_Microseconds();
+	for ( int i = 0; i < keys.Num(); i++ ) {
+		hash.Add( idStr::IHash( keys[i] ), i );
+	}
+	times.insert = Min( times.insert, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		const char * key = keys[order[i]];
+		for ( int j = hash.First( idStr::IHash( key ) ); j != -1; j = hash.Next( j ) ) {
+			if ( keys[j].Icmp( key ) == 0 ) {
+				found += ( j == order[i] );
+				break;
+			}
+		}
+	}
+	times.lookupHit = Min( times.lookupHit, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		const char * key = missingKeys[order[i]];
+		for ( int j = hash.First( idStr::IHash( key ) ); j != -1; j = hash.Next( j ) ) {
+			if ( keys[j].Icmp( key ) == 0 ) {
+				found++;
+				break;
+			}
+		}
+	}
+	times.lookupMiss = Min( times.lookupMiss, Sys_Microseconds() - start );
+
+	start = Sys_Microseconds();
+	for ( int i = 0; i < order.Num(); i++ ) {
+		hash.Remove( idStr::IHash( keys[order[i]] ), order[i] );
+	}
+	times.erase = Min( times.erase, Sys_Microseconds() - start );
+
+	times.valid &= ( found == keys.Num() );
+}
+
+/*
+================
+HashMapTest_Print
+================
+*/
+static void HashMapTest_Print( const char * name, const hashMapTimes_t & times, const int numKeys ) {
+	const float scale = 1000.0f / numKeys;
+	common->Printf( "%-28s %7.1f %7.1f %7.1f %7.1f  %s\n", name,
+						times.insert * scale, times.lookupHit * scale, times.lookupMiss * scale, times.erase * scale,
+						times.valid ? "ok" : "X" );
+}
+
+/*
+================
+TestHashMaps_f
+================
+*/
+CONSOLE_COMMAND( testHashMaps, "compares idHashIndex, idHashTableT and the flat hash maps on the decl, dict and resource keys, usage: testHashMaps [keyFile] [iterations]", NULL ) {
+	idStrList keys;
+	if ( args.Argc() > 1 ) {
+		if ( !HashMapTest_LoadKeys( args.Argv( 1 ), keys ) ) {
+			common->Printf( "couldn't read '%s'\n", args.Argv( 1 ) );
+			return;
+		}
+	} else {
+		HashMapTest_CollectKeys( keys );
+	}
+	if ( keys.Num() == 0 ) {
+		common->Printf( "no keys\n" );
+		return;
+	}
+	const int numIterations = Max( ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 10, 1 );
+
+	idStrList missingKeys;
+	missingKeys.SetNum( keys.Num() );
+	for ( int i = 0; i < keys.Num(); i++ ) {
+		missingKeys[i] = keys[i] + "_missing";
+	}
+
+	// lookups and erases happen in a random order
+	idRandom random( 0 );
+	idList<int> order;
+	order.SetNum( keys.Num() );
+	for ( int i = 0; i < order.Num(); i++ ) {
+		order[i] = i;
+	}
+	for ( int i = order.Num() - 1; i > 0; i-- ) {
+		const int j = ( ( random.RandomInt() << 15 ) | random.RandomInt() ) % ( i + 1 );
+		SwapValues( order[i], order[j] );
+	}
+
+	hashMapTimes_t times[5];
+	for ( int i = 0; i < 5; i++ ) {
+		times[i].insert = times[i].lookupHit = times[i].lookupMiss = times[i].erase = (uint64)-1;
+		times[i].valid = true;
+	}
+
+	for ( int i = 0; i < numIterations; i++ ) {
+		HashMapTest_RunHashIndex( keys, missingKeys, order, times[0] );
+		HashMapTest_Run< idHashTableT< idStr, int > >( keys, missingKeys, order, times[1] );
+		HashMapTest_Run< idFlatHashMap< idStr, int > >( keys, missingKeys, order, times[2] );
+		HashMapTest_Run< idOrderedFlatHashMap< idStr, int > >( keys, missingKeys, order, times[3] );
+		// the decl manager tables point at the names of the decls instead of copying them
+		HashMapTest_Run< idFlatHashMap< const char *, int > >( keys, missingKeys, order, times[4] );
+	}
+
+	common->Printf( "%d keys, best of %d iterations, nanoseconds per key\n", keys.Num(), numIterations );
+	common->Printf( "%-28s %7s %7s %7s %7s\n", "", "insert", "hit", "miss", "erase" );
+	HashMapTest_Print( "idHashIndex", times[0], keys.Num() );
+	HashMapTest_Print( "idHashTableT", times[1], keys.Num() );
+	HashMapTest_Print( "idFlatHashMap", times[2], keys.Num() );
+	HashMapTest_Print( "idOrderedFlatHashMap", times[3], keys.Num() );
+	HashMapTest_Print( "idFlatHashMap<const char *>", times[4], keys.Num() );
+}
+
+/*
+================
+DumpHashMapKeys_f
+================
+*/
+CONSOLE_COMMAND( dumpHashMapKeys, "writes the decl, dict and resource keys used by testHashMaps to a file, usage: dumpHashMapKeys <keyFile>", NULL ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: dumpHashMapKeys <keyFile>\n" );
+		return;
+	}
+	idStrList keys;
+	HashMapTest_CollectKeys( keys );
+	idFile * file = fileSystem->OpenFileWrite( args.Argv( 1 ) );
+	if ( file == NULL ) {
+		common->Printf( "couldn't open '%s'\n", args.Argv( 1 ) );
+		return;
+	}
+	for ( int i = 0; i < keys.Num(); i++ ) {
+		file->Printf( "%s\n", keys[i].c_str() );
+	}
+	fileSystem->CloseFile( file );
+	common->Printf( "wrote %d keys to %s\n", keys.Num(), args.Argv( 1 ) );
+}
+
+/*
+====================================================================================
+
+ Dict lookup benchmark
+
+====================================================================================
+*/
+
+// the keys read while spawning an entity
+static const idDictKey dictTestKeys[] = {
+	idDictKey( "classname" ), idDictKey( "name" ), idDictKey( "model" ), idDictKey( "skin" ),
+	idDictKey( "shader" ), idDictKey( "origin" ), idDictKey( "rotation" ), idDictKey( "angle" ),
+	idDictKey( "_color" ), idDictKey( "shaderParm3" ), idDictKey( "shaderParm4" ), idDictKey( "shaderParm5" ),
+	idDictKey( "shaderParm6" ), idDictKey( "shaderParm7" ), idDictKey( "noDynamicInteractions" ), idDictKey( "noshadows" ),
+	idDictKey( "noselfshadows" ), idDictKey( "gui" ), idDictKey( "noGrab" ), idDictKey( "skin_xray" ),
+	idDictKey( "cameraTarget" ), idDictKey( "solidForTeam" ), idDictKey( "neverDormant" ), idDictKey( "hide" ),
+	idDictKey( "cinematic" ), idDictKey( "networkSync" ), idDictKey( "health" ), idDictKey( "bind" ),
+	idDictKey( "scriptobject" ), idDictKey( "slowmo" ), idDictKey( "spawnclass" ), idDictKey( "mass" )
+};
+
+/*
+================
+TestDictLookups_f
+================
+*/
+CONSOLE_COMMAND( testDictLookups, "compares spawn arg lookups by string and by interned key on all entityDefs, usage: testDictLookups [iterations]", NULL ) {
+	const int numIterations = Max( ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 10, 1 );
+	const int numKeys = sizeof( dictTestKeys ) / sizeof( dictTestKeys[0] );
+
+	idList< const idDict * > dicts;
+	const int numEntityDefs = declManager->GetNumDecls( DECL_ENTITYDEF );
+	for ( int i = 0; i < numEntityDefs; i++ ) {
+		const idDeclEntityDef * entityDef = static_cast<const idDeclEntityDef *>( declManager->DeclByIndex( DECL_ENTITYDEF, i, true ) );
+		dicts.Append( &entityDef->dict );
+	}
+	if ( dicts.Num() == 0 ) {
+		common->Printf( "no entityDefs\n" );
+		return;
+	}
+
+	uint64 stringTime = (uint64)-1;
+	uint64 internedTime = (uint64)-1;
+	int numFound[2] = { 0, 0 };
+	bool valid = true;
+	for ( int iteration = 0; iteration < numIterations; iteration++ ) {
+		numFound[0] = numFound[1] = 0;
+
+		uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < dicts.Num(); i++ ) {
+			for ( int j = 0; j < numKeys; j++ ) {
+				if ( dicts[i]->FindKey( dictTestKeys[j].c_str() ) != NULL ) {
+					numFound[0]++;
+				}
+			}
+		}
+		stringTime = Min( stringTime, Sys_Microseconds() - start );
+
+		start = Sys_Microseconds();
+		for ( int i = 0; i < dicts.Num(); i++ ) {
+			for ( int j = 0; j < numKeys; j++ ) {
+				if ( dicts[i]->FindKey( dictTestKeys[j] ) != NULL ) {
+					numFound[1]++;
+				}
+			}
+		}
+		internedTime = Min( internedTime, Sys_Microseconds() - start );
+	}
+
+	// both paths have to find the same key/value pairs
+	for ( int i = 0; i < dicts.Num(); i++ ) {
+		for ( int j = 0; j < numKeys; j++ ) {
+			valid &= ( dicts[i]->FindKey( dictTestKeys[j].c_str() ) == dicts[i]->FindKey( dictTestKeys[j] ) );
+		}
+	}
+
+	const int numLookups = dicts.Num() * numKeys;
+	common->Printf( "%d entityDefs, %d keys, %d hits, best of %d iterations\n", dicts.Num(), numKeys, numFound[0], numIterations );
+	common->Printf( "string   %10.0f lookups/sec\n", numLookups / ( Max( stringTime, (uint64)1 ) * 1e-6 ) );
+	common->Printf( "interned %10.0f lookups/sec%s\n", numLookups / ( Max( internedTime, (uint64)1 ) * 1e-6 ), ( valid && numFound[0] == numFound[1] ) ? "" : " MISMATCH" );
+}
+
 /*
 ====================================================================================
 
@@ -1368,7 +1733,7 @@ idDeclManagerLocal::CreateNewDecl
 */
 idDecl *idDeclManagerLocal::CreateNewDecl( declType_t type, const char *name, const char *_fileName ) {
 	int typeIndex = (int)type;
-	int i, hash;
+	int i, *index;
 
 	if ( typeIndex < 0 || typeIndex >= declTypes.Num() || declTypes[typeIndex] == NULL || typeIndex >= DECL_MAX_TYPES ) {
 		common->FatalError( "idDeclManager::CreateNewDecl: bad type: %i", typeIndex );
@@ -1383,12 +1748,9 @@ idDecl *idDeclManagerLocal::CreateNewDecl( declType_t type, const char *name, co
 	fileName.BackSlashesToSlashes();
 
 	// see if it already exists
-	hash = hashTables[typeIndex].GenerateKey( canonicalName, false );
-	for ( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) ) {
-		if ( linearLists[typeIndex][i]->name.Icmp( canonicalName ) == 0 ) {
-			linearLists[typeIndex][i]->AllocateSelf();
-			return linearLists[typeIndex][i]->self;
-		}
+	if ( hashTables[typeIndex].Get( canonicalName, &index ) ) {
+		linearLists[typeIndex][*index]->AllocateSelf();
+		return linearLists[typeIndex][*index]->self;
 	}
 
 	idDeclFile *sourceFile;
@@ -1437,8 +1799,8 @@ idDecl *idDeclManagerLocal::CreateNewDecl( declType_t type, const char *name, co
 	sourceFile->decls = decl;
 
 	// add it to the hash table and linear list
-	decl->index = linearLists[typeIndex].Num();
-	hashTables[typeIndex].Add( hash, linearLists[typeIndex].Append( decl ) );
+	decl->index = linearLists[typeIndex].Append( decl );
+	hashTables[typeIndex].Set( decl->name.c_str(), decl->index );
 
 	return decl->self;
 }
@@ -1460,33 +1822,20 @@ bool idDeclManagerLocal::RenameDecl( declType_t type, const char* oldName, const
 
 	// make sure it already exists
 	int typeIndex = (int)type;
-	int i, hash;
-	hash = hashTables[typeIndex].GenerateKey( canonicalOldName, false );
-	for ( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) ) {
-		if ( linearLists[typeIndex][i]->name.Icmp( canonicalOldName ) == 0 ) {
-			decl = linearLists[typeIndex][i];
-			break;
-		}
-	}
-	if(!decl)
+	int *index;
+	if ( !hashTables[typeIndex].Get( canonicalOldName, &index ) ) {
 		return false;
+	}
+	decl = linearLists[typeIndex][*index];
 
-	//if ( !hashTables[(int)type].Get( canonicalOldName, &declPtr ) )
-	//	return false;
-
-	//decl = *declPtr;
+	// the key points at the name of the decl, so remove it before the name changes
+	hashTables[typeIndex].Remove( canonicalOldName );
 
 	//Change the name
 	decl->name = canonicalNewName;
 
-
 	// add it to the hash table
-	//hashTables[(int)decl->type].Set( decl->name, decl );
-	int newhash = hashTables[typeIndex].GenerateKey( canonicalNewName, false );
-	hashTables[typeIndex].Add( newhash, decl->index );
-
-	//Remove the old hash item
-	hashTables[typeIndex].Remove(hash, decl->index);
+	hashTables[typeIndex].Set( decl->name.c_str(), decl->index );
 
 	return true;
 }
@@ -1726,7 +2075,7 @@ This finds or creats the decl, but does not cause a parse.  This is only used in
 */
 idDeclLocal *idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const char *name, bool makeDefault ) {
 	int typeIndex = (int)type;
-	int i, hash;
+	int *index;
 
 	if ( typeIndex < 0 || typeIndex >= declTypes.Num() || declTypes[typeIndex] == NULL || typeIndex >= DECL_MAX_TYPES ) {
 		common->FatalError( "idDeclManager::FindTypeWithoutParsing: bad type: %i", typeIndex );
@@ -1738,15 +2087,12 @@ idDeclLocal *idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	MakeNameCanonical( name, canonicalName, sizeof( canonicalName ) );
 
 	// see if it already exists
-	hash = hashTables[typeIndex].GenerateKey( canonicalName, false );
-	for ( i = hashTables[typeIndex].First( hash ); i >= 0; i = hashTables[typeIndex].Next( i ) ) {
-		if ( linearLists[typeIndex][i]->name.Icmp( canonicalName ) == 0 ) {
-			// only print these when decl_show is set to 2, because it can be a lot of clutter
-			if ( decl_show.GetInteger() > 1 ) {
-				MediaPrint( "referencing %s %s\n", declTypes[ type ]->typeName.c_str(), name );
-			}
-			return linearLists[typeIndex][i];
+	if ( hashTables[typeIndex].Get( canonicalName, &index ) ) {
+		// only print these when decl_show is set to 2, because it can be a lot of clutter
+		if ( decl_show.GetInteger() > 1 ) {
+			MediaPrint( "referencing %s %s\n", declTypes[ type ]->typeName.c_str(), name );
 		}
+		return linearLists[typeIndex][*index];
 	}
 
 	if ( !makeDefault ) {
@@ -1766,8 +2112,8 @@ idDeclLocal *idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	decl->parsedOutsideLevelLoad = !insideLevelLoad;
 
 	// add it to the linear list and hash table
-	decl->index = linearLists[typeIndex].Num();
-	hashTables[typeIndex].Add( hash, linearLists[typeIndex].Append( decl ) );
+	decl->index = linearLists[typeIndex].Append( decl );
+	hashTables[typeIndex].Set( decl->name.c_str(), decl->index );
 
 	return decl;
 }
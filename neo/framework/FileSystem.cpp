@@ -242,6 +242,7 @@ private:
 	int		resourceBufferSize;
 	int		resourceBufferAvailable;
 	int		numFilesOpenedAsCached;
+	idSysMutex	resourceReadMutex;	// the resource containers are read through one shared file, also from the image streaming thread
 
 private:
 
@@ -299,6 +300,7 @@ idFileSystemLocal::ReadFromBGL
 ================
 */
 int idFileSystemLocal::ReadFromBGL( idFile *_resourceFile, void * _buffer, int _offset, int _len ) {
+	idScopedCriticalSection lock( resourceReadMutex );
 	if ( _resourceFile->Tell() != _offset ) {
 		_resourceFile->Seek( _offset, FS_SEEK_SET );
 	}
@@ -371,6 +371,12 @@ void idCommonLocal::Frame() {
 		// This is the only place this is incremented
 		idLib::frameNumber++;
 
+		// the memory tag counters are per thread, sum them once a frame to keep the peaks current
+		Mem_UpdateTagPeaks();
+
+		// the game thread finished with the last frame, so nothing else is submitting job lists
+		parallelJobManager->SyncPoint();
+
 		// allow changing SIMD usage on the fly
 		if ( com_forceGenericSIMD.IsModified() ) {
 			idSIMD::InitProcessor( "doom", com_forceGenericSIMD.GetBool() );
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 idStrPool		idDict::globalKeys;
 idStrPool		idDict::globalValues;
+int				idDict::globalKeysGeneration;
 
 /*
 ================
@@ -478,6 +479,44 @@ bool idDict::GetMatrix( const char *key, const char *defaultString, idMat3 &out
 	return found;
 }
 
+/*
+================
+idDict::GetVector
+================
+*/
+bool idDict::GetVector( const idDictKey &key, const char *defaultString, idVec3 &out ) const {
+	bool		found;
+	const char	*s;
+
+	if ( !defaultString ) {
+		defaultString = "0 0 0";
+	}
+
+	found = GetString( key, defaultString, &s );
+	out.Zero();
+	sscanf( s, "%f %f %f", &out.x, &out.y, &out.z );
+	return found;
+}
+
+/*
+================
+idDict::GetMatrix
+================
+*/
+bool idDict::GetMatrix( const idDictKey &key, const char *defaultString, idMat3 &out ) const {
+	const char	*s;
+	bool		found;
+
+	if ( !defaultString ) {
+		defaultString = "1 0 0 0 1 0 0 0 1";
+	}
+
+	found = GetString( key, defaultString, &s );
+	out.Identity();
+	sscanf( s, "%f %f %f %f %f %f %f %f %f", &out[0].x, &out[0].y, &out[0].z, &out[1].x, &out[1].y, &out[1].z, &out[2].x, &out[2].y, &out[2].z );
+	return found;
+}
+
 /*
 ================
 WriteString
@@ -514,6 +553,31 @@ const idKeyValue *idDict::FindKey( const char *key ) const {
 	return NULL;
 }
 
+/*
+================
+idDict::FindKey
+
+  All keys are allocated from globalKeys, which is case insensitive, so an interned
+  key matches a key/value pair exactly when both point to the same pool string.
+================
+*/
+const idKeyValue *idDict::FindKey( const idDictKey &key ) const {
+	if ( key.poolGeneration != globalKeysGeneration ) {
+		// the pool string is never freed because the interned key holds a reference
+		key.poolStr = globalKeys.AllocString( key.name );
+		key.poolGeneration = globalKeysGeneration;
+	}
+
+	const int hash = argHash.GenerateKey( key.hash );
+	for ( int i = argHash.First( hash ); i != -1; i = argHash.Next( i ) ) {
+		if ( args[i].key == key.poolStr ) {
+			return &args[i];
+		}
+	}
+
+	return NULL;
+}
+
 /*
 ================
 idDict::FindKeyIndex
@@ -890,6 +954,7 @@ idDict::Shutdown
 void idDict::Shutdown() {
 	globalKeys.Clear();
 	globalValues.Clear();
+	globalKeysGeneration++;
 }
 
 /*
@@ -64,6 +64,37 @@ private:
 	const idPoolStr *	value;
 };
 
+/*
+================================================
+idDictKey is an interned dictionary key for lookups in hot code like entity spawning.
+The case insensitive hash is computed from the literal when the key is constructed and
+the key is resolved to the string in the global key pool on the first lookup. After
+that a lookup only walks the hash chain and compares pool string pointers.
+
+	static const idDictKey spawnKey_model( "model" );
+	const char * model = spawnArgs.GetString( spawnKey_model );
+================================================
+*/
+class idDictKey {
+	friend class idDict;
+
+public:
+							// only for string literals and other arrays that live as long as the key
+	template< int length >
+	explicit				idDictKey( const char ( &name )[length] ) : name( name ), hash( idStr::IHash( name, length - 1 ) ), poolStr( NULL ), poolGeneration( -1 ) {
+								assert( idStr::Length( name ) == length - 1 );
+							}
+
+	const char *			c_str() const { return name; }
+	int						GetHash() const { return hash; }
+
+private:
+	const char *			name;
+	int						hash;
+	mutable const idPoolStr * poolStr;
+	mutable int				poolGeneration;
+};
+
 /*
 ================================================
 idSort_KeyValue 
@@ -140,11 +171,25 @@ public:
 	bool				GetAngles( const char *key, const char *defaultString, idAngles &out ) const;
 	bool				GetMatrix( const char *key, const char *defaultString, idMat3 &out ) const;
 
+						// lookups with interned keys
+	const char *		GetString( const idDictKey &key, const char *defaultString = "" ) const;
+	float				GetFloat( const idDictKey &key, const char *defaultString ) const;
+	int					GetInt( const idDictKey &key, const char *defaultString ) const;
+	bool				GetBool( const idDictKey &key, const char *defaultString ) const;
+	float				GetFloat( const idDictKey &key, const float defaultFloat = 0.0f ) const;
+	int					GetInt( const idDictKey &key, const int defaultInt = 0 ) const;
+	bool				GetBool( const idDictKey &key, const bool defaultBool = false ) const;
+	bool				GetString( const idDictKey &key, const char *defaultString, const char **out ) const;
+	bool				GetString( const idDictKey &key, const char *defaultString, idStr &out ) const;
+	bool				GetVector( const idDictKey &key, const char *defaultString, idVec3 &out ) const;
+	bool				GetMatrix( const idDictKey &key, const char *defaultString, idMat3 &out ) const;
+
 	int					GetNumKeyVals() const;
 	const idKeyValue *	GetKeyVal( int index ) const;
 						// returns the key/value pair with the given key
 						// returns NULL if the key/value pair does not exist
 	const idKeyValue *	FindKey( const char *key ) const;
+	const idKeyValue *	FindKey( const idDictKey &key ) const;
 						// returns the index to the key/value pair with the given key
 						// returns -1 if the key/value pair does not exist
 	int					FindKeyIndex( const char *key ) const;
@@ -180,6 +225,7 @@ private:
 
 	static idStrPool	globalKeys;
 	static idStrPool	globalValues;
+	static int			globalKeysGeneration;	// changes when globalKeys is cleared to invalidate interned keys
 };
 
 
@@ -334,6 +380,70 @@ ID_INLINE idMat3 idDict::GetMatrix( const char *key, const char *defaultString )
 	return out;
 }
 
+ID_INLINE const char *idDict::GetString( const idDictKey &key, const char *defaultString ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		return kv->GetValue();
+	}
+	return defaultString;
+}
+
+ID_INLINE float idDict::GetFloat( const idDictKey &key, const char *defaultString ) const {
+	return atof( GetString( key, defaultString ) );
+}
+
+ID_INLINE int idDict::GetInt( const idDictKey &key, const char *defaultString ) const {
+	return atoi( GetString( key, defaultString ) );
+}
+
+ID_INLINE bool idDict::GetBool( const idDictKey &key, const char *defaultString ) const {
+	return ( atoi( GetString( key, defaultString ) ) != 0 );
+}
+
+ID_INLINE float idDict::GetFloat( const idDictKey &key, const float defaultFloat ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		return atof( kv->GetValue() );
+	}
+	return defaultFloat;
+}
+
+ID_INLINE int idDict::GetInt( const idDictKey &key, const int defaultInt ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		return atoi( kv->GetValue() );
+	}
+	return defaultInt;
+}
+
+ID_INLINE bool idDict::GetBool( const idDictKey &key, const bool defaultBool ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		return atoi( kv->GetValue() ) != 0;
+	}
+	return defaultBool;
+}
+
+ID_INLINE bool idDict::GetString( const idDictKey &key, const char *defaultString, const char **out ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		*out = kv->GetValue();
+		return true;
+	}
+	*out = defaultString;
+	return false;
+}
+
+ID_INLINE bool idDict::GetString( const idDictKey &key, const char *defaultString, idStr &out ) const {
+	const idKeyValue *kv = FindKey( key );
+	if ( kv ) {
+		out = kv->GetValue();
+		return true;
+	}
+	out = defaultString;
+	return false;
+}
+
 ID_INLINE int idDict::GetNumKeyVals() const {
 	return args.Num();
 }
@@ -0,0 +1,310 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+idCVar frameArena_threadSize( "frameArena_threadSize", "256", CVAR_INTEGER | CVAR_NOCHEAT, "initial size in kB of the frame arena of each thread", 16, 65536 );
+
+static const int MAX_FRAME_ARENAS			= 64;
+
+static idSysMutex			frameArenaMutex;
+static idFrameArena *		frameArenas[MAX_FRAME_ARENAS];
+static int					numFrameArenas;
+
+// plain data because job threads may still use their arenas while static destructors run
+static DWORD				threadArenaTlsIndex = TLS_OUT_OF_INDEXES;
+static interlockedInt_t		numThreadArenas;
+
+/*
+========================
+idFrameArena::idFrameArena
+========================
+*/
+idFrameArena::idFrameArena() {
+	name = "";
+	firstBlock = NULL;
+	currentBlock = NULL;
+	totalUsed = 0;
+	highWater = 0;
+	numOverflows = 0;
+	numOpenMarks = 0;
+	frameNumber = 0;
+	registered = false;
+}
+
+/*
+========================
+idFrameArena::~idFrameArena
+========================
+*/
+idFrameArena::~idFrameArena() {
+	Shutdown();
+}
+
+/*
+========================
+idFrameArena::AllocBlock
+========================
+*/
+idFrameArena::block_t * idFrameArena::AllocBlock( const int size ) {
+	block_t * block = (block_t *)Mem_Alloc16( ALIGN( sizeof( block_t ), 16 ) + size, TAG_FRAME_ARENA );
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+/*
+========================
+idFrameArena::BlockData
+========================
+*/
+byte * idFrameArena::BlockData( block_t * block ) {
+	return (byte *)block + ALIGN( sizeof( block_t ), 16 );
+}
+
+/*
+========================
+idFrameArena::Init
+========================
+*/
+void idFrameArena::Init( const char * name, const int size ) {
+	Shutdown();
+
+	this->name = name;
+	firstBlock = AllocBlock( ALIGN( size, 16 ) );
+	currentBlock = firstBlock;
+
+	idScopedCriticalSection lock( frameArenaMutex );
+	if ( numFrameArenas < MAX_FRAME_ARENAS ) {
+		frameArenas[numFrameArenas++] = this;
+		registered = true;
+	}
+}
+
+/*
+========================
+idFrameArena::Shutdown
+========================
+*/
+void idFrameArena::Shutdown() {
+	assert( numOpenMarks == 0 );
+
+	for ( block_t * block = firstBlock; block != NULL; ) {
+		block_t * next = block->next;
+		Mem_Free16( block );
+		block = next;
+	}
+	firstBlock = NULL;
+	currentBlock = NULL;
+	totalUsed = 0;
+	highWater = 0;
+	numOverflows = 0;
+
+	if ( registered ) {
+		idScopedCriticalSection lock( frameArenaMutex );
+		for ( int i = 0; i < numFrameArenas; i++ ) {
+			if ( frameArenas[i] == this ) {
+				frameArenas[i] = frameArenas[--numFrameArenas];
+				break;
+			}
+		}
+		registered = false;
+	}
+}
+
+/*
+========================
+idFrameArena::Reset
+========================
+*/
+void idFrameArena::Reset() {
+	assert( numOpenMarks == 0 );
+
+	if ( firstBlock != NULL && firstBlock->next != NULL ) {
+		// the arena overflowed, replace all blocks with one that holds the whole frame
+		const int size = GetSize();
+		for ( block_t * block = firstBlock; block != NULL; ) {
+			block_t * next = block->next;
+			Mem_Free16( block );
+			block = next;
+		}
+		firstBlock = AllocBlock( ALIGN( Max( size, highWater ), 16 ) );
+	}
+	if ( firstBlock != NULL ) {
+		firstBlock->used = 0;
+	}
+	currentBlock = firstBlock;
+	totalUsed = 0;
+}
+
+/*
+========================
+idFrameArena::Alloc
+========================
+*/
+void * idFrameArena::Alloc( const int bytes, const int alignment ) {
+	assert( bytes >= 0 );
+	assert( idMath::IsPowerOfTwo( alignment ) );
+
+	for ( block_t * block = currentBlock; block != NULL; block = block->next ) {
+		byte * data = BlockData( block );
+		const int start = (int)( ALIGN( (UINT_PTR)( data + block->used ), (UINT_PTR)alignment ) - (UINT_PTR)data );
+		if ( start + bytes <= block->size ) {
+			totalUsed += start + bytes - block->used;
+			highWater = Max( highWater, totalUsed );
+			block->used = start + bytes;
+			currentBlock = block;
+			return data + start;
+		}
+		// the blocks after the current one are left over from a rollback and are empty
+		assert( block->next == NULL || block->next->used == 0 );
+	}
+
+	// add a block that is at least as large as all previous blocks together
+	block_t * block = AllocBlock( ALIGN( Max( bytes + alignment, Max( GetSize(), 64 * 1024 ) ), 16 ) );
+	if ( currentBlock == NULL ) {
+		firstBlock = block;
+	} else {
+		block_t * last = currentBlock;
+		while ( last->next != NULL ) {
+			last = last->next;
+		}
+		last->next = block;
+		numOverflows++;
+	}
+	currentBlock = block;
+	return Alloc( bytes, alignment );
+}
+
+/*
+========================
+idFrameArena::GetMark
+========================
+*/
+idFrameArena::mark_t idFrameArena::GetMark() const {
+	mark_t mark;
+	mark.block = currentBlock;
+	mark.used = ( currentBlock != NULL ) ? currentBlock->used : 0;
+	mark.totalUsed = totalUsed;
+	return mark;
+}
+
+/*
+========================
+idFrameArena::Rollback
+========================
+*/
+void idFrameArena::Rollback( const mark_t & mark ) {
+	block_t * markBlock = ( mark.block != NULL ) ? (block_t *)mark.block : firstBlock;
+	if ( markBlock == NULL ) {
+		return;
+	}
+	for ( block_t * block = markBlock->next; block != NULL && block->used != 0; block = block->next ) {
+		block->used = 0;
+	}
+	markBlock->used = mark.used;
+	currentBlock = markBlock;
+	totalUsed = mark.totalUsed;
+}
+
+/*
+========================
+idFrameArena::GetSize
+========================
+*/
+int idFrameArena::GetSize() const {
+	int size = 0;
+	for ( const block_t * block = firstBlock; block != NULL; block = block->next ) {
+		size += block->size;
+	}
+	return size;
+}
+
+/*
+========================
+idFrameArena::ThreadArena
+
+Every thread gets its own arena on first use. An arena is reset by its own thread on
+the first use in a new frame, so no other thread ever touches it.
+
+The arenas come from the heap and are never freed, so a job thread that is still
+running while the statics are destroyed at exit keeps a valid arena. There is no limit
+on the number of threads, arenas beyond MAX_FRAME_ARENAS are only left out of the report.
+========================
+*/
+idFrameArena * idFrameArena::ThreadArena() {
+	if ( threadArenaTlsIndex == TLS_OUT_OF_INDEXES ) {
+		const DWORD tlsIndex = TlsAlloc();
+		if ( InterlockedCompareExchange( (volatile LONG *)&threadArenaTlsIndex, tlsIndex, TLS_OUT_OF_INDEXES ) != TLS_OUT_OF_INDEXES ) {
+			// another thread got there first
+			TlsFree( tlsIndex );
+		}
+	}
+
+	idFrameArena * arena = (idFrameArena *)TlsGetValue( threadArenaTlsIndex );
+	if ( arena == NULL ) {
+		const int index = Sys_InterlockedIncrement( numThreadArenas ) - 1;
+		char name[32];
+		idStr::snPrintf( name, sizeof( name ), idLib::IsMainThread() ? "main thread" : "thread %d", index );
+		arena = new (TAG_FRAME_ARENA) idFrameArena;
+		arena->Init( Mem_CopyString( name ), frameArena_threadSize.GetInteger() * 1024 );
+		arena->frameNumber = idLib::frameNumber;
+		TlsSetValue( threadArenaTlsIndex, arena );
+	}
+	if ( arena->frameNumber != idLib::frameNumber && arena->numOpenMarks == 0 ) {
+		arena->Reset();
+		arena->frameNumber = idLib::frameNumber;
+	}
+	return arena;
+}
+
+/*
+========================
+idFrameArena::PrintReport
+========================
+*/
+void idFrameArena::PrintReport() {
+	idScopedCriticalSection lock( frameArenaMutex );
+
+	idLib::Printf( "arena                 size kB    used kB  high water kB  overflows\n" );
+	for ( int i = 0; i < numFrameArenas; i++ ) {
+		const idFrameArena * arena = frameArenas[i];
+		idLib::Printf( "%-20s %8d %10d %14d %10d\n", arena->GetName(), arena->GetSize() >> 10, arena->GetUsed() >> 10, arena->GetHighWater() >> 10, arena->GetNumOverflows() );
+	}
+}
+
+/*
+==================
+frameArenaReport
+==================
+*/
+CONSOLE_COMMAND( frameArenaReport, "lists the size, use and high water mark of all frame arenas", NULL ) {
+	idFrameArena::PrintReport();
+}
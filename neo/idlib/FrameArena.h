@@ -0,0 +1,130 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __FRAMEARENA_H__
+#define __FRAMEARENA_H__
+
+/*
+===============================================================================
+
+	Frame-scoped linear arena.
+
+	An allocation only bumps a pointer and is never freed on its own. All
+	allocations are released at once when the arena is reset, or back to a mark
+	taken with GetMark, so short lived temporaries can be nested.
+
+	When the current block runs out, another block is allocated from the heap.
+	The next Reset replaces all blocks with a single block that holds the high
+	water mark, so an arena stops touching the heap once it has seen its largest
+	frame.
+
+	An arena is not thread safe. idFrameArena::ThreadArena returns the arena of
+	the calling thread, which is reset on its first use in a new frame unless an
+	idScopedFrameArenaMark is open on it.
+
+===============================================================================
+*/
+
+class idFrameArena {
+	friend class idScopedFrameArenaMark;
+public:
+	struct mark_t {
+		void *				block;
+		int					used;
+		int					totalUsed;
+	};
+
+							idFrameArena();
+							~idFrameArena();
+
+	void					Init( const char * name, const int size );
+	void					Shutdown();
+
+							// releases all allocations
+	void					Reset();
+
+	void *					Alloc( const int bytes, const int alignment = 16 );
+							// uninitialized array, the type must be POD
+	template< class type >
+	type *					AllocArray( const int num ) { return (type *)Alloc( num * sizeof( type ) ); }
+
+	mark_t					GetMark() const;
+							// releases everything allocated after the mark was taken
+	void					Rollback( const mark_t & mark );
+
+	const char *			GetName() const { return name; }
+	int						GetUsed() const { return totalUsed; }
+	int						GetSize() const;
+	int						GetHighWater() const { return highWater; }
+	int						GetNumOverflows() const { return numOverflows; }
+
+							// arena of the calling thread, for temporaries of game code and jobs
+	static idFrameArena *	ThreadArena();
+	static void				PrintReport();
+
+private:
+	struct block_t {
+		block_t *			next;
+		int					size;
+		int					used;
+	};
+
+	const char *			name;
+	block_t *				firstBlock;
+	block_t *				currentBlock;
+	int						totalUsed;
+	int						highWater;
+	int						numOverflows;
+	int						numOpenMarks;
+	int						frameNumber;
+	bool					registered;
+
+	static block_t *		AllocBlock( const int size );
+	static byte *			BlockData( block_t * block );
+
+							idFrameArena( const idFrameArena & );
+	void					operator=( const idFrameArena & );
+};
+
+/*
+================================================
+idScopedFrameArenaMark rolls an arena back to where it was when the mark was
+created once the mark goes out of scope.
+================================================
+*/
+class idScopedFrameArenaMark {
+public:
+							idScopedFrameArenaMark( idFrameArena & arena ) : arena( &arena ), mark( arena.GetMark() ) { arena.numOpenMarks++; }
+							~idScopedFrameArenaMark() { arena->Rollback( mark ); arena->numOpenMarks--; }
+
+private:
+	idFrameArena *			arena;
+	idFrameArena::mark_t	mark;
+};
+
+#endif /* !__FRAMEARENA_H__ */
@@ -37,6 +37,593 @@ If you have questions concerning this license or the applicable additional terms
 
 #undef new
 
+// Set to 0 to send every allocation straight to the CRT aligned heap.
+#define USE_SMALL_OBJECT_ALLOCATOR		1
+
+/*
+================================================================================================
+
+	Memory tag accounting
+
+	Every allocation is charged to its memTag_t for as long as it lives. Each thread counts
+	its allocations and frees in its own block of counters so the allocator does not touch
+	any shared cache line, the blocks are only summed when the stats are queried. A thread
+	that frees memory another thread allocated ends up with negative counts, only the sum
+	over all threads is meaningful. The peak is raised whenever the sum is taken, which
+	Mem_UpdateTagPeaks does once per frame.
+
+	For a few tags a sample of the allocation call stacks can be recorded as well, see
+	the memTagStacks command.
+
+================================================================================================
+*/
+
+static const char * memTagNames[] = {
+#define MEM_TAG( x )	#x,
+#include "sys/sys_alloc_tags.h"
+};
+
+compile_time_assert( sizeof( memTagNames ) / sizeof( memTagNames[0] ) == TAG_NUM_TAGS );
+
+struct memTagThreadStats_t {
+	int64					bytes[TAG_NUM_TAGS];
+	int64					numAllocs[TAG_NUM_TAGS];
+	int64					totalAllocs[TAG_NUM_TAGS];
+	int						sampleCountdown;
+	memTagThreadStats_t *	next;				// all thread blocks ever created
+};
+
+// plain data because allocations happen before any constructors run
+static DWORD				memTagTlsIndex = TLS_OUT_OF_INDEXES;
+static interlockedInt_t		memTagThreadStatsLock;
+static memTagThreadStats_t *	memTagThreadStats;
+static int64				memTagPeakBytes[TAG_NUM_TAGS];
+
+static const int MAX_SAMPLED_TAGS		= 8;
+static const int MAX_SAMPLED_STACKS		= 256;
+static const int SAMPLED_STACK_DEPTH	= 8;
+
+struct memStackSample_t {
+	address_t				stack[SAMPLED_STACK_DEPTH];
+	int						count;
+	int64					bytes;
+};
+
+static bool					memStackSampling;						// any tag sampled, checked before anything else
+static int					memTagSampleRate;						// sample every Nth allocation of a sampled tag on a thread
+static int					memTagSampleSlot[TAG_NUM_TAGS];			// 1 + index in memStackSamples, 0 if not sampled
+static interlockedInt_t		memStackSampleLock;
+static memStackSample_t		memStackSamples[MAX_SAMPLED_TAGS][MAX_SAMPLED_STACKS];
+static int					memNumStackSamples[MAX_SAMPLED_TAGS];
+
+/*
+==================
+Mem_LockThreadStats
+==================
+*/
+static void Mem_LockThreadStats() {
+	while ( Sys_InterlockedCompareExchange( memTagThreadStatsLock, 1, 0 ) != 0 ) {
+		Sys_Yield();
+	}
+}
+
+/*
+==================
+Mem_UnlockThreadStats
+==================
+*/
+static void Mem_UnlockThreadStats() {
+	Sys_InterlockedExchange( memTagThreadStatsLock, 0 );
+}
+
+/*
+==================
+Mem_GetThreadStats
+==================
+*/
+static ID_INLINE memTagThreadStats_t * Mem_GetThreadStats() {
+	if ( memTagTlsIndex != TLS_OUT_OF_INDEXES ) {
+		memTagThreadStats_t * stats = (memTagThreadStats_t *)TlsGetValue( memTagTlsIndex );
+		if ( stats != NULL ) {
+			return stats;
+		}
+	}
+
+	Mem_LockThreadStats();
+	if ( memTagTlsIndex == TLS_OUT_OF_INDEXES ) {
+		memTagTlsIndex = TlsAlloc();
+	}
+	// the block outlives the thread because its counts are still part of the totals
+	memTagThreadStats_t * stats = (memTagThreadStats_t *)_aligned_malloc( sizeof( memTagThreadStats_t ), 16 );
+	memset( stats, 0, sizeof( memTagThreadStats_t ) );
+	stats->next = memTagThreadStats;
+	memTagThreadStats = stats;
+	Mem_UnlockThreadStats();
+
+	TlsSetValue( memTagTlsIndex, stats );
+	return stats;
+}
+
+/*
+==================
+Mem_SampleCallStack
+==================
+*/
+static void Mem_SampleCallStack( const memTag_t tag, const int size ) {
+	// release builds omit frame pointers so the ebp walk of Sys_GetCallStack is not safe here
+	address_t stack[SAMPLED_STACK_DEPTH];
+	Sys_CaptureCallStack( stack, SAMPLED_STACK_DEPTH );
+
+	while ( Sys_InterlockedCompareExchange( memStackSampleLock, 1, 0 ) != 0 ) {
+		Sys_Yield();
+	}
+
+	const int slot = memTagSampleSlot[tag] - 1;
+	if ( slot >= 0 ) {
+		memStackSample_t * samples = memStackSamples[slot];
+		int i;
+		for ( i = 0; i < memNumStackSamples[slot]; i++ ) {
+			if ( memcmp( samples[i].stack, stack, sizeof( stack ) ) == 0 ) {
+				break;
+			}
+		}
+		if ( i == memNumStackSamples[slot] && i < MAX_SAMPLED_STACKS ) {
+			memcpy( samples[i].stack, stack, sizeof( stack ) );
+			samples[i].count = 0;
+			samples[i].bytes = 0;
+			memNumStackSamples[slot]++;
+		}
+		if ( i < MAX_SAMPLED_STACKS ) {
+			samples[i].count++;
+			samples[i].bytes += size;
+		}
+	}
+
+	Sys_InterlockedExchange( memStackSampleLock, 0 );
+}
+
+/*
+==================
+Mem_TagAlloc
+==================
+*/
+static ID_INLINE void Mem_TagAlloc( const memTag_t tag, const int size ) {
+	memTagThreadStats_t * stats = Mem_GetThreadStats();
+	stats->bytes[tag] += size;
+	stats->numAllocs[tag]++;
+	stats->totalAllocs[tag]++;
+
+	if ( memStackSampling && memTagSampleSlot[tag] != 0 ) {
+		if ( --stats->sampleCountdown <= 0 ) {
+			stats->sampleCountdown = memTagSampleRate;
+			Mem_SampleCallStack( tag, size );
+		}
+	}
+}
+
+/*
+==================
+Mem_TagFree
+==================
+*/
+static ID_INLINE void Mem_TagFree( const memTag_t tag, const int size ) {
+	memTagThreadStats_t * stats = Mem_GetThreadStats();
+	stats->bytes[tag] -= size;
+	stats->numAllocs[tag]--;
+}
+
+/*
+==================
+Mem_GetTagName
+==================
+*/
+const char * Mem_GetTagName( const memTag_t tag ) {
+	if ( tag < 0 || tag >= TAG_NUM_TAGS ) {
+		return "?";
+	}
+	return memTagNames[tag];
+}
+
+/*
+==================
+Mem_GetTagStats
+
+The counters of other threads are read while they may be changing, so the result is a
+close snapshot rather than an exact one.
+==================
+*/
+void Mem_GetTagStats( const memTag_t tag, memTagStats_t & stats ) {
+	assert( tag >= 0 && tag < TAG_NUM_TAGS );
+	memset( &stats, 0, sizeof( stats ) );
+
+	Mem_LockThreadStats();
+	for ( const memTagThreadStats_t * t = memTagThreadStats; t != NULL; t = t->next ) {
+		stats.bytes += t->bytes[tag];
+		stats.numAllocs += t->numAllocs[tag];
+		stats.totalAllocs += t->totalAllocs[tag];
+	}
+	memTagPeakBytes[tag] = Max( memTagPeakBytes[tag], stats.bytes );
+	stats.peakBytes = memTagPeakBytes[tag];
+	Mem_UnlockThreadStats();
+}
+
+/*
+==================
+Mem_UpdateTagPeaks
+==================
+*/
+void Mem_UpdateTagPeaks() {
+	memTagStats_t stats;
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		Mem_GetTagStats( (memTag_t)i, stats );
+	}
+}
+
+/*
+================================================================================================
+
+	Large allocations
+
+	Allocations that do not fit a small object size class come from the CRT aligned heap
+	with a 16 byte header in front that remembers the size and tag for Mem_Free16.
+
+================================================================================================
+*/
+
+static const int LARGE_ALLOC_MAGIC	= 0x4C41524C;
+
+struct largeAllocHeader_t {
+	int			size;
+	int			tag;
+	int			magic;
+	int			pad;
+};
+
+compile_time_assert( sizeof( largeAllocHeader_t ) == 16 );
+
+/*
+==================
+Mem_LargeAlloc
+==================
+*/
+static void * Mem_LargeAlloc( const int size, const memTag_t tag ) {
+	largeAllocHeader_t * header = (largeAllocHeader_t *)_aligned_malloc( size + sizeof( largeAllocHeader_t ), 16 );
+	if ( header == NULL ) {
+		return NULL;
+	}
+	header->size = size;
+	header->tag = tag;
+	header->magic = LARGE_ALLOC_MAGIC;
+	Mem_TagAlloc( tag, size );
+	return header + 1;
+}
+
+/*
+==================
+Mem_LargeFree
+==================
+*/
+static void Mem_LargeFree( void * ptr ) {
+	largeAllocHeader_t * header = (largeAllocHeader_t *)ptr - 1;
+	assert( header->magic == LARGE_ALLOC_MAGIC );
+	header->magic = 0;
+	Mem_TagFree( (memTag_t)header->tag, header->size );
+	_aligned_free( header );
+}
+
+#if USE_SMALL_OBJECT_ALLOCATOR
+
+/*
+================================================================================================
+
+	Small object allocator
+
+	Allocations up to MAX_SMALL_OBJECT_SIZE are rounded up to one of a few size classes and
+	served from 64kB pages that each hold objects of a single size class. Every thread
+	has its own cache with a free list per size class so allocating and freeing on the
+	same thread takes no locks at all.
+
+	A page belongs to the thread that carved it. An object freed by any other thread is
+	pushed on the lock-free remote free queue of the owning thread, which the owner moves
+	back to its free lists once a free list runs dry.
+
+	Pages are carved out of 1MB chunks from the OS, which are never returned. A byte map
+	with an entry for every 64kB of address space tells the small object pages apart from
+	large allocations when freeing.
+
+================================================================================================
+*/
+
+static const int SMALL_PAGE_SHIFT			= 16;
+static const int SMALL_PAGE_SIZE			= 1 << SMALL_PAGE_SHIFT;
+static const int SMALL_PAGE_HEADER_SIZE		= 64;
+static const int SMALL_CHUNK_SIZE			= 16 * SMALL_PAGE_SIZE;
+static const int MAX_SMALL_OBJECT_SIZE		= 1024;
+
+static const int smallObjectSizes[] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024
+};
+static const int NUM_SMALL_OBJECT_SIZES		= sizeof( smallObjectSizes ) / sizeof( smallObjectSizes[0] );
+
+struct smallObject_t {
+	smallObject_t *			next;
+};
+
+struct smallObjectCache_t {
+	smallObject_t *			freeLists[NUM_SMALL_OBJECT_SIZES];
+	void *					remoteFrees;		// objects freed by other threads, only ever taken as a whole
+	smallObjectCache_t *	next;				// all thread caches ever created
+	uintptr_t				threadId;
+};
+
+struct smallObjectPage_t {
+	smallObjectCache_t *	owner;
+	int						sizeClass;
+	int						objectSize;
+	int						numObjects;
+	byte *					objects;
+	byte *					tags;				// memTag_t of every object
+};
+
+compile_time_assert( sizeof( smallObjectPage_t ) <= SMALL_PAGE_HEADER_SIZE );
+compile_time_assert( MAX_TAGS <= 256 );
+
+// these are used before any constructors run so they are all plain data
+static byte					smallObjectSizeClass[MAX_SMALL_OBJECT_SIZE / 16 + 1];
+static DWORD				smallObjectTlsIndex = TLS_OUT_OF_INDEXES;
+static interlockedInt_t		smallObjectLock;
+static byte *				smallObjectChunk;
+static int					smallObjectChunkPages;
+static smallObjectCache_t *	smallObjectCaches;
+
+#ifdef _WIN64
+static byte *				smallObjectPageMap[1 << 16];		// indexed by address bits 32-47
+#else
+static byte					smallObjectPageMap[1 << 16];		// indexed by address bits 16-31
+#endif
+
+/*
+==================
+SmallObject_Lock
+==================
+*/
+static void SmallObject_Lock() {
+	while ( Sys_InterlockedCompareExchange( smallObjectLock, 1, 0 ) != 0 ) {
+		Sys_Yield();
+	}
+}
+
+/*
+==================
+SmallObject_Unlock
+==================
+*/
+static void SmallObject_Unlock() {
+	Sys_InterlockedExchange( smallObjectLock, 0 );
+}
+
+/*
+==================
+SmallObject_IsSmallPage
+==================
+*/
+static ID_INLINE bool SmallObject_IsSmallPage( const void * ptr ) {
+	const uintptr_t address = (uintptr_t)ptr;
+#ifdef _WIN64
+	const byte * map = smallObjectPageMap[( address >> 32 ) & 0xFFFF];
+	return ( map != NULL && map[( address >> SMALL_PAGE_SHIFT ) & 0xFFFF] != 0 );
+#else
+	return ( smallObjectPageMap[address >> SMALL_PAGE_SHIFT] != 0 );
+#endif
+}
+
+/*
+==================
+SmallObject_MarkSmallPage
+
+Must be called with the small object lock held.
+==================
+*/
+static void SmallObject_MarkSmallPage( const void * ptr ) {
+	const uintptr_t address = (uintptr_t)ptr;
+#ifdef _WIN64
+	byte * & map = smallObjectPageMap[( address >> 32 ) & 0xFFFF];
+	if ( map == NULL ) {
+		map = (byte *)VirtualAlloc( NULL, 1 << 16, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+	}
+	map[( address >> SMALL_PAGE_SHIFT ) & 0xFFFF] = 1;
+#else
+	smallObjectPageMap[address >> SMALL_PAGE_SHIFT] = 1;
+#endif
+}
+
+/*
+==================
+SmallObject_PageForObject
+==================
+*/
+static ID_INLINE smallObjectPage_t * SmallObject_PageForObject( const void * ptr ) {
+	return (smallObjectPage_t *)( (uintptr_t)ptr & ~(uintptr_t)( SMALL_PAGE_SIZE - 1 ) );
+}
+
+/*
+==================
+SmallObject_Init
+
+Must be called with the small object lock held.
+==================
+*/
+static void SmallObject_Init() {
+	for ( int i = 0, sizeClass = 0; i <= MAX_SMALL_OBJECT_SIZE / 16; i++ ) {
+		while ( smallObjectSizes[sizeClass] < i * 16 ) {
+			sizeClass++;
+		}
+		smallObjectSizeClass[i] = (byte)sizeClass;
+	}
+	smallObjectTlsIndex = TlsAlloc();
+}
+
+/*
+==================
+SmallObject_GetThreadCache
+==================
+*/
+static smallObjectCache_t * SmallObject_GetThreadCache() {
+	if ( smallObjectTlsIndex == TLS_OUT_OF_INDEXES ) {
+		SmallObject_Lock();
+		if ( smallObjectTlsIndex == TLS_OUT_OF_INDEXES ) {
+			SmallObject_Init();
+		}
+		SmallObject_Unlock();
+	}
+
+	smallObjectCache_t * cache = (smallObjectCache_t *)TlsGetValue( smallObjectTlsIndex );
+	if ( cache != NULL ) {
+		return cache;
+	}
+
+	// the cache outlives the thread because other threads may still free objects to it
+	cache = (smallObjectCache_t *)_aligned_malloc( sizeof( smallObjectCache_t ), 16 );
+	memset( cache, 0, sizeof( smallObjectCache_t ) );
+	cache->threadId = Sys_GetCurrentThreadID();
+
+	SmallObject_Lock();
+	cache->next = smallObjectCaches;
+	smallObjectCaches = cache;
+	SmallObject_Unlock();
+
+	TlsSetValue( smallObjectTlsIndex, cache );
+	return cache;
+}
+
+/*
+==================
+SmallObject_NewPage
+
+Carves a new page for the given size class and puts all its objects on the free list.
+==================
+*/
+static bool SmallObject_NewPage( smallObjectCache_t * cache, const int sizeClass ) {
+	SmallObject_Lock();
+	if ( smallObjectChunkPages == 0 ) {
+		// VirtualAlloc returns memory aligned to the 64kB allocation granularity
+		smallObjectChunk = (byte *)VirtualAlloc( NULL, SMALL_CHUNK_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+		if ( smallObjectChunk == NULL ) {
+			SmallObject_Unlock();
+			return false;
+		}
+		assert( ( (uintptr_t)smallObjectChunk & ( SMALL_PAGE_SIZE - 1 ) ) == 0 );
+		smallObjectChunkPages = SMALL_CHUNK_SIZE / SMALL_PAGE_SIZE;
+	}
+	byte * pageMemory = smallObjectChunk;
+	smallObjectChunk += SMALL_PAGE_SIZE;
+	smallObjectChunkPages--;
+	SmallObject_MarkSmallPage( pageMemory );
+	SmallObject_Unlock();
+
+	const int objectSize = smallObjectSizes[sizeClass];
+
+	smallObjectPage_t * page = (smallObjectPage_t *)pageMemory;
+	page->owner = cache;
+	page->sizeClass = sizeClass;
+	page->objectSize = objectSize;
+	page->numObjects = ( SMALL_PAGE_SIZE - SMALL_PAGE_HEADER_SIZE - 16 ) / ( objectSize + 1 );
+	page->tags = pageMemory + SMALL_PAGE_HEADER_SIZE;
+	page->objects = page->tags + ( ( page->numObjects + 15 ) & ~15 );
+	assert( page->objects + page->numObjects * objectSize <= pageMemory + SMALL_PAGE_SIZE );
+
+	// link back to front so the objects are handed out in address order
+	smallObject_t * list = cache->freeLists[sizeClass];
+	for ( int i = page->numObjects - 1; i >= 0; i-- ) {
+		smallObject_t * object = (smallObject_t *)( page->objects + i * objectSize );
+		object->next = list;
+		list = object;
+	}
+	cache->freeLists[sizeClass] = list;
+	return true;
+}
+
+/*
+==================
+SmallObject_CollectRemoteFrees
+
+Moves the objects other threads freed back to the free lists of the owning thread.
+==================
+*/
+static void SmallObject_CollectRemoteFrees( smallObjectCache_t * cache ) {
+	smallObject_t * object = (smallObject_t *)Sys_InterlockedExchangePointer( cache->remoteFrees, NULL );
+	while ( object != NULL ) {
+		smallObject_t * next = object->next;
+		const int sizeClass = SmallObject_PageForObject( object )->sizeClass;
+		object->next = cache->freeLists[sizeClass];
+		cache->freeLists[sizeClass] = object;
+		object = next;
+	}
+}
+
+/*
+==================
+SmallObject_Alloc
+==================
+*/
+static void * SmallObject_Alloc( const int size, const memTag_t tag ) {
+	smallObjectCache_t * cache = SmallObject_GetThreadCache();
+	const int sizeClass = smallObjectSizeClass[( size + 15 ) >> 4];
+
+	smallObject_t * object = cache->freeLists[sizeClass];
+	if ( object == NULL ) {
+		if ( cache->remoteFrees != NULL ) {
+			SmallObject_CollectRemoteFrees( cache );
+		}
+		if ( cache->freeLists[sizeClass] == NULL ) {
+			if ( !SmallObject_NewPage( cache, sizeClass ) ) {
+				return NULL;
+			}
+		}
+		object = cache->freeLists[sizeClass];
+	}
+	cache->freeLists[sizeClass] = object->next;
+
+	smallObjectPage_t * page = SmallObject_PageForObject( object );
+	page->tags[( (byte *)object - page->objects ) / page->objectSize] = (byte)tag;
+	Mem_TagAlloc( tag, page->objectSize );
+
+	return object;
+}
+
+/*
+==================
+SmallObject_Free
+==================
+*/
+static void SmallObject_Free( void * ptr ) {
+	smallObjectPage_t * page = SmallObject_PageForObject( ptr );
+	const memTag_t tag = (memTag_t)page->tags[( (byte *)ptr - page->objects ) / page->objectSize];
+	Mem_TagFree( tag, page->objectSize );
+
+	smallObject_t * object = (smallObject_t *)ptr;
+	smallObjectCache_t * owner = page->owner;
+	if ( smallObjectTlsIndex != TLS_OUT_OF_INDEXES && TlsGetValue( smallObjectTlsIndex ) == owner ) {
+		object->next = owner->freeLists[page->sizeClass];
+		owner->freeLists[page->sizeClass] = object;
+		return;
+	}
+
+	// push on the remote free queue of the owning thread
+	for ( ; ; ) {
+		void * head = owner->remoteFrees;
+		object->next = (smallObject_t *)head;
+		if ( Sys_InterlockedCompareExchangePointer( owner->remoteFrees, head, object ) == head ) {
+			break;
+		}
+	}
+}
+
+#endif // USE_SMALL_OBJECT_ALLOCATOR
+
 /*
 ==================
 Mem_Alloc16
@@ -46,8 +633,14 @@ void * Mem_Alloc16( const int size, const memTag_t tag ) {
 	if ( !size ) {
 		return NULL;
 	}
+	assert( tag >= 0 && tag < TAG_NUM_TAGS );
 	const int paddedSize = ( size + 15 ) & ~15;
-	return _aligned_malloc( paddedSize, 16 );
+#if USE_SMALL_OBJECT_ALLOCATOR
+	if ( paddedSize <= MAX_SMALL_OBJECT_SIZE ) {
+		return SmallObject_Alloc( paddedSize, tag );
+	}
+#endif
+	return Mem_LargeAlloc( paddedSize, tag );
 }
 
 /*
@@ -59,7 +652,13 @@ void Mem_Free16( void *ptr ) {
 	if ( ptr == NULL ) {
 		return;
 	}
-	_aligned_free( ptr );
+#if USE_SMALL_OBJECT_ALLOCATOR
+	if ( SmallObject_IsSmallPage( ptr ) ) {
+		SmallObject_Free( ptr );
+		return;
+	}
+#endif
+	Mem_LargeFree( ptr );
 }
 
 /*
@@ -84,3 +683,337 @@ char *Mem_CopyString( const char *in ) {
 	return out;
 }
 
+/*
+================================================================================================
+
+	Memory tag reports
+
+================================================================================================
+*/
+
+static memTagStats_t	memTagSnapshots[2][TAG_NUM_TAGS];
+static int				memTagNumSnapshots;
+
+/*
+================================================
+idSort_MemTags sorts tag numbers by descending key.
+================================================
+*/
+class idSort_MemTags : public idSort_Quick< int, idSort_MemTags > {
+public:
+						idSort_MemTags( const int64 * keys ) : keys( keys ) {}
+	int					Compare( const int & a, const int & b ) const {
+							if ( keys[a] != keys[b] ) {
+								return ( keys[a] > keys[b] ) ? -1 : 1;
+							}
+							return a - b;
+						}
+private:
+	const int64 *		keys;
+};
+
+/*
+==================
+Mem_GetAllTagStats
+==================
+*/
+static void Mem_GetAllTagStats( memTagStats_t stats[TAG_NUM_TAGS] ) {
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		Mem_GetTagStats( (memTag_t)i, stats[i] );
+	}
+}
+
+/*
+==================
+memTagReport
+==================
+*/
+CONSOLE_COMMAND( memTagReport, "lists the memory allocated per memory tag, largest first", NULL ) {
+	memTagStats_t stats[TAG_NUM_TAGS];
+	Mem_GetAllTagStats( stats );
+
+	int64 keys[TAG_NUM_TAGS];
+	int order[TAG_NUM_TAGS];
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		keys[i] = stats[i].bytes;
+		order[i] = i;
+	}
+	idSort_MemTags( keys ).Sort( order, TAG_NUM_TAGS );
+
+	memTagStats_t total;
+	memset( &total, 0, sizeof( total ) );
+
+	idLib::Printf( "tag                           kB    peak kB      allocs  total allocs\n" );
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		const memTagStats_t & s = stats[order[i]];
+		if ( s.totalAllocs == 0 ) {
+			continue;
+		}
+		idLib::Printf( "%-24s %10lld %10lld %11lld %13lld\n", memTagNames[order[i]], s.bytes >> 10, s.peakBytes >> 10, s.numAllocs, s.totalAllocs );
+		total.bytes += s.bytes;
+		total.numAllocs += s.numAllocs;
+		total.totalAllocs += s.totalAllocs;
+	}
+	idLib::Printf( "%-24s %10lld %10s %11lld %13lld\n", "total", total.bytes >> 10, "", total.numAllocs, total.totalAllocs );
+}
+
+/*
+==================
+memTagSnapshot
+==================
+*/
+CONSOLE_COMMAND( memTagSnapshot, "remembers the current memory per tag for memTagDiff", NULL ) {
+	memcpy( memTagSnapshots[0], memTagSnapshots[1], sizeof( memTagSnapshots[0] ) );
+	Mem_GetAllTagStats( memTagSnapshots[1] );
+	memTagNumSnapshots = Min( memTagNumSnapshots + 1, 2 );
+	idLib::Printf( "memory tag snapshot %d taken\n", memTagNumSnapshots );
+}
+
+/*
+==================
+memTagDiff
+==================
+*/
+CONSOLE_COMMAND( memTagDiff, "shows how the memory per tag changed between the last two memTagSnapshots, or since the last snapshot", NULL ) {
+	if ( memTagNumSnapshots == 0 ) {
+		idLib::Printf( "no snapshot, use memTagSnapshot first\n" );
+		return;
+	}
+
+	const memTagStats_t * before;
+	const memTagStats_t * after;
+	memTagStats_t current[TAG_NUM_TAGS];
+	if ( memTagNumSnapshots < 2 ) {
+		Mem_GetAllTagStats( current );
+		before = memTagSnapshots[1];
+		after = current;
+		idLib::Printf( "changes since the last snapshot:\n" );
+	} else {
+		before = memTagSnapshots[0];
+		after = memTagSnapshots[1];
+		idLib::Printf( "changes between the last two snapshots:\n" );
+	}
+
+	int64 keys[TAG_NUM_TAGS];
+	int order[TAG_NUM_TAGS];
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		const int64 delta = after[i].bytes - before[i].bytes;
+		keys[i] = ( delta < 0 ) ? -delta : delta;
+		order[i] = i;
+	}
+	idSort_MemTags( keys ).Sort( order, TAG_NUM_TAGS );
+
+	int64 totalDelta = 0;
+	idLib::Printf( "tag                    before kB   after kB   delta kB  delta allocs\n" );
+	for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+		const int tag = order[i];
+		const int64 delta = after[tag].bytes - before[tag].bytes;
+		const int64 allocDelta = after[tag].numAllocs - before[tag].numAllocs;
+		if ( delta == 0 && allocDelta == 0 ) {
+			continue;
+		}
+		idLib::Printf( "%-24s %10lld %10lld %+10lld %+13lld\n", memTagNames[tag], before[tag].bytes >> 10, after[tag].bytes >> 10, delta / 1024, allocDelta );
+		totalDelta += delta;
+	}
+	idLib::Printf( "%-24s %10s %10s %+10lld\n", "total", "", "", totalDelta / 1024 );
+}
+
+/*
+==================
+memTagStacks
+==================
+*/
+CONSOLE_COMMAND( memTagStacks, "samples allocation call stacks of the largest tags, usage: memTagStacks [numTags] [sampleRate], without arguments prints the samples", NULL ) {
+	if ( args.Argc() > 1 ) {
+		const int numTags = idMath::ClampInt( 0, MAX_SAMPLED_TAGS, atoi( args.Argv( 1 ) ) );
+		const int sampleRate = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 64;
+
+		memTagStats_t stats[TAG_NUM_TAGS];
+		Mem_GetAllTagStats( stats );
+
+		int64 keys[TAG_NUM_TAGS];
+		int order[TAG_NUM_TAGS];
+		for ( int i = 0; i < TAG_NUM_TAGS; i++ ) {
+			keys[i] = stats[i].bytes;
+			order[i] = i;
+		}
+		idSort_MemTags( keys ).Sort( order, TAG_NUM_TAGS );
+
+		while ( Sys_InterlockedCompareExchange( memStackSampleLock, 1, 0 ) != 0 ) {
+			Sys_Yield();
+		}
+		memTagSampleRate = sampleRate;
+		memset( memTagSampleSlot, 0, sizeof( memTagSampleSlot ) );
+		memset( memNumStackSamples, 0, sizeof( memNumStackSamples ) );
+		for ( int i = 0; i < numTags; i++ ) {
+			memTagSampleSlot[order[i]] = i + 1;
+		}
+		memStackSampling = ( numTags > 0 );
+		Sys_InterlockedExchange( memStackSampleLock, 0 );
+
+		if ( numTags == 0 ) {
+			idLib::Printf( "call stack sampling disabled\n" );
+		} else {
+			idLib::Printf( "sampling every %d allocation call stacks of:", sampleRate );
+			for ( int i = 0; i < numTags; i++ ) {
+				idLib::Printf( " %s", memTagNames[order[i]] );
+			}
+			idLib::Printf( "\n" );
+		}
+		return;
+	}
+
+	for ( int tag = 0; tag < TAG_NUM_TAGS; tag++ ) {
+		const int slot = memTagSampleSlot[tag] - 1;
+		if ( slot < 0 ) {
+			continue;
+		}
+
+		// copy the samples so symbol lookup does not run under the lock
+		static memStackSample_t samples[MAX_SAMPLED_STACKS];
+		while ( Sys_InterlockedCompareExchange( memStackSampleLock, 1, 0 ) != 0 ) {
+			Sys_Yield();
+		}
+		const int numSamples = memNumStackSamples[slot];
+		memcpy( samples, memStackSamples[slot], numSamples * sizeof( samples[0] ) );
+		Sys_InterlockedExchange( memStackSampleLock, 0 );
+
+		int64 keys[MAX_SAMPLED_STACKS];
+		int order[MAX_SAMPLED_STACKS];
+		for ( int i = 0; i < numSamples; i++ ) {
+			keys[i] = samples[i].bytes;
+			order[i] = i;
+		}
+		idSort_MemTags( keys ).Sort( order, numSamples );
+
+		idLib::Printf( "%s: %d sampled call stacks\n", memTagNames[tag], numSamples );
+		for ( int i = 0; i < numSamples && i < 16; i++ ) {
+			const memStackSample_t & sample = samples[order[i]];
+			idLib::Printf( "%8lld kB %6d allocs %s\n", sample.bytes >> 10, sample.count, Sys_GetCallStackStr( sample.stack, SAMPLED_STACK_DEPTH ) );
+		}
+	}
+}
+
+/*
+================================================================================================
+
+	Allocator benchmark
+
+================================================================================================
+*/
+
+static const int ALLOC_TEST_SLOTS		= 2048;
+
+struct allocTestJob_t {
+	void *		(*allocFunc)( const int size );
+	void		(*freeFunc)( void * ptr );
+	int			seed;
+	int			iterations;
+	void *		slots[ALLOC_TEST_SLOTS];
+	int			numOps;
+};
+
+static void * AllocTest_Mem( const int size ) { return Mem_Alloc16( size, TAG_TEMP ); }
+static void AllocTest_MemFree( void * ptr ) { Mem_Free16( ptr ); }
+static void * AllocTest_CRT( const int size ) { return _aligned_malloc( ( size + 15 ) & ~15, 16 ); }
+static void AllocTest_CRTFree( void * ptr ) { _aligned_free( ptr ); }
+
+/*
+==================
+AllocTestJob
+
+Randomly allocates and frees in a fixed set of slots with mostly small sizes,
+roughly the mix of idStr, idList and decl allocations.
+==================
+*/
+static void AllocTestJob( allocTestJob_t * job ) {
+	idRandom random( job->seed );
+	for ( int i = 0; i < job->iterations; i++ ) {
+		const int slot = random.RandomInt( ALLOC_TEST_SLOTS );
+		if ( job->slots[slot] != NULL ) {
+			job->freeFunc( job->slots[slot] );
+			job->slots[slot] = NULL;
+		} else {
+			const int r = random.RandomInt( 100 );
+			const int size = ( r < 60 ) ? 8 + random.RandomInt( 120 ) : ( r < 95 ) ? 128 + random.RandomInt( 896 ) : 1024 + random.RandomInt( 7168 );
+			job->slots[slot] = job->allocFunc( size );
+		}
+		job->numOps++;
+	}
+}
+
+/*
+==================
+AllocTestFreeJob
+
+Frees the objects left over by another job, which usually ran on a different thread.
+==================
+*/
+static void AllocTestFreeJob( allocTestJob_t * job ) {
+	for ( int i = 0; i < ALLOC_TEST_SLOTS; i++ ) {
+		if ( job->slots[i] != NULL ) {
+			job->freeFunc( job->slots[i] );
+			job->slots[i] = NULL;
+			job->numOps++;
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( AllocTestJob, "AllocTestJob" );
+REGISTER_PARALLEL_JOB( AllocTestFreeJob, "AllocTestFreeJob" );
+
+/*
+==================
+RunAllocTest
+==================
+*/
+static void RunAllocTest( const char * name, void * (*allocFunc)( const int size ), void (*freeFunc)( void * ptr ), int numJobs, int iterations ) {
+	allocTestJob_t * jobs = (allocTestJob_t *)_aligned_malloc( numJobs * sizeof( allocTestJob_t ), 16 );
+	memset( jobs, 0, numJobs * sizeof( allocTestJob_t ) );
+
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs * 2, 1, NULL );
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		jobs[i].allocFunc = allocFunc;
+		jobs[i].freeFunc = freeFunc;
+		jobs[i].seed = 1013904223 + i;
+		jobs[i].iterations = iterations;
+		jobList->AddJob( (jobRun_t)AllocTestJob, &jobs[i] );
+	}
+	jobList->InsertSyncPoint( SYNC_SIGNAL );
+	jobList->InsertSyncPoint( SYNC_SYNCHRONIZE );
+	// free the objects of the neighbouring job to get cross-thread frees
+	for ( int i = 0; i < numJobs; i++ ) {
+		jobList->AddJob( (jobRun_t)AllocTestFreeJob, &jobs[( i + 1 ) % numJobs] );
+	}
+
+	const uint64 start = Sys_Microseconds();
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_DEFAULT );
+	jobList->Wait();
+	const uint64 end = Sys_Microseconds();
+
+	parallelJobManager->FreeJobList( jobList );
+
+	int numOps = 0;
+	for ( int i = 0; i < numJobs; i++ ) {
+		numOps += jobs[i].numOps;
+	}
+	_aligned_free( jobs );
+
+	const double seconds = Max( end - start, (uint64)1 ) * ( 1.0 / 1000000.0 );
+	idLib::Printf( "%-24s %10d ops %8lld us %8.2f Mops/s\n", name, numOps, end - start, numOps / seconds * ( 1.0 / 1000000.0 ) );
+}
+
+/*
+==================
+testAllocator
+==================
+*/
+CONSOLE_COMMAND( testAllocator, "compares Mem_Alloc16 with the CRT aligned heap on the job threads, usage: testAllocator [numJobs] [iterations]", NULL ) {
+	const int numJobs = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 16;
+	const int iterations = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 200000;
+
+	idLib::Printf( "%d jobs on %d job threads, %d operations per job\n", numJobs, parallelJobManager->GetNumProcessingUnits(), iterations );
+	RunAllocTest( "_aligned_malloc", AllocTest_CRT, AllocTest_CRTFree, numJobs, iterations );
+	RunAllocTest( "Mem_Alloc16", AllocTest_Mem, AllocTest_MemFree, numJobs, iterations );
+}
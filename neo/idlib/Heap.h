@@ -58,6 +58,18 @@ ID_INLINE void		Mem_Free( void *ptr ) { Mem_Free16( ptr ); }
 void *		Mem_ClearedAlloc( const int size, const memTag_t tag );
 char *		Mem_CopyString( const char *in );
 
+// Per memory tag accounting maintained by the allocator.
+struct memTagStats_t {
+	int64		bytes;			// bytes currently allocated with the tag
+	int64		peakBytes;		// highest bytes seen, checked at least once per frame
+	int64		numAllocs;		// number of live allocations
+	int64		totalAllocs;	// number of allocations ever made
+};
+
+void		Mem_GetTagStats( const memTag_t tag, memTagStats_t & stats );
+void		Mem_UpdateTagPeaks();
+const char *Mem_GetTagName( const memTag_t tag );
+
 ID_INLINE void *operator new( size_t s ) {
 	return Mem_Alloc( s, TAG_NEW );
 }
@@ -233,6 +233,7 @@ public:
 
 // memory management and arrays
 #include "Heap.h"
+#include "FrameArena.h"
 #include "containers/Sort.h"
 #include "containers/List.h"
 
@@ -290,6 +291,7 @@ public:
 #include "containers/BinSearch.h"
 #include "containers/HashIndex.h"
 #include "containers/HashTable.h"
+#include "containers/FlatHashMap.h"
 #include "containers/StaticList.h"
 #include "containers/LinkList.h"
 #include "containers/Hierarchy.h"
@@ -313,6 +315,7 @@ public:
 #include "MapFile.h"
 #include "Timer.h"
 #include "Thread.h"
+#include "LockFreeQueue.h"
 #include "Swap.h"
 #include "Callback.h"
 #include "ParallelJobList.h"
@@ -0,0 +1,265 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __LOCKFREEQUEUE_H__
+#define __LOCKFREEQUEUE_H__
+
+/*
+===============================================================================
+
+	Bounded lock-free queues.
+
+	idLockFreeSPSCQueue is a ring buffer for exactly one producer thread and one
+	consumer thread. Each side owns one index and only reads the other one, so
+	neither side ever executes an interlocked instruction.
+
+	idLockFreeMPMCQueue allows any number of producer and consumer threads. Every
+	slot carries a sequence number that tells whether it is ready to be written
+	or read in the current lap of the ring, and the threads claim slots with a
+	compare-exchange on the enqueue or dequeue position.
+
+	Both queues have a fixed capacity which must be a power of two. Push returns
+	false when the queue is full and Pop returns false when it is empty, neither
+	call ever blocks. The element type is copied with operator=.
+
+===============================================================================
+*/
+
+/*
+================================================
+idLockFreeSPSCQueue
+================================================
+*/
+template< class type, int capacity >
+class idLockFreeSPSCQueue {
+public:
+							idLockFreeSPSCQueue();
+
+							// producer thread only
+	bool					Push( const type & element );
+							// consumer thread only
+	bool					Pop( type & element );
+
+							// only exact when called while neither side is active
+	int						Num() const { return tail - head; }
+	bool					IsEmpty() const { return tail == head; }
+	int						Max() const { return capacity; }
+
+private:
+	static const int		MASK = capacity - 1;
+
+	// the consumer side and the producer side live on separate cache lines
+	volatile int			head;
+	int						cachedTail;			// consumer copy of tail
+	byte					pad0[CACHE_LINE_SIZE - 2 * sizeof( int )];
+	volatile int			tail;
+	int						cachedHead;			// producer copy of head
+	byte					pad1[CACHE_LINE_SIZE - 2 * sizeof( int )];
+	type					items[capacity];
+
+							idLockFreeSPSCQueue( const idLockFreeSPSCQueue & );
+	void					operator=( const idLockFreeSPSCQueue & );
+};
+
+/*
+========================
+idLockFreeSPSCQueue::idLockFreeSPSCQueue
+========================
+*/
+template< class type, int capacity >
+ID_INLINE idLockFreeSPSCQueue< type, capacity >::idLockFreeSPSCQueue() :
+	head( 0 ),
+	cachedTail( 0 ),
+	tail( 0 ),
+	cachedHead( 0 ) {
+	compile_time_assert( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 );
+}
+
+/*
+========================
+idLockFreeSPSCQueue::Push
+========================
+*/
+template< class type, int capacity >
+ID_INLINE bool idLockFreeSPSCQueue< type, capacity >::Push( const type & element ) {
+	const int t = tail;
+	if ( t - cachedHead == capacity ) {
+		cachedHead = head;
+		if ( t - cachedHead == capacity ) {
+			return false;
+		}
+	}
+	items[t & MASK] = element;
+	// the element has to be written before the consumer can see the new tail
+	SYS_READWRITEBARRIER;
+	tail = t + 1;
+	return true;
+}
+
+/*
+========================
+idLockFreeSPSCQueue::Pop
+========================
+*/
+template< class type, int capacity >
+ID_INLINE bool idLockFreeSPSCQueue< type, capacity >::Pop( type & element ) {
+	const int h = head;
+	if ( h == cachedTail ) {
+		cachedTail = tail;
+		if ( h == cachedTail ) {
+			return false;
+		}
+	}
+	// the tail has to be read before the element
+	SYS_READWRITEBARRIER;
+	element = items[h & MASK];
+	SYS_READWRITEBARRIER;
+	head = h + 1;
+	return true;
+}
+
+/*
+================================================
+idLockFreeMPMCQueue
+================================================
+*/
+template< class type, int capacity >
+class idLockFreeMPMCQueue {
+public:
+							idLockFreeMPMCQueue();
+
+	bool					Push( const type & element );
+	bool					Pop( type & element );
+
+							// only exact when called while no other thread uses the queue
+	int						Num() const { return enqueuePos.GetValue() - dequeuePos.GetValue(); }
+	bool					IsEmpty() const { return Num() == 0; }
+	int						Max() const { return capacity; }
+
+private:
+	static const int		MASK = capacity - 1;
+
+	struct cell_t {
+		volatile int		sequence;
+		type				data;
+	};
+
+	cell_t					cells[capacity];
+	byte					pad0[CACHE_LINE_SIZE];
+	idSysInterlockedInteger	enqueuePos;
+	byte					pad1[CACHE_LINE_SIZE - sizeof( idSysInterlockedInteger )];
+	idSysInterlockedInteger	dequeuePos;
+	byte					pad2[CACHE_LINE_SIZE - sizeof( idSysInterlockedInteger )];
+
+							idLockFreeMPMCQueue( const idLockFreeMPMCQueue & );
+	void					operator=( const idLockFreeMPMCQueue & );
+};
+
+/*
+========================
+idLockFreeMPMCQueue::idLockFreeMPMCQueue
+========================
+*/
+template< class type, int capacity >
+ID_INLINE idLockFreeMPMCQueue< type, capacity >::idLockFreeMPMCQueue() {
+	compile_time_assert( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 );
+	for ( int i = 0; i < capacity; i++ ) {
+		cells[i].sequence = i;
+	}
+}
+
+/*
+========================
+idLockFreeMPMCQueue::Push
+
+A cell is free for position 'pos' when its sequence equals 'pos'. After the element
+is written the sequence is set to 'pos + 1', which marks the cell as readable.
+========================
+*/
+template< class type, int capacity >
+ID_INLINE bool idLockFreeMPMCQueue< type, capacity >::Push( const type & element ) {
+	int pos = enqueuePos.GetValue();
+	cell_t * cell;
+	for ( ; ; ) {
+		cell = &cells[pos & MASK];
+		const int diff = cell->sequence - pos;
+		if ( diff == 0 ) {
+			const int prev = enqueuePos.CompareExchange( pos, pos + 1 );
+			if ( prev == pos ) {
+				break;
+			}
+			pos = prev;
+		} else if ( diff < 0 ) {
+			// the cell still holds an element from the previous lap
+			return false;
+		} else {
+			pos = enqueuePos.GetValue();
+		}
+	}
+	cell->data = element;
+	SYS_READWRITEBARRIER;
+	cell->sequence = pos + 1;
+	return true;
+}
+
+/*
+========================
+idLockFreeMPMCQueue::Pop
+
+A cell is readable for position 'pos' when its sequence equals 'pos + 1'. After the
+element is read the sequence is set to 'pos + capacity', which frees the cell for the
+next lap of the ring.
+========================
+*/
+template< class type, int capacity >
+ID_INLINE bool idLockFreeMPMCQueue< type, capacity >::Pop( type & element ) {
+	int pos = dequeuePos.GetValue();
+	cell_t * cell;
+	for ( ; ; ) {
+		cell = &cells[pos & MASK];
+		const int diff = cell->sequence - ( pos + 1 );
+		if ( diff == 0 ) {
+			const int prev = dequeuePos.CompareExchange( pos, pos + 1 );
+			if ( prev == pos ) {
+				break;
+			}
+			pos = prev;
+		} else if ( diff < 0 ) {
+			// nothing has been written to the cell in this lap
+			return false;
+		} else {
+			pos = dequeuePos.GetValue();
+		}
+	}
+	SYS_READWRITEBARRIER;
+	element = cell->data;
+	SYS_READWRITEBARRIER;
+	cell->sequence = pos + capacity;
+	return true;
+}
+
+#endif /* !__LOCKFREEQUEUE_H__ */
@@ -132,6 +132,96 @@ static idCVar jobs_longJobMicroSec( "jobs_longJobMicroSec", "10000", CVAR_INTEGE
 
 const static int		MAX_THREADS	= 32;
 
+// job graphs are recorded for the "jobs_replayGraphs" benchmark, a recorded entry is
+// either the execution time of a job in microseconds or one of the sync point markers
+enum {
+	RECORDED_SIGNAL			= -1,
+	RECORDED_SYNCHRONIZE	= -2
+};
+
+struct recordedJobGraph_t {
+	jobListId_t					id;
+	jobListPriority_t			priority;
+	int							latency;		// microseconds from Submit() until Wait() returned
+	idList< int, TAG_JOBLIST >	entries;
+};
+
+static idList< recordedJobGraph_t *, TAG_JOBLIST >	recordedJobGraphs;
+static idSysMutex				recordedJobGraphsMutex;
+static int						numJobGraphsToRecord;
+
+/*
+================================================================================================
+
+	Job tracing
+
+	With "jobs_trace" enabled every executed job, every span a job thread spends stalled on
+	a sync point and every wait of a host thread on a job list is written to a ring buffer
+	per thread. The rings are lock-free, a thread only ever writes to its own ring, and
+	"jobs_writeTrace" dumps them in the Chrome trace event format.
+
+================================================================================================
+*/
+
+static idCVar jobs_trace( "jobs_trace", "0", CVAR_BOOL | CVAR_NOCHEAT, "record the timing of every job and sync point wait, dump with jobs_writeTrace" );
+
+enum jobTraceEventType_t {
+	JOB_TRACE_JOB,
+	JOB_TRACE_SYNC_WAIT,
+	JOB_TRACE_LIST_WAIT
+};
+
+struct jobTraceEvent_t {
+	uint64				start;
+	uint64				end;
+	jobRun_t			function;
+	short				listId;
+	short				type;
+};
+
+static const int		JOB_TRACE_RING_SIZE		= 16384;	// events per thread, must be a power of two
+static const int		JOB_TRACE_HOST_RING		= 0;		// ring for all threads that are not job threads
+
+compile_time_assert( CONST_ISPOWEROFTWO( JOB_TRACE_RING_SIZE ) );
+
+struct jobTraceRing_t {
+	idSysInterlockedPointer< jobTraceEvent_t >	events;		// allocated the first time the thread records an event
+	idSysInterlockedInteger						numEvents;
+};
+
+static jobTraceRing_t	jobTraceRings[1 + MAX_THREADS];
+static ID_TLS			jobTraceRingIndex;						// job threads store their thread number + 1
+
+/*
+========================
+JobTrace
+========================
+*/
+static void JobTrace( jobTraceEventType_t type, jobListId_t listId, jobRun_t function, uint64 start, uint64 end ) {
+	jobTraceRing_t & ring = jobTraceRings[(ptrdiff_t)jobTraceRingIndex];
+
+	jobTraceEvent_t * events = ring.events.Get();
+	if ( events == NULL ) {
+		jobTraceEvent_t * newEvents = (jobTraceEvent_t *)Mem_ClearedAlloc( JOB_TRACE_RING_SIZE * sizeof( jobTraceEvent_t ), TAG_JOBLIST );
+		events = ring.events.CompareExchange( NULL, newEvents );
+		if ( events != NULL ) {
+			// another host thread allocated the ring first
+			Mem_Free( newEvents );
+		} else {
+			events = newEvents;
+		}
+	}
+
+	// the host ring can be written by several threads so slots are claimed atomically
+	const int index = ring.numEvents.Increment() - 1;
+	jobTraceEvent_t & event = events[index & ( JOB_TRACE_RING_SIZE - 1 )];
+	event.start = start;
+	event.end = end;
+	event.function = function;
+	event.listId = (short)listId;
+	event.type = (short)type;
+}
+
 struct threadJobListState_t {
 								threadJobListState_t() :
 									jobList( NULL ),
@@ -195,6 +285,10 @@ public:
 
 	bool					WaitForOtherJobList();
 
+	// Called by the job manager instead of handing the list to the job threads
+	// when the work-stealing scheduler is active.
+	void					SubmitStealing( int numThreads );
+
 	//------------------------
 	// This is thread safe and called from the job threads.
 	//------------------------
@@ -206,6 +300,7 @@ public:
 	};
 
 	int						RunJobs( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
+	void					RunStolenJob( unsigned int threadNum, int jobIndex );
 
 private:
 	static const int		NUM_DONE_GUARDS = 4;	// cycle through 4 guards so we can cyclicly chain job lists
@@ -227,6 +322,8 @@ private:
 		jobRun_t	function;
 		void *		data;
 		int			executed;
+		int			signalIndex;	// signal this job counts towards, only set by the work-stealing scheduler
+		int			microSec;		// execution time of the last run
 	};
 	idList< job_t, TAG_JOBLIST >		jobList;
 	idList< idSysInterlockedInteger, TAG_JOBLIST >	signalJobCount;
@@ -237,6 +334,23 @@ private:
 	threadStats_t						deferredThreadStats;
 	threadStats_t						threadStats;
 
+	// a stage is the run of jobs up to the next SYNC_SYNCHRONIZE point,
+	// it is released to the work-stealing scheduler once the signal it waits on completed
+	struct stage_t {
+		int			firstJob;
+		int			numJobs;
+		int			waitSignal;
+	};
+	bool								stealing;
+	int									numStealThreads;
+	idList< stage_t, TAG_JOBLIST >		stages;
+	idSysInterlockedInteger				releasedStage;
+	idSysInterlockedInteger				numRemainingJobs;
+
+	bool					IsExecuting() const;
+	void					RecordGraph() const;
+	void					ExecuteJob( unsigned int threadNum, int jobIndex );
+	void					ReleaseStages( int threadNum );
 	int						RunJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
 
 	static void				Nop( void * data ) {}
@@ -265,7 +379,9 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	lastSignalJob( 0 ),
 	waitForGuard( NULL ),
 	currentDoneGuard( 0 ),
-	jobList() {
+	jobList(),
+	stealing( false ),
+	numStealThreads( 0 ) {
 
 	assert( listPriority != JOBLIST_PRIORITY_NONE );
 
@@ -275,6 +391,8 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	jobList.SetNum( 0 );
 	signalJobCount.AssureSize( maxSyncs + 1 );			// need one extra for submit
 	signalJobCount.SetNum( 0 );
+	stages.AssureSize( maxSyncs + 1 );
+	stages.SetNum( 0 );
 
 	memset( &deferredThreadStats, 0, sizeof( threadStats_t ) );
 	memset( &threadStats, 0, sizeof( threadStats_t ) );
@@ -309,6 +427,7 @@ ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data
 		job.function = function;
 		job.data = data;
 		job.executed = 0;
+		job.microSec = 0;
 	} else {
 		// debug output to show us what is overflowing
 		int currentJobCount[MAX_REGISTERED_JOBS] = {};
@@ -351,6 +470,7 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 				job_t & job = jobList.Alloc();
 				job.function = Nop;
 				job.data = & JOB_SIGNAL;
+				job.microSec = 0;
 				hasSignal = true;
 			}
 			break;
@@ -360,6 +480,7 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 				job_t & job = jobList.Alloc();
 				job.function = Nop;
 				job.data = & JOB_SYNCHRONIZE;
+				job.microSec = 0;
 				hasSignal = false;
 				numSyncs++;
 			}
@@ -380,6 +501,7 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 	assert( fetchLock.GetValue() == 0 );
 
 	done = false;
+	stealing = false;
 	currentJob.SetValue( 0 );
 
 	memset( &deferredThreadStats, 0, sizeof( deferredThreadStats ) );
@@ -409,6 +531,7 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 	job_t & job = jobList.Alloc();
 	job.function = Nop;
 	job.data = & JOB_LIST_DONE;
+	job.microSec = 0;
 
 	if ( threaded ) {
 		// hand over to the manager
@@ -436,7 +559,7 @@ void idParallelJobList_Threads::Wait() {
 		bool waited = false;
 		uint64 waitStart = Sys_Microseconds();
 
-		while ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 ) {
+		while ( IsExecuting() ) {
 			Sys_Yield();
 			waited = true;
 		}
@@ -446,13 +569,22 @@ void idParallelJobList_Threads::Wait() {
 			waited = true;
 		}
 
+		if ( numJobGraphsToRecord > 0 ) {
+			RecordGraph();
+		}
+
 		jobList.SetNum( 0 );
 		signalJobCount.SetNum( 0 );
+		stages.SetNum( 0 );
 		numSyncs = 0;
 		lastSignalJob = 0;
 
 		uint64 waitEnd = Sys_Microseconds();
 		deferredThreadStats.waitTime = waited ? ( waitEnd - waitStart ) : 0;
+
+		if ( waited && jobs_trace.GetBool() ) {
+			JobTrace( JOB_TRACE_LIST_WAIT, listId, NULL, waitStart, waitEnd );
+		}
 	}
 	memcpy( & threadStats, & deferredThreadStats, sizeof( threadStats ) );
 	done = true;
@@ -464,7 +596,7 @@ idParallelJobList_Threads::TryWait
 ========================
 */
 bool idParallelJobList_Threads::TryWait() {
-	if ( jobList.Num() == 0 || signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 ) {
+	if ( jobList.Num() == 0 || !IsExecuting() ) {
 		Wait();
 		return true;
 	}
@@ -536,6 +668,42 @@ volatile jobRun_t longJobFunc;
 volatile void * longJobData;
 #endif
 
+/*
+========================
+idParallelJobList_Threads::ExecuteJob
+========================
+*/
+void idParallelJobList_Threads::ExecuteJob( unsigned int threadNum, int jobIndex ) {
+	job_t & job = jobList[jobIndex];
+
+	uint64 jobStart = Sys_Microseconds();
+
+	job.function( job.data );
+	job.executed = 1;
+
+	uint64 jobEnd = Sys_Microseconds();
+	job.microSec = (int)( jobEnd - jobStart );
+	deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
+
+	if ( jobs_trace.GetBool() && job.function != Nop ) {
+		JobTrace( JOB_TRACE_JOB, listId, job.function, jobStart, jobEnd );
+	}
+
+#ifndef _DEBUG
+	if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
+		if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
+			&& GetId() != JOBLIST_UTILITY ) {
+			longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
+			longJobFunc = job.function;
+			longJobData = job.data;
+			const char * jobName = GetJobName( job.function );
+			const char * jobListName = GetJobListName( GetId() );
+			idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
+		}
+	}
+#endif
+}
+
 /*
 ========================
 idParallelJobList_Threads::RunJobsInternal
@@ -626,29 +794,7 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 		}
 
 		// execute the next job
-		{
-			uint64 jobStart = Sys_Microseconds();
-
-			jobList[state.nextJobIndex].function( jobList[state.nextJobIndex].data );
-			jobList[state.nextJobIndex].executed = 1;
-
-			uint64 jobEnd = Sys_Microseconds();
-			deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
-
-#ifndef _DEBUG
-			if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
-				if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
-					&& GetId() != JOBLIST_UTILITY ) {
-					longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
-					longJobFunc = jobList[state.nextJobIndex].function;
-					longJobData = jobList[state.nextJobIndex].data;
-					const char * jobName = GetJobName( jobList[state.nextJobIndex].function );
-					const char * jobListName = GetJobListName( GetId() );
-					idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
-				}
-			}
-#endif
-		}
+		ExecuteJob( threadNum, state.nextJobIndex );
 
 		result |= RUN_PROGRESS;
 
@@ -685,6 +831,156 @@ int idParallelJobList_Threads::RunJobs( unsigned int threadNum, threadJobListSta
 	return result;
 }
 
+/*
+========================
+idParallelJobList_Threads::SubmitStealing
+
+Splits the job list into stages at the synchronization points and hands the
+first stage to the work-stealing scheduler. Every job is tagged with the signal
+it counts towards so the job that completes a signal can release the next stage.
+========================
+*/
+void idParallelJobList_Threads::SubmitStealing( int numThreads ) {
+	assert( !done );
+
+	stealing = true;
+	numStealThreads = numThreads;
+
+	// the JOB_LIST_DONE marker at the end is not dealt out
+	const int numJobs = jobList.Num() - 1;
+
+	stages.SetNum( 0 );
+	stage_t * stage = &stages.Alloc();
+	stage->firstJob = 0;
+	stage->waitSignal = -1;
+
+	int signalIndex = 0;
+	for ( int i = 0; i < numJobs; i++ ) {
+		if ( jobList[i].data == & JOB_SIGNAL ) {
+			signalIndex++;
+		} else if ( jobList[i].data == & JOB_SYNCHRONIZE ) {
+			assert( signalIndex > 0 );
+			stage->numJobs = i - stage->firstJob;
+			stage = &stages.Alloc();
+			stage->firstJob = i;
+			stage->waitSignal = signalIndex - 1;
+		}
+		jobList[i].signalIndex = signalIndex;
+	}
+	stage->numJobs = numJobs - stage->firstJob;
+
+	numRemainingJobs.SetValue( numJobs );
+	releasedStage.SetValue( 0 );
+
+	void QueueStealJobs( idParallelJobList_Threads * jobList, jobListPriority_t priority, int firstJob, int numJobs, int threadNum, int numThreads );
+	QueueStealJobs( this, listPriority, stages[0].firstJob, stages[0].numJobs, -1, numStealThreads );
+}
+
+/*
+========================
+idParallelJobList_Threads::ReleaseStages
+
+Releases every stage for which the signal it waits on has completed. This may be
+called from several threads at the same time but each stage is only released once.
+========================
+*/
+void idParallelJobList_Threads::ReleaseStages( int threadNum ) {
+	for ( ; ; ) {
+		const int stage = releasedStage.GetValue();
+		if ( stage + 1 >= stages.Num() ) {
+			return;
+		}
+		if ( signalJobCount[stages[stage + 1].waitSignal].GetValue() > 0 ) {
+			return;
+		}
+		if ( releasedStage.CompareExchange( stage, stage + 1 ) != stage ) {
+			continue;
+		}
+		void QueueStealJobs( idParallelJobList_Threads * jobList, jobListPriority_t priority, int firstJob, int numJobs, int threadNum, int numThreads );
+		QueueStealJobs( this, listPriority, stages[stage + 1].firstJob, stages[stage + 1].numJobs, threadNum, numStealThreads );
+	}
+}
+
+/*
+========================
+idParallelJobList_Threads::RunStolenJob
+========================
+*/
+void idParallelJobList_Threads::RunStolenJob( unsigned int threadNum, int jobIndex ) {
+	assert( stealing );
+	assert( threadNum < MAX_THREADS );
+
+	uint64 start = Sys_Microseconds();
+
+	// the job is not counted as done until it has executed so Wait() cannot get past this
+	numThreadsExecuting.Increment();
+
+	if ( deferredThreadStats.startTime == 0 ) {
+		deferredThreadStats.startTime = start;	// first time any thread is running jobs from this list
+	}
+
+	ExecuteJob( threadNum, jobIndex );
+
+	if ( signalJobCount[jobList[jobIndex].signalIndex].Decrement() == 0 ) {
+		ReleaseStages( threadNum );
+	}
+
+	if ( numRemainingJobs.Decrement() == 0 ) {
+		deferredThreadStats.endTime = Sys_Microseconds();
+		doneGuards[currentDoneGuard].Decrement();
+	}
+
+	deferredThreadStats.threadTotalTime[threadNum] += Sys_Microseconds() - start;
+
+	numThreadsExecuting.Decrement();
+}
+
+/*
+========================
+idParallelJobList_Threads::IsExecuting
+========================
+*/
+bool idParallelJobList_Threads::IsExecuting() const {
+	if ( stealing ) {
+		return ( numRemainingJobs.GetValue() > 0 );
+	}
+	return ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 );
+}
+
+/*
+========================
+idParallelJobList_Threads::RecordGraph
+========================
+*/
+void idParallelJobList_Threads::RecordGraph() const {
+	idScopedCriticalSection lock( recordedJobGraphsMutex );
+
+	if ( numJobGraphsToRecord <= 0 ) {
+		return;
+	}
+	numJobGraphsToRecord--;
+
+	recordedJobGraph_t * graph = new (TAG_JOBLIST) recordedJobGraph_t;
+	graph->id = listId;
+	graph->priority = listPriority;
+	graph->latency = (int)( Sys_Microseconds() - deferredThreadStats.submitTime );
+	graph->entries.SetNum( 0 );
+	for ( int i = 0; i < jobList.Num(); i++ ) {
+		if ( jobList[i].data == & JOB_SIGNAL ) {
+			graph->entries.Append( RECORDED_SIGNAL );
+		} else if ( jobList[i].data == & JOB_SYNCHRONIZE ) {
+			graph->entries.Append( RECORDED_SYNCHRONIZE );
+		} else if ( jobList[i].data != & JOB_LIST_DONE ) {
+			graph->entries.Append( jobList[i].microSec );
+		}
+	}
+	recordedJobGraphs.Append( graph );
+
+	if ( numJobGraphsToRecord == 0 ) {
+		idLib::Printf( "recorded %d job graphs\n", recordedJobGraphs.Num() );
+	}
+}
+
 /*
 ========================
 idParallelJobList_Threads::WaitForOtherJobList
@@ -900,6 +1196,221 @@ jobListId_t idParallelJobList::GetId() const {
 /*
 ================================================================================================
 
+idJobStealQueues
+
+The work-stealing scheduler gives every job thread a deque of individual jobs for
+each job list priority. A job thread pops jobs from the back of its own deques and,
+once those run dry, steals jobs from the front of the deques of the other threads.
+The jobs that are released when a synchronization point is passed are pushed on the
+deques of the thread that passed it, so the other threads only touch them by stealing.
+
+================================================================================================
+*/
+
+struct stealJob_t {
+	idParallelJobList_Threads *	jobList;
+	int							jobIndex;
+};
+
+/*
+================================================
+idJobDeque
+================================================
+*/
+class idJobDeque {
+public:
+							idJobDeque() : first( 0 ), count( 0 ) {}
+
+	void					PushBack( idParallelJobList_Threads * jobList, int firstJob, int numJobs );
+	void					PushFront( const stealJob_t & job );
+	bool					PopBack( stealJob_t & job );
+	bool					PopFront( stealJob_t & job );
+	bool					IsEmpty() const { return count == 0; }
+
+private:
+	static const int		INITIAL_SIZE = 256;
+
+	idSysMutex				lock;
+	idList< stealJob_t, TAG_JOBLIST >	ring;	// the size of the ring is always a power of two
+	int						first;
+	volatile int			count;
+
+	void					Grow( int minSize );
+};
+
+/*
+========================
+idJobDeque::Grow
+========================
+*/
+void idJobDeque::Grow( int minSize ) {
+	int newSize = Max( ring.Num(), INITIAL_SIZE );
+	while ( newSize < minSize ) {
+		newSize <<= 1;
+	}
+	if ( newSize == ring.Num() ) {
+		return;
+	}
+	idList< stealJob_t, TAG_JOBLIST > newRing;
+	newRing.SetNum( newSize );
+	for ( int i = 0; i < count; i++ ) {
+		newRing[i] = ring[( first + i ) & ( ring.Num() - 1 )];
+	}
+	ring.Swap( newRing );
+	first = 0;
+}
+
+/*
+========================
+idJobDeque::PushBack
+========================
+*/
+void idJobDeque::PushBack( idParallelJobList_Threads * jobList, int firstJob, int numJobs ) {
+	idScopedCriticalSection scopedLock( lock );
+	Grow( count + numJobs );
+	const int mask = ring.Num() - 1;
+	for ( int i = 0; i < numJobs; i++ ) {
+		stealJob_t & job = ring[( first + count + i ) & mask];
+		job.jobList = jobList;
+		job.jobIndex = firstJob + i;
+	}
+	count += numJobs;
+}
+
+/*
+========================
+idJobDeque::PushFront
+========================
+*/
+void idJobDeque::PushFront( const stealJob_t & job ) {
+	idScopedCriticalSection scopedLock( lock );
+	Grow( count + 1 );
+	first = ( first - 1 ) & ( ring.Num() - 1 );
+	ring[first] = job;
+	count++;
+}
+
+/*
+========================
+idJobDeque::PopBack
+========================
+*/
+bool idJobDeque::PopBack( stealJob_t & job ) {
+	if ( count == 0 ) {
+		return false;
+	}
+	idScopedCriticalSection scopedLock( lock );
+	if ( count == 0 ) {
+		return false;
+	}
+	count--;
+	job = ring[( first + count ) & ( ring.Num() - 1 )];
+	return true;
+}
+
+/*
+========================
+idJobDeque::PopFront
+========================
+*/
+bool idJobDeque::PopFront( stealJob_t & job ) {
+	if ( count == 0 ) {
+		return false;
+	}
+	idScopedCriticalSection scopedLock( lock );
+	if ( count == 0 ) {
+		return false;
+	}
+	job = ring[first];
+	first = ( first + 1 ) & ( ring.Num() - 1 );
+	count--;
+	return true;
+}
+
+/*
+================================================
+idJobStealQueues
+================================================
+*/
+class idJobStealQueues {
+public:
+							idJobStealQueues() : numThreads( 0 ) {}
+
+	void					SetNumThreads( int numThreads ) { this->numThreads = numThreads; }
+
+	void					Push( int threadNum, jobListPriority_t priority, idParallelJobList_Threads * jobList, int firstJob, int numJobs );
+	bool					Pop( int threadNum, stealJob_t & job );
+	bool					IsEmpty() const;
+
+private:
+	static const int		NUM_PRIORITIES = JOBLIST_PRIORITY_HIGH;
+
+	int						numThreads;
+	idJobDeque				deques[MAX_THREADS][NUM_PRIORITIES];
+};
+
+static idJobStealQueues	jobStealQueues;
+
+/*
+========================
+idJobStealQueues::Push
+========================
+*/
+void idJobStealQueues::Push( int threadNum, jobListPriority_t priority, idParallelJobList_Threads * jobList, int firstJob, int numJobs ) {
+	assert( threadNum >= 0 && threadNum < numThreads );
+	assert( priority > JOBLIST_PRIORITY_NONE && priority <= NUM_PRIORITIES );
+	deques[threadNum][priority - 1].PushBack( jobList, firstJob, numJobs );
+}
+
+/*
+========================
+idJobStealQueues::Pop
+
+Returns the job with the highest priority, preferring jobs from the deque of
+the given thread. Jobs from job lists that still wait on another job list are
+moved to the front of their deque and skipped.
+========================
+*/
+bool idJobStealQueues::Pop( int threadNum, stealJob_t & job ) {
+	for ( int priority = NUM_PRIORITIES - 1; priority >= 0; priority-- ) {
+		if ( deques[threadNum][priority].PopBack( job ) ) {
+			if ( !job.jobList->WaitForOtherJobList() ) {
+				return true;
+			}
+			deques[threadNum][priority].PushFront( job );
+		}
+		for ( int i = 1; i < numThreads; i++ ) {
+			idJobDeque & victim = deques[( threadNum + i ) % numThreads][priority];
+			if ( victim.PopFront( job ) ) {
+				if ( !job.jobList->WaitForOtherJobList() ) {
+					return true;
+				}
+				victim.PushFront( job );
+			}
+		}
+	}
+	return false;
+}
+
+/*
+========================
+idJobStealQueues::IsEmpty
+========================
+*/
+bool idJobStealQueues::IsEmpty() const {
+	for ( int i = 0; i < numThreads; i++ ) {
+		for ( int priority = 0; priority < NUM_PRIORITIES; priority++ ) {
+			if ( !deques[i][priority].IsEmpty() ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+================================================================================================
+
 idJobThread
 
 ================================================================================================
@@ -932,6 +1443,7 @@ private:
 	unsigned int				threadNum;
 
 	virtual int					Run();
+	void						RunStolenJobs();
 };
 
 /*
@@ -991,6 +1503,9 @@ int idJobThread::Run() {
 	threadJobListState_t threadJobListState[MAX_JOBLISTS];
 	int numJobLists = 0;
 	int lastStalledJobList = -1;
+	uint64 stallStart = 0;
+
+	jobTraceRingIndex = threadNum + 1;
 
 	while ( !IsTerminating() ) {
 
@@ -1005,6 +1520,7 @@ int idJobThread::Run() {
 			firstJobList++;
 		}
 		if ( numJobLists == 0 ) {
+			RunStolenJobs();
 			break;
 		}
 
@@ -1037,6 +1553,18 @@ int idJobThread::Run() {
 		// try running one or more jobs from the current job list
 		int result = threadJobListState[currentJobList].jobList->RunJobs( threadNum, threadJobListState[currentJobList], singleJob );
 
+		// trace the time spent without making progress because of sync points
+		if ( ( result & ( idParallelJobList_Threads::RUN_PROGRESS | idParallelJobList_Threads::RUN_DONE ) ) != 0 ) {
+			if ( stallStart != 0 ) {
+				JobTrace( JOB_TRACE_SYNC_WAIT, threadJobListState[currentJobList].jobList->GetId(), NULL, stallStart, Sys_Microseconds() );
+				stallStart = 0;
+			}
+		} else if ( ( result & idParallelJobList_Threads::RUN_STALLED ) != 0 ) {
+			if ( stallStart == 0 && jobs_trace.GetBool() ) {
+				stallStart = Sys_Microseconds();
+			}
+		}
+
 		if ( ( result & idParallelJobList_Threads::RUN_DONE ) != 0 ) {
 			// done with this job list so remove it from the local list
 			for ( int i = currentJobList; i < numJobLists - 1; i++ ) {
@@ -1059,6 +1587,35 @@ int idJobThread::Run() {
 	return 0;
 }
 
+/*
+========================
+idJobThread::RunStolenJobs
+========================
+*/
+void idJobThread::RunStolenJobs() {
+	uint64 stallStart = 0;
+
+	while ( !IsTerminating() ) {
+		stealJob_t job;
+		if ( !jobStealQueues.Pop( threadNum, job ) ) {
+			if ( jobStealQueues.IsEmpty() ) {
+				break;
+			}
+			// only jobs from job lists that wait on another job list are left
+			if ( stallStart == 0 && jobs_trace.GetBool() ) {
+				stallStart = Sys_Microseconds();
+			}
+			Sys_Yield();
+			continue;
+		}
+		if ( stallStart != 0 ) {
+			JobTrace( JOB_TRACE_SYNC_WAIT, job.jobList->GetId(), NULL, stallStart, Sys_Microseconds() );
+			stallStart = 0;
+		}
+		job.jobList->RunStolenJob( threadNum, job.jobIndex );
+	}
+}
+
 /*
 ================================================================================================
 
@@ -1104,12 +1661,13 @@ extern void Sys_CPUCount( int & logicalNum, int & coreNum, int & packageNum );
 
 
 idCVar jobs_numThreads( "jobs_numThreads", NUM_JOB_THREADS, CVAR_INTEGER | CVAR_NOCHEAT, "number of threads used to crunch through jobs", 0, MAX_JOB_THREADS );
+idCVar jobs_scheduler( "jobs_scheduler", "0", CVAR_INTEGER | CVAR_NOCHEAT | CVAR_INIT, "job scheduler selected when the job manager starts, 0 = shared job list, 1 = per-thread work-stealing deques", 0, 1 );
 
 class idParallelJobManagerLocal : public idParallelJobManager {
 public:
 	virtual						~idParallelJobManagerLocal() {}
 
-	virtual void				Init();
+	virtual void				Init( jobScheduler_t scheduler );
 	virtual void				Shutdown();
 
 	virtual idParallelJobList *	AllocJobList( jobListId_t id, jobListPriority_t priority, unsigned int maxJobs, unsigned int maxSyncs, const idColor * color );
@@ -1120,13 +1678,21 @@ public:
 	virtual idParallelJobList *	GetJobList( int index );
 
 	virtual int					GetNumProcessingUnits();
+	virtual jobScheduler_t		GetScheduler() const { return scheduler; }
 
 	virtual void				WaitForAllJobLists();
 
+	virtual void				SyncPoint();
+
 	void						Submit( idParallelJobList_Threads * jobList, int parallelism );
+	void						QueueStealJobs( idParallelJobList_Threads * jobList, jobListPriority_t priority, int firstJob, int numJobs, int threadNum, int numThreads );
+
+	// Only used by the job graph replay benchmark from SyncPoint, all job lists must be idle.
+	void						SetScheduler( jobScheduler_t scheduler );
 
 private:
 	idJobThread						threads[MAX_JOB_THREADS];
+	jobScheduler_t					scheduler;
 	unsigned int					maxThreads;
 	int								numPhysicalCpuCores;
 	int								numLogicalCpuCores;
@@ -1146,16 +1712,31 @@ void SubmitJobList( idParallelJobList_Threads * jobList, int parallelism ) {
 	parallelJobManagerLocal.Submit( jobList, parallelism );
 }
 
+/*
+========================
+QueueStealJobs
+========================
+*/
+void QueueStealJobs( idParallelJobList_Threads * jobList, jobListPriority_t priority, int firstJob, int numJobs, int threadNum, int numThreads ) {
+	parallelJobManagerLocal.QueueStealJobs( jobList, priority, firstJob, numJobs, threadNum, numThreads );
+}
+
 /*
 ========================
 idParallelJobManagerLocal::Init
 ========================
 */
-void idParallelJobManagerLocal::Init() {
+void idParallelJobManagerLocal::Init( jobScheduler_t scheduler ) {
 	// on consoles this will have specific cores for the threads, but on PC they will all be CORE_ANY
 	core_t cores[] = JOB_THREAD_CORES;
 	assert( sizeof( cores ) / sizeof( cores[0] ) >= MAX_JOB_THREADS );
 
+	if ( scheduler == JOB_SCHEDULER_DEFAULT ) {
+		scheduler = (jobScheduler_t) jobs_scheduler.GetInteger();
+	}
+	this->scheduler = scheduler;
+	jobStealQueues.SetNumThreads( MAX_JOB_THREADS );
+
 	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
 		threads[i].Start( cores[i], i );
 	}
@@ -1290,8 +1871,469 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads * jobList, int
 		return;
 	}
 
+	if ( scheduler == JOB_SCHEDULER_WORK_STEALING ) {
+		jobList->SubmitStealing( Min( numThreads, MAX_JOB_THREADS ) );
+		return;
+	}
+
 	for ( int i = 0; i < numThreads; i++ ) {
 		threads[i].AddJobList( jobList );
 		threads[i].SignalWork();
 	}
-}
\ No newline at end of file
+}
+/*
+========================
+idParallelJobManagerLocal::QueueStealJobs
+
+Pushes a range of jobs on the work-stealing deques. Jobs released by a job thread
+go on the deques of that thread, jobs from the submitting thread are dealt out in
+contiguous blocks over the threads that may work on the job list.
+========================
+*/
+void idParallelJobManagerLocal::QueueStealJobs( idParallelJobList_Threads * jobList, jobListPriority_t priority, int firstJob, int numJobs, int threadNum, int numThreads ) {
+	assert( numThreads > 0 && numThreads <= MAX_JOB_THREADS );
+
+	if ( numJobs <= 0 ) {
+		return;
+	}
+
+	if ( threadNum >= 0 ) {
+		jobStealQueues.Push( threadNum, priority, jobList, firstJob, numJobs );
+	} else {
+		for ( int i = 0; i < numThreads; i++ ) {
+			const int start = firstJob + numJobs * i / numThreads;
+			const int end = firstJob + numJobs * ( i + 1 ) / numThreads;
+			if ( end > start ) {
+				jobStealQueues.Push( i, priority, jobList, start, end - start );
+			}
+		}
+	}
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		if ( i != threadNum ) {
+			threads[i].SignalWork();
+		}
+	}
+}
+
+/*
+========================
+idParallelJobManagerLocal::SetScheduler
+========================
+*/
+void idParallelJobManagerLocal::SetScheduler( jobScheduler_t scheduler ) {
+	assert( idLib::IsMainThread() );
+	WaitForAllJobLists();
+	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+		threads[i].WaitForThread();
+	}
+	this->scheduler = scheduler;
+}
+
+/*
+================================================================================================
+
+	Job graph recording and replay
+
+	"jobs_recordGraphs" captures the shape of the next submitted job lists: the execution
+	time of every job and the position of the sync points. "jobs_replayGraphs" replays
+	captured graphs with spinning jobs of the same length through both schedulers and
+	reports the submit-to-wait latency percentiles per job list. The replay does not need
+	the renderer or a map so it can be run from a dedicated server.
+
+	Switching the scheduler while another thread submits a job list would hand that list
+	to a scheduler it was not queued with, so the command only remembers the request and
+	the replay runs from SyncPoint at the start of the next frame.
+
+================================================================================================
+*/
+
+static const int JOB_GRAPH_FILE_MAGIC		= ( 'J' << 24 ) | ( 'G' << 16 ) | ( 'R' << 8 ) | 'F';
+static const int JOB_GRAPH_FILE_VERSION		= 1;
+
+struct replayJob_t {
+	int		microSec;
+};
+
+/*
+========================
+ReplayJob
+========================
+*/
+static void ReplayJob( replayJob_t * job ) {
+	const uint64 end = Sys_Microseconds() + job->microSec;
+	while ( Sys_Microseconds() < end ) {
+	}
+}
+
+REGISTER_PARALLEL_JOB( ReplayJob, "ReplayJob" );
+
+/*
+========================
+FreeRecordedJobGraphs
+========================
+*/
+static void FreeRecordedJobGraphs( idList< recordedJobGraph_t *, TAG_JOBLIST > & graphs ) {
+	graphs.DeleteContents( true );
+}
+
+/*
+========================
+ReplayJobGraphs
+
+Returns the latencies of every replayed graph, indexed by job list id.
+========================
+*/
+static void ReplayJobGraphs( const idList< recordedJobGraph_t *, TAG_JOBLIST > & graphs, int repeat, idList< int, TAG_JOBLIST > latencies[MAX_JOBLISTS] ) {
+	idParallelJobList * jobLists[MAX_JOBLISTS] = {};
+	idList< replayJob_t, TAG_JOBLIST > replayJobs;
+
+	for ( int i = 0; i < MAX_JOBLISTS; i++ ) {
+		latencies[i].SetNum( 0 );
+	}
+
+	for ( int r = 0; r < repeat; r++ ) {
+		for ( int g = 0; g < graphs.Num(); g++ ) {
+			const recordedJobGraph_t * graph = graphs[g];
+
+			idParallelJobList * jobList = jobLists[graph->id];
+			if ( jobList == NULL ) {
+				jobList = parallelJobManager->AllocJobList( graph->id, graph->priority, graph->entries.Num(), graph->entries.Num() / 2, NULL );
+				jobLists[graph->id] = jobList;
+			}
+
+			// the job data must stay put while the job list runs
+			replayJobs.SetNum( graph->entries.Num() );
+
+			for ( int i = 0; i < graph->entries.Num(); i++ ) {
+				const int entry = graph->entries[i];
+				if ( entry == RECORDED_SIGNAL ) {
+					jobList->InsertSyncPoint( SYNC_SIGNAL );
+				} else if ( entry == RECORDED_SYNCHRONIZE ) {
+					jobList->InsertSyncPoint( SYNC_SYNCHRONIZE );
+				} else {
+					replayJobs[i].microSec = entry;
+					jobList->AddJob( (jobRun_t)ReplayJob, &replayJobs[i] );
+				}
+			}
+
+			const uint64 start = Sys_Microseconds();
+			jobList->Submit();
+			jobList->Wait();
+			latencies[graph->id].Append( (int)( Sys_Microseconds() - start ) );
+		}
+	}
+
+	for ( int i = 0; i < MAX_JOBLISTS; i++ ) {
+		parallelJobManager->FreeJobList( jobLists[i] );
+	}
+
+	for ( int i = 0; i < MAX_JOBLISTS; i++ ) {
+		latencies[i].SortWithTemplate( idSort_QuickDefault< int >() );
+	}
+}
+
+/*
+========================
+PrintJobGraphLatencies
+========================
+*/
+static void PrintJobGraphLatencies( const char * schedulerName, idList< int, TAG_JOBLIST > latencies[MAX_JOBLISTS] ) {
+	for ( int i = 0; i < MAX_JOBLISTS; i++ ) {
+		const idList< int, TAG_JOBLIST > & l = latencies[i];
+		if ( l.Num() == 0 ) {
+			continue;
+		}
+		idLib::Printf( "%-14s %7d %7d %8d %8d %8d %8d\n", schedulerName, i, l.Num(),
+							l[l.Num() * 50 / 100], l[l.Num() * 90 / 100], l[l.Num() * 99 / 100], l[l.Num() - 1] );
+	}
+}
+
+/*
+========================
+jobs_recordGraphs
+========================
+*/
+CONSOLE_COMMAND( jobs_recordGraphs, "records the job graphs of the next submitted job lists, usage: jobs_recordGraphs [count]", NULL ) {
+	idScopedCriticalSection lock( recordedJobGraphsMutex );
+
+	FreeRecordedJobGraphs( recordedJobGraphs );
+	numJobGraphsToRecord = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 1000;
+	idLib::Printf( "recording the next %d job graphs\n", numJobGraphsToRecord );
+}
+
+/*
+========================
+jobs_writeGraphs
+========================
+*/
+CONSOLE_COMMAND( jobs_writeGraphs, "writes the recorded job graphs to a file, usage: jobs_writeGraphs <filename>", NULL ) {
+	if ( args.Argc() < 2 ) {
+		idLib::Printf( "usage: jobs_writeGraphs <filename>\n" );
+		return;
+	}
+
+	idScopedCriticalSection lock( recordedJobGraphsMutex );
+
+	idFile * file = fileSystem->OpenFileWrite( args.Argv( 1 ) );
+	if ( file == NULL ) {
+		idLib::Printf( "couldn't open %s for writing\n", args.Argv( 1 ) );
+		return;
+	}
+	file->WriteBig( JOB_GRAPH_FILE_MAGIC );
+	file->WriteBig( JOB_GRAPH_FILE_VERSION );
+	file->WriteBig( recordedJobGraphs.Num() );
+	for ( int i = 0; i < recordedJobGraphs.Num(); i++ ) {
+		const recordedJobGraph_t * graph = recordedJobGraphs[i];
+		file->WriteBig( (int)graph->id );
+		file->WriteBig( (int)graph->priority );
+		file->WriteBig( graph->latency );
+		file->WriteBig( graph->entries.Num() );
+		file->WriteBigArray( graph->entries.Ptr(), graph->entries.Num() );
+	}
+	delete file;
+
+	idLib::Printf( "wrote %d job graphs to %s\n", recordedJobGraphs.Num(), args.Argv( 1 ) );
+}
+
+static idStr	pendingJobGraphReplay;
+static int		pendingJobGraphReplayRepeat;
+
+/*
+========================
+ReplayJobGraphFile
+========================
+*/
+static void ReplayJobGraphFile( const char * fileName, const int repeat ) {
+	idFile * file = fileSystem->OpenFileRead( fileName );
+	if ( file == NULL ) {
+		idLib::Printf( "couldn't open %s\n", fileName );
+		return;
+	}
+
+	int magic = 0;
+	int version = 0;
+	int numGraphs = 0;
+	file->ReadBig( magic );
+	file->ReadBig( version );
+	file->ReadBig( numGraphs );
+	if ( magic != JOB_GRAPH_FILE_MAGIC || version != JOB_GRAPH_FILE_VERSION || numGraphs < 0 ) {
+		idLib::Printf( "%s is not a job graph file\n", fileName );
+		delete file;
+		return;
+	}
+
+	idList< recordedJobGraph_t *, TAG_JOBLIST > graphs;
+	for ( int i = 0; i < numGraphs; i++ ) {
+		int id = 0;
+		int priority = 0;
+		int numEntries = 0;
+		recordedJobGraph_t * graph = new (TAG_JOBLIST) recordedJobGraph_t;
+		file->ReadBig( id );
+		file->ReadBig( priority );
+		file->ReadBig( graph->latency );
+		file->ReadBig( numEntries );
+		if ( id < 0 || id >= MAX_JOBLISTS || priority <= JOBLIST_PRIORITY_NONE || priority > JOBLIST_PRIORITY_HIGH || numEntries < 0 ) {
+			idLib::Printf( "%s is corrupt\n", fileName );
+			delete graph;
+			FreeRecordedJobGraphs( graphs );
+			delete file;
+			return;
+		}
+		graph->id = (jobListId_t)id;
+		graph->priority = (jobListPriority_t)priority;
+		graph->entries.SetNum( numEntries );
+		file->ReadBigArray( graph->entries.Ptr(), numEntries );
+		graphs.Append( graph );
+	}
+	delete file;
+
+	const jobScheduler_t originalScheduler = parallelJobManagerLocal.GetScheduler();
+
+	idLib::Printf( "replaying %d job graphs %d times on %d threads\n", graphs.Num(), repeat, parallelJobManager->GetNumProcessingUnits() );
+	idLib::Printf( "scheduler        listId    runs   p50 us   p90 us   p99 us   max us\n" );
+
+	idList< int, TAG_JOBLIST > latencies[MAX_JOBLISTS];
+
+	parallelJobManagerLocal.SetScheduler( JOB_SCHEDULER_SHARED_LIST );
+	ReplayJobGraphs( graphs, repeat, latencies );
+	PrintJobGraphLatencies( "shared list", latencies );
+
+	parallelJobManagerLocal.SetScheduler( JOB_SCHEDULER_WORK_STEALING );
+	ReplayJobGraphs( graphs, repeat, latencies );
+	PrintJobGraphLatencies( "work stealing", latencies );
+
+	parallelJobManagerLocal.SetScheduler( originalScheduler );
+
+	FreeRecordedJobGraphs( graphs );
+}
+
+/*
+========================
+idParallelJobManagerLocal::SyncPoint
+========================
+*/
+void idParallelJobManagerLocal::SyncPoint() {
+	assert( idLib::IsMainThread() );
+
+	if ( pendingJobGraphReplay.IsEmpty() ) {
+		return;
+	}
+	WaitForAllJobLists();
+	ReplayJobGraphFile( pendingJobGraphReplay, pendingJobGraphReplayRepeat );
+	pendingJobGraphReplay.Clear();
+}
+
+/*
+========================
+jobs_replayGraphs
+========================
+*/
+CONSOLE_COMMAND( jobs_replayGraphs, "replays recorded job graphs through all job schedulers at the start of the next frame, usage: jobs_replayGraphs <filename> [repeat]", NULL ) {
+	if ( args.Argc() < 2 ) {
+		idLib::Printf( "usage: jobs_replayGraphs <filename> [repeat]\n" );
+		return;
+	}
+	pendingJobGraphReplay = args.Argv( 1 );
+	pendingJobGraphReplayRepeat = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 1;
+}
+
+/*
+================================================================================================
+
+	Job trace export
+
+================================================================================================
+*/
+
+/*
+========================
+GetTraceJobListName
+========================
+*/
+static const char * GetTraceJobListName( int id ) {
+	switch( id ) {
+		case JOBLIST_RENDERER_FRONTEND:	return "JOBLIST_RENDERER_FRONTEND";
+		case JOBLIST_RENDERER_BACKEND:	return "JOBLIST_RENDERER_BACKEND";
+		case JOBLIST_UTILITY:			return "JOBLIST_UTILITY";
+		default:						return va( "JOBLIST_%d", id );
+	}
+}
+
+/*
+========================
+jobs_writeTrace
+========================
+*/
+CONSOLE_COMMAND( jobs_writeTrace, "writes the events recorded with jobs_trace as a Chrome trace (chrome://tracing), usage: jobs_writeTrace <filename>", NULL ) {
+	if ( args.Argc() < 2 ) {
+		idLib::Printf( "usage: jobs_writeTrace <filename>\n" );
+		return;
+	}
+
+	idFile * file = fileSystem->OpenFileWrite( args.Argv( 1 ) );
+	if ( file == NULL ) {
+		idLib::Printf( "couldn't open %s for writing\n", args.Argv( 1 ) );
+		return;
+	}
+
+	// stop recording while the rings are read
+	const bool tracing = jobs_trace.GetBool();
+	jobs_trace.SetBool( false );
+	parallelJobManager->WaitForAllJobLists();
+
+	int numWritten = 0;
+	file->Printf( "{\"traceEvents\":[\n" );
+	for ( int r = 0; r < 1 + MAX_THREADS; r++ ) {
+		const jobTraceEvent_t * events = jobTraceRings[r].events.Get();
+		const int numEvents = jobTraceRings[r].numEvents.GetValue();
+		if ( events == NULL || numEvents == 0 ) {
+			continue;
+		}
+		file->Printf( "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+							numWritten > 0 ? ",\n" : "", r, ( r == JOB_TRACE_HOST_RING ) ? "host" : va( "JobListProcessor_%d", r - 1 ) );
+		numWritten++;
+
+		const int first = Max( 0, numEvents - JOB_TRACE_RING_SIZE );
+		for ( int i = first; i < numEvents; i++ ) {
+			const jobTraceEvent_t & event = events[i & ( JOB_TRACE_RING_SIZE - 1 )];
+			const char * name;
+			switch( event.type ) {
+				case JOB_TRACE_JOB:			name = GetJobName( event.function ); break;
+				case JOB_TRACE_SYNC_WAIT:	name = "sync point wait"; break;
+				default:					name = "job list wait"; break;
+			}
+			file->Printf( ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%d}",
+							name, GetTraceJobListName( event.listId ), event.start, event.end - event.start, r );
+			numWritten++;
+		}
+
+		jobTraceRings[r].numEvents.SetValue( 0 );
+	}
+	file->Printf( "\n]}\n" );
+	delete file;
+
+	jobs_trace.SetBool( tracing );
+
+	idLib::Printf( "wrote %d trace events to %s\n", numWritten, args.Argv( 1 ) );
+}
+
+struct traceOverheadJob_t {
+	float	result;
+};
+
+/*
+========================
+TraceOverheadJob
+
+About as much work as a small frontend job.
+========================
+*/
+static void TraceOverheadJob( traceOverheadJob_t * job ) {
+	float x = 1.0f;
+	for ( int i = 0; i < 4096; i++ ) {
+		x = x * 0.999f + idMath::Sqrt( x + (float)i );
+	}
+	job->result = x;
+}
+
+REGISTER_PARALLEL_JOB( TraceOverheadJob, "TraceOverheadJob" );
+
+/*
+========================
+jobs_traceOverhead
+========================
+*/
+CONSOLE_COMMAND( jobs_traceOverhead, "measures the cost of jobs_trace, usage: jobs_traceOverhead [numJobs] [iterations]", NULL ) {
+	const int numJobs = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 1024;
+	const int iterations = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 64;
+
+	idList< traceOverheadJob_t, TAG_JOBLIST > jobs;
+	jobs.SetNum( numJobs );
+
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+
+	const bool tracing = jobs_trace.GetBool();
+
+	uint64 best[2] = { (uint64)-1, (uint64)-1 };
+	for ( int i = 0; i < iterations * 2; i++ ) {
+		// alternate to spread out any frequency scaling noise
+		const int trace = i & 1;
+		jobs_trace.SetBool( trace != 0 );
+
+		for ( int j = 0; j < numJobs; j++ ) {
+			jobList->AddJob( (jobRun_t)TraceOverheadJob, &jobs[j] );
+		}
+		const uint64 start = Sys_Microseconds();
+		jobList->Submit();
+		jobList->Wait();
+		best[trace] = Min( best[trace], Sys_Microseconds() - start );
+	}
+
+	jobs_trace.SetBool( tracing );
+
+	parallelJobManager->FreeJobList( jobList );
+
+	const double overhead = ( best[0] > 0 ) ? ( (double)best[1] - (double)best[0] ) * 100.0 / (double)best[0] : 0.0;
+	idLib::Printf( "%d jobs: %llu us without tracing, %llu us with tracing, %1.2f%% overhead\n", numJobs, best[0], best[1], overhead );
+}
@@ -63,6 +63,12 @@ enum jobListParallelism_t {
 	JOBLIST_PARALLELISM_MAX_THREADS		= -3	// use the maximum number of job threads, which can help if there is IO to overlap
 };
 
+enum jobScheduler_t {
+	JOB_SCHEDULER_DEFAULT				= -1,	// use the "jobs_scheduler" cvar
+	JOB_SCHEDULER_SHARED_LIST			= 0,	// job threads claim jobs from a job list through a shared counter
+	JOB_SCHEDULER_WORK_STEALING			= 1		// jobs are dealt out over per-thread deques and idle threads steal
+};
+
 #define assert_spu_local_store( ptr )
 #define assert_not_spu_local_store( ptr )
 
@@ -140,7 +146,8 @@ class idParallelJobManager {
 public:
 	virtual						~idParallelJobManager() {}
 
-	virtual void				Init() = 0;
+	// The scheduler cannot be changed while the job manager is running.
+	virtual void				Init( jobScheduler_t scheduler = JOB_SCHEDULER_DEFAULT ) = 0;
 	virtual void				Shutdown() = 0;
 
 	virtual idParallelJobList *	AllocJobList( jobListId_t id, jobListPriority_t priority, unsigned int maxJobs, unsigned int maxSyncs, const idColor * color ) = 0;
@@ -151,8 +158,13 @@ public:
 	virtual idParallelJobList *	GetJobList( int index ) = 0;
 
 	virtual int					GetNumProcessingUnits() = 0;
+	virtual jobScheduler_t		GetScheduler() const = 0;
 
 	virtual void				WaitForAllJobLists() = 0;
+
+	// Called by the main thread at the start of every frame, when no other thread can be
+	// submitting job lists, to run the debug commands that need all job lists idle.
+	virtual void				SyncPoint() = 0;
 };
 
 extern idParallelJobManager *	parallelJobManager;
@@ -281,3 +281,208 @@ void TestWorkers() {
 		workers.SignalWorkAndWait();
 	}
 }
+
+/*
+================================================================================================
+
+	lock-free queue stress test and benchmark
+
+================================================================================================
+*/
+
+static const int QUEUE_TEST_CAPACITY = 1024;
+
+struct queueTestItem_t {
+	int		producer;
+	int		sequence;
+};
+
+/*
+================================================
+idLockedQueueTest is the mutex-protected idList ring the lock-free queues are compared against.
+================================================
+*/
+class idLockedQueueTest {
+public:
+					idLockedQueueTest() : head( 0 ), tail( 0 ) { ring.SetNum( QUEUE_TEST_CAPACITY ); }
+
+	bool			Push( const queueTestItem_t & element ) {
+						idScopedCriticalSection lock( mutex );
+						if ( tail - head == ring.Num() ) {
+							return false;
+						}
+						ring[tail++ & ( ring.Num() - 1 )] = element;
+						return true;
+					}
+	bool			Pop( queueTestItem_t & element ) {
+						idScopedCriticalSection lock( mutex );
+						if ( tail == head ) {
+							return false;
+						}
+						element = ring[head++ & ( ring.Num() - 1 )];
+						return true;
+					}
+
+private:
+	idSysMutex		mutex;
+	idList< queueTestItem_t, TAG_IDLIB_LIST > ring;
+	int				head;
+	int				tail;
+};
+
+/*
+================================================
+idQueueTestProducer pushes an increasing sequence of items.
+================================================
+*/
+template< class queueType >
+class idQueueTestProducer : public idSysThread {
+public:
+	virtual int Run() {
+		while ( !*start ) {
+			Sys_Yield();
+		}
+		queueTestItem_t item;
+		item.producer = producer;
+		for ( item.sequence = 0; item.sequence < numItems; item.sequence++ ) {
+			while ( !queue->Push( item ) ) {
+				Sys_Yield();
+			}
+		}
+		return 0;
+	}
+
+	queueType *			queue;
+	volatile bool *		start;
+	int					producer;
+	int					numItems;
+};
+
+/*
+================================================
+idQueueTestConsumer pops items until all produced items have been consumed and
+checks that the items of each producer arrive in order.
+================================================
+*/
+template< class queueType >
+class idQueueTestConsumer : public idSysThread {
+public:
+	virtual int Run() {
+		while ( !*start ) {
+			Sys_Yield();
+		}
+		queueTestItem_t item;
+		while ( consumed->GetValue() < totalItems ) {
+			if ( !queue->Pop( item ) ) {
+				Sys_Yield();
+				continue;
+			}
+			if ( item.producer < 0 || item.producer >= lastSequence.Num() || item.sequence <= lastSequence[item.producer] ) {
+				numErrors++;
+			} else {
+				lastSequence[item.producer] = item.sequence;
+			}
+			checksum += item.sequence;
+			numItems++;
+			consumed->Increment();
+		}
+		return 0;
+	}
+
+	queueType *					queue;
+	volatile bool *				start;
+	idSysInterlockedInteger *	consumed;
+	int							totalItems;
+	idList< int >				lastSequence;
+	int64						checksum;
+	int64						numItems;
+	int							numErrors;
+};
+
+/*
+========================
+TestQueue
+========================
+*/
+template< class queueType >
+static void TestQueue( const char * name, const int numProducers, const int numConsumers, const int itemsPerProducer ) {
+	queueType * queue = new (TAG_IDLIB) queueType;
+	volatile bool start = false;
+	idSysInterlockedInteger consumed;
+
+	idList< idQueueTestProducer< queueType > * > producers;
+	idList< idQueueTestConsumer< queueType > * > consumers;
+	for ( int i = 0; i < numProducers; i++ ) {
+		idQueueTestProducer< queueType > * producer = new (TAG_IDLIB) idQueueTestProducer< queueType >;
+		producer->queue = queue;
+		producer->start = &start;
+		producer->producer = i;
+		producer->numItems = itemsPerProducer;
+		producer->StartThread( va( "queueProducer%d", i ), CORE_ANY );
+		producers.Append( producer );
+	}
+	for ( int i = 0; i < numConsumers; i++ ) {
+		idQueueTestConsumer< queueType > * consumer = new (TAG_IDLIB) idQueueTestConsumer< queueType >;
+		consumer->queue = queue;
+		consumer->start = &start;
+		consumer->consumed = &consumed;
+		consumer->totalItems = numProducers * itemsPerProducer;
+		consumer->lastSequence.AssureSize( numProducers, -1 );
+		consumer->checksum = 0;
+		consumer->numItems = 0;
+		consumer->numErrors = 0;
+		consumer->StartThread( va( "queueConsumer%d", i ), CORE_ANY );
+		consumers.Append( consumer );
+	}
+
+	const uint64 startTime = Sys_Microseconds();
+	start = true;
+	for ( int i = 0; i < numProducers; i++ ) {
+		producers[i]->WaitForThread();
+	}
+	for ( int i = 0; i < numConsumers; i++ ) {
+		consumers[i]->WaitForThread();
+	}
+	const uint64 endTime = Sys_Microseconds();
+
+	int64 checksum = 0;
+	int64 numItems = 0;
+	int numErrors = 0;
+	for ( int i = 0; i < numConsumers; i++ ) {
+		checksum += consumers[i]->checksum;
+		numItems += consumers[i]->numItems;
+		numErrors += consumers[i]->numErrors;
+	}
+	const int64 expectedChecksum = (int64)numProducers * itemsPerProducer * ( itemsPerProducer - 1 ) / 2;
+	if ( numItems != (int64)numProducers * itemsPerProducer || checksum != expectedChecksum ) {
+		numErrors++;
+	}
+
+	const double seconds = Max( (double)( endTime - startTime ), 1.0 ) * 1e-6;
+	idLib::Printf( "%-10s %2d x %-2d %8.1f ms %8.2f Mitems/s %s\n", name, numProducers, numConsumers,
+					seconds * 1000.0, numItems / seconds * 1e-6, ( numErrors == 0 ) ? "ok" : va( "FAILED (%d errors)", numErrors ) );
+
+	producers.DeleteContents();
+	consumers.DeleteContents();
+	delete queue;
+}
+
+/*
+========================
+testLockFreeQueues
+========================
+*/
+CONSOLE_COMMAND( testLockFreeQueues, "stress tests the lock-free queues against a mutex-protected idList, usage: testLockFreeQueues [producers] [consumers] [itemsPerProducer]", NULL ) {
+	const int numProducers = ( args.Argc() > 1 ) ? idMath::ClampInt( 1, 64, atoi( args.Argv( 1 ) ) ) : 2;
+	const int numConsumers = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 64, atoi( args.Argv( 2 ) ) ) : 2;
+	// the shared consumed counter is 32 bits, so keep the total item count within its range
+	const int itemsPerProducer = idMath::ClampInt( 1, INT_MAX / numProducers, ( args.Argc() > 3 ) ? atoi( args.Argv( 3 ) ) : 1000000 );
+
+	TestQueue< idLockedQueueTest >( "locked", numProducers, numConsumers, itemsPerProducer );
+	TestQueue< idLockFreeMPMCQueue< queueTestItem_t, QUEUE_TEST_CAPACITY > >( "mpmc", numProducers, numConsumers, itemsPerProducer );
+
+	// the single producer single consumer queue can only be tested with one thread on each side
+	TestQueue< idLockedQueueTest >( "locked", 1, 1, itemsPerProducer );
+	TestQueue< idLockFreeMPMCQueue< queueTestItem_t, QUEUE_TEST_CAPACITY > >( "mpmc", 1, 1, itemsPerProducer );
+	TestQueue< idLockFreeSPSCQueue< queueTestItem_t, QUEUE_TEST_CAPACITY > >( "spsc", 1, 1, itemsPerProducer );
+}
@@ -0,0 +1,1099 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __FLATHASHMAP_H__
+#define __FLATHASHMAP_H__
+
+/*
+================================================================================================
+
+	Open addressing hash maps.
+
+	idFlatHashMap stores the keys and values in a single array of slots, next to an array
+	with one control byte per slot. The control byte of a used slot holds 7 bits of the hash
+	of its key, so a lookup compares a whole group of 16 control bytes at once and only
+	compares the keys of the slots whose hash bits match. Groups are probed quadratically.
+
+	idOrderedFlatHashMap probes the same way but keeps the entries in an array in insertion
+	order, so the iteration order only depends on the order in which keys were added.
+	Removing an entry from it is linear in the number of entries.
+
+	Neither map allocates memory until the first key is added.
+
+================================================================================================
+*/
+
+/*
+================================================
+idFlatHash_Mix scrambles all bits of an integer key into a 32 bit hash.
+================================================
+*/
+ID_INLINE unsigned int idFlatHash_Mix( uint64 key ) {
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return (unsigned int)key;
+}
+
+/*
+================================================
+idFlatHash_String is a case insensitive FNV-1a string hash. idStr::IHash is not used
+because the low bits of its sum hash are poorly distributed.
+================================================
+*/
+ID_INLINE unsigned int idFlatHash_String( const char * string ) {
+	unsigned int hash = 2166136261U;
+	for ( ; *string != '\0'; string++ ) {
+		hash ^= (byte)idStr::ToLower( *string );
+		hash *= 16777619U;
+	}
+	return idFlatHash_Mix( hash );
+}
+
+/*
+================================================
+idFlatHashTraits provides the hash and the equality test for a key type. The default
+works for integer and enum keys. String keys are case insensitive like the keys of
+idHashTableT. A map with const char * keys does not copy the strings.
+================================================
+*/
+template< typename _key_ >
+class idFlatHashTraits {
+public:
+	static unsigned int	Hash( const _key_ & key ) { return idFlatHash_Mix( (uint64)key ); }
+	static bool			Equals( const _key_ & key1, const _key_ & key2 ) { return key1 == key2; }
+};
+
+template< typename _type_ >
+class idFlatHashTraits< _type_ * > {
+public:
+	static unsigned int	Hash( _type_ * const & key ) { return idFlatHash_Mix( (uint64)(ptrdiff_t)key ); }
+	static bool			Equals( _type_ * const & key1, _type_ * const & key2 ) { return key1 == key2; }
+};
+
+template<>
+class idFlatHashTraits< idStr > {
+public:
+	static unsigned int	Hash( const idStr & key ) { return idFlatHash_String( key.c_str() ); }
+	static bool			Equals( const idStr & key1, const idStr & key2 ) { return key1.Icmp( key2 ) == 0; }
+};
+
+template<>
+class idFlatHashTraits< const char * > {
+public:
+	static unsigned int	Hash( const char * const & key ) { return idFlatHash_String( key ); }
+	static bool			Equals( const char * const & key1, const char * const & key2 ) { return idStr::Icmp( key1, key2 ) == 0; }
+};
+
+/*
+================================================
+idFlatHashGroup holds the control byte operations shared by the flat hash maps.
+A control byte is either EMPTY, DELETED or the low 7 bits of the hash of a used slot.
+The number of slots is always a power of two and a multiple of the group width.
+================================================
+*/
+class idFlatHashGroup {
+public:
+	static const int	WIDTH = 16;
+	static const byte	EMPTY = 0x80;
+	static const byte	DELETED = 0xFE;
+
+	static bool			IsFull( const byte ctrl ) { return ( ctrl & 0x80 ) == 0; }
+	static byte			H2( const unsigned int hash ) { return (byte)( hash & 0x7F ); }
+	static int			H1( const unsigned int hash ) { return (int)( hash >> 7 ); }
+
+						// bit mask of the slots in the group with the given control byte
+	static unsigned int	Match( const byte * group, const byte h2 );
+	static unsigned int	MatchEmpty( const byte * group );
+	static unsigned int	MatchEmptyOrDeleted( const byte * group );
+	static int			LowestBit( const unsigned int mask );
+
+						// first unused slot on the probe sequence of the hash
+	static int			FindFreeSlot( const byte * ctrl, const int numSlots, const unsigned int hash );
+						// marks a used slot as unused, returns true if it became a DELETED slot
+	static bool			ClearSlot( byte * ctrl, const int slot );
+						// smallest table that keeps num entries below the maximum load after growing
+	static int			NumSlotsForEntries( const int num );
+	static bool			NeedsGrow( const int numSlots, const int numUsed );
+};
+
+/*
+========================
+idFlatHashGroup::Match
+========================
+*/
+ID_INLINE unsigned int idFlatHashGroup::Match( const byte * group, const byte h2 ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	const __m128i ctrl = _mm_load_si128( (const __m128i *)group );
+	return (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( (char)h2 ) ) );
+#else
+	unsigned int mask = 0;
+	for ( int i = 0; i < WIDTH; i++ ) {
+		if ( group[i] == h2 ) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/*
+========================
+idFlatHashGroup::MatchEmpty
+========================
+*/
+ID_INLINE unsigned int idFlatHashGroup::MatchEmpty( const byte * group ) {
+	return Match( group, EMPTY );
+}
+
+/*
+========================
+idFlatHashGroup::MatchEmptyOrDeleted
+========================
+*/
+ID_INLINE unsigned int idFlatHashGroup::MatchEmptyOrDeleted( const byte * group ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	// both EMPTY and DELETED have the high bit set
+	return (unsigned int)_mm_movemask_epi8( _mm_load_si128( (const __m128i *)group ) );
+#else
+	unsigned int mask = 0;
+	for ( int i = 0; i < WIDTH; i++ ) {
+		if ( !IsFull( group[i] ) ) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/*
+========================
+idFlatHashGroup::LowestBit
+========================
+*/
+ID_INLINE int idFlatHashGroup::LowestBit( const unsigned int mask ) {
+	assert( mask != 0 );
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return (int)index;
+#else
+	int index = 0;
+	while ( ( mask & ( 1U << index ) ) == 0 ) {
+		index++;
+	}
+	return index;
+#endif
+}
+
+/*
+========================
+idFlatHashGroup::FindFreeSlot
+========================
+*/
+ID_INLINE int idFlatHashGroup::FindFreeSlot( const byte * ctrl, const int numSlots, const unsigned int hash ) {
+	const int groupMask = ( numSlots / WIDTH ) - 1;
+	int group = H1( hash ) & groupMask;
+	for ( int probe = 1; ; probe++ ) {
+		const unsigned int mask = MatchEmptyOrDeleted( ctrl + group * WIDTH );
+		if ( mask != 0 ) {
+			return group * WIDTH + LowestBit( mask );
+		}
+		assert( probe <= groupMask + 1 );
+		group = ( group + probe ) & groupMask;
+	}
+}
+
+/*
+========================
+idFlatHashGroup::ClearSlot
+
+A lookup stops at the first group with an EMPTY slot. If the group of the slot still
+has an EMPTY slot, it never caused a probe sequence to continue past it and the slot
+can become EMPTY as well. Otherwise it has to become DELETED.
+========================
+*/
+ID_INLINE bool idFlatHashGroup::ClearSlot( byte * ctrl, const int slot ) {
+	assert( IsFull( ctrl[slot] ) );
+	if ( MatchEmpty( ctrl + ( slot & ~( WIDTH - 1 ) ) ) != 0 ) {
+		ctrl[slot] = EMPTY;
+		return false;
+	}
+	ctrl[slot] = DELETED;
+	return true;
+}
+
+/*
+========================
+idFlatHashGroup::NumSlotsForEntries
+========================
+*/
+ID_INLINE int idFlatHashGroup::NumSlotsForEntries( const int num ) {
+	// grow to at most 7/16 load, so a full table doubles in size
+	int numSlots = WIDTH;
+	while ( num * 16 > numSlots * 7 ) {
+		numSlots *= 2;
+	}
+	return numSlots;
+}
+
+/*
+========================
+idFlatHashGroup::NeedsGrow
+========================
+*/
+ID_INLINE bool idFlatHashGroup::NeedsGrow( const int numSlots, const int numUsed ) {
+	// the maximum load is 7/8
+	return numUsed * 8 > numSlots * 7;
+}
+
+/*
+================================================
+idFlatHashMap is an open addressing hash map with the keys and values stored inline.
+Keys and values must be default constructible and assignable, like the elements of idList.
+Slot numbers are only valid until the next Set, Remove or Reserve.
+================================================
+*/
+template< typename _key_, class _value_, class _traits_ = idFlatHashTraits< _key_ > >
+class idFlatHashMap {
+public:
+	static const int NULL_SLOT = -1;
+
+					idFlatHashMap();
+					idFlatHashMap( const idFlatHashMap & other );
+					~idFlatHashMap();
+
+	size_t			Allocated() const;
+	size_t			Size() const;
+
+	_value_ &		Set( const _key_ & key, const _value_ & value );
+
+	bool			Get( const _key_ & key, _value_ ** value = NULL );
+	bool			Get( const _key_ & key, const _value_ ** value = NULL ) const;
+
+	bool			Remove( const _key_ & key );
+
+					// removes all entries but keeps the memory
+	void			Clear();
+					// removes all entries and frees the memory
+	void			Free();
+					// deletes the values, which must be pointers, and frees the memory
+	void			DeleteContents();
+					// makes room for num entries without growing
+	void			Reserve( const int num );
+
+	int				Num() const;
+
+					// iterate with: for ( int i = map.First(); i != map.NULL_SLOT; i = map.Next( i ) )
+	int				First() const;
+	int				Next( const int slot ) const;
+	const _key_ &	GetKey( const int slot ) const;
+	_value_ &		GetValue( const int slot );
+	const _value_ &	GetValue( const int slot ) const;
+
+	idFlatHashMap &	operator=( const idFlatHashMap & other );
+
+private:
+	struct slot_t {
+		_key_		key;
+		_value_		value;
+	};
+
+	byte *			ctrl;
+	slot_t *		slots;
+	int				numSlots;
+	int				numEntries;
+	int				numDeleted;
+
+	int				FindSlot( const _key_ & key, const unsigned int hash ) const;
+	void			Resize( const int newNumSlots );
+};
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::idFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idFlatHashMap<_key_,_value_,_traits_>::idFlatHashMap() {
+	ctrl = NULL;
+	slots = NULL;
+	numSlots = 0;
+	numEntries = 0;
+	numDeleted = 0;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::idFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idFlatHashMap<_key_,_value_,_traits_>::idFlatHashMap( const idFlatHashMap & other ) {
+	ctrl = NULL;
+	slots = NULL;
+	numSlots = 0;
+	numEntries = 0;
+	numDeleted = 0;
+	*this = other;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::~idFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idFlatHashMap<_key_,_value_,_traits_>::~idFlatHashMap() {
+	Free();
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Allocated
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE size_t idFlatHashMap<_key_,_value_,_traits_>::Allocated() const {
+	return numSlots * ( sizeof( byte ) + sizeof( slot_t ) );
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Size
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE size_t idFlatHashMap<_key_,_value_,_traits_>::Size() const {
+	return sizeof( idFlatHashMap ) + Allocated();
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::FindSlot
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idFlatHashMap<_key_,_value_,_traits_>::FindSlot( const _key_ & key, const unsigned int hash ) const {
+	if ( numEntries == 0 ) {
+		return NULL_SLOT;
+	}
+	const byte h2 = idFlatHashGroup::H2( hash );
+	const int groupMask = ( numSlots / idFlatHashGroup::WIDTH ) - 1;
+	int group = idFlatHashGroup::H1( hash ) & groupMask;
+	for ( int probe = 1; probe <= groupMask + 1; probe++ ) {
+		const byte * groupCtrl = ctrl + group * idFlatHashGroup::WIDTH;
+		for ( unsigned int mask = idFlatHashGroup::Match( groupCtrl, h2 ); mask != 0; mask &= mask - 1 ) {
+			const int slot = group * idFlatHashGroup::WIDTH + idFlatHashGroup::LowestBit( mask );
+			if ( _traits_::Equals( slots[slot].key, key ) ) {
+				return slot;
+			}
+		}
+		if ( idFlatHashGroup::MatchEmpty( groupCtrl ) != 0 ) {
+			break;
+		}
+		group = ( group + probe ) & groupMask;
+	}
+	return NULL_SLOT;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Resize
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idFlatHashMap<_key_,_value_,_traits_>::Resize( const int newNumSlots ) {
+	assert( idMath::IsPowerOfTwo( newNumSlots ) && newNumSlots >= idFlatHashGroup::WIDTH );
+	assert( !idFlatHashGroup::NeedsGrow( newNumSlots, numEntries ) );
+
+	byte * oldCtrl = ctrl;
+	slot_t * oldSlots = slots;
+	const int oldNumSlots = numSlots;
+
+	ctrl = (byte *)Mem_Alloc16( newNumSlots, TAG_IDLIB_HASH );
+	memset( ctrl, idFlatHashGroup::EMPTY, newNumSlots );
+	slots = new (TAG_IDLIB_HASH) slot_t[ newNumSlots ];
+	numSlots = newNumSlots;
+	numDeleted = 0;
+
+	for ( int i = 0; i < oldNumSlots; i++ ) {
+		if ( idFlatHashGroup::IsFull( oldCtrl[i] ) ) {
+			const unsigned int hash = _traits_::Hash( oldSlots[i].key );
+			const int slot = idFlatHashGroup::FindFreeSlot( ctrl, numSlots, hash );
+			ctrl[slot] = idFlatHashGroup::H2( hash );
+			slots[slot] = oldSlots[i];
+		}
+	}
+
+	Mem_Free16( oldCtrl );
+	delete[] oldSlots;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Set
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE _value_ & idFlatHashMap<_key_,_value_,_traits_>::Set( const _key_ & key, const _value_ & value ) {
+	const unsigned int hash = _traits_::Hash( key );
+	int slot = FindSlot( key, hash );
+	if ( slot != NULL_SLOT ) {
+		slots[slot].value = value;
+		return slots[slot].value;
+	}
+
+	if ( idFlatHashGroup::NeedsGrow( numSlots, numEntries + numDeleted + 1 ) ) {
+		// rehashes at the same size if there are mostly deleted slots
+		Resize( Max( numSlots, idFlatHashGroup::NumSlotsForEntries( numEntries + 1 ) ) );
+	}
+
+	slot = idFlatHashGroup::FindFreeSlot( ctrl, numSlots, hash );
+	if ( ctrl[slot] == idFlatHashGroup::DELETED ) {
+		numDeleted--;
+	}
+	ctrl[slot] = idFlatHashGroup::H2( hash );
+	slots[slot].key = key;
+	slots[slot].value = value;
+	numEntries++;
+	return slots[slot].value;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Get
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idFlatHashMap<_key_,_value_,_traits_>::Get( const _key_ & key, _value_ ** value ) {
+	const int slot = FindSlot( key, _traits_::Hash( key ) );
+	if ( value != NULL ) {
+		*value = ( slot != NULL_SLOT ) ? &slots[slot].value : NULL;
+	}
+	return ( slot != NULL_SLOT );
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Get
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idFlatHashMap<_key_,_value_,_traits_>::Get( const _key_ & key, const _value_ ** value ) const {
+	const int slot = FindSlot( key, _traits_::Hash( key ) );
+	if ( value != NULL ) {
+		*value = ( slot != NULL_SLOT ) ? &slots[slot].value : NULL;
+	}
+	return ( slot != NULL_SLOT );
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Remove
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idFlatHashMap<_key_,_value_,_traits_>::Remove( const _key_ & key ) {
+	const int slot = FindSlot( key, _traits_::Hash( key ) );
+	if ( slot == NULL_SLOT ) {
+		return false;
+	}
+	if ( idFlatHashGroup::ClearSlot( ctrl, slot ) ) {
+		numDeleted++;
+	}
+	// release any memory held by the key and value
+	slots[slot] = slot_t();
+	numEntries--;
+	return true;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Clear
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idFlatHashMap<_key_,_value_,_traits_>::Clear() {
+	for ( int i = 0; i < numSlots; i++ ) {
+		if ( idFlatHashGroup::IsFull( ctrl[i] ) ) {
+			slots[i] = slot_t();
+		}
+	}
+	if ( ctrl != NULL ) {
+		memset( ctrl, idFlatHashGroup::EMPTY, numSlots );
+	}
+	numEntries = 0;
+	numDeleted = 0;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Free
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idFlatHashMap<_key_,_value_,_traits_>::Free() {
+	Mem_Free16( ctrl );
+	delete[] slots;
+	ctrl = NULL;
+	slots = NULL;
+	numSlots = 0;
+	numEntries = 0;
+	numDeleted = 0;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::DeleteContents
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idFlatHashMap<_key_,_value_,_traits_>::DeleteContents() {
+	for ( int i = 0; i < numSlots; i++ ) {
+		if ( idFlatHashGroup::IsFull( ctrl[i] ) ) {
+			delete slots[i].value;
+		}
+	}
+	Free();
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Reserve
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idFlatHashMap<_key_,_value_,_traits_>::Reserve( const int num ) {
+	int newNumSlots = idFlatHashGroup::WIDTH;
+	while ( idFlatHashGroup::NeedsGrow( newNumSlots, num ) ) {
+		newNumSlots *= 2;
+	}
+	if ( newNumSlots > numSlots ) {
+		Resize( newNumSlots );
+	}
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Num
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idFlatHashMap<_key_,_value_,_traits_>::Num() const {
+	return numEntries;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::First
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idFlatHashMap<_key_,_value_,_traits_>::First() const {
+	return Next( NULL_SLOT );
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::Next
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idFlatHashMap<_key_,_value_,_traits_>::Next( const int slot ) const {
+	for ( int i = slot + 1; i < numSlots; i++ ) {
+		if ( idFlatHashGroup::IsFull( ctrl[i] ) ) {
+			return i;
+		}
+	}
+	return NULL_SLOT;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::GetKey
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE const _key_ & idFlatHashMap<_key_,_value_,_traits_>::GetKey( const int slot ) const {
+	assert( slot >= 0 && slot < numSlots && idFlatHashGroup::IsFull( ctrl[slot] ) );
+	return slots[slot].key;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::GetValue
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE _value_ & idFlatHashMap<_key_,_value_,_traits_>::GetValue( const int slot ) {
+	assert( slot >= 0 && slot < numSlots && idFlatHashGroup::IsFull( ctrl[slot] ) );
+	return slots[slot].value;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::GetValue
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE const _value_ & idFlatHashMap<_key_,_value_,_traits_>::GetValue( const int slot ) const {
+	assert( slot >= 0 && slot < numSlots && idFlatHashGroup::IsFull( ctrl[slot] ) );
+	return slots[slot].value;
+}
+
+/*
+========================
+idFlatHashMap<_key_,_value_,_traits_>::operator=
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idFlatHashMap<_key_,_value_,_traits_> & idFlatHashMap<_key_,_value_,_traits_>::operator=( const idFlatHashMap & other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	Free();
+	if ( other.numSlots > 0 ) {
+		ctrl = (byte *)Mem_Alloc16( other.numSlots, TAG_IDLIB_HASH );
+		memcpy( ctrl, other.ctrl, other.numSlots );
+		slots = new (TAG_IDLIB_HASH) slot_t[ other.numSlots ];
+		for ( int i = 0; i < other.numSlots; i++ ) {
+			if ( idFlatHashGroup::IsFull( other.ctrl[i] ) ) {
+				slots[i] = other.slots[i];
+			}
+		}
+		numSlots = other.numSlots;
+		numEntries = other.numEntries;
+		numDeleted = other.numDeleted;
+	}
+	return *this;
+}
+
+/*
+================================================
+idOrderedFlatHashMap is an open addressing hash map that keeps its entries in insertion
+order. The table only stores the index of the entry for each used slot, so iteration
+walks a dense array. Entry indexes are only valid until the next Remove.
+================================================
+*/
+template< typename _key_, class _value_, class _traits_ = idFlatHashTraits< _key_ > >
+class idOrderedFlatHashMap {
+public:
+	static const int NULL_INDEX = -1;
+
+					idOrderedFlatHashMap();
+					idOrderedFlatHashMap( const idOrderedFlatHashMap & other );
+					~idOrderedFlatHashMap();
+
+	size_t			Allocated() const;
+	size_t			Size() const;
+
+	_value_ &		Set( const _key_ & key, const _value_ & value );
+
+	bool			Get( const _key_ & key, _value_ ** value = NULL );
+	bool			Get( const _key_ & key, const _value_ ** value = NULL ) const;
+					// returns the insertion order index of the key or NULL_INDEX
+	int				FindIndex( const _key_ & key ) const;
+
+					// linear in the number of entries
+	bool			Remove( const _key_ & key );
+
+					// removes all entries but keeps the memory
+	void			Clear();
+					// removes all entries and frees the memory
+	void			Free();
+					// deletes the values, which must be pointers, and frees the memory
+	void			DeleteContents();
+					// makes room for num entries without growing
+	void			Reserve( const int num );
+
+	int				Num() const;
+
+					// entries in insertion order, 0 <= index < Num()
+	const _key_ &	GetKey( const int index ) const;
+	_value_ &		GetValue( const int index );
+	const _value_ &	GetValue( const int index ) const;
+
+	idOrderedFlatHashMap &	operator=( const idOrderedFlatHashMap & other );
+
+private:
+	struct entry_t {
+		_key_		key;
+		_value_		value;
+	};
+
+	idList< entry_t, TAG_IDLIB_HASH >	entries;
+	byte *			ctrl;
+	int *			indexes;		// entry index of every used slot
+	int				numSlots;
+	int				numDeleted;
+
+	int				FindSlot( const _key_ & key, const unsigned int hash ) const;
+	void			Resize( const int newNumSlots );
+};
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::idOrderedFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idOrderedFlatHashMap<_key_,_value_,_traits_>::idOrderedFlatHashMap() {
+	ctrl = NULL;
+	indexes = NULL;
+	numSlots = 0;
+	numDeleted = 0;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::idOrderedFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idOrderedFlatHashMap<_key_,_value_,_traits_>::idOrderedFlatHashMap( const idOrderedFlatHashMap & other ) {
+	ctrl = NULL;
+	indexes = NULL;
+	numSlots = 0;
+	numDeleted = 0;
+	*this = other;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::~idOrderedFlatHashMap
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idOrderedFlatHashMap<_key_,_value_,_traits_>::~idOrderedFlatHashMap() {
+	Free();
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Allocated
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE size_t idOrderedFlatHashMap<_key_,_value_,_traits_>::Allocated() const {
+	return entries.Allocated() + numSlots * ( sizeof( byte ) + sizeof( int ) );
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Size
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE size_t idOrderedFlatHashMap<_key_,_value_,_traits_>::Size() const {
+	return sizeof( idOrderedFlatHashMap ) + Allocated();
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::FindSlot
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idOrderedFlatHashMap<_key_,_value_,_traits_>::FindSlot( const _key_ & key, const unsigned int hash ) const {
+	if ( entries.Num() == 0 ) {
+		return -1;
+	}
+	const byte h2 = idFlatHashGroup::H2( hash );
+	const int groupMask = ( numSlots / idFlatHashGroup::WIDTH ) - 1;
+	int group = idFlatHashGroup::H1( hash ) & groupMask;
+	for ( int probe = 1; probe <= groupMask + 1; probe++ ) {
+		const byte * groupCtrl = ctrl + group * idFlatHashGroup::WIDTH;
+		for ( unsigned int mask = idFlatHashGroup::Match( groupCtrl, h2 ); mask != 0; mask &= mask - 1 ) {
+			const int slot = group * idFlatHashGroup::WIDTH + idFlatHashGroup::LowestBit( mask );
+			if ( _traits_::Equals( entries[indexes[slot]].key, key ) ) {
+				return slot;
+			}
+		}
+		if ( idFlatHashGroup::MatchEmpty( groupCtrl ) != 0 ) {
+			break;
+		}
+		group = ( group + probe ) & groupMask;
+	}
+	return -1;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Resize
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idOrderedFlatHashMap<_key_,_value_,_traits_>::Resize( const int newNumSlots ) {
+	assert( idMath::IsPowerOfTwo( newNumSlots ) && newNumSlots >= idFlatHashGroup::WIDTH );
+	assert( !idFlatHashGroup::NeedsGrow( newNumSlots, entries.Num() ) );
+
+	if ( newNumSlots != numSlots ) {
+		Mem_Free16( ctrl );
+		Mem_Free16( indexes );
+		ctrl = (byte *)Mem_Alloc16( newNumSlots, TAG_IDLIB_HASH );
+		indexes = (int *)Mem_Alloc16( newNumSlots * sizeof( int ), TAG_IDLIB_HASH );
+		numSlots = newNumSlots;
+	}
+	memset( ctrl, idFlatHashGroup::EMPTY, numSlots );
+	numDeleted = 0;
+
+	// the entries are the only copy of the keys, so the table is rebuilt from them
+	for ( int i = 0; i < entries.Num(); i++ ) {
+		const unsigned int hash = _traits_::Hash( entries[i].key );
+		const int slot = idFlatHashGroup::FindFreeSlot( ctrl, numSlots, hash );
+		ctrl[slot] = idFlatHashGroup::H2( hash );
+		indexes[slot] = i;
+	}
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Set
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE _value_ & idOrderedFlatHashMap<_key_,_value_,_traits_>::Set( const _key_ & key, const _value_ & value ) {
+	const unsigned int hash = _traits_::Hash( key );
+	int slot = FindSlot( key, hash );
+	if ( slot != -1 ) {
+		entries[indexes[slot]].value = value;
+		return entries[indexes[slot]].value;
+	}
+
+	if ( idFlatHashGroup::NeedsGrow( numSlots, entries.Num() + numDeleted + 1 ) ) {
+		// rehashes at the same size if there are mostly deleted slots
+		Resize( Max( numSlots, idFlatHashGroup::NumSlotsForEntries( entries.Num() + 1 ) ) );
+	}
+
+	slot = idFlatHashGroup::FindFreeSlot( ctrl, numSlots, hash );
+	if ( ctrl[slot] == idFlatHashGroup::DELETED ) {
+		numDeleted--;
+	}
+	ctrl[slot] = idFlatHashGroup::H2( hash );
+	indexes[slot] = entries.Num();
+
+	entry_t & entry = entries.Alloc();
+	entry.key = key;
+	entry.value = value;
+	return entry.value;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Get
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idOrderedFlatHashMap<_key_,_value_,_traits_>::Get( const _key_ & key, _value_ ** value ) {
+	const int index = FindIndex( key );
+	if ( value != NULL ) {
+		*value = ( index != NULL_INDEX ) ? &entries[index].value : NULL;
+	}
+	return ( index != NULL_INDEX );
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Get
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idOrderedFlatHashMap<_key_,_value_,_traits_>::Get( const _key_ & key, const _value_ ** value ) const {
+	const int index = FindIndex( key );
+	if ( value != NULL ) {
+		*value = ( index != NULL_INDEX ) ? &entries[index].value : NULL;
+	}
+	return ( index != NULL_INDEX );
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::FindIndex
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idOrderedFlatHashMap<_key_,_value_,_traits_>::FindIndex( const _key_ & key ) const {
+	const int slot = FindSlot( key, _traits_::Hash( key ) );
+	return ( slot != -1 ) ? indexes[slot] : NULL_INDEX;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Remove
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE bool idOrderedFlatHashMap<_key_,_value_,_traits_>::Remove( const _key_ & key ) {
+	const int slot = FindSlot( key, _traits_::Hash( key ) );
+	if ( slot == -1 ) {
+		return false;
+	}
+	const int index = indexes[slot];
+	if ( idFlatHashGroup::ClearSlot( ctrl, slot ) ) {
+		numDeleted++;
+	}
+	entries.RemoveIndex( index );
+
+	// the entries after the removed one moved down
+	for ( int i = 0; i < numSlots; i++ ) {
+		if ( idFlatHashGroup::IsFull( ctrl[i] ) && indexes[i] > index ) {
+			indexes[i]--;
+		}
+	}
+	return true;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Clear
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idOrderedFlatHashMap<_key_,_value_,_traits_>::Clear() {
+	entries.SetNum( 0 );
+	if ( ctrl != NULL ) {
+		memset( ctrl, idFlatHashGroup::EMPTY, numSlots );
+	}
+	numDeleted = 0;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Free
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idOrderedFlatHashMap<_key_,_value_,_traits_>::Free() {
+	entries.Clear();
+	Mem_Free16( ctrl );
+	Mem_Free16( indexes );
+	ctrl = NULL;
+	indexes = NULL;
+	numSlots = 0;
+	numDeleted = 0;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::DeleteContents
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idOrderedFlatHashMap<_key_,_value_,_traits_>::DeleteContents() {
+	for ( int i = 0; i < entries.Num(); i++ ) {
+		delete entries[i].value;
+	}
+	Free();
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Reserve
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE void idOrderedFlatHashMap<_key_,_value_,_traits_>::Reserve( const int num ) {
+	int newNumSlots = idFlatHashGroup::WIDTH;
+	while ( idFlatHashGroup::NeedsGrow( newNumSlots, num ) ) {
+		newNumSlots *= 2;
+	}
+	if ( newNumSlots > numSlots ) {
+		Resize( newNumSlots );
+	}
+	if ( num > entries.NumAllocated() ) {
+		entries.Resize( num );
+	}
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::Num
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE int idOrderedFlatHashMap<_key_,_value_,_traits_>::Num() const {
+	return entries.Num();
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::GetKey
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE const _key_ & idOrderedFlatHashMap<_key_,_value_,_traits_>::GetKey( const int index ) const {
+	return entries[index].key;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::GetValue
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE _value_ & idOrderedFlatHashMap<_key_,_value_,_traits_>::GetValue( const int index ) {
+	return entries[index].value;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::GetValue
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE const _value_ & idOrderedFlatHashMap<_key_,_value_,_traits_>::GetValue( const int index ) const {
+	return entries[index].value;
+}
+
+/*
+========================
+idOrderedFlatHashMap<_key_,_value_,_traits_>::operator=
+========================
+*/
+template< typename _key_, class _value_, class _traits_ >
+ID_INLINE idOrderedFlatHashMap<_key_,_value_,_traits_> & idOrderedFlatHashMap<_key_,_value_,_traits_>::operator=( const idOrderedFlatHashMap & other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	Free();
+	entries = other.entries;
+	if ( other.numSlots > 0 ) {
+		ctrl = (byte *)Mem_Alloc16( other.numSlots, TAG_IDLIB_HASH );
+		indexes = (int *)Mem_Alloc16( other.numSlots * sizeof( int ), TAG_IDLIB_HASH );
+		memcpy( ctrl, other.ctrl, other.numSlots );
+		memcpy( indexes, other.indexes, other.numSlots * sizeof( int ) );
+		numSlots = other.numSlots;
+		numDeleted = other.numDeleted;
+	}
+	return *this;
+}
+
+#endif /* !__FLATHASHMAP_H__ */
@@ -35,9 +35,30 @@ If you have questions concerning this license or the applicable additional terms
 //
 //===============================================================
 
-float	idMatX::temp[MATX_MAX_TEMP+4];
-float *	idMatX::tempPtr = (float *) ( ( (int) idMatX::temp + 15 ) & ~15 );
-int		idMatX::tempIndex = 0;
+idMatX::tempPool_t	idMatX::mainThreadTemp;
+ID_TLS				idMatX::threadTemp;
+
+/*
+=============
+idMatX::AllocTempPool
+
+The main thread uses a static pool, other threads get their own pool the first
+time they use temporary memory. Job threads live as long as the process so their
+pools are never freed.
+=============
+*/
+idMatX::tempPool_t *idMatX::AllocTempPool() {
+	tempPool_t * pool;
+	if ( idLib::IsMainThread() ) {
+		pool = &mainThreadTemp;
+	} else {
+		pool = new (TAG_MATH) tempPool_t;
+	}
+	pool->ptr = (float *) ( ( (UINT_PTR) pool->temp + 15 ) & ~15 );
+	pool->index = 0;
+	threadTemp = (ptrdiff_t) pool;
+	return pool;
+}
 
 
 /*
@@ -36,7 +36,8 @@ idMatX - arbitrary sized dense real matrix
 
 The matrix lives on 16 byte aligned and 16 byte padded memory.
 
-NOTE: due to the temporary memory pool idMatX cannot be used by multiple threads.
+NOTE: each thread has its own temporary memory pool, so temporary results
+must not be passed from one thread to another.
 
 ===============================================================================
 */
@@ -245,11 +246,19 @@ private:
 	int				alloced;				// floats allocated, if -1 then mat points to data set with SetData
 	float *			mat;					// memory the matrix is stored
 
-	static float	temp[MATX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	typedef struct {
+		float *		ptr;					// pointer to 16 byte aligned temporary memory
+		int			index;					// index into memory pool, wraps around
+		float		temp[MATX_MAX_TEMP+4];	// used to store intermediate results
+	} tempPool_t;
+
+	static tempPool_t	mainThreadTemp;		// temporary memory of the main thread
+	static ID_TLS		threadTemp;			// temporary memory of the calling thread
 
 private:
+	static tempPool_t *	AllocTempPool();
+	static tempPool_t *	GetTempPool();
+	bool			IsTempMemory() const;
 	void			SetTempSize( int rows, int columns );
 	float			DeterminantGeneric() const;
 	bool			InverseSelfGeneric();
@@ -281,7 +290,7 @@ idMatX::~idMatX
 */
 ID_INLINE idMatX::~idMatX() {
 	// if not temp memory
-	if ( mat != NULL && ( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP ) && alloced != -1 ) {
+	if ( mat != NULL && alloced != -1 && !IsTempMemory() ) {
 		Mem_Free16( mat );
 	}
 }
@@ -396,7 +405,7 @@ ID_INLINE idMatX &idMatX::operator=( const idMatX &a ) {
 #else
 	memcpy( mat, a.mat, s * sizeof( float ) );
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -514,7 +523,7 @@ ID_INLINE idMatX &idMatX::operator*=( const float a ) {
 		mat[i] *= a;
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -525,7 +534,7 @@ idMatX::operator*=
 */
 ID_INLINE idMatX &idMatX::operator*=( const idMatX &a ) {
 	*this = *this * a;
-	idMatX::tempIndex = 0;
+	idMatX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -546,7 +555,7 @@ ID_INLINE idMatX &idMatX::operator+=( const idMatX &a ) {
 		mat[i] += a.mat[i];
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -567,7 +576,7 @@ ID_INLINE idMatX &idMatX::operator-=( const idMatX &a ) {
 		mat[i] -= a.mat[i];
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -658,7 +667,7 @@ idMatX::SetSize
 */
 ID_INLINE void idMatX::SetSize( int rows, int columns ) {
 	if ( rows != numRows || columns != numColumns || mat == NULL ) {
-		assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+		assert( !IsTempMemory() );
 		int alloc = ( rows * columns + 3 ) & ~3;
 		if ( alloc > alloced && alloced != -1 ) {
 			if ( mat != NULL ) {
@@ -673,21 +682,45 @@ ID_INLINE void idMatX::SetSize( int rows, int columns ) {
 	}
 }
 
+/*
+========================
+idMatX::GetTempPool
+========================
+*/
+ID_INLINE idMatX::tempPool_t *idMatX::GetTempPool() {
+	tempPool_t * pool = (tempPool_t *)(ptrdiff_t)threadTemp;
+	if ( pool == NULL ) {
+		pool = AllocTempPool();
+	}
+	return pool;
+}
+
+/*
+========================
+idMatX::IsTempMemory
+========================
+*/
+ID_INLINE bool idMatX::IsTempMemory() const {
+	const tempPool_t * pool = GetTempPool();
+	return ( mat >= pool->ptr && mat <= pool->ptr + MATX_MAX_TEMP );
+}
+
 /*
 ========================
 idMatX::SetTempSize
 ========================
 */
 ID_INLINE void idMatX::SetTempSize( int rows, int columns ) {
+	tempPool_t * pool = GetTempPool();
 	int newSize;
 
 	newSize = ( rows * columns + 3 ) & ~3;
 	assert( newSize < MATX_MAX_TEMP );
-	if ( idMatX::tempIndex + newSize > MATX_MAX_TEMP ) {
-		idMatX::tempIndex = 0;
+	if ( pool->index + newSize > MATX_MAX_TEMP ) {
+		pool->index = 0;
 	}
-	mat = idMatX::tempPtr + idMatX::tempIndex;
-	idMatX::tempIndex += newSize;
+	mat = pool->ptr + pool->index;
+	pool->index += newSize;
 	alloced = newSize;
 	numRows = rows;
 	numColumns = columns;
@@ -700,7 +733,7 @@ idMatX::SetData
 ========================
 */
 ID_INLINE void idMatX::SetData( int rows, int columns, float *data ) {
-	assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+	assert( !IsTempMemory() );
 	if ( mat != NULL && alloced != -1 ) {
 		Mem_Free16( mat );
 	}
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "Simd_Generic.h"
 #include "Simd_SSE.h"
+#include "Simd_AVX2.h"
 
 idSIMDProcessor	*	processor = NULL;			// pointer to SIMD processor
 idSIMDProcessor *	generic = NULL;				// pointer to generic SIMD implementation
@@ -66,6 +67,11 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 	} else {
 
 		if ( processor == NULL ) {
+#ifdef ID_SIMD_AVX2
+			if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_AVX2 ) ) {
+				processor = new (TAG_MATH) idSIMD_AVX2;
+			} else
+#endif
 			if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) ) {
 				processor = new (TAG_MATH) idSIMD_SSE;
 			} else {
@@ -1232,8 +1238,16 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 				return;
 			}
 			p_simd = new (TAG_MATH) idSIMD_SSE;
+#ifdef ID_SIMD_AVX2
+		} else if ( idStr::Icmp( argString, "AVX2" ) == 0 ) {
+			if ( !( cpuid & CPUID_MMX ) || !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_AVX2 ) ) {
+				common->Printf( "CPU does not support MMX & SSE & AVX2\n" );
+				return;
+			}
+			p_simd = new (TAG_MATH) idSIMD_AVX2;
+#endif
 		} else {
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AVX2, AltiVec\n" );
 			return;
 		}
 	}
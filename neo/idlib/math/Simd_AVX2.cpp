@@ -0,0 +1,828 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../precompiled.h"
+#include "Simd_Generic.h"
+#include "Simd_SSE.h"
+#include "Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_SIMD_AVX2
+
+#include <immintrin.h>
+
+#define M_PI	3.14159265358979323846f
+
+#define _mm256_madd_ps( a, b, c )			_mm256_fmadd_ps( (a), (b), (c) )
+#define _mm256_nmsub_ps( a, b, c )			_mm256_fnmadd_ps( (a), (b), (c) )
+#define _mm256_splat1_ps( x )				_mm256_set1_ps( (x) )
+
+/*
+============
+_mm256_load2_ps
+
+  loads two 16-byte aligned 4-float vectors into the low and high lanes
+============
+*/
+static ID_INLINE __m256 _mm256_load2_ps( const float *lo, const float *hi ) {
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( lo ) ), _mm_load_ps( hi ), 1 );
+}
+
+/*
+============
+_mm256_loadu2_ps
+============
+*/
+static ID_INLINE __m256 _mm256_loadu2_ps( const float *lo, const float *hi ) {
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( lo ) ), _mm_loadu_ps( hi ), 1 );
+}
+
+/*
+============
+_mm256_store2_ps
+
+  stores the low and high lanes to two 16-byte aligned 4-float vectors
+============
+*/
+static ID_INLINE void _mm256_store2_ps( float *lo, float *hi, const __m256 &v ) {
+	_mm_store_ps( lo, _mm256_castps256_ps128( v ) );
+	_mm_store_ps( hi, _mm256_extractf128_ps( v, 1 ) );
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName() const {
+	return "MMX & SSE & AVX2";
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 vmin = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_splat1_ps( -idMath::INFINITY );
+
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v = _mm256_loadu_ps( src + i );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 min4 = _mm_min_ps( _mm256_castps256_ps128( vmin ), _mm256_extractf128_ps( vmin, 1 ) );
+	__m128 max4 = _mm_max_ps( _mm256_castps256_ps128( vmax ), _mm256_extractf128_ps( vmax, 1 ) );
+	min4 = _mm_min_ps( min4, _mm_perm_ps( min4, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	max4 = _mm_max_ps( max4, _mm_perm_ps( max4, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	min4 = _mm_min_ps( min4, _mm_perm_ps( min4, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	max4 = _mm_max_ps( max4, _mm_perm_ps( max4, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+
+	_mm256_zeroupper();
+
+	_mm_store_ss( &min, min4 );
+	_mm_store_ss( &max, max4 );
+
+	for ( ; i < count; i++ ) {
+		if ( src[i] < min ) {
+			min = src[i];
+		}
+		if ( src[i] > max ) {
+			max = src[i];
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	__m256 vmin = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_splat1_ps( -idMath::INFINITY );
+
+	const float *srcPtr = src->ToFloatPtr();
+
+	// four idVec2 per register, the lanes alternate x, y
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m256 v = _mm256_loadu_ps( srcPtr + i * 2 );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 min4 = _mm_min_ps( _mm256_castps256_ps128( vmin ), _mm256_extractf128_ps( vmin, 1 ) );
+	__m128 max4 = _mm_max_ps( _mm256_castps256_ps128( vmax ), _mm256_extractf128_ps( vmax, 1 ) );
+	min4 = _mm_min_ps( min4, _mm_perm_ps( min4, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	max4 = _mm_max_ps( max4, _mm_perm_ps( max4, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+
+	_mm256_zeroupper();
+
+	ALIGN16( float minf[4] );
+	ALIGN16( float maxf[4] );
+	_mm_store_ps( minf, min4 );
+	_mm_store_ps( maxf, max4 );
+
+	min[0] = minf[0]; min[1] = minf[1];
+	max[0] = maxf[0]; max[1] = maxf[1];
+
+	for ( ; i < count; i++ ) {
+		const idVec2 &v = src[i];
+		if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+		if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	__m256 vmina = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vminb = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vminc = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmaxa = _mm256_splat1_ps( -idMath::INFINITY );
+	__m256 vmaxb = _mm256_splat1_ps( -idMath::INFINITY );
+	__m256 vmaxc = _mm256_splat1_ps( -idMath::INFINITY );
+
+	const float *srcPtr = src->ToFloatPtr();
+
+	// eight idVec3 per three registers, the lanes cycle through x, y, z
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 va = _mm256_loadu_ps( srcPtr + i * 3 +  0 );		// x y z x y z x y
+		__m256 vb = _mm256_loadu_ps( srcPtr + i * 3 +  8 );		// z x y z x y z x
+		__m256 vc = _mm256_loadu_ps( srcPtr + i * 3 + 16 );		// y z x y z x y z
+		vmina = _mm256_min_ps( vmina, va );
+		vminb = _mm256_min_ps( vminb, vb );
+		vminc = _mm256_min_ps( vminc, vc );
+		vmaxa = _mm256_max_ps( vmaxa, va );
+		vmaxb = _mm256_max_ps( vmaxb, vb );
+		vmaxc = _mm256_max_ps( vmaxc, vc );
+	}
+
+	ALIGN16( float minf[24] );
+	ALIGN16( float maxf[24] );
+	_mm256_storeu_ps( minf +  0, vmina );
+	_mm256_storeu_ps( minf +  8, vminb );
+	_mm256_storeu_ps( minf + 16, vminc );
+	_mm256_storeu_ps( maxf +  0, vmaxa );
+	_mm256_storeu_ps( maxf +  8, vmaxb );
+	_mm256_storeu_ps( maxf + 16, vmaxc );
+
+	_mm256_zeroupper();
+
+	min[0] = min[1] = min[2] = idMath::INFINITY; max[0] = max[1] = max[2] = -idMath::INFINITY;
+	for ( int j = 0; j < 24; j++ ) {
+		const int c = j % 3;
+		if ( minf[j] < min[c] ) { min[c] = minf[j]; }
+		if ( maxf[j] > max[c] ) { max[c] = maxf[j]; }
+	}
+
+	for ( ; i < count; i++ ) {
+		const idVec3 &v = src[i];
+		if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+		if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+		if ( v[2] < min[2] ) { min[2] = v[2]; } if ( v[2] > max[2] ) { max[2] = v[2]; }
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	__m256 vmin0 = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmin1 = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmax0 = _mm256_splat1_ps( -idMath::INFINITY );
+	__m256 vmax1 = _mm256_splat1_ps( -idMath::INFINITY );
+
+	// two vertices per register, the fourth float of each lane holds the texture coordinates and is ignored
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m256 v0 = _mm256_loadu2_ps( src[i+0].xyz.ToFloatPtr(), src[i+1].xyz.ToFloatPtr() );
+		__m256 v1 = _mm256_loadu2_ps( src[i+2].xyz.ToFloatPtr(), src[i+3].xyz.ToFloatPtr() );
+		vmin0 = _mm256_min_ps( vmin0, v0 );
+		vmin1 = _mm256_min_ps( vmin1, v1 );
+		vmax0 = _mm256_max_ps( vmax0, v0 );
+		vmax1 = _mm256_max_ps( vmax1, v1 );
+	}
+
+	vmin0 = _mm256_min_ps( vmin0, vmin1 );
+	vmax0 = _mm256_max_ps( vmax0, vmax1 );
+
+	__m128 min4 = _mm_min_ps( _mm256_castps256_ps128( vmin0 ), _mm256_extractf128_ps( vmin0, 1 ) );
+	__m128 max4 = _mm_max_ps( _mm256_castps256_ps128( vmax0 ), _mm256_extractf128_ps( vmax0, 1 ) );
+
+	_mm256_zeroupper();
+
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[i].xyz.ToFloatPtr() );
+		min4 = _mm_min_ps( min4, v );
+		max4 = _mm_max_ps( max4, v );
+	}
+
+	ALIGN16( float minf[4] );
+	ALIGN16( float maxf[4] );
+	_mm_store_ps( minf, min4 );
+	_mm_store_ps( maxf, max4 );
+
+	min.Set( minf[0], minf[1], minf[2] );
+	max.Set( maxf[0], maxf[1], maxf[2] );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const triIndex_t *indexes, const int count ) {
+	__m256 vmin0 = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmin1 = _mm256_splat1_ps( idMath::INFINITY );
+	__m256 vmax0 = _mm256_splat1_ps( -idMath::INFINITY );
+	__m256 vmax1 = _mm256_splat1_ps( -idMath::INFINITY );
+
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m256 v0 = _mm256_loadu2_ps( src[indexes[i+0]].xyz.ToFloatPtr(), src[indexes[i+1]].xyz.ToFloatPtr() );
+		__m256 v1 = _mm256_loadu2_ps( src[indexes[i+2]].xyz.ToFloatPtr(), src[indexes[i+3]].xyz.ToFloatPtr() );
+		vmin0 = _mm256_min_ps( vmin0, v0 );
+		vmin1 = _mm256_min_ps( vmin1, v1 );
+		vmax0 = _mm256_max_ps( vmax0, v0 );
+		vmax1 = _mm256_max_ps( vmax1, v1 );
+	}
+
+	vmin0 = _mm256_min_ps( vmin0, vmin1 );
+	vmax0 = _mm256_max_ps( vmax0, vmax1 );
+
+	__m128 min4 = _mm_min_ps( _mm256_castps256_ps128( vmin0 ), _mm256_extractf128_ps( vmin0, 1 ) );
+	__m128 max4 = _mm_max_ps( _mm256_castps256_ps128( vmax0 ), _mm256_extractf128_ps( vmax0, 1 ) );
+
+	_mm256_zeroupper();
+
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[indexes[i]].xyz.ToFloatPtr() );
+		min4 = _mm_min_ps( min4, v );
+		max4 = _mm_max_ps( max4, v );
+	}
+
+	ALIGN16( float minf[4] );
+	ALIGN16( float maxf[4] );
+	_mm_store_ps( minf, min4 );
+	_mm_store_ps( maxf, max4 );
+
+	min.Set( minf[0], minf[1], minf[2] );
+	max.Set( maxf[0], maxf[1], maxf[2] );
+}
+
+/*
+============
+idSIMD_AVX2::BlendJoints
+============
+*/
+void VPCALL idSIMD_AVX2::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+
+	if ( lerp <= 0.0f ) {
+		return;
+	} else if ( lerp >= 1.0f ) {
+		for ( int i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	const __m256 vlerp = _mm256_splat1_ps( lerp );
+
+	const __m256 vector_float_one		= _mm256_splat1_ps( 1.0f );
+	const __m256 vector_float_sign_bit	= _mm256_castsi256_ps( _mm256_set1_epi32( 0x80000000 ) );
+	const __m256 vector_float_rsqrt_c0	= _mm256_splat1_ps( -3.0f );
+	const __m256 vector_float_rsqrt_c1	= _mm256_splat1_ps( -0.5f );
+	const __m256 vector_float_tiny		= _mm256_splat1_ps( 1e-10f );
+	const __m256 vector_float_half_pi	= _mm256_splat1_ps( M_PI*0.5f );
+
+	const __m256 vector_float_sin_c0	= _mm256_splat1_ps( -2.39e-08f );
+	const __m256 vector_float_sin_c1	= _mm256_splat1_ps(  2.7526e-06f );
+	const __m256 vector_float_sin_c2	= _mm256_splat1_ps( -1.98409e-04f );
+	const __m256 vector_float_sin_c3	= _mm256_splat1_ps(  8.3333315e-03f );
+	const __m256 vector_float_sin_c4	= _mm256_splat1_ps( -1.666666664e-01f );
+
+	const __m256 vector_float_atan_c0	= _mm256_splat1_ps(  0.0028662257f );
+	const __m256 vector_float_atan_c1	= _mm256_splat1_ps( -0.0161657367f );
+	const __m256 vector_float_atan_c2	= _mm256_splat1_ps(  0.0429096138f );
+	const __m256 vector_float_atan_c3	= _mm256_splat1_ps( -0.0752896400f );
+	const __m256 vector_float_atan_c4	= _mm256_splat1_ps(  0.1065626393f );
+	const __m256 vector_float_atan_c5	= _mm256_splat1_ps( -0.1420889944f );
+	const __m256 vector_float_atan_c6	= _mm256_splat1_ps(  0.1999355085f );
+	const __m256 vector_float_atan_c7	= _mm256_splat1_ps( -0.3333314528f );
+
+	// joints a-d go in the low lanes and joints e-h in the high lanes
+	int i = 0;
+	for ( ; i < numJoints - 7; i += 8 ) {
+		const int n0 = index[i+0];
+		const int n1 = index[i+1];
+		const int n2 = index[i+2];
+		const int n3 = index[i+3];
+		const int n4 = index[i+4];
+		const int n5 = index[i+5];
+		const int n6 = index[i+6];
+		const int n7 = index[i+7];
+
+		__m256 jqae = _mm256_load2_ps( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr() );
+		__m256 jqbf = _mm256_load2_ps( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr() );
+		__m256 jqcg = _mm256_load2_ps( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr() );
+		__m256 jqdh = _mm256_load2_ps( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr() );
+
+		__m256 jtae = _mm256_load2_ps( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr() );
+		__m256 jtbf = _mm256_load2_ps( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr() );
+		__m256 jtcg = _mm256_load2_ps( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr() );
+		__m256 jtdh = _mm256_load2_ps( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr() );
+
+		__m256 bqae = _mm256_load2_ps( blendJoints[n0].q.ToFloatPtr(), blendJoints[n4].q.ToFloatPtr() );
+		__m256 bqbf = _mm256_load2_ps( blendJoints[n1].q.ToFloatPtr(), blendJoints[n5].q.ToFloatPtr() );
+		__m256 bqcg = _mm256_load2_ps( blendJoints[n2].q.ToFloatPtr(), blendJoints[n6].q.ToFloatPtr() );
+		__m256 bqdh = _mm256_load2_ps( blendJoints[n3].q.ToFloatPtr(), blendJoints[n7].q.ToFloatPtr() );
+
+		__m256 btae = _mm256_load2_ps( blendJoints[n0].t.ToFloatPtr(), blendJoints[n4].t.ToFloatPtr() );
+		__m256 btbf = _mm256_load2_ps( blendJoints[n1].t.ToFloatPtr(), blendJoints[n5].t.ToFloatPtr() );
+		__m256 btcg = _mm256_load2_ps( blendJoints[n2].t.ToFloatPtr(), blendJoints[n6].t.ToFloatPtr() );
+		__m256 btdh = _mm256_load2_ps( blendJoints[n3].t.ToFloatPtr(), blendJoints[n7].t.ToFloatPtr() );
+
+		btae = _mm256_sub_ps( btae, jtae );
+		btbf = _mm256_sub_ps( btbf, jtbf );
+		btcg = _mm256_sub_ps( btcg, jtcg );
+		btdh = _mm256_sub_ps( btdh, jtdh );
+
+		jtae = _mm256_madd_ps( vlerp, btae, jtae );
+		jtbf = _mm256_madd_ps( vlerp, btbf, jtbf );
+		jtcg = _mm256_madd_ps( vlerp, btcg, jtcg );
+		jtdh = _mm256_madd_ps( vlerp, btdh, jtdh );
+
+		_mm256_store2_ps( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr(), jtae );
+		_mm256_store2_ps( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr(), jtbf );
+		_mm256_store2_ps( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr(), jtcg );
+		_mm256_store2_ps( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr(), jtdh );
+
+		// the unpacks work per 128-bit lane so the same transpose as the SSE code applies
+		__m256 jqr = _mm256_unpacklo_ps( jqae, jqcg );
+		__m256 jqs = _mm256_unpackhi_ps( jqae, jqcg );
+		__m256 jqt = _mm256_unpacklo_ps( jqbf, jqdh );
+		__m256 jqu = _mm256_unpackhi_ps( jqbf, jqdh );
+
+		__m256 bqr = _mm256_unpacklo_ps( bqae, bqcg );
+		__m256 bqs = _mm256_unpackhi_ps( bqae, bqcg );
+		__m256 bqt = _mm256_unpacklo_ps( bqbf, bqdh );
+		__m256 bqu = _mm256_unpackhi_ps( bqbf, bqdh );
+
+		__m256 jqx = _mm256_unpacklo_ps( jqr, jqt );
+		__m256 jqy = _mm256_unpackhi_ps( jqr, jqt );
+		__m256 jqz = _mm256_unpacklo_ps( jqs, jqu );
+		__m256 jqw = _mm256_unpackhi_ps( jqs, jqu );
+
+		__m256 bqx = _mm256_unpacklo_ps( bqr, bqt );
+		__m256 bqy = _mm256_unpackhi_ps( bqr, bqt );
+		__m256 bqz = _mm256_unpacklo_ps( bqs, bqu );
+		__m256 bqw = _mm256_unpackhi_ps( bqs, bqu );
+
+		__m256 cosoma = _mm256_mul_ps( jqx, bqx );
+		__m256 cosomb = _mm256_mul_ps( jqy, bqy );
+		__m256 cosome = _mm256_madd_ps( jqz, bqz, cosoma );
+		__m256 cosomf = _mm256_madd_ps( jqw, bqw, cosomb );
+		__m256 cosomg = _mm256_add_ps( cosome, cosomf );
+
+		__m256 sign = _mm256_and_ps( cosomg, vector_float_sign_bit );
+		__m256 cosom = _mm256_xor_ps( cosomg, sign );
+		__m256 ss = _mm256_nmsub_ps( cosom, cosom, vector_float_one );
+
+		ss = _mm256_max_ps( ss, vector_float_tiny );
+
+		__m256 rs = _mm256_rsqrt_ps( ss );
+		__m256 sq = _mm256_mul_ps( rs, rs );
+		__m256 sh = _mm256_mul_ps( rs, vector_float_rsqrt_c1 );
+		__m256 sx = _mm256_madd_ps( ss, sq, vector_float_rsqrt_c0 );
+		__m256 sinom = _mm256_mul_ps( sh, sx );						// sinom = sqrt( ss );
+
+		ss = _mm256_mul_ps( ss, sinom );
+
+		__m256 mina = _mm256_min_ps( ss, cosom );
+		__m256 maxa = _mm256_max_ps( ss, cosom );
+		__m256 mask = _mm256_cmp_ps( mina, cosom, _CMP_EQ_OQ );
+		__m256 masksign = _mm256_and_ps( mask, vector_float_sign_bit );
+		__m256 maskPI = _mm256_and_ps( mask, vector_float_half_pi );
+
+		__m256 rcpa = _mm256_rcp_ps( maxa );
+		__m256 rcpb = _mm256_mul_ps( maxa, rcpa );
+		__m256 rcpd = _mm256_add_ps( rcpa, rcpa );
+		__m256 rcp = _mm256_nmsub_ps( rcpb, rcpa, rcpd );			// 1 / y or 1 / x
+		__m256 ata = _mm256_mul_ps( mina, rcp );						// x / y or y / x
+
+		__m256 atb = _mm256_xor_ps( ata, masksign );				// -x / y or y / x
+		__m256 atc = _mm256_mul_ps( atb, atb );
+		__m256 atd = _mm256_madd_ps( atc, vector_float_atan_c0, vector_float_atan_c1 );
+
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c2 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c3 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c4 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c5 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c6 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_atan_c7 );
+		atd = _mm256_madd_ps( atd, atc, vector_float_one );
+
+		__m256 omega_a = _mm256_madd_ps( atd, atb, maskPI );
+		__m256 omega_b = _mm256_mul_ps( vlerp, omega_a );
+		omega_a = _mm256_sub_ps( omega_a, omega_b );
+
+		__m256 sinsa = _mm256_mul_ps( omega_a, omega_a );
+		__m256 sinsb = _mm256_mul_ps( omega_b, omega_b );
+		__m256 sina = _mm256_madd_ps( sinsa, vector_float_sin_c0, vector_float_sin_c1 );
+		__m256 sinb = _mm256_madd_ps( sinsb, vector_float_sin_c0, vector_float_sin_c1 );
+		sina = _mm256_madd_ps( sina, sinsa, vector_float_sin_c2 );
+		sinb = _mm256_madd_ps( sinb, sinsb, vector_float_sin_c2 );
+		sina = _mm256_madd_ps( sina, sinsa, vector_float_sin_c3 );
+		sinb = _mm256_madd_ps( sinb, sinsb, vector_float_sin_c3 );
+		sina = _mm256_madd_ps( sina, sinsa, vector_float_sin_c4 );
+		sinb = _mm256_madd_ps( sinb, sinsb, vector_float_sin_c4 );
+		sina = _mm256_madd_ps( sina, sinsa, vector_float_one );
+		sinb = _mm256_madd_ps( sinb, sinsb, vector_float_one );
+		sina = _mm256_mul_ps( sina, omega_a );
+		sinb = _mm256_mul_ps( sinb, omega_b );
+		__m256 scalea = _mm256_mul_ps( sina, sinom );
+		__m256 scaleb = _mm256_mul_ps( sinb, sinom );
+
+		scaleb = _mm256_xor_ps( scaleb, sign );
+
+		jqx = _mm256_mul_ps( jqx, scalea );
+		jqy = _mm256_mul_ps( jqy, scalea );
+		jqz = _mm256_mul_ps( jqz, scalea );
+		jqw = _mm256_mul_ps( jqw, scalea );
+
+		jqx = _mm256_madd_ps( bqx, scaleb, jqx );
+		jqy = _mm256_madd_ps( bqy, scaleb, jqy );
+		jqz = _mm256_madd_ps( bqz, scaleb, jqz );
+		jqw = _mm256_madd_ps( bqw, scaleb, jqw );
+
+		__m256 tp0 = _mm256_unpacklo_ps( jqx, jqz );
+		__m256 tp1 = _mm256_unpackhi_ps( jqx, jqz );
+		__m256 tp2 = _mm256_unpacklo_ps( jqy, jqw );
+		__m256 tp3 = _mm256_unpackhi_ps( jqy, jqw );
+
+		__m256 pae = _mm256_unpacklo_ps( tp0, tp2 );
+		__m256 pbf = _mm256_unpackhi_ps( tp0, tp2 );
+		__m256 pcg = _mm256_unpacklo_ps( tp1, tp3 );
+		__m256 pdh = _mm256_unpackhi_ps( tp1, tp3 );
+
+		_mm256_store2_ps( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr(), pae );
+		_mm256_store2_ps( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr(), pbf );
+		_mm256_store2_ps( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr(), pcg );
+		_mm256_store2_ps( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr(), pdh );
+	}
+
+	_mm256_zeroupper();
+
+	if ( i < numJoints ) {
+		idSIMD_SSE::BlendJoints( joints, blendJoints, lerp, index + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::BlendJointsFast
+============
+*/
+void VPCALL idSIMD_AVX2::BlendJointsFast( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	assert_16_byte_aligned( joints );
+	assert_16_byte_aligned( blendJoints );
+	assert_16_byte_aligned( JOINTQUAT_Q_OFFSET );
+	assert_16_byte_aligned( JOINTQUAT_T_OFFSET );
+	assert_sizeof_16_byte_multiple( idJointQuat );
+
+	if ( lerp <= 0.0f ) {
+		return;
+	} else if ( lerp >= 1.0f ) {
+		for ( int i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	const __m256 vector_float_sign_bit	= _mm256_castsi256_ps( _mm256_set1_epi32( 0x80000000 ) );
+	const __m256 vector_float_rsqrt_c0	= _mm256_splat1_ps( -3.0f );
+	const __m256 vector_float_rsqrt_c1	= _mm256_splat1_ps( -0.5f );
+
+	const float scaledLerp = lerp / ( 1.0f - lerp );
+	const __m256 vlerp = _mm256_splat1_ps( lerp );
+	const __m256 vscaledLerp = _mm256_splat1_ps( scaledLerp );
+
+	int i = 0;
+	for ( ; i < numJoints - 7; i += 8 ) {
+		const int n0 = index[i+0];
+		const int n1 = index[i+1];
+		const int n2 = index[i+2];
+		const int n3 = index[i+3];
+		const int n4 = index[i+4];
+		const int n5 = index[i+5];
+		const int n6 = index[i+6];
+		const int n7 = index[i+7];
+
+		__m256 jqae = _mm256_load2_ps( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr() );
+		__m256 jqbf = _mm256_load2_ps( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr() );
+		__m256 jqcg = _mm256_load2_ps( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr() );
+		__m256 jqdh = _mm256_load2_ps( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr() );
+
+		__m256 jtae = _mm256_load2_ps( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr() );
+		__m256 jtbf = _mm256_load2_ps( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr() );
+		__m256 jtcg = _mm256_load2_ps( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr() );
+		__m256 jtdh = _mm256_load2_ps( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr() );
+
+		__m256 bqae = _mm256_load2_ps( blendJoints[n0].q.ToFloatPtr(), blendJoints[n4].q.ToFloatPtr() );
+		__m256 bqbf = _mm256_load2_ps( blendJoints[n1].q.ToFloatPtr(), blendJoints[n5].q.ToFloatPtr() );
+		__m256 bqcg = _mm256_load2_ps( blendJoints[n2].q.ToFloatPtr(), blendJoints[n6].q.ToFloatPtr() );
+		__m256 bqdh = _mm256_load2_ps( blendJoints[n3].q.ToFloatPtr(), blendJoints[n7].q.ToFloatPtr() );
+
+		__m256 btae = _mm256_load2_ps( blendJoints[n0].t.ToFloatPtr(), blendJoints[n4].t.ToFloatPtr() );
+		__m256 btbf = _mm256_load2_ps( blendJoints[n1].t.ToFloatPtr(), blendJoints[n5].t.ToFloatPtr() );
+		__m256 btcg = _mm256_load2_ps( blendJoints[n2].t.ToFloatPtr(), blendJoints[n6].t.ToFloatPtr() );
+		__m256 btdh = _mm256_load2_ps( blendJoints[n3].t.ToFloatPtr(), blendJoints[n7].t.ToFloatPtr() );
+
+		btae = _mm256_sub_ps( btae, jtae );
+		btbf = _mm256_sub_ps( btbf, jtbf );
+		btcg = _mm256_sub_ps( btcg, jtcg );
+		btdh = _mm256_sub_ps( btdh, jtdh );
+
+		jtae = _mm256_madd_ps( vlerp, btae, jtae );
+		jtbf = _mm256_madd_ps( vlerp, btbf, jtbf );
+		jtcg = _mm256_madd_ps( vlerp, btcg, jtcg );
+		jtdh = _mm256_madd_ps( vlerp, btdh, jtdh );
+
+		_mm256_store2_ps( joints[n0].t.ToFloatPtr(), joints[n4].t.ToFloatPtr(), jtae );
+		_mm256_store2_ps( joints[n1].t.ToFloatPtr(), joints[n5].t.ToFloatPtr(), jtbf );
+		_mm256_store2_ps( joints[n2].t.ToFloatPtr(), joints[n6].t.ToFloatPtr(), jtcg );
+		_mm256_store2_ps( joints[n3].t.ToFloatPtr(), joints[n7].t.ToFloatPtr(), jtdh );
+
+		__m256 jqr = _mm256_unpacklo_ps( jqae, jqcg );
+		__m256 jqs = _mm256_unpackhi_ps( jqae, jqcg );
+		__m256 jqt = _mm256_unpacklo_ps( jqbf, jqdh );
+		__m256 jqu = _mm256_unpackhi_ps( jqbf, jqdh );
+
+		__m256 bqr = _mm256_unpacklo_ps( bqae, bqcg );
+		__m256 bqs = _mm256_unpackhi_ps( bqae, bqcg );
+		__m256 bqt = _mm256_unpacklo_ps( bqbf, bqdh );
+		__m256 bqu = _mm256_unpackhi_ps( bqbf, bqdh );
+
+		__m256 jqx = _mm256_unpacklo_ps( jqr, jqt );
+		__m256 jqy = _mm256_unpackhi_ps( jqr, jqt );
+		__m256 jqz = _mm256_unpacklo_ps( jqs, jqu );
+		__m256 jqw = _mm256_unpackhi_ps( jqs, jqu );
+
+		__m256 bqx = _mm256_unpacklo_ps( bqr, bqt );
+		__m256 bqy = _mm256_unpackhi_ps( bqr, bqt );
+		__m256 bqz = _mm256_unpacklo_ps( bqs, bqu );
+		__m256 bqw = _mm256_unpackhi_ps( bqs, bqu );
+
+		__m256 cosoma = _mm256_mul_ps( jqx, bqx );
+		__m256 cosomb = _mm256_mul_ps( jqy, bqy );
+		__m256 cosome = _mm256_madd_ps( jqz, bqz, cosoma );
+		__m256 cosomf = _mm256_madd_ps( jqw, bqw, cosomb );
+		__m256 cosom = _mm256_add_ps( cosome, cosomf );
+
+		__m256 sign = _mm256_and_ps( cosom, vector_float_sign_bit );
+
+		__m256 scale = _mm256_xor_ps( vscaledLerp, sign );
+
+		jqx = _mm256_madd_ps( scale, bqx, jqx );
+		jqy = _mm256_madd_ps( scale, bqy, jqy );
+		jqz = _mm256_madd_ps( scale, bqz, jqz );
+		jqw = _mm256_madd_ps( scale, bqw, jqw );
+
+		__m256 da = _mm256_mul_ps( jqx, jqx );
+		__m256 db = _mm256_mul_ps( jqy, jqy );
+		__m256 de = _mm256_madd_ps( jqz, jqz, da );
+		__m256 df = _mm256_madd_ps( jqw, jqw, db );
+		__m256 d = _mm256_add_ps( de, df );
+
+		__m256 rs = _mm256_rsqrt_ps( d );
+		__m256 sq = _mm256_mul_ps( rs, rs );
+		__m256 sh = _mm256_mul_ps( rs, vector_float_rsqrt_c1 );
+		__m256 sx = _mm256_madd_ps( d, sq, vector_float_rsqrt_c0 );
+		__m256 s = _mm256_mul_ps( sh, sx );
+
+		jqx = _mm256_mul_ps( jqx, s );
+		jqy = _mm256_mul_ps( jqy, s );
+		jqz = _mm256_mul_ps( jqz, s );
+		jqw = _mm256_mul_ps( jqw, s );
+
+		__m256 tp0 = _mm256_unpacklo_ps( jqx, jqz );
+		__m256 tp1 = _mm256_unpackhi_ps( jqx, jqz );
+		__m256 tp2 = _mm256_unpacklo_ps( jqy, jqw );
+		__m256 tp3 = _mm256_unpackhi_ps( jqy, jqw );
+
+		__m256 pae = _mm256_unpacklo_ps( tp0, tp2 );
+		__m256 pbf = _mm256_unpackhi_ps( tp0, tp2 );
+		__m256 pcg = _mm256_unpacklo_ps( tp1, tp3 );
+		__m256 pdh = _mm256_unpackhi_ps( tp1, tp3 );
+
+		_mm256_store2_ps( joints[n0].q.ToFloatPtr(), joints[n4].q.ToFloatPtr(), pae );
+		_mm256_store2_ps( joints[n1].q.ToFloatPtr(), joints[n5].q.ToFloatPtr(), pbf );
+		_mm256_store2_ps( joints[n2].q.ToFloatPtr(), joints[n6].q.ToFloatPtr(), pcg );
+		_mm256_store2_ps( joints[n3].q.ToFloatPtr(), joints[n7].q.ToFloatPtr(), pdh );
+	}
+
+	_mm256_zeroupper();
+
+	if ( i < numJoints ) {
+		idSIMD_SSE::BlendJointsFast( joints, blendJoints, lerp, index + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	assert( sizeof( idJointQuat ) == JOINTQUAT_SIZE );
+	assert( sizeof( idJointMat ) == JOINTMAT_SIZE );
+	assert( (int)(&((idJointQuat *)0)->t) == (int)(&((idJointQuat *)0)->q) + (int)sizeof( ((idJointQuat *)0)->q ) );
+
+	const float * jointQuatPtr = (float *)jointQuats;
+	float * jointMatPtr = (float *)jointMats;
+
+	const __m256 vector_float_first_sign_bit		= _mm256_castsi256_ps( _mm256_set_epi32( 0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000 ) );
+	const __m256 vector_float_last_three_sign_bits	= _mm256_castsi256_ps( _mm256_set_epi32( 0x80000000, 0x80000000, 0x80000000, 0x00000000, 0x80000000, 0x80000000, 0x80000000, 0x00000000 ) );
+	const __m256 vector_float_first_pos_half		= _mm256_set_ps(  0.0f,  0.0f,  0.0f,  0.5f,  0.0f,  0.0f,  0.0f,  0.5f );	// +.5 0 0 0
+	const __m256 vector_float_first_neg_half		= _mm256_set_ps(  0.0f,  0.0f,  0.0f, -0.5f,  0.0f,  0.0f,  0.0f, -0.5f );	// -.5 0 0 0
+	const __m256 vector_float_quat2mat_mad1			= _mm256_set_ps( -1.0f, +1.0f, -1.0f, -1.0f, -1.0f, +1.0f, -1.0f, -1.0f );	//  - - + -
+	const __m256 vector_float_quat2mat_mad2			= _mm256_set_ps( -1.0f, -1.0f, +1.0f, -1.0f, -1.0f, -1.0f, +1.0f, -1.0f );	//  - + - -
+	const __m256 vector_float_quat2mat_mad3			= _mm256_set_ps( +1.0f, -1.0f, -1.0f, +1.0f, +1.0f, -1.0f, -1.0f, +1.0f );	//  + - - +
+
+	// every register holds one joint per 128-bit lane, all shuffles below stay within a lane
+	int i = 0;
+	for ( ; i + 3 < numJoints; i += 4 ) {
+
+		__m256 q0 = _mm256_load2_ps( &jointQuatPtr[i*8+0*8+0], &jointQuatPtr[i*8+1*8+0] );
+		__m256 q1 = _mm256_load2_ps( &jointQuatPtr[i*8+2*8+0], &jointQuatPtr[i*8+3*8+0] );
+
+		__m256 t0 = _mm256_load2_ps( &jointQuatPtr[i*8+0*8+4], &jointQuatPtr[i*8+1*8+4] );
+		__m256 t1 = _mm256_load2_ps( &jointQuatPtr[i*8+2*8+4], &jointQuatPtr[i*8+3*8+4] );
+
+		__m256 d0 = _mm256_add_ps( q0, q0 );
+		__m256 d1 = _mm256_add_ps( q1, q1 );
+
+		__m256 sa0 = _mm256_permute_ps( q0, _MM_SHUFFLE( 1, 0, 0, 1 ) );						//   y,   x,   x,   y
+		__m256 sb0 = _mm256_permute_ps( d0, _MM_SHUFFLE( 2, 2, 1, 1 ) );						//  y2,  y2,  z2,  z2
+		__m256 sc0 = _mm256_permute_ps( q0, _MM_SHUFFLE( 3, 3, 3, 2 ) );						//   z,   w,   w,   w
+		__m256 sd0 = _mm256_permute_ps( d0, _MM_SHUFFLE( 0, 1, 2, 2 ) );						//  z2,  z2,  y2,  x2
+		__m256 sa1 = _mm256_permute_ps( q1, _MM_SHUFFLE( 1, 0, 0, 1 ) );						//   y,   x,   x,   y
+		__m256 sb1 = _mm256_permute_ps( d1, _MM_SHUFFLE( 2, 2, 1, 1 ) );						//  y2,  y2,  z2,  z2
+		__m256 sc1 = _mm256_permute_ps( q1, _MM_SHUFFLE( 3, 3, 3, 2 ) );						//   z,   w,   w,   w
+		__m256 sd1 = _mm256_permute_ps( d1, _MM_SHUFFLE( 0, 1, 2, 2 ) );						//  z2,  z2,  y2,  x2
+
+		sa0 = _mm256_xor_ps( sa0, vector_float_first_sign_bit );
+		sa1 = _mm256_xor_ps( sa1, vector_float_first_sign_bit );
+
+		sc0 = _mm256_xor_ps( sc0, vector_float_last_three_sign_bits );						// flip stupid inverse quaternions
+		sc1 = _mm256_xor_ps( sc1, vector_float_last_three_sign_bits );						// flip stupid inverse quaternions
+
+		__m256 ma0 = _mm256_madd_ps( sa0, sb0, vector_float_first_pos_half );				//  .5 - yy2,  xy2,  xz2,  yz2		//  .5 0 0 0
+		__m256 mb0 = _mm256_madd_ps( sc0, sd0, vector_float_first_neg_half );				// -.5 + zz2,  wz2,  wy2,  wx2		// -.5 0 0 0
+		__m256 mc0 = _mm256_nmsub_ps( q0, d0, vector_float_first_pos_half );				//  .5 - xx2, -yy2, -zz2, -ww2		//  .5 0 0 0
+		__m256 ma1 = _mm256_madd_ps( sa1, sb1, vector_float_first_pos_half );				//  .5 - yy2,  xy2,  xz2,  yz2		//  .5 0 0 0
+		__m256 mb1 = _mm256_madd_ps( sc1, sd1, vector_float_first_neg_half );				// -.5 + zz2,  wz2,  wy2,  wx2		// -.5 0 0 0
+		__m256 mc1 = _mm256_nmsub_ps( q1, d1, vector_float_first_pos_half );				//  .5 - xx2, -yy2, -zz2, -ww2		//  .5 0 0 0
+
+		__m256 mf0 = _mm256_shuffle_ps( ma0, mc0, _MM_SHUFFLE( 0, 0, 1, 1 ) );				//       xy2,  xy2, .5 - xx2, .5 - xx2	// 01, 01, 10, 10
+		__m256 md0 = _mm256_shuffle_ps( mf0, ma0, _MM_SHUFFLE( 3, 2, 0, 2 ) );				//  .5 - xx2,  xy2,  xz2,  yz2			// 10, 01, 02, 03
+		__m256 me0 = _mm256_shuffle_ps( ma0, mb0, _MM_SHUFFLE( 3, 2, 1, 0 ) );				//  .5 - yy2,  xy2,  wy2,  wx2			// 00, 01, 12, 13
+		__m256 mf1 = _mm256_shuffle_ps( ma1, mc1, _MM_SHUFFLE( 0, 0, 1, 1 ) );				//       xy2,  xy2, .5 - xx2, .5 - xx2	// 01, 01, 10, 10
+		__m256 md1 = _mm256_shuffle_ps( mf1, ma1, _MM_SHUFFLE( 3, 2, 0, 2 ) );				//  .5 - xx2,  xy2,  xz2,  yz2			// 10, 01, 02, 03
+		__m256 me1 = _mm256_shuffle_ps( ma1, mb1, _MM_SHUFFLE( 3, 2, 1, 0 ) );				//  .5 - yy2,  xy2,  wy2,  wx2			// 00, 01, 12, 13
+
+		__m256 ra0 = _mm256_madd_ps( mb0, vector_float_quat2mat_mad1, ma0 );				// 1 - yy2 - zz2, xy2 - wz2, xz2 + wy2,					// - - + -
+		__m256 rb0 = _mm256_madd_ps( mb0, vector_float_quat2mat_mad2, md0 );				// 1 - xx2 - zz2, xy2 + wz2,          , yz2 - wx2		// - + - -
+		__m256 rc0 = _mm256_madd_ps( me0, vector_float_quat2mat_mad3, md0 );				// 1 - xx2 - yy2,          , xz2 - wy2, yz2 + wx2		// + - - +
+		__m256 ra1 = _mm256_madd_ps( mb1, vector_float_quat2mat_mad1, ma1 );				// 1 - yy2 - zz2, xy2 - wz2, xz2 + wy2,					// - - + -
+		__m256 rb1 = _mm256_madd_ps( mb1, vector_float_quat2mat_mad2, md1 );				// 1 - xx2 - zz2, xy2 + wz2,          , yz2 - wx2		// - + - -
+		__m256 rc1 = _mm256_madd_ps( me1, vector_float_quat2mat_mad3, md1 );				// 1 - xx2 - yy2,          , xz2 - wy2, yz2 + wx2		// + - - +
+
+		__m256 ta0 = _mm256_shuffle_ps( ra0, t0, _MM_SHUFFLE( 0, 0, 2, 2 ) );
+		__m256 tb0 = _mm256_shuffle_ps( rb0, t0, _MM_SHUFFLE( 1, 1, 3, 3 ) );
+		__m256 tc0 = _mm256_shuffle_ps( rc0, t0, _MM_SHUFFLE( 2, 2, 0, 0 ) );
+		__m256 ta1 = _mm256_shuffle_ps( ra1, t1, _MM_SHUFFLE( 0, 0, 2, 2 ) );
+		__m256 tb1 = _mm256_shuffle_ps( rb1, t1, _MM_SHUFFLE( 1, 1, 3, 3 ) );
+		__m256 tc1 = _mm256_shuffle_ps( rc1, t1, _MM_SHUFFLE( 2, 2, 0, 0 ) );
+
+		ra0 = _mm256_shuffle_ps( ra0, ta0, _MM_SHUFFLE( 2, 0, 1, 0 ) );						// 00 01 02 10
+		rb0 = _mm256_shuffle_ps( rb0, tb0, _MM_SHUFFLE( 2, 0, 0, 1 ) );						// 01 00 03 11
+		rc0 = _mm256_shuffle_ps( rc0, tc0, _MM_SHUFFLE( 2, 0, 3, 2 ) );						// 02 03 00 12
+		ra1 = _mm256_shuffle_ps( ra1, ta1, _MM_SHUFFLE( 2, 0, 1, 0 ) );						// 00 01 02 10
+		rb1 = _mm256_shuffle_ps( rb1, tb1, _MM_SHUFFLE( 2, 0, 0, 1 ) );						// 01 00 03 11
+		rc1 = _mm256_shuffle_ps( rc1, tc1, _MM_SHUFFLE( 2, 0, 3, 2 ) );						// 02 03 00 12
+
+		_mm256_store2_ps( &jointMatPtr[i*12+0*12+0], &jointMatPtr[i*12+1*12+0], ra0 );
+		_mm256_store2_ps( &jointMatPtr[i*12+0*12+4], &jointMatPtr[i*12+1*12+4], rb0 );
+		_mm256_store2_ps( &jointMatPtr[i*12+0*12+8], &jointMatPtr[i*12+1*12+8], rc0 );
+		_mm256_store2_ps( &jointMatPtr[i*12+2*12+0], &jointMatPtr[i*12+3*12+0], ra1 );
+		_mm256_store2_ps( &jointMatPtr[i*12+2*12+4], &jointMatPtr[i*12+3*12+4], rb1 );
+		_mm256_store2_ps( &jointMatPtr[i*12+2*12+8], &jointMatPtr[i*12+3*12+8], rc1 );
+	}
+
+	_mm256_zeroupper();
+
+	if ( i < numJoints ) {
+		idSIMD_SSE::ConvertJointQuatsToJointMats( jointMats + i, jointQuats + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformJoints
+
+  The joint hierarchy is a serial dependency chain, so instead of working on
+  more joints at once the first two rows of the parent matrix share a register.
+============
+*/
+void VPCALL idSIMD_AVX2::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m256 vector_float_mask_keep_last	= _mm256_castsi256_ps( _mm256_set_epi32( 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000 ) );
+
+	const float *__restrict firstMatrix = jointMats->ToFloatPtr() + ( firstJoint + firstJoint + firstJoint - 3 ) * 4;
+
+	__m256 pmab = _mm256_loadu_ps( firstMatrix + 0 );
+	__m128 pmc = _mm_load_ps( firstMatrix + 8 );
+
+	for ( int joint = firstJoint; joint <= lastJoint; joint++ ) {
+		const int parent = parents[joint];
+		const float *__restrict parentMatrix = jointMats->ToFloatPtr() + ( parent + parent + parent ) * 4;
+		float *__restrict childMatrix = jointMats->ToFloatPtr() + ( joint + joint + joint ) * 4;
+
+		if ( parent != joint - 1 ) {
+			pmab = _mm256_loadu_ps( parentMatrix + 0 );
+			pmc = _mm_load_ps( parentMatrix + 8 );
+		}
+
+		__m256 cma = _mm256_broadcast_ps( (const __m128 *)( childMatrix + 0 ) );
+		__m256 cmb = _mm256_broadcast_ps( (const __m128 *)( childMatrix + 4 ) );
+		__m256 cmc = _mm256_broadcast_ps( (const __m128 *)( childMatrix + 8 ) );
+
+		__m256 tab = _mm256_permute_ps( pmab, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+		__m256 tde = _mm256_permute_ps( pmab, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+		__m256 tgh = _mm256_permute_ps( pmab, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+
+		__m128 tc = _mm_permute_ps( pmc, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+		__m128 tf = _mm_permute_ps( pmc, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+		__m128 ti = _mm_permute_ps( pmc, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+
+		pmab = _mm256_madd_ps( tab, cma, _mm256_and_ps( pmab, vector_float_mask_keep_last ) );
+		pmc = _mm_fmadd_ps( tc, _mm256_castps256_ps128( cma ), _mm_and_ps( pmc, _mm256_castps256_ps128( vector_float_mask_keep_last ) ) );
+
+		pmab = _mm256_madd_ps( tde, cmb, pmab );
+		pmc = _mm_fmadd_ps( tf, _mm256_castps256_ps128( cmb ), pmc );
+
+		pmab = _mm256_madd_ps( tgh, cmc, pmab );
+		pmc = _mm_fmadd_ps( ti, _mm256_castps256_ps128( cmc ), pmc );
+
+		_mm256_storeu_ps( childMatrix + 0, pmab );
+		_mm_store_ps( childMatrix + 8, pmc );
+	}
+
+	_mm256_zeroupper();
+}
+
+#endif /* ID_SIMD_AVX2 */
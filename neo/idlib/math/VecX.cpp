@@ -35,9 +35,30 @@ If you have questions concerning this license or the applicable additional terms
 //
 //===============================================================
 
-float	idVecX::temp[VECX_MAX_TEMP+4];
-float *	idVecX::tempPtr = (float *) ( ( (int) idVecX::temp + 15 ) & ~15 );
-int		idVecX::tempIndex = 0;
+idVecX::tempPool_t	idVecX::mainThreadTemp;
+ID_TLS				idVecX::threadTemp;
+
+/*
+=============
+idVecX::AllocTempPool
+
+The main thread uses a static pool, other threads get their own pool the first
+time they use temporary memory. Job threads live as long as the process so their
+pools are never freed.
+=============
+*/
+idVecX::tempPool_t *idVecX::AllocTempPool() {
+	tempPool_t * pool;
+	if ( idLib::IsMainThread() ) {
+		pool = &mainThreadTemp;
+	} else {
+		pool = new (TAG_MATH) tempPool_t;
+	}
+	pool->ptr = (float *) ( ( (UINT_PTR) pool->temp + 15 ) & ~15 );
+	pool->index = 0;
+	threadTemp = (ptrdiff_t) pool;
+	return pool;
+}
 
 /*
 =============
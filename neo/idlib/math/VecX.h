@@ -36,7 +36,8 @@ idVecX - arbitrary sized vector
 
 The vector lives on 16 byte aligned and 16 byte padded memory.
 
-NOTE: due to the temporary memory pool idVecX cannot be used by multiple threads
+NOTE: each thread has its own temporary memory pool, so temporary results
+must not be passed from one thread to another
 
 ===============================================================================
 */
@@ -114,10 +115,18 @@ private:
 	int				alloced;				// if -1 p points to data set with SetData
 	float *			p;						// memory the vector is stored
 
-	static float	temp[VECX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	typedef struct {
+		float *		ptr;					// pointer to 16 byte aligned temporary memory
+		int			index;					// index into memory pool, wraps around
+		float		temp[VECX_MAX_TEMP+4];	// used to store intermediate results
+	} tempPool_t;
 
+	static tempPool_t	mainThreadTemp;		// temporary memory of the main thread
+	static ID_TLS		threadTemp;			// temporary memory of the calling thread
+
+	static tempPool_t *	AllocTempPool();
+	ID_INLINE static tempPool_t *GetTempPool();
+	ID_INLINE bool	IsTempMemory() const;
 	ID_INLINE void	SetTempSize( int size );
 };
 
@@ -161,7 +170,7 @@ idVecX::~idVecX
 */
 ID_INLINE idVecX::~idVecX() {
 	// if not temp memory
-	if ( p && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 ) {
+	if ( p && alloced != -1 && !IsTempMemory() ) {
 		Mem_Free16( p );
 	}
 }
@@ -240,7 +249,7 @@ ID_INLINE idVecX &idVecX::operator=( const idVecX &a ) {
 #else
 	memcpy( p, a.p, a.size * sizeof( float ) );
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -304,7 +313,7 @@ ID_INLINE idVecX &idVecX::operator+=( const idVecX &a ) {
 		p[i] += a.p[i];
 	}
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -324,7 +333,7 @@ ID_INLINE idVecX &idVecX::operator-=( const idVecX &a ) {
 		p[i] -= a.p[i];
 	}
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempPool()->index = 0;
 	return *this;
 }
 
@@ -467,7 +476,7 @@ idVecX::SetSize
 ========================
 */
 ID_INLINE void idVecX::SetSize( int newSize ) {
-	//assert( p < idVecX::tempPtr || p > idVecX::tempPtr + VECX_MAX_TEMP );
+	//assert( !IsTempMemory() );
 	if ( newSize != size || p == NULL ) {
 		int alloc = ( newSize + 3 ) & ~3;
 		if ( alloc > alloced && alloced != -1 ) {
@@ -512,20 +521,44 @@ ID_INLINE void idVecX::ChangeSize( int newSize, bool makeZero ) {
 	}
 }
 
+/*
+========================
+idVecX::GetTempPool
+========================
+*/
+ID_INLINE idVecX::tempPool_t *idVecX::GetTempPool() {
+	tempPool_t * pool = (tempPool_t *)(ptrdiff_t)threadTemp;
+	if ( pool == NULL ) {
+		pool = AllocTempPool();
+	}
+	return pool;
+}
+
+/*
+========================
+idVecX::IsTempMemory
+========================
+*/
+ID_INLINE bool idVecX::IsTempMemory() const {
+	const tempPool_t * pool = GetTempPool();
+	return ( p >= pool->ptr && p < pool->ptr + VECX_MAX_TEMP );
+}
+
 /*
 ========================
 idVecX::SetTempSize
 ========================
 */
 ID_INLINE void idVecX::SetTempSize( int newSize ) {
+	tempPool_t * pool = GetTempPool();
 	size = newSize;
 	alloced = ( newSize + 3 ) & ~3;
 	assert( alloced < VECX_MAX_TEMP );
-	if ( idVecX::tempIndex + alloced > VECX_MAX_TEMP ) {
-		idVecX::tempIndex = 0;
+	if ( pool->index + alloced > VECX_MAX_TEMP ) {
+		pool->index = 0;
 	}
-	p = idVecX::tempPtr + idVecX::tempIndex;
-	idVecX::tempIndex += alloced;
+	p = pool->ptr + pool->index;
+	pool->index += alloced;
 	VECX_CLEAREND();
 }
 
@@ -535,7 +568,7 @@ idVecX::SetData
 ========================
 */
 ID_INLINE void idVecX::SetData( int length, float *data ) {
-	if ( p != NULL && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 ) {
+	if ( p != NULL && alloced != -1 && !IsTempMemory() ) {
 		Mem_Free16( p );
 	}
 	assert_16_byte_aligned( data ); // data must be 16 byte aligned
@@ -40,8 +40,10 @@ MEM_TAG( TRI_SIL_EDGE )
 MEM_TAG( TRI_DOMINANT_TRIS )
 MEM_TAG( TRI_MIR_VERT )
 MEM_TAG( TRI_DUP_VERT )
+MEM_TAG( TRI_BVH )
 MEM_TAG( SRFTRIS )
 MEM_TAG( TEMP )			// Temp data which should be automatically freed at the end of the function
+MEM_TAG( FRAME_ARENA )	// Blocks of the frame-scoped linear arenas
 MEM_TAG( PAGE )
 MEM_TAG( DEFRAG_BLOCK )
 MEM_TAG( MATH )
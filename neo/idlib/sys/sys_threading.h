@@ -47,6 +47,9 @@ If you have questions concerning this license or the applicable additional terms
 	// MemoryBarrier() inserts and CPU instruction that keeps the CPU from reordering reads and writes.
 	#pragma intrinsic(_ReadWriteBarrier)
 	#define SYS_MEMORYBARRIER		_ReadWriteBarrier(); MemoryBarrier()
+	// x86 does not reorder stores with other stores or loads with other loads, so publishing
+	// data through a volatile index only needs the compiler barrier.
+	#define SYS_READWRITEBARRIER	_ReadWriteBarrier()
 
 
 
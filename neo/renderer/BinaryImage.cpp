@@ -41,6 +41,18 @@ If you have questions concerning this license or the applicable additional terms
 #include "color/ColorSpace.h"
 
 idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "Use high quality (slow) compression" );
+idCVar image_parallelCompression( "image_parallelCompression", "1", CVAR_BOOL, "compress generated images in parallel on the job system" );
+
+/*
+========================
+IsBlockCompressed
+
+All the compressed formats encode 4x4 blocks and need the image padded to whole blocks.
+========================
+*/
+static bool IsBlockCompressed( textureFormat_t format ) {
+	return ( format == FMT_DXT1 || format == FMT_DXT5 || format == FMT_BC5 || format == FMT_BC7 );
+}
 
 /*
 ========================
@@ -79,6 +91,10 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 		}
 	}
 
+	// all levels are queued and compressed together once the mip chain has been built
+	idDxtJobEncoder encoder;
+	idList< byte * > encoderSources;
+
 	int	scaledWidth = width;
 	int scaledHeight = height;
 	images.SetNum( numLevels );
@@ -90,7 +106,7 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 		byte * dxtPic = pic;
 		int	dxtWidth = 0;
 		int	dxtHeight = 0;
-		if ( textureFormat == FMT_DXT5 || textureFormat == FMT_DXT1 ) {
+		if ( IsBlockCompressed( textureFormat ) ) {
 			if ( ( scaledWidth & 3 ) || ( scaledHeight & 3 ) ) {
 				dxtWidth = ( scaledWidth + 3 ) & ~3;
 				dxtHeight = ( scaledHeight + 3 ) & ~3;
@@ -112,36 +128,50 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 
 		// compress data or convert floats as necessary
 		if ( textureFormat == FMT_DXT1 ) {
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight / 2 );
 			if ( image_highQualityCompression.GetBool() ) {
-				dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+				encoder.AddImage( &idDxtEncoder::CompressImageDXT1HQ, 8, dxtPic, img.data, dxtWidth, dxtHeight );
 			} else {
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+				encoder.AddImage( &idDxtEncoder::CompressImageDXT1Fast, 8, dxtPic, img.data, dxtWidth, dxtHeight );
 			}
 		} else if ( textureFormat == FMT_DXT5 ) {
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight );
 			if ( colorFormat == CFM_NORMAL_DXT5 ) {
 				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressNormalMapDXT5HQ, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				} else {
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressNormalMapDXT5Fast, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				}
 			} else if ( colorFormat == CFM_YCOCG_DXT5 ) {
 				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressYCoCgDXT5HQ, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				} else {
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressYCoCgDXT5Fast, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				}
 			} else {
 				fileData.colorFormat = colorFormat = CFM_DEFAULT;
 				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressImageDXT5HQ, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				} else {
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					encoder.AddImage( &idDxtEncoder::CompressImageDXT5Fast, 16, dxtPic, img.data, dxtWidth, dxtHeight );
 				}
 			}
+		} else if ( textureFormat == FMT_BC5 ) {
+			// BC5 has the same layout as DXN2, X in the first block and Y in the second
+			img.Alloc( dxtWidth * dxtHeight );
+			if ( image_highQualityCompression.GetBool() ) {
+				encoder.AddImage( &idDxtEncoder::CompressNormalMapDXN2HQ, 16, dxtPic, img.data, dxtWidth, dxtHeight );
+			} else {
+				encoder.AddImage( &idDxtEncoder::CompressNormalMapDXN2Fast, 16, dxtPic, img.data, dxtWidth, dxtHeight );
+			}
+		} else if ( textureFormat == FMT_BC7 ) {
+			fileData.colorFormat = colorFormat = CFM_DEFAULT;
+			img.Alloc( dxtWidth * dxtHeight );
+			if ( image_highQualityCompression.GetBool() ) {
+				encoder.AddImage( &idDxtEncoder::CompressImageBC7HQ, 16, dxtPic, img.data, dxtWidth, dxtHeight );
+			} else {
+				encoder.AddImage( &idDxtEncoder::CompressImageBC7Fast, 16, dxtPic, img.data, dxtWidth, dxtHeight );
+			}
 		} else if ( textureFormat == FMT_LUM8 || textureFormat == FMT_INT8 ) {
 			// LUM8 and INT8 just read the red channel
 			img.Alloc( scaledWidth * scaledHeight );
@@ -176,9 +206,10 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 			}
 		}
 
-		// if we had to pad to quads, free the padded version
+		// the compressors keep reading the source until the encoder is finished,
+		// if we had to pad to quads that is only the padded version
 		if ( pic != dxtPic ) {
-			Mem_Free( dxtPic );
+			encoderSources.Append( dxtPic );
 			dxtPic = NULL;
 		}
 
@@ -189,7 +220,11 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 		} else {
 			shrunk = R_MipMap( pic, scaledWidth, scaledHeight );
 		}
-		Mem_Free( pic );
+		if ( dxtPic == pic && IsBlockCompressed( textureFormat ) ) {
+			encoderSources.Append( pic );
+		} else {
+			Mem_Free( pic );
+		}
 		pic = shrunk;
 
 		scaledWidth = Max( 1, scaledWidth >> 1 );
@@ -197,6 +232,11 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 	}
 
 	Mem_Free( pic );
+
+	encoder.Finish( image_parallelCompression.GetBool() );
+	for ( int i = 0; i < encoderSources.Num(); i++ ) {
+		Mem_Free( encoderSources[i] );
+	}
 }
 
 /*
@@ -238,6 +278,10 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte * pics[6], int num
 
 	images.SetNum( fileData.numLevels * 6 );
 
+	// all faces and levels are queued and compressed together once the mip chains have been built
+	idDxtJobEncoder encoder;
+	idList< byte * > encoderSources;
+
 	for ( int side = 0; side < 6; side++ ) {
 		const byte *orig = pics[side];
 		const byte *pic = orig;
@@ -247,11 +291,12 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte * pics[6], int num
 			idBinaryImageData &img = images[ level * 6 + side ];
 
 			// handle padding blocks less than 4x4 for the DXT compressors
-			ALIGN16( byte padBlock[64] );
 			int		padSize;
 			const byte *padSrc;
-			if ( scaledWidth < 4 && ( textureFormat == FMT_DXT1 || textureFormat == FMT_DXT5 ) ) {
+			if ( scaledWidth < 4 && IsBlockCompressed( textureFormat ) ) {
+				byte * padBlock = (byte *)Mem_Alloc( 64, TAG_TEMP );
 				PadImageTo4x4( pic, scaledWidth, scaledWidth, padBlock );
+				encoderSources.Append( padBlock );
 				padSize = 4;
 				padSrc = padBlock;
 			} else {
@@ -265,12 +310,16 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte * pics[6], int num
 			img.height = padSize;
 			if ( textureFormat == FMT_DXT1 ) {
 				img.Alloc( padSize * padSize / 2 );
-				idDxtEncoder dxt;
-				dxt.CompressImageDXT1Fast( padSrc, img.data, padSize, padSize );
+				encoder.AddImage( &idDxtEncoder::CompressImageDXT1Fast, 8, padSrc, img.data, padSize, padSize );
 			} else if ( textureFormat == FMT_DXT5 ) {
 				img.Alloc( padSize * padSize );
-				idDxtEncoder dxt;
-				dxt.CompressImageDXT5Fast( padSrc, img.data, padSize, padSize );
+				encoder.AddImage( &idDxtEncoder::CompressImageDXT5Fast, 16, padSrc, img.data, padSize, padSize );
+			} else if ( textureFormat == FMT_BC5 ) {
+				img.Alloc( padSize * padSize );
+				encoder.AddImage( &idDxtEncoder::CompressNormalMapDXN2Fast, 16, padSrc, img.data, padSize, padSize );
+			} else if ( textureFormat == FMT_BC7 ) {
+				img.Alloc( padSize * padSize );
+				encoder.AddImage( &idDxtEncoder::CompressImageBC7Fast, 16, padSrc, img.data, padSize, padSize );
 			} else {
 				fileData.format = textureFormat = FMT_RGBA8;
 				img.Alloc( padSize * padSize * 4 );
@@ -285,7 +334,11 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte * pics[6], int num
 				shrunk = R_MipMap( pic, scaledWidth, scaledWidth );
 			}
 			if ( pic != orig ) {
-				Mem_Free( (void *)pic );
+				if ( padSrc == pic && IsBlockCompressed( textureFormat ) ) {
+					encoderSources.Append( (byte *)pic );
+				} else {
+					Mem_Free( (void *)pic );
+				}
 				pic = NULL;
 			}
 			pic = shrunk;
@@ -298,6 +351,11 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte * pics[6], int num
 			pic = NULL;
 		}
 	}
+
+	encoder.Finish( image_parallelCompression.GetBool() );
+	for ( int i = 0; i < encoderSources.Num(); i++ ) {
+		Mem_Free( encoderSources[i] );
+	}
 }
 
 /*
@@ -346,14 +404,14 @@ idBinaryImage::LoadFromGeneratedFile
 Load the preprocessed image from the generated folder.
 ==========================
 */
-ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime ) {
+ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxLevelSize ) {
 	idStr binaryFileName;
 	MakeGeneratedFileName( binaryFileName );
 	idFileLocal bFile = fileSystem->OpenFileRead( binaryFileName );
 	if ( bFile == NULL ) {
 		return FILE_NOT_FOUND_TIMESTAMP;
 	}
-	if ( LoadFromGeneratedFile( bFile, sourceFileTime ) ) {
+	if ( LoadFromGeneratedFile( bFile, sourceFileTime, maxLevelSize ) ) {
 		return bFile->Timestamp();
 	}
 	return FILE_NOT_FOUND_TIMESTAMP;
@@ -366,21 +424,8 @@ idBinaryImage::LoadFromGeneratedFile
 Load the preprocessed image from the generated folder.
 ==========================
 */
-bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileTime ) {
-	if ( bFile->Read( &fileData, sizeof( fileData ) ) <= 0 ) {
-		return false;
-	}
-	idSwapClass<bimageFile_t> swap;
-	swap.Big( fileData.sourceFileTime );
-	swap.Big( fileData.headerMagic );
-	swap.Big( fileData.textureType );
-	swap.Big( fileData.format );
-	swap.Big( fileData.colorFormat );
-	swap.Big( fileData.width );
-	swap.Big( fileData.height );
-	swap.Big( fileData.numLevels );
-
-	if ( BIMAGE_MAGIC != fileData.headerMagic ) {
+bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileTime, int maxLevelSize ) {
+	if ( !LoadHeaderFromGeneratedFile( bFile ) ) {
 		return false;
 	}
 	if ( fileData.sourceFileTime != sourceFileTime && !fileSystem->InProductionMode() ) {
@@ -392,27 +437,42 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileT
 		numImages *= 6;
 	}
 
-	images.SetNum( numImages );
+	images.Clear();
+	images.Resize( numImages );
 
 	for ( int i = 0; i < numImages; i++ ) {
-		idBinaryImageData &img = images[ i ];
-		if ( bFile->Read( &img, sizeof( bimageImage_t ) ) <= 0 ) {
+		bimageImage_t header;
+		if ( bFile->Read( &header, sizeof( bimageImage_t ) ) <= 0 ) {
 			return false;
 		}
 		idSwapClass<bimageImage_t> swap;
-		swap.Big( img.level );
-		swap.Big( img.destZ );
-		swap.Big( img.width );
-		swap.Big( img.height );
-		swap.Big( img.dataSize );
-		assert( img.level >= 0 && img.level < fileData.numLevels );
-		assert( img.destZ == 0 || fileData.textureType == TT_CUBIC );
-		assert( img.dataSize > 0 );
+		swap.Big( header.level );
+		swap.Big( header.destZ );
+		swap.Big( header.width );
+		swap.Big( header.height );
+		swap.Big( header.dataSize );
+		assert( header.level >= 0 && header.level < fileData.numLevels );
+		assert( header.destZ == 0 || fileData.textureType == TT_CUBIC );
+		assert( header.dataSize > 0 );
 		// DXT images need to be padded to 4x4 block sizes, but the original image
 		// sizes are still retained, so the stored data size may be larger than
 		// just the multiplication of dimensions
-		assert( img.dataSize >= img.width * img.height * BitsForFormat( (textureFormat_t)fileData.format ) / 8 );
-		img.Alloc( img.dataSize );
+		assert( header.dataSize >= header.width * header.height * BitsForFormat( (textureFormat_t)fileData.format ) / 8 );
+
+		// the levels are stored largest first, so skipped levels are never read
+		if ( maxLevelSize > 0 && header.level < fileData.numLevels - 1 && Max( header.width, header.height ) > maxLevelSize ) {
+			if ( bFile->Seek( header.dataSize, FS_SEEK_CUR ) != 0 ) {
+				return false;
+			}
+			continue;
+		}
+
+		idBinaryImageData &img = images.Alloc();
+		img.level = header.level;
+		img.destZ = header.destZ;
+		img.width = header.width;
+		img.height = header.height;
+		img.Alloc( header.dataSize );
 		if ( img.data == NULL ) {
 			return false;
 		}
@@ -425,6 +485,28 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileT
 	return true;
 }
 
+/*
+==========================
+idBinaryImage::LoadHeaderFromGeneratedFile
+==========================
+*/
+bool idBinaryImage::LoadHeaderFromGeneratedFile( idFile * bFile ) {
+	if ( bFile->Read( &fileData, sizeof( fileData ) ) <= 0 ) {
+		return false;
+	}
+	idSwapClass<bimageFile_t> swap;
+	swap.Big( fileData.sourceFileTime );
+	swap.Big( fileData.headerMagic );
+	swap.Big( fileData.textureType );
+	swap.Big( fileData.format );
+	swap.Big( fileData.colorFormat );
+	swap.Big( fileData.width );
+	swap.Big( fileData.height );
+	swap.Big( fileData.numLevels );
+
+	return ( BIMAGE_MAGIC == fileData.headerMagic );
+}
+
 /*
 ==========================
 idBinaryImage::MakeGeneratedFileName
@@ -447,3 +529,274 @@ void idBinaryImage::GetGeneratedFileName( idStr & gfn, const char *name ) {
 }
 
 
+
+/*
+========================
+GeneratedImageGammaMips
+
+The mip filtering is not stored in the generated file, keep this in sync with idImage::DeriveOpts.
+========================
+*/
+static bool GeneratedImageGammaMips( textureUsage_t usage ) {
+	switch ( usage ) {
+		case TD_DIFFUSE:
+		case TD_SPECULAR:
+		case TD_DEFAULT:
+		case TD_FONT:
+		case TD_LIGHT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+========================
+R_GenerateImages_f
+
+Rebuilds all the generated images below a directory from their source images with the
+format and number of levels already stored in each generated file. It does not need a
+map or a rendering context, so it can be run in batch from the command line with
+"+generateImages textures/base +quit". Images made by image programs can't be traced
+back to their source from the generated name and are skipped.
+========================
+*/
+void R_GenerateImages_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: generateImages <directory> [serial]\n" );
+		return;
+	}
+
+	const bool saveParallel = image_parallelCompression.GetBool();
+	image_parallelCompression.SetBool( idStr::Icmp( args.Argv( 2 ), "serial" ) != 0 );
+
+	idStr path = "generated/images/";
+	path += args.Argv( 1 );
+	path.StripTrailing( '/' );
+
+	idFileList * files = fileSystem->ListFilesTree( path, ".bimage", true );
+
+	const int prefixLength = idStr::Length( "generated/images/" );
+	int numBuilt = 0;
+	int numSkipped = 0;
+	uint64 totalPixels = 0;
+	uint64 encodeMicroSec = 0;
+	const uint64 startMicroSec = Sys_Microseconds();
+
+	for ( int i = 0; i < files->GetNumFiles(); i++ ) {
+		idStr imageName = files->GetFile( i ) + prefixLength;
+		imageName.StripTrailingOnce( ".bimage" );
+
+		// the generated name is the image name with #__<usage><cube> inserted before the extension
+		const int tag = imageName.Find( "#__" );
+		if ( tag < 0 || imageName.Length() < tag + 7 ) {
+			numSkipped++;
+			continue;
+		}
+		const textureUsage_t usage = (textureUsage_t)atoi( imageName.Mid( tag + 3, 2 ) );
+		const cubeFiles_t cubeFiles = (cubeFiles_t)atoi( imageName.Mid( tag + 5, 2 ) );
+		idStr sourceName = imageName.Left( tag );
+		sourceName += imageName.c_str() + tag + 7;
+
+		idBinaryImage im( imageName );
+		{
+			idFileLocal file( fileSystem->OpenFileRead( files->GetFile( i ) ) );
+			if ( file == NULL || !im.LoadHeaderFromGeneratedFile( file ) ) {
+				common->Warning( "generateImages: couldn't read %s", files->GetFile( i ) );
+				numSkipped++;
+				continue;
+			}
+		}
+		const bimageFile_t header = im.GetFileHeader();
+		textureFormat_t format = (textureFormat_t)header.format;
+		textureColor_t colorFormat = (textureColor_t)header.colorFormat;
+		ID_TIME_T sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
+
+		if ( header.textureType == TT_CUBIC ) {
+			byte * pics[6];
+			int size = 0;
+			if ( !R_LoadCubeImages( sourceName, cubeFiles, pics, &size, &sourceFileTime ) ) {
+				numSkipped++;
+				continue;
+			}
+			const bool sameSize = ( size == header.width );
+			if ( sameSize ) {
+				const uint64 start = Sys_Microseconds();
+				im.LoadCubeFromMemory( size, (const byte **)pics, header.numLevels, format, GeneratedImageGammaMips( usage ) );
+				encodeMicroSec += Sys_Microseconds() - start;
+			}
+			for ( int j = 0; j < 6; j++ ) {
+				if ( pics[j] ) {
+					Mem_Free( pics[j] );
+				}
+			}
+			if ( !sameSize ) {
+				numSkipped++;
+				continue;
+			}
+		} else {
+			byte * pic = NULL;
+			int width = 0;
+			int height = 0;
+			R_LoadImageProgram( sourceName, &pic, &width, &height, &sourceFileTime );
+			if ( pic == NULL || width != header.width || height != header.height ) {
+				// a resized source changes the number of levels, let the game regenerate it
+				if ( pic != NULL ) {
+					Mem_Free( pic );
+				}
+				numSkipped++;
+				continue;
+			}
+			const uint64 start = Sys_Microseconds();
+			im.Load2DFromMemory( width, height, pic, header.numLevels, format, colorFormat, GeneratedImageGammaMips( usage ) );
+			encodeMicroSec += Sys_Microseconds() - start;
+			Mem_Free( pic );
+		}
+
+		for ( int j = 0; j < im.NumImages(); j++ ) {
+			const bimageImage_t & img = im.GetImageHeader( j );
+			totalPixels += img.width * img.height;
+		}
+
+		im.WriteGeneratedFile( sourceFileTime );
+		numBuilt++;
+	}
+
+	fileSystem->FreeFileList( files );
+	image_parallelCompression.SetBool( saveParallel );
+
+	const float megaPixels = totalPixels / 1000000.0f;
+	const float encodeSeconds = encodeMicroSec / 1000000.0f;
+	common->Printf( "%d images rebuilt, %d skipped in %1.2f seconds\n", numBuilt, numSkipped, ( Sys_Microseconds() - startMicroSec ) / 1000000.0f );
+	common->Printf( "%1.1f megapixels encoded in %1.2f seconds: %1.1f megapixels/sec\n", megaPixels, encodeSeconds, ( encodeSeconds > 0.0f ) ? megaPixels / encodeSeconds : 0.0f );
+}
+
+typedef void ( idDxtDecoder::*dxtDecompressFunc_t )( const byte *, byte *, int, int );
+
+struct imageCompressionTest_t {
+	const char *		name;
+	dxtCompressFunc_t	compress;
+	dxtDecompressFunc_t	decompress;
+	int					bytesPerBlock;
+	textureColor_t		colorFormat;		// source conversion, the same as idBinaryImage::Load2DFromMemory
+	int					channels[4];		// decoded channel compared to the source red, green, blue and alpha, -1 to skip
+	bool				highQuality;
+};
+
+static const imageCompressionTest_t imageCompressionTests[] = {
+	{ "DXT1",			&idDxtEncoder::CompressImageDXT1Fast,		&idDxtDecoder::DecompressImageDXT1,			8,	CFM_DEFAULT,		{ 0, 1, 2, -1 },	false },
+	{ "DXT1 HQ",		&idDxtEncoder::CompressImageDXT1HQ,			&idDxtDecoder::DecompressImageDXT1,			8,	CFM_DEFAULT,		{ 0, 1, 2, -1 },	true },
+	{ "DXT5",			&idDxtEncoder::CompressImageDXT5Fast,		&idDxtDecoder::DecompressImageDXT5,			16,	CFM_DEFAULT,		{ 0, 1, 2, 3 },		false },
+	{ "DXT5 HQ",		&idDxtEncoder::CompressImageDXT5HQ,			&idDxtDecoder::DecompressImageDXT5,			16,	CFM_DEFAULT,		{ 0, 1, 2, 3 },		true },
+	{ "YCoCg DXT5",		&idDxtEncoder::CompressYCoCgDXT5Fast,		&idDxtDecoder::DecompressYCoCgDXT5,			16,	CFM_YCOCG_DXT5,		{ 0, 1, 2, -1 },	false },
+	{ "YCoCg DXT5 HQ",	&idDxtEncoder::CompressYCoCgDXT5HQ,			&idDxtDecoder::DecompressYCoCgDXT5,			16,	CFM_YCOCG_DXT5,		{ 0, 1, 2, -1 },	true },
+	{ "BC7",			&idDxtEncoder::CompressImageBC7Fast,		&idDxtDecoder::DecompressImageBC7,			16,	CFM_DEFAULT,		{ 0, 1, 2, 3 },		false },
+	{ "BC7 HQ",			&idDxtEncoder::CompressImageBC7HQ,			&idDxtDecoder::DecompressImageBC7,			16,	CFM_DEFAULT,		{ 0, 1, 2, 3 },		true },
+	{ "normal DXT5",	&idDxtEncoder::CompressNormalMapDXT5Fast,	&idDxtDecoder::DecompressImageDXT5,			16,	CFM_NORMAL_DXT5,	{ 3, 1, -1, -1 },	false },
+	{ "normal DXT5 HQ",	&idDxtEncoder::CompressNormalMapDXT5HQ,		&idDxtDecoder::DecompressImageDXT5,			16,	CFM_NORMAL_DXT5,	{ 3, 1, -1, -1 },	true },
+	{ "normal BC5",		&idDxtEncoder::CompressNormalMapDXN2Fast,	&idDxtDecoder::DecompressNormalMapDXN2,		16,	CFM_DEFAULT,		{ 0, 1, -1, -1 },	false },
+	{ "normal BC5 HQ",	&idDxtEncoder::CompressNormalMapDXN2HQ,		&idDxtDecoder::DecompressNormalMapDXN2,		16,	CFM_DEFAULT,		{ 0, 1, -1, -1 },	true },
+};
+static const int numImageCompressionTests = sizeof( imageCompressionTests ) / sizeof( imageCompressionTests[0] );
+
+/*
+========================
+R_TestImageCompression_f
+
+Compresses an image with each of the encoders on a single thread and prints the encode time
+and the peak signal to noise ratio of the decoded image. The color encoders are measured on
+the channels their format keeps and the normal map encoders on the X and Y stored in the red
+and green of the source, so only the normal rows are meaningful for a normal map and only the
+others for a color image. The slow high quality encoders only run when asked for.
+========================
+*/
+void R_TestImageCompression_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: testImageCompression <image> [hq]\n" );
+		return;
+	}
+	const bool testHighQuality = ( idStr::Icmp( args.Argv( 2 ), "hq" ) == 0 );
+
+	byte * pic = NULL;
+	int width = 0;
+	int height = 0;
+	R_LoadImageProgram( args.Argv( 1 ), &pic, &width, &height, NULL );
+	if ( pic == NULL ) {
+		common->Warning( "testImageCompression: couldn't load %s", args.Argv( 1 ) );
+		return;
+	}
+
+	// only compare whole blocks so the decoders can write straight into the result
+	const int blockWidth = width & ~3;
+	const int blockHeight = height & ~3;
+	if ( blockWidth == 0 || blockHeight == 0 ) {
+		common->Warning( "testImageCompression: %s is smaller than a block", args.Argv( 1 ) );
+		Mem_Free( pic );
+		return;
+	}
+	const int numPixels = blockWidth * blockHeight;
+
+	byte * source = (byte *)Mem_Alloc( numPixels * 4, TAG_TEMP );
+	for ( int y = 0; y < blockHeight; y++ ) {
+		memcpy( source + y * blockWidth * 4, pic + y * width * 4, blockWidth * 4 );
+	}
+	Mem_Free( pic );
+
+	byte * input = (byte *)Mem_Alloc( numPixels * 4, TAG_TEMP );
+	byte * compressed = (byte *)Mem_Alloc( numPixels, TAG_TEMP );
+	byte * decoded = (byte *)Mem_Alloc( numPixels * 4, TAG_TEMP );
+
+	common->Printf( "%s: %d x %d\n", args.Argv( 1 ), blockWidth, blockHeight );
+	common->Printf( "encoder         bpp     msec  MPix/s    PSNR\n" );
+
+	for ( int i = 0; i < numImageCompressionTests; i++ ) {
+		const imageCompressionTest_t & test = imageCompressionTests[i];
+		if ( test.highQuality && !testHighQuality ) {
+			continue;
+		}
+
+		memcpy( input, source, numPixels * 4 );
+		if ( test.colorFormat == CFM_YCOCG_DXT5 ) {
+			idColorSpace::ConvertRGBToCoCg_Y( input, input, blockWidth, blockHeight );
+		} else if ( test.colorFormat == CFM_NORMAL_DXT5 && !test.highQuality ) {
+			for ( int j = 0; j < numPixels; j++ ) {
+				input[j*4+3] = input[j*4+0];
+				input[j*4+0] = 0;
+				input[j*4+2] = 0;
+			}
+		}
+
+		idDxtEncoder encoder;
+		const uint64 start = Sys_Microseconds();
+		( encoder.*test.compress )( input, compressed, blockWidth, blockHeight );
+		const uint64 encodeMicroSec = Sys_Microseconds() - start;
+
+		idDxtDecoder decoder;
+		( decoder.*test.decompress )( compressed, decoded, blockWidth, blockHeight );
+		if ( test.colorFormat == CFM_YCOCG_DXT5 ) {
+			idColorSpace::ConvertCoCgSYToRGB( decoded, decoded, blockWidth, blockHeight );
+		}
+
+		double sqrError = 0.0;
+		int numSamples = 0;
+		for ( int j = 0; j < numPixels; j++ ) {
+			for ( int c = 0; c < 4; c++ ) {
+				if ( test.channels[c] >= 0 ) {
+					const int d = decoded[j*4+test.channels[c]] - source[j*4+c];
+					sqrError += d * d;
+					numSamples++;
+				}
+			}
+		}
+		const double meanSqrError = sqrError / numSamples;
+		const double psnr = ( meanSqrError > 0.0 ) ? 10.0 * log10( 255.0 * 255.0 / meanSqrError ) : 99.99;
+
+		common->Printf( "%-15s %3d %8.1f %7.1f %7.2f\n", test.name, test.bytesPerBlock / 2, encodeMicroSec / 1000.0f,
+			( encodeMicroSec > 0 ) ? numPixels / (float)encodeMicroSec : 0.0f, psnr );
+	}
+
+	Mem_Free( source );
+	Mem_Free( input );
+	Mem_Free( compressed );
+	Mem_Free( decoded );
+}
@@ -48,7 +48,12 @@ public:
 	void				Load2DFromMemory( int width, int height, const byte * pic_const, int numLevels, textureFormat_t & textureFormat, textureColor_t & colorFormat, bool gammaMips );
 	void				LoadCubeFromMemory( int width, const byte * pics[6], int numLevels, textureFormat_t & textureFormat, bool gammaMips );
 
-	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime );
+	// with a non zero maxLevelSize, mip levels wider or taller than that are skipped,
+	// the smallest level is always loaded
+	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxLevelSize = 0 );
+	bool				LoadFromGeneratedFile( idFile * f, ID_TIME_T sourceFileTime, int maxLevelSize );
+	// reads just the file header, which is then available from GetFileHeader()
+	bool				LoadHeaderFromGeneratedFile( idFile * f );
 	ID_TIME_T			WriteGeneratedFile( ID_TIME_T sourceFileTime );
 
 	const bimageFile_t &	GetFileHeader() { return fileData; }
@@ -94,7 +99,6 @@ private:
 
 private:
 	void				MakeGeneratedFileName( idStr & gfn );
-	bool				LoadFromGeneratedFile( idFile * f, ID_TIME_T sourceFileTime );
 };
 
 #endif // __BINARYIMAGE_H__
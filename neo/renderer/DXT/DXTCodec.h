@@ -28,6 +28,12 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __DXTCODEC_H__
 #define __DXTCODEC_H__
 
+// AVX2 intrinsics are not available before Visual Studio 2012, the AVX2 paths
+// are selected at run-time when the SIMD processor reports CPUID_AVX2
+#if defined( _MSC_VER ) && _MSC_VER >= 1700
+#define ID_DXT_AVX2
+#endif
+
 /*
 ================================================================================================
 Contains the DxtEncoder and DxtDecoder declarations.
@@ -47,7 +53,8 @@ The supported formats are:
 	* DXT5 = DXT1 + alpha values in 4x4 block approximated by equidistant points on line through alpha space
 	* CTX1 = colors in a 4x4 block approximated by equidistant points on a line through 2D space
 	* DXN1 = one DXT5 alpha block (aka DXT5A, or ATI1N)
-	* DXN2 = two DXT5 alpha blocks (aka 3Dc, or ATI2N)
+	* DXN2 = two DXT5 alpha blocks (aka 3Dc, ATI2N, or BC5)
+	* BC7  = RGBA colors in 4x4 block approximated by points on a line through 4D space (single subset mode 6 only)
 ================================================
 */
 class idDxtEncoder {
@@ -65,6 +72,7 @@ public:
 	void	CompressImageDXT1Fast( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressImageDXT1Fast_Generic( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressImageDXT1Fast_SSE2( const byte *inBuf, byte *outBuf, int width, int height );
+	void	CompressImageDXT1Fast_AVX2( const byte *inBuf, byte *outBuf, int width, int height );
 
 	// high quality DXT1 compression (with alpha), uses exhaustive search to find a line through color space and is very slow
 	void	CompressImageDXT1AlphaHQ( const byte *inBuf, byte *outBuf, int width, int height ) { /* not implemented */ assert( 0 ); }
@@ -82,6 +90,7 @@ public:
 	void	CompressImageDXT5Fast( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressImageDXT5Fast_Generic( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressImageDXT5Fast_SSE2( const byte *inBuf, byte *outBuf, int width, int height );
+	void	CompressImageDXT5Fast_AVX2( const byte *inBuf, byte *outBuf, int width, int height );
 
 	// high quality CTX1 compression, uses exhaustive search to find a line through 2D space and is very slow
 	void	CompressImageCTX1HQ( const byte *inBuf, byte *outBuf, int width, int height );
@@ -136,14 +145,20 @@ public:
 	void	CompressNormalMapDXT5Fast_Generic( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressNormalMapDXT5Fast_SSE2( const byte *inBuf, byte *outBuf, int width, int height );
 
-	// high quality tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N) format
+	// high quality tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N, BC5) format
 	void	CompressNormalMapDXN2HQ( const byte *inBuf, byte *outBuf, int width, int height );
 	
-	// fast tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N) format, for real-time use
+	// fast tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N, BC5) format, for real-time use
 	void	CompressNormalMapDXN2Fast( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressNormalMapDXN2Fast_Generic( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressNormalMapDXN2Fast_SSE2( const byte *inBuf, byte *outBuf, int width, int height ) { /* not implemented */ assert( 0 ); }
 
+	// mode 6 only BC7 compression, principal axis end points refined by least squares and a local search, slow
+	void	CompressImageBC7HQ( const byte *inBuf, byte *outBuf, int width, int height );
+
+	// fast mode 6 only BC7 compression, principal axis end points with a single least squares refinement
+	void	CompressImageBC7Fast( const byte *inBuf, byte *outBuf, int width, int height );
+
 	// fast single channel conversion from DXN1 (aka DXT5A or ATI1N) to DXT1, reasonably fast (also works in-place)
 	void	ConvertImageDXN1_DXT1( const byte *inBuf, byte *outBuf, int width, int height );
 	
@@ -250,6 +265,9 @@ private:
 
 	void				DecodeNormalYValues( const byte *inBuf, byte &min, byte &max, byte *values );
 	void				EncodeNormalRGBIndices( byte *outBuf, const byte min, const byte max, const byte *values );
+
+	void				CompressImageBC7Mode6( const byte *inBuf, byte *outBuf, int width, int height, bool highQuality );
+	int					EmitBC7Mode6Block( const byte *colorBlock, bool highQuality );
 };
 
 /*
@@ -258,6 +276,12 @@ idDxtEncoder::CompressImageDXT1Fast
 ========================
 */
 ID_INLINE void idDxtEncoder::CompressImageDXT1Fast( const byte *inBuf, byte *outBuf, int width, int height ) {
+#ifdef ID_DXT_AVX2
+	if ( SIMDProcessor->cpuid & CPUID_AVX2 ) {
+		CompressImageDXT1Fast_AVX2( inBuf, outBuf, width, height );
+		return;
+	}
+#endif
 #ifdef ID_WIN_X86_SSE2_INTRIN
 	CompressImageDXT1Fast_SSE2( inBuf, outBuf, width, height );
 #else
@@ -284,6 +308,12 @@ idDxtEncoder::CompressImageDXT5Fast
 ========================
 */
 ID_INLINE void idDxtEncoder::CompressImageDXT5Fast( const byte *inBuf, byte *outBuf, int width, int height ) {
+#ifdef ID_DXT_AVX2
+	if ( SIMDProcessor->cpuid & CPUID_AVX2 ) {
+		CompressImageDXT5Fast_AVX2( inBuf, outBuf, width, height );
+		return;
+	}
+#endif
 #ifdef ID_WIN_X86_SSE2_INTRIN
 	CompressImageDXT5Fast_SSE2( inBuf, outBuf, width, height );
 #else
@@ -495,9 +525,13 @@ public:
 	void	DecompressNormalMapDXT5( const byte *inBuf, byte *outBuf, int width, int height );
 	void	DecompressNormalMapDXT5Renormalize( const byte *inBuf, byte *outBuf, int width, int height );
 
-	// tangent space normal map decompression from DXN2 format
+	// tangent space normal map decompression from DXN2 (BC5) format
 	void	DecompressNormalMapDXN2( const byte *inBuf, byte *outBuf, int width, int height );
 
+	// BC7 decompression, only the single subset mode 6 written by idDxtEncoder is supported,
+	// blocks in any other mode are decoded as opaque magenta
+	void	DecompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height );
+
 	// decompose a DXT image into indices and two images with colors
 	void	DecomposeImageDXT1( const byte *inBuf, byte *colorIndices, byte *pic1, byte *pic2, int width, int height );
 	void	DecomposeImageDXT5( const byte *inBuf, byte *colorIndices, byte *alphaIndices, byte *pic1, byte *pic2, int width, int height );
@@ -521,6 +555,7 @@ private:
 	void				DecodeAlphaValues( byte *colorBlock, const int offset );
 	void				DecodeColorValues( byte *colorBlock, bool noBlack, bool writeAlpha );
 	void				DecodeCTX1Values( byte *colorBlock );
+	void				DecodeBC7Values( byte *colorBlock );
 
 	void				DecomposeColorBlock( byte colors[2][4], byte colorIndices[16], bool noBlack );
 	void				DecomposeAlphaBlock( byte colors[2][4], byte alphaIndices[16] );
@@ -621,4 +656,40 @@ ID_INLINE byte idDxtDecoder::NormalScaleFrom565( unsigned short c565 ) const {
 	return ( c | ( c >> 5 ) );
 }
 
+/*
+================================================
+idDxtJobEncoder compresses a batch of images on the job system. Every 4x4 block row
+of a DXT image is encoded independently, so each queued image is split into bands
+of block rows and every band is compressed by its own idDxtEncoder in a separate
+job. The output is identical to compressing the images one at a time.
+
+Source and destination padding are not supported, the images are assumed to be
+tightly packed.
+================================================
+*/
+typedef void ( idDxtEncoder::*dxtCompressFunc_t )( const byte *inBuf, byte *outBuf, int width, int height );
+
+class idDxtJobEncoder {
+public:
+	// queues an image for compression, the buffers have to stay valid until Finish() returns.
+	// bytesPerBlock is 8 for DXT1, CTX1 and DXN1 and 16 for the other formats.
+	void	AddImage( dxtCompressFunc_t compress, int bytesPerBlock, const byte *inBuf, byte *outBuf, int width, int height );
+
+	// compresses all queued images, when useJobs is false everything is done on the calling thread
+	void	Finish( bool useJobs = true );
+
+	int		NumBands() const { return bands.Num(); }
+
+	struct dxtBand_t {
+		dxtCompressFunc_t	compress;
+		const byte *		inBuf;
+		byte *				outBuf;
+		int					width;
+		int					height;
+	};
+
+private:
+	idList< dxtBand_t, TAG_IMAGE >	bands;
+};
+
 #endif // !__DXTCODEC_H__
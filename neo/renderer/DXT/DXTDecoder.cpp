@@ -169,6 +169,64 @@ void idDxtDecoder::DecodeCTX1Values( byte *colorBlock ) {
 	}
 }
 
+/*
+========================
+BC7ReadBits
+========================
+*/
+static unsigned int BC7ReadBits( const byte *block, int &bitOffset, const int numBits ) {
+	unsigned int value = 0;
+	for ( int i = 0; i < numBits; i++, bitOffset++ ) {
+		value |= ( ( block[bitOffset >> 3] >> ( bitOffset & 7 ) ) & 1 ) << i;
+	}
+	return value;
+}
+
+/*
+========================
+idDxtDecoder::DecodeBC7Values
+========================
+*/
+void idDxtDecoder::DecodeBC7Values( byte *colorBlock ) {
+	static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	byte block[16];
+	byte endPoints[2][4];
+
+	for ( int i = 0; i < 16; i++ ) {
+		block[i] = ReadByte();
+	}
+
+	// the mode is the number of zero bits before the first set bit
+	if ( ( block[0] & 0x7F ) != ( 1 << 6 ) ) {
+		for ( int i = 0; i < 16; i++ ) {
+			colorBlock[i*4+0] = 255;
+			colorBlock[i*4+1] = 0;
+			colorBlock[i*4+2] = 255;
+			colorBlock[i*4+3] = 255;
+		}
+		return;
+	}
+
+	int bitOffset = 7;
+	for ( int c = 0; c < 4; c++ ) {
+		endPoints[0][c] = (byte)( BC7ReadBits( block, bitOffset, 7 ) << 1 );
+		endPoints[1][c] = (byte)( BC7ReadBits( block, bitOffset, 7 ) << 1 );
+	}
+	const byte pBit0 = (byte)BC7ReadBits( block, bitOffset, 1 );
+	const byte pBit1 = (byte)BC7ReadBits( block, bitOffset, 1 );
+	for ( int c = 0; c < 4; c++ ) {
+		endPoints[0][c] |= pBit0;
+		endPoints[1][c] |= pBit1;
+	}
+
+	for ( int i = 0; i < 16; i++ ) {
+		const int w = weights[BC7ReadBits( block, bitOffset, ( i == 0 ) ? 3 : 4 )];
+		for ( int c = 0; c < 4; c++ ) {
+			colorBlock[i*4+c] = (byte)( ( ( 64 - w ) * endPoints[0][c] + w * endPoints[1][c] + 32 ) >> 6 );
+		}
+	}
+}
+
 /*
 ========================
 idDxtDecoder::DecompressImageDXT1
@@ -231,6 +289,26 @@ void idDxtDecoder::DecompressImageDXT5_nVidia7x( const byte *inBuf, byte *outBuf
 	}
 }
 
+/*
+========================
+idDxtDecoder::DecompressImageBC7
+========================
+*/
+void idDxtDecoder::DecompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height ) {
+	byte block[64];
+
+	this->width = width;
+	this->height = height;
+	this->inData = inBuf;
+
+	for ( int j = 0; j < height; j += 4 ) {
+		for ( int i = 0; i < width; i += 4 ) {
+			DecodeBC7Values( block );
+			EmitBlock( outBuf, i, j, block );
+		}
+	}
+}
+
 /*
 ========================
 idDxtDecoder::DecompressYCoCgDXT5
@@ -4746,3 +4746,449 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte *inBuf, byte *outBuf, int w
 		inBuf += srcPadding;
 	}
 }
+
+/*
+================================================================================================
+
+	BC7
+
+	Only the single subset mode 6 is written: 7-bit RGBA end points with a unique p-bit each
+	and 4-bit indices. It never loses the alpha channel and beats DXT5 on smooth blocks, but
+	blocks with more than one distinct color line need the partitioned modes and come out
+	worse than from a full BC7 encoder. The HQ variant only refines the mode 6 end points
+	further, it does not search other modes.
+
+================================================================================================
+*/
+
+static const int BC7_MODE6_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/*
+========================
+BC7PrincipalAxisEndPoints
+
+Fits a line through the RGBA colors of the block and returns the extremes of the projected colors.
+========================
+*/
+static void BC7PrincipalAxisEndPoints( const byte *colorBlock, float *endPoint0, float *endPoint1 ) {
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for ( int i = 0; i < 16; i++ ) {
+		for ( int c = 0; c < 4; c++ ) {
+			mean[c] += colorBlock[i*4+c];
+		}
+	}
+	for ( int c = 0; c < 4; c++ ) {
+		mean[c] *= ( 1.0f / 16.0f );
+	}
+
+	float covariance[4][4];
+	memset( covariance, 0, sizeof( covariance ) );
+	for ( int i = 0; i < 16; i++ ) {
+		float d[4];
+		for ( int c = 0; c < 4; c++ ) {
+			d[c] = colorBlock[i*4+c] - mean[c];
+		}
+		for ( int r = 0; r < 4; r++ ) {
+			for ( int c = 0; c < 4; c++ ) {
+				covariance[r][c] += d[r] * d[c];
+			}
+		}
+	}
+
+	// power iteration, seeded with the covariance row of the channel with the largest variance
+	int seed = 0;
+	for ( int c = 1; c < 4; c++ ) {
+		if ( covariance[c][c] > covariance[seed][seed] ) {
+			seed = c;
+		}
+	}
+	float axis[4];
+	for ( int c = 0; c < 4; c++ ) {
+		axis[c] = covariance[seed][c];
+	}
+	for ( int iteration = 0; iteration < 8; iteration++ ) {
+		float next[4];
+		float largest = 0.0f;
+		for ( int r = 0; r < 4; r++ ) {
+			next[r] = covariance[r][0] * axis[0] + covariance[r][1] * axis[1] + covariance[r][2] * axis[2] + covariance[r][3] * axis[3];
+			largest = Max( largest, idMath::Fabs( next[r] ) );
+		}
+		if ( largest < idMath::FLT_EPSILON ) {
+			break;
+		}
+		for ( int c = 0; c < 4; c++ ) {
+			axis[c] = next[c] / largest;
+		}
+	}
+
+	const float lengthSqr = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+	if ( lengthSqr < idMath::FLT_EPSILON ) {
+		// a single color
+		for ( int c = 0; c < 4; c++ ) {
+			endPoint0[c] = endPoint1[c] = mean[c];
+		}
+		return;
+	}
+	const float invLength = idMath::InvSqrt( lengthSqr );
+	for ( int c = 0; c < 4; c++ ) {
+		axis[c] *= invLength;
+	}
+
+	float minT = idMath::INFINITY;
+	float maxT = -idMath::INFINITY;
+	for ( int i = 0; i < 16; i++ ) {
+		float t = 0.0f;
+		for ( int c = 0; c < 4; c++ ) {
+			t += ( colorBlock[i*4+c] - mean[c] ) * axis[c];
+		}
+		minT = Min( minT, t );
+		maxT = Max( maxT, t );
+	}
+	for ( int c = 0; c < 4; c++ ) {
+		endPoint0[c] = idMath::ClampFloat( 0.0f, 255.0f, mean[c] + minT * axis[c] );
+		endPoint1[c] = idMath::ClampFloat( 0.0f, 255.0f, mean[c] + maxT * axis[c] );
+	}
+}
+
+/*
+========================
+BC7LeastSquaresEndPoints
+
+Solves for the end points that minimize the squared error with the given indices.
+Returns false if all colors use the same weight and the system is singular.
+========================
+*/
+static bool BC7LeastSquaresEndPoints( const byte *colorBlock, const byte *indices, float *endPoint0, float *endPoint1 ) {
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for ( int i = 0; i < 16; i++ ) {
+		const float b = BC7_MODE6_WEIGHTS[indices[i]] * ( 1.0f / 64.0f );
+		const float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for ( int c = 0; c < 4; c++ ) {
+			ax[c] += a * colorBlock[i*4+c];
+			bx[c] += b * colorBlock[i*4+c];
+		}
+	}
+
+	const float det = aa * bb - ab * ab;
+	if ( idMath::Fabs( det ) < 1e-4f ) {
+		return false;
+	}
+	const float invDet = 1.0f / det;
+	for ( int c = 0; c < 4; c++ ) {
+		endPoint0[c] = idMath::ClampFloat( 0.0f, 255.0f, ( bb * ax[c] - ab * bx[c] ) * invDet );
+		endPoint1[c] = idMath::ClampFloat( 0.0f, 255.0f, ( aa * bx[c] - ab * ax[c] ) * invDet );
+	}
+	return true;
+}
+
+/*
+========================
+BC7QuantizeMode6EndPoint
+
+Mode 6 end points are 7 bits per channel, the p-bit is the shared low bit of all four channels.
+========================
+*/
+static void BC7QuantizeMode6EndPoint( const float *endPoint, const int pBit, byte *quantized ) {
+	for ( int c = 0; c < 4; c++ ) {
+		const int q = idMath::ClampInt( 0, 127, idMath::Ftoi( ( endPoint[c] - pBit ) * 0.5f + 0.5f ) );
+		quantized[c] = (byte)( ( q << 1 ) | pBit );
+	}
+}
+
+/*
+========================
+BC7FindMode6Indices
+
+Returns the squared error or a value larger than lastError as soon as the error exceeds lastError.
+========================
+*/
+static int BC7FindMode6Indices( const byte *colorBlock, const byte *endPoint0, const byte *endPoint1, byte *indices, int lastError ) {
+	int palette[16][4];
+	for ( int i = 0; i < 16; i++ ) {
+		const int w = BC7_MODE6_WEIGHTS[i];
+		for ( int c = 0; c < 4; c++ ) {
+			palette[i][c] = ( ( 64 - w ) * endPoint0[c] + w * endPoint1[c] + 32 ) >> 6;
+		}
+	}
+
+	int error = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		const byte * color = colorBlock + i * 4;
+		int bestError = INT_MAX;
+		int bestIndex = 0;
+		for ( int j = 0; j < 16; j++ ) {
+			const int dr = color[0] - palette[j][0];
+			const int dg = color[1] - palette[j][1];
+			const int db = color[2] - palette[j][2];
+			const int da = color[3] - palette[j][3];
+			const int e = dr * dr + dg * dg + db * db + da * da;
+			if ( e < bestError ) {
+				bestError = e;
+				bestIndex = j;
+			}
+		}
+		indices[i] = (byte)bestIndex;
+		error += bestError;
+		if ( error > lastError ) {
+			return error;
+		}
+	}
+	return error;
+}
+
+/*
+========================
+BC7WriteBits
+========================
+*/
+static void BC7WriteBits( byte *block, int &bitOffset, const unsigned int value, const int numBits ) {
+	for ( int i = 0; i < numBits; i++, bitOffset++ ) {
+		if ( value & ( 1 << i ) ) {
+			block[bitOffset >> 3] |= (byte)( 1 << ( bitOffset & 7 ) );
+		}
+	}
+}
+
+/*
+========================
+idDxtEncoder::EmitBC7Mode6Block
+
+params:	colorBlock	- 4*4 RGBA block
+params:	highQuality	- refine the end points until they converge and search around them
+return:	squared error of the emitted block
+========================
+*/
+int idDxtEncoder::EmitBC7Mode6Block( const byte *colorBlock, bool highQuality ) {
+	float endPoint0[4];
+	float endPoint1[4];
+	byte quantized[2][4];
+	byte indices[16];
+	byte bestEndPoints[2][4];
+	byte bestIndices[16];
+	int bestError = INT_MAX;
+
+	BC7PrincipalAxisEndPoints( colorBlock, endPoint0, endPoint1 );
+
+	const int refinements = highQuality ? 4 : 1;
+	for ( int iteration = 0; iteration <= refinements; iteration++ ) {
+		const int lastError = bestError;
+
+		// the p-bits can't be derived from the unquantized end points, so try all four combinations
+		for ( int p = 0; p < 4; p++ ) {
+			BC7QuantizeMode6EndPoint( endPoint0, p & 1, quantized[0] );
+			BC7QuantizeMode6EndPoint( endPoint1, p >> 1, quantized[1] );
+			const int error = BC7FindMode6Indices( colorBlock, quantized[0], quantized[1], indices, bestError );
+			if ( error < bestError ) {
+				bestError = error;
+				memcpy( bestEndPoints, quantized, sizeof( bestEndPoints ) );
+				memcpy( bestIndices, indices, sizeof( bestIndices ) );
+			}
+		}
+
+		if ( bestError == 0 || bestError == lastError ) {
+			break;
+		}
+		if ( !BC7LeastSquaresEndPoints( colorBlock, bestIndices, endPoint0, endPoint1 ) ) {
+			break;
+		}
+	}
+
+	if ( highQuality ) {
+		// nudge each quantized channel up and down one step, keeping the p-bits
+		bool improved = true;
+		for ( int pass = 0; pass < 2 && improved && bestError > 0; pass++ ) {
+			improved = false;
+			for ( int e = 0; e < 2; e++ ) {
+				for ( int c = 0; c < 4; c++ ) {
+					for ( int step = -2; step <= 2; step += 4 ) {
+						const int value = bestEndPoints[e][c] + step;
+						if ( value < 0 || value > 255 ) {
+							continue;
+						}
+						memcpy( quantized, bestEndPoints, sizeof( quantized ) );
+						quantized[e][c] = (byte)value;
+						const int error = BC7FindMode6Indices( colorBlock, quantized[0], quantized[1], indices, bestError );
+						if ( error < bestError ) {
+							bestError = error;
+							memcpy( bestEndPoints, quantized, sizeof( bestEndPoints ) );
+							memcpy( bestIndices, indices, sizeof( bestIndices ) );
+							improved = true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// the high bit of the index of the first texel is implied to be zero, swap the end points if it is set
+	if ( bestIndices[0] & 8 ) {
+		for ( int c = 0; c < 4; c++ ) {
+			SwapValues( bestEndPoints[0][c], bestEndPoints[1][c] );
+		}
+		for ( int i = 0; i < 16; i++ ) {
+			bestIndices[i] = 15 - bestIndices[i];
+		}
+	}
+
+	byte block[16];
+	memset( block, 0, sizeof( block ) );
+	int bitOffset = 0;
+	BC7WriteBits( block, bitOffset, 1 << 6, 7 );
+	for ( int c = 0; c < 4; c++ ) {
+		BC7WriteBits( block, bitOffset, bestEndPoints[0][c] >> 1, 7 );
+		BC7WriteBits( block, bitOffset, bestEndPoints[1][c] >> 1, 7 );
+	}
+	BC7WriteBits( block, bitOffset, bestEndPoints[0][0] & 1, 1 );
+	BC7WriteBits( block, bitOffset, bestEndPoints[1][0] & 1, 1 );
+	BC7WriteBits( block, bitOffset, bestIndices[0], 3 );
+	for ( int i = 1; i < 16; i++ ) {
+		BC7WriteBits( block, bitOffset, bestIndices[i], 4 );
+	}
+	assert( bitOffset == 128 );
+
+	for ( int i = 0; i < 16; i++ ) {
+		EmitByte( block[i] );
+	}
+	return bestError;
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Mode6
+========================
+*/
+void idDxtEncoder::CompressImageBC7Mode6( const byte *inBuf, byte *outBuf, int width, int height, bool highQuality ) {
+	ALIGN16( byte block[64] );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	// unlike the DXT encoders this accepts any size, blocks that stick out past the right or
+	// bottom edge repeat the last column and row so every output block gets written
+	for ( int j = 0; j < height; j += 4, inBuf += width * 4*4 ) {
+		for ( int i = 0; i < width; i += 4 ) {
+
+			if ( i + 4 > width || j + 4 > height ) {
+				for ( int y = 0; y < 4; y++ ) {
+					for ( int x = 0; x < 4; x++ ) {
+						const int sx = Min( i + x, width - 1 );
+						const int sy = Min( y, height - j - 1 );
+						memcpy( block + ( y * 4 + x ) * 4, inBuf + ( sy * width + sx ) * 4, 4 );
+					}
+				}
+			} else {
+				ExtractBlock( inBuf + i * 4, width, block );
+			}
+
+			EmitBC7Mode6Block( block, highQuality );
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7HQ
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7HQ( const byte *inBuf, byte *outBuf, int width, int height ) {
+	CompressImageBC7Mode6( inBuf, outBuf, width, height, true );
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Fast
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7Fast( const byte *inBuf, byte *outBuf, int width, int height ) {
+	CompressImageBC7Mode6( inBuf, outBuf, width, height, false );
+}
+
+/*
+================================================================================================
+
+	idDxtJobEncoder
+
+================================================================================================
+*/
+
+static const int DXT_BLOCKS_PER_JOB = 1024;		// roughly 100,000 clock cycles with the fast encoders
+
+/*
+========================
+DxtCompressBand
+========================
+*/
+static void DxtCompressBand( idDxtJobEncoder::dxtBand_t * band ) {
+	idDxtEncoder encoder;
+	( encoder.*band->compress )( band->inBuf, band->outBuf, band->width, band->height );
+}
+
+REGISTER_PARALLEL_JOB( DxtCompressBand, "DxtCompressBand" );
+
+/*
+========================
+idDxtJobEncoder::AddImage
+========================
+*/
+void idDxtJobEncoder::AddImage( dxtCompressFunc_t compress, int bytesPerBlock, const byte *inBuf, byte *outBuf, int width, int height ) {
+	const int blocksWide = width >> 2;
+	const int blockRows = height >> 2;
+
+	// images that are not made of whole blocks go through the encoders' own special cases in one piece
+	int rowsPerBand = blockRows;
+	if ( width >= 4 && height >= 4 && ( width & 3 ) == 0 && ( height & 3 ) == 0 ) {
+		rowsPerBand = Max( 1, DXT_BLOCKS_PER_JOB / blocksWide );
+	}
+
+	for ( int row = 0; row < blockRows || row == 0; row += rowsPerBand ) {
+		dxtBand_t & band = bands.Alloc();
+		band.compress = compress;
+		band.inBuf = inBuf + row * 4 * width * 4;
+		band.outBuf = outBuf + row * blocksWide * bytesPerBlock;
+		band.width = width;
+		band.height = ( blockRows > rowsPerBand ) ? Min( rowsPerBand, blockRows - row ) * 4 : height;
+	}
+}
+
+/*
+========================
+idDxtJobEncoder::Finish
+========================
+*/
+void idDxtJobEncoder::Finish( bool useJobs ) {
+	if ( !useJobs || bands.Num() <= 1 ) {
+		for ( int i = 0; i < bands.Num(); i++ ) {
+			DxtCompressBand( &bands[i] );
+		}
+	} else {
+		idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, bands.Num(), 0, NULL );
+		for ( int i = 0; i < bands.Num(); i++ ) {
+			jobList->AddJob( (jobRun_t)DxtCompressBand, &bands[i] );
+		}
+		jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+	}
+	bands.Clear();
+}
@@ -0,0 +1,374 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+/*
+================================================================================================
+Contains the DxtEncoder implementation for AVX2.
+
+Two horizontally adjacent 4x4 blocks are encoded at once, one in each 128-bit lane. A single
+32 byte load from a row of the image holds a row of both blocks, so each lane goes through
+exactly the same steps as the generic encoder and the output is bit-identical to it.
+================================================================================================
+*/
+
+#pragma hdrstop
+#include "DXTCodec_local.h"
+#include "DXTCodec.h"
+
+#ifdef ID_DXT_AVX2
+
+#include <immintrin.h>
+
+#define INSET_COLOR_SHIFT		4		// inset the bounding box with ( range >> shift )
+#define INSET_ALPHA_SHIFT		5		// inset alpha channel
+
+#define C565_5_MASK				0xF8	// 0xFF minus last three bits
+#define C565_6_MASK				0xFC	// 0xFF minus last two bits
+
+#if !defined( R_SHUFFLE_D )
+#define R_SHUFFLE_D( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
+#endif
+
+/*
+========================
+LoadBlockRows_AVX2
+
+Loads the four rows of a pair of blocks. Without a second block the first one is
+repeated in the high lane so nothing is read past the end of the row.
+========================
+*/
+static ID_INLINE void LoadBlockRows_AVX2( const byte * inPtr, int width, bool pair, __m256i rows[4] ) {
+	for ( int r = 0; r < 4; r++ ) {
+		const byte * rowPtr = inPtr + r * width * 4;
+		if ( pair ) {
+			rows[r] = _mm256_loadu_si256( (const __m256i *)rowPtr );
+		} else {
+			rows[r] = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)rowPtr ) );
+		}
+	}
+}
+
+/*
+========================
+GetMinMaxBBoxInset_AVX2
+
+Takes the extents of the bounding box of the colors in both blocks and insets them.
+The results are returned as 16-bit RGBA words, repeated twice in each lane.
+========================
+*/
+static ID_INLINE void GetMinMaxBBoxInset_AVX2( const __m256i rows[4], __m256i & min16, __m256i & max16 ) {
+	__m256i min = _mm256_min_epu8( _mm256_min_epu8( rows[0], rows[1] ), _mm256_min_epu8( rows[2], rows[3] ) );
+	__m256i max = _mm256_max_epu8( _mm256_max_epu8( rows[0], rows[1] ), _mm256_max_epu8( rows[2], rows[3] ) );
+
+	min = _mm256_min_epu8( min, _mm256_shuffle_epi32( min, R_SHUFFLE_D( 2, 3, 2, 3 ) ) );
+	max = _mm256_max_epu8( max, _mm256_shuffle_epi32( max, R_SHUFFLE_D( 2, 3, 2, 3 ) ) );
+	min = _mm256_min_epu8( min, _mm256_shuffle_epi32( min, R_SHUFFLE_D( 1, 1, 1, 1 ) ) );
+	max = _mm256_max_epu8( max, _mm256_shuffle_epi32( max, R_SHUFFLE_D( 1, 1, 1, 1 ) ) );
+	min = _mm256_shuffle_epi32( min, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	max = _mm256_shuffle_epi32( max, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	const __m256i zero = _mm256_setzero_si256();
+	min16 = _mm256_unpacklo_epi8( min, zero );
+	max16 = _mm256_unpacklo_epi8( max, zero );
+
+	// ( max - min ) >> shift, the multiply high shifts each channel by its own amount
+	const __m256i insetShift = _mm256_setr_epi16(	1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ),
+													1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ),
+													1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ),
+													1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ) );
+	const __m256i inset = _mm256_mulhi_epu16( _mm256_sub_epi16( max16, min16 ), insetShift );
+
+	min16 = _mm256_add_epi16( min16, inset );
+	max16 = _mm256_sub_epi16( max16, inset );
+}
+
+/*
+========================
+PackColor_AVX2
+
+Returns the 16-bit RGBA words of each lane packed as a 4 byte color.
+========================
+*/
+static ID_INLINE void PackColor_AVX2( const __m256i & color16, int color[2] ) {
+	const __m256i color8 = _mm256_packus_epi16( color16, color16 );
+	color[0] = _mm_cvtsi128_si32( _mm256_castsi256_si128( color8 ) );
+	color[1] = _mm_cvtsi128_si32( _mm256_extracti128_si256( color8, 1 ) );
+}
+
+/*
+========================
+QuantizeColor_AVX2
+
+Expands the 16-bit RGBA words to the color a decoder reconstructs from 565 with alpha cleared.
+========================
+*/
+static ID_INLINE __m256i QuantizeColor_AVX2( const __m256i & color16 ) {
+	const __m256i mask = _mm256_setr_epi16(	C565_5_MASK, C565_6_MASK, C565_5_MASK, 0, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0,
+											C565_5_MASK, C565_6_MASK, C565_5_MASK, 0, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0 );
+	const __m256i shift = _mm256_setr_epi16(	1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0, 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0,
+												1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0, 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0 );
+	return _mm256_or_si256( _mm256_and_si256( color16, mask ), _mm256_mulhi_epu16( color16, shift ) );
+}
+
+/*
+========================
+ColorDistances_AVX2
+
+Sum of absolute RGB differences between each of the 8 pixels and a palette color.
+========================
+*/
+static ID_INLINE __m256i ColorDistances_AVX2( const __m256i & pixels, const __m256i & color ) {
+	const __m256i absDiff = _mm256_or_si256( _mm256_subs_epu8( pixels, color ), _mm256_subs_epu8( color, pixels ) );
+	const __m256i pairSums = _mm256_maddubs_epi16( absDiff, _mm256_set1_epi8( 1 ) );
+	return _mm256_madd_epi16( pairSums, _mm256_set1_epi16( 1 ) );
+}
+
+/*
+========================
+OrReduceLanes_AVX2
+
+Combines the four dwords of each lane, the result is in the first dword of the lane.
+========================
+*/
+static ID_INLINE void OrReduceLanes_AVX2( __m256i v, unsigned int result[2] ) {
+	v = _mm256_or_si256( v, _mm256_shuffle_epi32( v, R_SHUFFLE_D( 2, 3, 2, 3 ) ) );
+	v = _mm256_or_si256( v, _mm256_shuffle_epi32( v, R_SHUFFLE_D( 1, 1, 1, 1 ) ) );
+	result[0] = _mm_cvtsi128_si32( _mm256_castsi256_si128( v ) );
+	result[1] = _mm_cvtsi128_si32( _mm256_extracti128_si256( v, 1 ) );
+}
+
+/*
+========================
+FindColorIndices_AVX2
+
+Same selection as idDxtEncoder::EmitColorIndices, for both blocks.
+========================
+*/
+static ID_INLINE void FindColorIndices_AVX2( const __m256i rows[4], const __m256i & min16, const __m256i & max16, unsigned int result[2] ) {
+	const __m256i div3 = _mm256_set1_epi16( ( 1 << 16 ) / 3 + 1 );
+
+	const __m256i c0 = QuantizeColor_AVX2( max16 );
+	const __m256i c1 = QuantizeColor_AVX2( min16 );
+	const __m256i c2 = _mm256_mulhi_epu16( _mm256_add_epi16( _mm256_add_epi16( c0, c0 ), c1 ), div3 );
+	const __m256i c3 = _mm256_mulhi_epu16( _mm256_add_epi16( _mm256_add_epi16( c1, c1 ), c0 ), div3 );
+
+	const __m256i color0 = _mm256_packus_epi16( c0, c0 );
+	const __m256i color1 = _mm256_packus_epi16( c1, c1 );
+	const __m256i color2 = _mm256_packus_epi16( c2, c2 );
+	const __m256i color3 = _mm256_packus_epi16( c3, c3 );
+
+	const __m256i rgbMask = _mm256_set1_epi32( 0x00FFFFFF );
+	const __m256i one = _mm256_set1_epi32( 1 );
+	const __m256i two = _mm256_set1_epi32( 2 );
+
+	__m256i indices = _mm256_setzero_si256();
+	for ( int r = 0; r < 4; r++ ) {
+		const __m256i pixels = _mm256_and_si256( rows[r], rgbMask );
+
+		const __m256i d0 = ColorDistances_AVX2( pixels, color0 );
+		const __m256i d1 = ColorDistances_AVX2( pixels, color1 );
+		const __m256i d2 = ColorDistances_AVX2( pixels, color2 );
+		const __m256i d3 = ColorDistances_AVX2( pixels, color3 );
+
+		const __m256i b0 = _mm256_cmpgt_epi32( d0, d3 );
+		const __m256i b1 = _mm256_cmpgt_epi32( d1, d2 );
+		const __m256i b2 = _mm256_cmpgt_epi32( d0, d2 );
+		const __m256i b3 = _mm256_cmpgt_epi32( d1, d3 );
+		const __m256i b4 = _mm256_cmpgt_epi32( d2, d3 );
+
+		const __m256i x0 = _mm256_and_si256( b1, b2 );
+		const __m256i x1 = _mm256_and_si256( b0, b3 );
+		const __m256i x2 = _mm256_and_si256( b0, b4 );
+
+		const __m256i index = _mm256_or_si256( _mm256_and_si256( x2, one ), _mm256_and_si256( _mm256_or_si256( x0, x1 ), two ) );
+		const __m256i shift = _mm256_setr_epi32( r * 8 + 0, r * 8 + 2, r * 8 + 4, r * 8 + 6, r * 8 + 0, r * 8 + 2, r * 8 + 4, r * 8 + 6 );
+		indices = _mm256_or_si256( indices, _mm256_sllv_epi32( index, shift ) );
+	}
+
+	OrReduceLanes_AVX2( indices, result );
+}
+
+/*
+========================
+FindAlphaIndices_AVX2
+
+Same selection as idDxtEncoder::EmitAlphaIndices, for both blocks. Each block gets two
+24-bit values with the 3-bit indices of its first and last eight pixels.
+========================
+*/
+static ID_INLINE void FindAlphaIndices_AVX2( const __m256i rows[4], const int minColor[2], const int maxColor[2], unsigned int result[2][2] ) {
+	const int ALPHA_RANGE = 7;
+
+	int ab[2][7];
+	for ( int b = 0; b < 2; b++ ) {
+		const int minAlpha = ( minColor[b] >> 24 ) & 0xFF;
+		const int maxAlpha = ( maxColor[b] >> 24 ) & 0xFF;
+		for ( int k = 0; k < 7; k++ ) {
+			ab[b][k] = ( ( 13 - 2 * k ) * maxAlpha + ( 1 + 2 * k ) * minAlpha + ALPHA_RANGE ) / ( ALPHA_RANGE * 2 );
+		}
+	}
+
+	__m256i thresholds[7];
+	for ( int k = 0; k < 7; k++ ) {
+		thresholds[k] = _mm256_setr_epi32( ab[0][k], ab[0][k], ab[0][k], ab[0][k], ab[1][k], ab[1][k], ab[1][k], ab[1][k] );
+	}
+
+	const __m256i one = _mm256_set1_epi32( 1 );
+	const __m256i two = _mm256_set1_epi32( 2 );
+	const __m256i seven = _mm256_set1_epi32( 7 );
+
+	__m256i indices[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+	for ( int r = 0; r < 4; r++ ) {
+		const __m256i alpha = _mm256_srli_epi32( rows[r], 24 );
+
+		// every threshold above the alpha adds a -1
+		__m256i below = _mm256_setzero_si256();
+		for ( int k = 0; k < 7; k++ ) {
+			below = _mm256_add_epi32( below, _mm256_cmpgt_epi32( thresholds[k], alpha ) );
+		}
+
+		__m256i index = _mm256_and_si256( _mm256_sub_epi32( one, below ), seven );
+		index = _mm256_xor_si256( index, _mm256_and_si256( _mm256_cmpgt_epi32( two, index ), one ) );
+
+		const int s = ( r & 1 ) * 12;
+		const __m256i shift = _mm256_setr_epi32( s + 0, s + 3, s + 6, s + 9, s + 0, s + 3, s + 6, s + 9 );
+		indices[r >> 1] = _mm256_or_si256( indices[r >> 1], _mm256_sllv_epi32( index, shift ) );
+	}
+
+	unsigned int half[2];
+	OrReduceLanes_AVX2( indices[0], half );
+	result[0][0] = half[0];
+	result[1][0] = half[1];
+	OrReduceLanes_AVX2( indices[1], half );
+	result[0][1] = half[0];
+	result[1][1] = half[1];
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT1Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXT1Fast_AVX2( const byte *inBuf, byte *outBuf, int width, int height ) {
+	__m256i rows[4];
+	__m256i min16;
+	__m256i max16;
+	int minColor[2];
+	int maxColor[2];
+	unsigned int colorIndices[2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for ( int j = 0; j < height; j += 4, inBuf += width * 4*4 ) {
+		for ( int i = 0; i < width; i += 8 ) {
+			const int numBlocks = ( i + 4 < width ) ? 2 : 1;
+
+			LoadBlockRows_AVX2( inBuf + i * 4, width, numBlocks == 2, rows );
+			GetMinMaxBBoxInset_AVX2( rows, min16, max16 );
+			PackColor_AVX2( min16, minColor );
+			PackColor_AVX2( max16, maxColor );
+			FindColorIndices_AVX2( rows, min16, max16, colorIndices );
+
+			for ( int b = 0; b < numBlocks; b++ ) {
+				EmitUShort( ColorTo565( (const byte *)&maxColor[b] ) );
+				EmitUShort( ColorTo565( (const byte *)&minColor[b] ) );
+				EmitUInt( colorIndices[b] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT5Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageDXT5Fast_AVX2( const byte *inBuf, byte *outBuf, int width, int height ) {
+	__m256i rows[4];
+	__m256i min16;
+	__m256i max16;
+	int minColor[2];
+	int maxColor[2];
+	unsigned int colorIndices[2];
+	unsigned int alphaIndices[2][2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for ( int j = 0; j < height; j += 4, inBuf += width * 4*4 ) {
+		for ( int i = 0; i < width; i += 8 ) {
+			const int numBlocks = ( i + 4 < width ) ? 2 : 1;
+
+			LoadBlockRows_AVX2( inBuf + i * 4, width, numBlocks == 2, rows );
+			GetMinMaxBBoxInset_AVX2( rows, min16, max16 );
+			PackColor_AVX2( min16, minColor );
+			PackColor_AVX2( max16, maxColor );
+			FindAlphaIndices_AVX2( rows, minColor, maxColor, alphaIndices );
+			FindColorIndices_AVX2( rows, min16, max16, colorIndices );
+
+			for ( int b = 0; b < numBlocks; b++ ) {
+				EmitByte( (byte)( maxColor[b] >> 24 ) );
+				EmitByte( (byte)( minColor[b] >> 24 ) );
+
+				for ( int h = 0; h < 2; h++ ) {
+					EmitByte( (byte)( alphaIndices[b][h] >>  0 ) );
+					EmitByte( (byte)( alphaIndices[b][h] >>  8 ) );
+					EmitByte( (byte)( alphaIndices[b][h] >> 16 ) );
+				}
+
+				EmitUShort( ColorTo565( (const byte *)&maxColor[b] ) );
+				EmitUShort( ColorTo565( (const byte *)&minColor[b] ) );
+				EmitUInt( colorIndices[b] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+#endif // ID_DXT_AVX2
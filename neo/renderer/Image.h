@@ -98,6 +98,9 @@ public:
 	// estimates size of the GL image based on dimensions and storage type
 	int			StorageSize() const;
 
+	// estimated size of the mip chain starting at the given level
+	int			StorageSizeForLevel( int level ) const;
+
 	// print a one line summary of the image
 	void		Print() const;
 
@@ -146,13 +149,23 @@ public:
 	// done under any normal circumstances, and probably not at all on consoles.
 	void		Resize( int width, int height );
 
-	bool		IsCompressed() const { return ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 ); }
+	bool		IsCompressed() const { return ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 || opts.format == FMT_BC5 || opts.format == FMT_BC7 ); }
 
 	void		SetTexParameters();	// update aniso and trilinear
 
 	bool		IsLoaded() const { return texnum != TEXTURE_NOT_LOADED; }
 
+	// streamed images only keep their small mip levels resident until the
+	// front end sees them large enough on screen to need more
+	bool		IsStreamed() const { return streamBaseLevel > 0; }
+	int			GetResidentLevel() const { return residentLevel; }
+
+	// called by the front end for every visible surface using the image, screenSize is in pixels
+	void		RequestStreaming( int frameNum, int screenSize );
+
 	static void			GetGeneratedName( idStr &_name, const textureUsage_t &_usage, const cubeFiles_t &_cube );
+	// only mip mapped 2D interaction textures are streamed
+	static bool			CanStream( textureFilter_t _filter, textureUsage_t _usage, cubeFiles_t _cube );
 
 private:
 	friend class idImageManager;
@@ -160,6 +173,9 @@ private:
 	void				AllocImage();
 	void				DeriveOpts();
 
+	int					StreamingLevelWanted( int frameNum ) const;
+	void				UploadStreamedLevels( idBinaryImage & im );
+
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			cubeFiles;				// If this is a cube map, and if so, what kind
@@ -179,6 +195,15 @@ private:
 
 	int					refCount;				// overall ref count
 
+	// texture streaming
+	idStr				streamName;				// generated file name the streamed levels are read from
+	int					residentLevel;			// first mip level in the texture object, 0 unless streamed
+	int					streamBaseLevel;		// level that is loaded up front and always kept, 0 if not streamed
+	int					streamPendingLevel;		// level the outstanding stream request loads, -1 if none
+	int					streamGeneration;		// incremented on every load so stale stream requests are dropped
+	int					streamRequestFrame;		// last frame a visible surface used the image
+	int					streamRequestSize;		// largest screen size in pixels during streamRequestFrame
+
 	static const GLuint TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 
 	GLuint				texnum;				// gl texture binding
@@ -208,6 +233,21 @@ ID_INLINE idImage::idImage( const char * name ) : imgName( name ) {
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+	residentLevel = 0;
+	streamBaseLevel = 0;
+	streamPendingLevel = -1;
+	streamGeneration = 0;
+	streamRequestFrame = -1;
+	streamRequestSize = 0;
+}
+
+ID_INLINE void idImage::RequestStreaming( int frameNum, int screenSize ) {
+	if ( streamRequestFrame != frameNum ) {
+		streamRequestFrame = frameNum;
+		streamRequestSize = screenSize;
+	} else if ( screenSize > streamRequestSize ) {
+		streamRequestSize = screenSize;
+	}
 }
 
 
@@ -217,6 +257,54 @@ void	R_WriteTGA( const char *filename, const byte *data, int width, int height,
 
 
 
+/*
+================================================
+idImageStreamer reads the mip levels of streamed images on a background thread.
+
+The main thread opens the file and queues the request, the streaming thread reads
+and validates the levels, and the main thread picks up the completed request to
+upload it and close the file. Only the main thread touches the image itself.
+================================================
+*/
+struct imageStreamRequest_t {
+	idImage *			image;
+	int					generation;		// image->streamGeneration when the request was made
+	int					level;			// first mip level to load
+	int					maxLevelSize;	// size of that level, larger levels are skipped
+	ID_TIME_T			sourceFileTime;
+	idFile *			file;
+	idBinaryImage *		binaryImage;	// NULL when the load failed
+};
+
+struct imageStreamCandidate_t {
+	idImage *			image;
+	int					level;			// level the image wants to have resident
+	int					sortKey;
+};
+
+class idImageStreamer : public idSysThread {
+public:
+	static const int	MAX_REQUESTS = 256;
+
+						idImageStreamer() : numPending( 0 ) {}
+
+	void				Start();
+	void				Stop();
+
+	// main thread only
+	bool				AddRequest( const imageStreamRequest_t & request );
+	bool				GetCompleted( imageStreamRequest_t & request );
+	int					NumPending() const { return numPending; }
+
+protected:
+	virtual int			Run();
+
+private:
+	idLockFreeSPSCQueue< imageStreamRequest_t, MAX_REQUESTS >	requests;
+	idLockFreeSPSCQueue< imageStreamRequest_t, MAX_REQUESTS >	completed;
+	int					numPending;
+};
+
 class idImageManager {
 public:
 
@@ -224,6 +312,7 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		streamingSuspended = false;
 	}
 
 	void				Init();
@@ -281,6 +370,14 @@ public:
 
 	void				PrintMemInfo( MemInfo_t *mi );
 
+	// texture streaming
+	void				RequestStreaming( const idMaterial * material, int screenSize );
+	// called once per frame after the swap, finishes completed loads and issues new ones
+	void				UpdateStreaming();
+	// waits for all outstanding stream requests and issues no new ones until EndLevelLoad
+	void				SuspendStreaming();
+	int					StreamedBytes() const;
+
 	// built-in images
 	void CreateIntrinsicImages();
 	idImage *			defaultImage;
@@ -312,10 +409,23 @@ public:
 
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
+
+private:
+	void				FinishStreamRequest( imageStreamRequest_t & request );
+	bool				IssueStreamRequest( idImage * image, int level );
+
+	idImageStreamer		streamer;
+	bool				streamingSuspended;
+	idList< imageStreamCandidate_t, TAG_IDLIB_LIST_IMAGE >	streamPromote;
+	idList< imageStreamCandidate_t, TAG_IDLIB_LIST_IMAGE >	streamDemote;
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
 
+void R_TestImageStreaming_f( const idCmdArgs &args );
+void R_GenerateImages_f( const idCmdArgs &args );
+void R_TestImageCompression_f( const idCmdArgs &args );
+
 int MakePowerOfTwo( int num );
 
 /*
@@ -675,6 +675,11 @@ void idImageManager::Init() {
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "testImageStreaming", R_TestImageStreaming_f, CMD_FL_RENDERER, "compares loading complete mip chains against streamed resident levels for a map's image manifest, usage: testImageStreaming <mapName> [baseSize]" );
+	cmdSystem->AddCommand( "generateImages", R_GenerateImages_f, CMD_FL_RENDERER, "rebuilds the generated images below a directory and reports the encoding throughput, usage: generateImages <directory> [serial]" );
+	cmdSystem->AddCommand( "testImageCompression", R_TestImageCompression_f, CMD_FL_RENDERER, "reports the encode time and PSNR of each texture compressor for an image, usage: testImageCompression <image> [hq]" );
+
+	streamer.Start();
 
 	// should forceLoadImages be here?
 }
@@ -685,6 +690,9 @@ Shutdown
 ===============
 */
 void idImageManager::Shutdown() {
+	SuspendStreaming();
+	streamer.Stop();
+
 	images.DeleteContents( true );
 	imageHash.Clear();
 
@@ -699,6 +707,8 @@ Frees all images used by the previous level
 void idImageManager::BeginLevelLoad() {
 	insideLevelLoad = true;
 
+	SuspendStreaming();
+
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
 
@@ -800,6 +810,7 @@ idImageManager::EndLevelLoad
 */
 void idImageManager::EndLevelLoad() {
 	insideLevelLoad = false;
+	streamingSuspended = false;
 
 	common->Printf( "----- idImageManager::EndLevelLoad -----\n" );
 	int start = Sys_Milliseconds();
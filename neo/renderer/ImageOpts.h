@@ -87,6 +87,14 @@ enum textureFormat_t {
 	FMT_X16,			// 16 bpp
 	FMT_Y16_X16,		// 32 bpp
 	FMT_RGB565,			// 16 bpp
+
+	//------------------------
+	// Compressed texture formats that need GL_ARB_texture_compression_rgtc / bptc,
+	// after the others so the values stored in generated images don't change
+	//------------------------
+
+	FMT_BC5,			// 8 bpp, two DXT5 alpha blocks
+	FMT_BC7,			// 8 bpp
 };
 
 int BitsForFormat( textureFormat_t format );
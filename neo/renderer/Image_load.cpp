@@ -31,6 +31,12 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+extern idCVar image_streaming;
+extern idCVar image_streamingBaseSize;
+
+idCVar image_useBC5Normals( "image_useBC5Normals", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "compress normal maps to BC5 instead of DXT5 when the hardware supports it, takes effect when images are loaded" );
+idCVar image_useBC7( "image_useBC7", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "compress plain color images to BC7 instead of DXT5 when the hardware supports it, takes effect when images are loaded" );
+
 /*
 ================
 BitsForFormat
@@ -51,6 +57,8 @@ int BitsForFormat( textureFormat_t format ) {
 		case FMT_DEPTH:		return 32;
 		case FMT_X16:		return 16;
 		case FMT_Y16_X16:	return 32;
+		case FMT_BC5:		return 8;
+		case FMT_BC7:		return 8;
 		default:
 			assert( 0 );
 			return 0;
@@ -88,12 +96,22 @@ ID_INLINE void idImage::DeriveOpts() {
 				break;
 			case TD_DEFAULT:
 				opts.gammaMips = true;
-				opts.format = FMT_DXT5;
+				if ( image_useBC7.GetBool() && glConfig.bptcTextureCompressionAvailable ) {
+					opts.format = FMT_BC7;
+				} else {
+					opts.format = FMT_DXT5;
+				}
 				opts.colorFormat = CFM_DEFAULT;
 				break;
 			case TD_BUMP:
-				opts.format = FMT_DXT5;
-				opts.colorFormat = CFM_NORMAL_DXT5;
+				if ( image_useBC5Normals.GetBool() && glConfig.rgtcTextureCompressionAvailable ) {
+					// X in red and Y in green, swizzled to the DXT5 layout when the texture is created
+					opts.format = FMT_BC5;
+					opts.colorFormat = CFM_DEFAULT;
+				} else {
+					opts.format = FMT_DXT5;
+					opts.colorFormat = CFM_NORMAL_DXT5;
+				}
 				break;
 			case TD_FONT:
 				opts.format = FMT_DXT1;
@@ -132,7 +150,7 @@ ID_INLINE void idImage::DeriveOpts() {
 			while ( temp_width > 1 || temp_height > 1 ) {
 				temp_width >>= 1;
 				temp_height >>= 1;
-				if ( ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 ) &&
+				if ( IsCompressed() &&
 					( ( temp_width & 0x3 ) != 0 || ( temp_height & 0x3 ) != 0 ) ) {
 						break;
 				}
@@ -276,6 +294,13 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		return;
 	}
 
+	// drop any stream request still in flight for the previous load
+	streamGeneration++;
+	streamPendingLevel = -1;
+	streamBaseLevel = 0;
+	residentLevel = 0;
+	streamName.Clear();
+
 	if ( com_productionMode.GetInteger() != 0 ) {
 		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 		if ( cubeFiles != CF_2D ) {
@@ -299,8 +324,12 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 	idStrStatic< MAX_OSPATH > generatedName = GetName();
 	GetGeneratedName( generatedName, usage, cubeFiles );
 
+	// world textures only load their small mip levels here, the rest is streamed in once they are seen up close
+	const bool streamed = image_streaming.GetBool() && CanStream( filter, usage, cubeFiles );
+	const int maxLevelSize = streamed ? Max( image_streamingBaseSize.GetInteger(), 1 ) : 0;
+
 	idBinaryImage im( generatedName );
-	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 
 	// BFHACK, do not want to tweak on buildgame so catch these images here
 	if ( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP && fileSystem->UsingResourceFiles() ) {
@@ -309,31 +338,31 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 			if ( generatedName.Find( "guis/assets/white#__0000", false ) >= 0 ) {
 				generatedName.Replace( "white#__0000", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 				break;
 			}
 			if ( generatedName.Find( "guis/assets/white#__0100", false ) >= 0 ) {
 				generatedName.Replace( "white#__0100", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 				break;
 			}
 			if ( generatedName.Find( "textures/black#__0100", false ) >= 0 ) {
 				generatedName.Replace( "black#__0100", "black#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 				break;
 			}
 			if ( generatedName.Find( "textures/decals/bulletglass1_d#__0100", false ) >= 0 ) {
 				generatedName.Replace( "bulletglass1_d#__0100", "bulletglass1_d#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 				break;
 			}
 			if ( generatedName.Find( "models/monsters/skeleton/skeleton01_d#__1000", false ) >= 0 ) {
 				generatedName.Replace( "skeleton01_d#__1000", "skeleton01_d#__0100" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, maxLevelSize );
 				break;
 			}
 		}
@@ -351,6 +380,10 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		opts.colorFormat = (textureColor_t)header.colorFormat;
 		opts.format = (textureFormat_t)header.format;
 		opts.textureType = (textureType_t)header.textureType;
+		if ( streamed && im.NumImages() > 0 && im.GetImageHeader( 0 ).level > 0 ) {
+			streamName = im.GetName();
+			streamBaseLevel = im.GetImageHeader( 0 ).level;
+		}
 		if ( cvarSystem->GetCVarBool( "fs_buildresources" ) ) {
 			// for resource gathering write this image to the preload file for this map
 			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
@@ -416,6 +449,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
 	}
 
+	residentLevel = streamBaseLevel;
 	AllocImage();
 
 
@@ -570,8 +604,17 @@ int idImage::StorageSize() const {
 	if ( !IsLoaded() ) {
 		return 0;
 	}
-	int baseSize = opts.width * opts.height;
-	if ( opts.numLevels > 1 ) {
+	return StorageSizeForLevel( residentLevel );
+}
+
+/*
+==================
+StorageSizeForLevel
+==================
+*/
+int idImage::StorageSizeForLevel( int level ) const {
+	int baseSize = Max( opts.width >> level, 1 ) * Max( opts.height >> level, 1 );
+	if ( opts.numLevels - level > 1 ) {
 		baseSize *= 4;
 		baseSize /= 3;
 	}
@@ -621,6 +664,8 @@ void idImage::Print() const {
 		NAME_FORMAT( DEPTH );
 		NAME_FORMAT( X16 );
 		NAME_FORMAT( Y16_X16 );
+		NAME_FORMAT( BC5 );
+		NAME_FORMAT( BC7 );
 		default:
 			common->Printf( "<%3i>", opts.format );
 			break;
@@ -0,0 +1,494 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+
+#include "tr_local.h"
+
+/*
+================================================================================================
+
+	Texture streaming
+
+Streamed images load only their mip levels up to image_streamingBaseSize when the level
+loads. The front end records how large each streamed image appears on screen, and once a
+frame the image manager queues loads for the levels that are needed and evicts the levels
+of the least recently seen images while the streamed textures are over their budget.
+
+Evicting levels reallocates the texture and reads the remaining smaller levels from disk
+again, since they can not be copied out of the old texture without GL 4.3. Streaming is
+off by default until the hitches of promotion and eviction have been measured on the
+shipped maps, testImageStreaming only reports the load sizes.
+
+================================================================================================
+*/
+
+idCVar image_streaming( "image_streaming", "0", CVAR_RENDERER | CVAR_BOOL, "only load the small mip levels of world textures up front and stream in the rest when needed, takes effect when images are loaded" );
+idCVar image_streamingBaseSize( "image_streamingBaseSize", "64", CVAR_RENDERER | CVAR_INTEGER, "largest mip level size of streamed images that is loaded up front and always kept", 1, 4096 );
+idCVar image_streamingBudget( "image_streamingBudget", "256", CVAR_RENDERER | CVAR_INTEGER, "texture memory budget in megabytes for streamed images" );
+idCVar image_streamingLodBias( "image_streamingLodBias", "0", CVAR_RENDERER | CVAR_INTEGER, "positive values stream in smaller mip levels than the screen size asks for" );
+idCVar image_streamingKeepFrames( "image_streamingKeepFrames", "60", CVAR_RENDERER | CVAR_INTEGER, "number of frames a streamed image keeps the levels it was last seen with" );
+idCVar image_streamingMaxRequests( "image_streamingMaxRequests", "16", CVAR_RENDERER | CVAR_INTEGER, "maximum number of stream requests issued per frame", 1, idImageStreamer::MAX_REQUESTS );
+idCVar image_showStreaming( "image_showStreaming", "0", CVAR_RENDERER | CVAR_BOOL, "print texture streaming requests and evictions" );
+
+/*
+========================
+idImageStreamer::Start
+========================
+*/
+void idImageStreamer::Start() {
+	StartWorkerThread( "ImageStreamer", CORE_ANY, THREAD_BELOW_NORMAL );
+}
+
+/*
+========================
+idImageStreamer::Stop
+========================
+*/
+void idImageStreamer::Stop() {
+	StopThread();
+}
+
+/*
+========================
+idImageStreamer::AddRequest
+========================
+*/
+bool idImageStreamer::AddRequest( const imageStreamRequest_t & request ) {
+	if ( !requests.Push( request ) ) {
+		return false;
+	}
+	numPending++;
+	SignalWork();
+	return true;
+}
+
+/*
+========================
+idImageStreamer::GetCompleted
+========================
+*/
+bool idImageStreamer::GetCompleted( imageStreamRequest_t & request ) {
+	if ( !completed.Pop( request ) ) {
+		return false;
+	}
+	numPending--;
+	return true;
+}
+
+/*
+========================
+idImageStreamer::Run
+========================
+*/
+int idImageStreamer::Run() {
+	imageStreamRequest_t request;
+	while ( requests.Pop( request ) ) {
+		if ( !request.binaryImage->LoadFromGeneratedFile( request.file, request.sourceFileTime, request.maxLevelSize ) || request.binaryImage->NumImages() == 0 ) {
+			delete request.binaryImage;
+			request.binaryImage = NULL;
+		}
+		// never fails, there can't be more completed requests than queued ones
+		verify( completed.Push( request ) );
+	}
+	return 0;
+}
+
+/*
+========================
+idImage::CanStream
+========================
+*/
+bool idImage::CanStream( textureFilter_t _filter, textureUsage_t _usage, cubeFiles_t _cube ) {
+	if ( _cube != CF_2D || _filter != TF_DEFAULT ) {
+		return false;
+	}
+	return ( _usage == TD_DIFFUSE || _usage == TD_SPECULAR || _usage == TD_BUMP );
+}
+
+/*
+========================
+idImage::StreamingLevelWanted
+
+The smallest level that still has at least as many texels across as the image
+covers pixels on screen.
+========================
+*/
+int idImage::StreamingLevelWanted( int frameNum ) const {
+	if ( streamRequestFrame < 0 || frameNum - streamRequestFrame > image_streamingKeepFrames.GetInteger() ) {
+		return streamBaseLevel;
+	}
+	const int size = Max( opts.width, opts.height );
+	const int screenSize = Max( streamRequestSize, 1 );
+	int level = 0;
+	while ( level < streamBaseLevel && ( size >> ( level + 1 ) ) >= screenSize ) {
+		level++;
+	}
+	return idMath::ClampInt( 0, streamBaseLevel, level + image_streamingLodBias.GetInteger() );
+}
+
+/*
+========================
+idImage::UploadStreamedLevels
+========================
+*/
+void idImage::UploadStreamedLevels( idBinaryImage & im ) {
+	residentLevel = im.GetImageHeader( 0 ).level;
+
+	AllocImage();
+
+	for ( int i = 0; i < im.NumImages(); i++ ) {
+		const bimageImage_t & img = im.GetImageHeader( i );
+		const byte * data = im.GetImageData( i );
+		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+	}
+}
+
+/*
+========================
+idImageManager::RequestStreaming
+========================
+*/
+void idImageManager::RequestStreaming( const idMaterial * material, int screenSize ) {
+	for ( int i = 0; i < material->GetNumStages(); i++ ) {
+		idImage * image = material->GetStage( i )->texture.image;
+		if ( image != NULL && image->IsStreamed() ) {
+			image->RequestStreaming( tr.frameCount, screenSize );
+		}
+	}
+}
+
+/*
+========================
+idImageManager::IssueStreamRequest
+========================
+*/
+bool idImageManager::IssueStreamRequest( idImage * image, int level ) {
+	idStr fileName;
+	idBinaryImage::GetGeneratedFileName( fileName, image->streamName );
+
+	// the file is opened here because the file system isn't safe to use from other threads,
+	// only reading from the opened file is
+	idFile * file = fileSystem->OpenFileRead( fileName );
+	if ( file == NULL ) {
+		idLib::Warning( "Couldn't open %s for streaming", fileName.c_str() );
+		image->streamBaseLevel = 0;
+		return false;
+	}
+
+	imageStreamRequest_t request;
+	request.image = image;
+	request.generation = image->streamGeneration;
+	request.level = level;
+	request.maxLevelSize = Max( 1, Max( image->opts.width, image->opts.height ) >> level );
+	request.sourceFileTime = image->sourceFileTime;
+	request.file = file;
+	request.binaryImage = new (TAG_IMAGE) idBinaryImage( image->streamName );
+
+	if ( !streamer.AddRequest( request ) ) {
+		delete request.binaryImage;
+		fileSystem->CloseFile( file );
+		return false;
+	}
+
+	if ( image_showStreaming.GetBool() ) {
+		common->Printf( "stream %s level %i -> %i (%ik -> %ik)\n", image->GetName(), image->residentLevel, level,
+						image->StorageSizeForLevel( image->residentLevel ) >> 10, image->StorageSizeForLevel( level ) >> 10 );
+	}
+
+	image->streamPendingLevel = level;
+	return true;
+}
+
+/*
+========================
+idImageManager::FinishStreamRequest
+========================
+*/
+void idImageManager::FinishStreamRequest( imageStreamRequest_t & request ) {
+	fileSystem->CloseFile( request.file );
+
+	idImage * image = request.image;
+
+	// the image may have been purged or reloaded since the request was made
+	if ( request.generation == image->streamGeneration && image->IsLoaded() ) {
+		image->streamPendingLevel = -1;
+
+		if ( request.binaryImage == NULL ) {
+			idLib::Warning( "Couldn't stream %s, keeping the resident levels", image->GetName() );
+			image->streamBaseLevel = 0;
+		} else {
+			const bimageFile_t & header = request.binaryImage->GetFileHeader();
+			if ( header.width != image->opts.width || header.height != image->opts.height || header.numLevels != image->opts.numLevels || header.format != image->opts.format ) {
+				idLib::Warning( "%s changed on disk, keeping the resident levels", image->GetName() );
+				image->streamBaseLevel = 0;
+			} else {
+				image->UploadStreamedLevels( *request.binaryImage );
+			}
+		}
+	}
+
+	delete request.binaryImage;
+}
+
+/*
+========================
+idImageManager::StreamedBytes
+========================
+*/
+int idImageManager::StreamedBytes() const {
+	int bytes = 0;
+	for ( int i = 0; i < images.Num(); i++ ) {
+		if ( images[i]->IsStreamed() ) {
+			bytes += images[i]->StorageSize();
+		}
+	}
+	return bytes;
+}
+
+/*
+========================
+idSort_StreamCandidates
+========================
+*/
+class idSort_StreamCandidates : public idSort_Quick< imageStreamCandidate_t, idSort_StreamCandidates > {
+public:
+	int Compare( const imageStreamCandidate_t & a, const imageStreamCandidate_t & b ) const {
+		return a.sortKey - b.sortKey;
+	}
+};
+
+/*
+========================
+idImageManager::UpdateStreaming
+========================
+*/
+void idImageManager::UpdateStreaming() {
+	imageStreamRequest_t request;
+	while ( streamer.GetCompleted( request ) ) {
+		FinishStreamRequest( request );
+	}
+
+	if ( streamingSuspended || insideLevelLoad ) {
+		return;
+	}
+
+	const int frameNum = tr.frameCount;
+	const int budget = Max( image_streamingBudget.GetInteger(), 0 ) * 1024 * 1024;
+
+	// the budget is checked against the size every image will have once the outstanding requests finish
+	int projectedBytes = 0;
+	streamPromote.SetNum( 0 );
+	streamDemote.SetNum( 0 );
+	for ( int i = 0; i < images.Num(); i++ ) {
+		idImage * image = images[i];
+		if ( !image->IsStreamed() || !image->IsLoaded() ) {
+			continue;
+		}
+		if ( image->streamPendingLevel >= 0 ) {
+			projectedBytes += image->StorageSizeForLevel( image->streamPendingLevel );
+			continue;
+		}
+		projectedBytes += image->StorageSize();
+
+		const int wanted = image->StreamingLevelWanted( frameNum );
+		if ( wanted < image->residentLevel ) {
+			// largest on screen first
+			imageStreamCandidate_t & candidate = streamPromote.Alloc();
+			candidate.image = image;
+			candidate.level = wanted;
+			candidate.sortKey = -image->streamRequestSize;
+		} else if ( wanted > image->residentLevel ) {
+			// least recently seen first
+			imageStreamCandidate_t & candidate = streamDemote.Alloc();
+			candidate.image = image;
+			candidate.level = wanted;
+			candidate.sortKey = image->streamRequestFrame;
+		}
+	}
+
+	streamPromote.SortWithTemplate( idSort_StreamCandidates() );
+	streamDemote.SortWithTemplate( idSort_StreamCandidates() );
+
+	int numRequests = Min( image_streamingMaxRequests.GetInteger(), idImageStreamer::MAX_REQUESTS - streamer.NumPending() );
+	int numDemoted = 0;
+
+	for ( int i = 0; i < streamPromote.Num() && numRequests > 0; i++ ) {
+		idImage * image = streamPromote[i].image;
+		const int level = streamPromote[i].level;
+		const int growth = image->StorageSizeForLevel( level ) - image->StorageSize();
+
+		// evict the least recently seen levels until the new ones fit
+		while ( projectedBytes + growth > budget && numDemoted < streamDemote.Num() && numRequests > 1 ) {
+			const imageStreamCandidate_t & evict = streamDemote[numDemoted++];
+			const int shrink = evict.image->StorageSize() - evict.image->StorageSizeForLevel( evict.level );
+			if ( IssueStreamRequest( evict.image, evict.level ) ) {
+				projectedBytes -= shrink;
+				numRequests--;
+			}
+		}
+		if ( projectedBytes + growth > budget ) {
+			break;
+		}
+		if ( IssueStreamRequest( image, level ) ) {
+			projectedBytes += growth;
+			numRequests--;
+		}
+	}
+
+	// the budget may have been lowered
+	while ( projectedBytes > budget && numDemoted < streamDemote.Num() && numRequests > 0 ) {
+		const imageStreamCandidate_t & evict = streamDemote[numDemoted++];
+		const int shrink = evict.image->StorageSize() - evict.image->StorageSizeForLevel( evict.level );
+		if ( IssueStreamRequest( evict.image, evict.level ) ) {
+			projectedBytes -= shrink;
+			numRequests--;
+		}
+	}
+}
+
+/*
+========================
+idImageManager::SuspendStreaming
+========================
+*/
+void idImageManager::SuspendStreaming() {
+	streamingSuspended = true;
+
+	// the requests hold open files, which must be closed before the resource containers change
+	while ( streamer.NumPending() > 0 ) {
+		streamer.WaitForThread();
+		imageStreamRequest_t request;
+		while ( streamer.GetCompleted( request ) ) {
+			FinishStreamRequest( request );
+		}
+	}
+}
+
+/*
+========================
+R_TestImageStreaming_f
+
+Loads every image in the preload manifest of a map once completely and once with
+only the levels streaming keeps resident, without uploading anything.
+
+testImageStreaming <mapName> [baseSize]
+========================
+*/
+void R_TestImageStreaming_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: testImageStreaming <mapName> [baseSize]\n" );
+		return;
+	}
+
+	idStrStatic< MAX_OSPATH > manifestName = args.Argv( 1 );
+	manifestName.StripFileExtension();
+	if ( idStr::Icmpn( manifestName, "maps/", 5 ) != 0 ) {
+		manifestName = va( "maps/%s", manifestName.c_str() );
+	}
+	manifestName += ".preload";
+
+	idPreloadManifest manifest;
+	if ( !manifest.LoadManifest( manifestName ) ) {
+		common->Printf( "couldn't load %s\n", manifestName.c_str() );
+		return;
+	}
+
+	const int baseSize = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : image_streamingBaseSize.GetInteger();
+
+	int numImages = 0;
+	int numStreamable = 0;
+	int numMissing = 0;
+	int64 fullBytes = 0;
+	int64 streamedBytes = 0;
+	uint64 fullMicroseconds = 0;
+	uint64 streamedMicroseconds = 0;
+
+	for ( int i = 0; i < manifest.NumResources(); i++ ) {
+		const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
+		if ( p.resType != PRELOAD_IMAGE || globalImages->ExcludePreloadImage( p.resourceName ) ) {
+			continue;
+		}
+
+		// same name mangling as idImageManager::ImageFromFile and idImage::ActuallyLoadImage
+		idStrStatic< MAX_OSPATH > name = p.resourceName;
+		name.Replace( ".tga", "" );
+		name.BackSlashesToSlashes();
+		const textureFilter_t filter = (textureFilter_t)p.imgData.filter;
+		const cubeFiles_t cube = (cubeFiles_t)p.imgData.cubeMap;
+		textureUsage_t usage = (textureUsage_t)p.imgData.usage;
+		if ( idStr::Icmpn( name, "fonts", 5 ) == 0 || idStr::Icmpn( name, "newfonts", 8 ) == 0 ) {
+			usage = TD_FONT;
+		}
+		if ( idStr::Icmpn( name, "lights", 6 ) == 0 ) {
+			usage = TD_LIGHT;
+		}
+
+		ID_TIME_T sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
+		if ( com_productionMode.GetInteger() == 0 ) {
+			if ( cube != CF_2D ) {
+				R_LoadCubeImages( name, cube, NULL, NULL, &sourceFileTime );
+			} else {
+				R_LoadImageProgram( name, NULL, NULL, NULL, &sourceFileTime );
+			}
+		}
+
+		idStrStatic< MAX_OSPATH > generatedName = name;
+		idImage::GetGeneratedName( generatedName, usage, cube );
+
+		numImages++;
+
+		uint64 start = Sys_Microseconds();
+		idBinaryImage full( generatedName );
+		if ( full.LoadFromGeneratedFile( sourceFileTime ) == FILE_NOT_FOUND_TIMESTAMP ) {
+			numMissing++;
+			continue;
+		}
+		fullMicroseconds += Sys_Microseconds() - start;
+		for ( int j = 0; j < full.NumImages(); j++ ) {
+			fullBytes += full.GetImageHeader( j ).dataSize;
+		}
+
+		const bool streamable = idImage::CanStream( filter, usage, cube );
+		start = Sys_Microseconds();
+		idBinaryImage streamed( generatedName );
+		streamed.LoadFromGeneratedFile( sourceFileTime, streamable ? baseSize : 0 );
+		streamedMicroseconds += Sys_Microseconds() - start;
+		for ( int j = 0; j < streamed.NumImages(); j++ ) {
+			streamedBytes += streamed.GetImageHeader( j ).dataSize;
+		}
+		if ( streamable && streamed.NumImages() > 0 && streamed.GetImageHeader( 0 ).level > 0 ) {
+			numStreamable++;
+		}
+	}
+
+	common->Printf( "%s: %i images, %i streamed with base size %i, %i without a generated file\n", manifestName.c_str(), numImages, numStreamable, baseSize, numMissing );
+	common->Printf( "complete mip chains: %6.1f MB in %6i msec\n", fullBytes / ( 1024.0 * 1024.0 ), (int)( fullMicroseconds / 1000 ) );
+	common->Printf( "resident levels:     %6.1f MB in %6i msec\n", streamedBytes / ( 1024.0 * 1024.0 ), (int)( streamedMicroseconds / 1000 ) );
+}
@@ -507,14 +507,11 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 		edef->lastInteraction = interaction;
 	}
 
-	// update the interaction table
-	if ( renderWorld->interactionTable != NULL ) {
-		int index = ldef->index * renderWorld->interactionTableWidth + edef->index;
-		if ( renderWorld->interactionTable[index] != NULL ) {
-			common->Error( "idInteraction::AllocAndLink: non NULL table entry" );
-		}
-		renderWorld->interactionTable[ index ] = interaction;
+	// update the interaction index
+	if ( ldef->interactionIndex.Get( edef->index ) ) {
+		common->Error( "idInteraction::AllocAndLink: non NULL index entry" );
 	}
+	ldef->interactionIndex.Set( edef->index, interaction );
 
 	return interaction;
 }
@@ -585,13 +582,13 @@ Removes links and puts it back on the free list.
 ===============
 */
 void idInteraction::UnlinkAndFree() {
-	// clear the table pointer
+	// clear the index pointer
 	idRenderWorldLocal *renderWorld = this->lightDef->world;
-	int index = this->lightDef->index * renderWorld->interactionTableWidth + this->entityDef->index;
-	if ( renderWorld->interactionTable[index] != this && renderWorld->interactionTable[index] != INTERACTION_EMPTY ) {
-		common->Error( "idInteraction::UnlinkAndFree: interactionTable wasn't set" );
+	const idInteraction * inter = this->lightDef->FindInteraction( this->entityDef->index );
+	if ( inter != this && inter != INTERACTION_EMPTY ) {
+		common->Error( "idInteraction::UnlinkAndFree: interactionIndex wasn't set" );
 	}
-	renderWorld->interactionTable[index] = NULL;
+	this->lightDef->interactionIndex.Remove( this->entityDef->index );
 
 	Unlink();
 
@@ -606,10 +603,10 @@ void idInteraction::UnlinkAndFree() {
 idInteraction::MakeEmpty
 
 Relinks the interaction at the end of both the light and entity chains
-and adds the INTERACTION_EMPTY marker to the interactionTable.
+and adds the INTERACTION_EMPTY marker to the light's interactionIndex.
 
 It is necessary to keep the empty interaction so when entities or lights move
-they can set all the interactionTable values to NULL. 
+they can remove all the interactionIndex entries. 
 ===============
 */
 void idInteraction::MakeEmpty() {
@@ -638,10 +635,9 @@ void idInteraction::MakeEmpty() {
 		this->lightDef->firstInteraction = this;
 	}
 
-	// store the special marker in the interaction table
-	const int interactionIndex = lightDef->index * entityDef->world->interactionTableWidth + entityDef->index;
-	assert( entityDef->world->interactionTable[ interactionIndex ] == this );
-	entityDef->world->interactionTable[ interactionIndex ] = INTERACTION_EMPTY;
+	// store the special marker in the interaction index
+	assert( lightDef->FindInteraction( entityDef->index ) == this );
+	lightDef->interactionIndex.Set( entityDef->index, INTERACTION_EMPTY );
 }
 
 /*
@@ -844,3 +840,189 @@ void R_ShowInteractionMemory_f( const idCmdArgs &args ) {
 	common->Printf( "%i maxInteractionsForEntity\n", maxInteractionsForEntity );
 	common->Printf( "%i maxInteractionsForLight\n", maxInteractionsForLight );
 }
+
+struct interactionIndexStats_t {
+	int			numLights;
+	int			numEntities;
+	int			numInteractions;
+	int64		sparseBytes;
+	int64		denseBytes;
+	int			numLookups;
+	int			numFound;
+	uint64		lookupMicroseconds;
+};
+
+/*
+===================
+R_MeasureInteractionIndex
+
+Measures the sparse interaction index of the current world, with the same lookup
+pattern as R_AddSingleLight. Returns false if no world is loaded.
+===================
+*/
+static bool R_MeasureInteractionIndex( interactionIndexStats_t & stats ) {
+	const idRenderWorldLocal * world = tr.primaryWorld;
+	if ( world == NULL ) {
+		return false;
+	}
+
+	memset( &stats, 0, sizeof( stats ) );
+	stats.numEntities = world->entityDefs.Num();
+	for ( int i = 0; i < world->lightDefs.Num(); i++ ) {
+		const idRenderLightLocal * light = world->lightDefs[i];
+		if ( light == NULL ) {
+			continue;
+		}
+		stats.sparseBytes += light->interactionIndex.Allocated();
+		stats.numInteractions += light->interactionIndex.Num();
+		stats.numLights++;
+	}
+	stats.denseBytes = (int64)( world->entityDefs.Num() + 100 ) * ( world->lightDefs.Num() + 100 ) * sizeof( idInteraction * );
+
+	const uint64 start = Sys_Microseconds();
+	for ( int i = 0; i < world->lightDefs.Num(); i++ ) {
+		const idRenderLightLocal * light = world->lightDefs[i];
+		if ( light == NULL ) {
+			continue;
+		}
+		for ( const areaReference_t * lref = light->references; lref != NULL; lref = lref->ownerNext ) {
+			const portalArea_t * area = lref->area;
+			for ( const areaReference_t * eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext ) {
+				if ( light->FindInteraction( eref->entity->index ) != NULL ) {
+					stats.numFound++;
+				}
+				stats.numLookups++;
+			}
+		}
+	}
+	stats.lookupMicroseconds = Sys_Microseconds() - start;
+	return true;
+}
+
+/*
+===================
+R_TestInteractionIndex_f
+
+Compares the memory use and lookup time of the per-light sparse interaction index
+against the dense lightDefs * entityDefs table it replaced, both for the current
+world and for a synthetic light / entity set.
+
+testInteractionIndex [entities] [lights] [interactionsPerLight]
+===================
+*/
+void R_TestInteractionIndex_f( const idCmdArgs &args ) {
+	const int numEntities = ( args.Argc() > 1 ) ? idMath::ClampInt( 1, 1 << 20, atoi( args.Argv( 1 ) ) ) : 10000;
+	const int numLights = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 1 << 16, atoi( args.Argv( 2 ) ) ) : 2000;
+	const int interactionsPerLight = ( args.Argc() > 3 ) ? idMath::ClampInt( 1, numEntities, atoi( args.Argv( 3 ) ) ) : 64;
+
+	interactionIndexStats_t stats;
+	if ( R_MeasureInteractionIndex( stats ) ) {
+		common->Printf( "world: %i lights, %i entities, %i indexed interactions\n", stats.numLights, stats.numEntities, stats.numInteractions );
+		common->Printf( "world: sparse index %i kB, dense table would be %i kB\n", (int)( stats.sparseBytes >> 10 ), (int)( stats.denseBytes >> 10 ) );
+		common->Printf( "world: %i lookups, %i found, %i usec\n", stats.numLookups, stats.numFound, (int)stats.lookupMicroseconds );
+	}
+
+	// synthetic set, half of the lookups hit an interaction and half miss, as they do
+	// for the entities in a light's areas that it doesn't reach
+	common->Printf( "synthetic: %i entities x %i lights, %i interactions per light\n", numEntities, numLights, interactionsPerLight );
+
+	idRandom random( 0 );
+	idFlatHashMap< int, idInteraction * > * sparse = new (TAG_RENDER) idFlatHashMap< int, idInteraction * >[numLights];
+	const int lookupsPerLight = interactionsPerLight * 2;
+	idList< int > lookups;
+	lookups.SetNum( numLights * lookupsPerLight );
+	size_t sparseBytes = 0;
+	for ( int l = 0; l < numLights; l++ ) {
+		int * lightLookups = &lookups[l * lookupsPerLight];
+		for ( int i = 0; i < interactionsPerLight; i++ ) {
+			const int e = random.RandomInt( numEntities );
+			sparse[l].Set( e, (idInteraction *)( ( (intptr_t)l * numEntities + e ) * 2 + 2 ) );
+			lightLookups[i * 2 + 0] = e;
+			lightLookups[i * 2 + 1] = random.RandomInt( numEntities );
+		}
+		sparseBytes += sparse[l].Allocated();
+	}
+
+	int64 sparseSum = 0;
+	uint64 start = Sys_Microseconds();
+	for ( int l = 0; l < numLights; l++ ) {
+		const idFlatHashMap< int, idInteraction * > & index = sparse[l];
+		const int * lightLookups = &lookups[l * lookupsPerLight];
+		for ( int i = 0; i < lookupsPerLight; i++ ) {
+			idInteraction * const * inter = NULL;
+			if ( index.Get( lightLookups[i], &inter ) ) {
+				sparseSum += (intptr_t)*inter;
+			}
+		}
+	}
+	const uint64 sparseMicroseconds = Sys_Microseconds() - start;
+
+	common->Printf( "sparse: %i kB, %i lookups in %i usec\n", (int)( sparseBytes >> 10 ), numLights * lookupsPerLight, (int)sparseMicroseconds );
+
+	// the dense table is only built when it fits, which is the point of the sparse index
+	const int64 denseBytes = (int64)numEntities * numLights * sizeof( idInteraction * );
+	if ( denseBytes > 512 * 1024 * 1024 ) {
+		common->Printf( "dense: %i kB, too large to build\n", (int)( denseBytes >> 10 ) );
+	} else {
+		idInteraction ** dense = (idInteraction **)R_ClearedStaticAlloc( (int)denseBytes );
+		for ( int l = 0; l < numLights; l++ ) {
+			for ( int i = sparse[l].First(); i != sparse[l].NULL_SLOT; i = sparse[l].Next( i ) ) {
+				dense[l * numEntities + sparse[l].GetKey( i )] = sparse[l].GetValue( i );
+			}
+		}
+
+		int64 denseSum = 0;
+		start = Sys_Microseconds();
+		for ( int l = 0; l < numLights; l++ ) {
+			idInteraction * const * row = dense + l * numEntities;
+			const int * lightLookups = &lookups[l * lookupsPerLight];
+			for ( int i = 0; i < lookupsPerLight; i++ ) {
+				denseSum += (intptr_t)row[lightLookups[i]];
+			}
+		}
+		const uint64 denseMicroseconds = Sys_Microseconds() - start;
+
+		common->Printf( "dense: %i kB, %i lookups in %i usec\n", (int)( denseBytes >> 10 ), numLights * lookupsPerLight, (int)denseMicroseconds );
+		if ( denseSum != sparseSum ) {
+			common->Warning( "testInteractionIndex: sparse and dense lookups differ" );
+		}
+
+		R_StaticFree( dense );
+	}
+
+	delete[] sparse;
+}
+
+/*
+===================
+R_BenchmarkInteractionIndex_f
+
+Appends the sparse index numbers of the loaded map to a log file, so they can be
+collected across the shipped maps by running it once per map.
+
+benchmarkInteractionIndex [logFile]
+===================
+*/
+void R_BenchmarkInteractionIndex_f( const idCmdArgs &args ) {
+	interactionIndexStats_t stats;
+	if ( !R_MeasureInteractionIndex( stats ) ) {
+		common->Printf( "no map loaded\n" );
+		return;
+	}
+
+	const char * logName = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "interactionIndex.csv";
+	idFile * logFile = fileSystem->OpenFileAppend( logName, false, "fs_savepath" );
+	if ( logFile == NULL ) {
+		common->Printf( "couldn't open %s\n", logName );
+		return;
+	}
+	if ( logFile->Length() == 0 ) {
+		logFile->Printf( "map,lights,entities,interactions,sparseKB,denseKB,lookups,found,usec\n" );
+	}
+	logFile->Printf( "%s,%i,%i,%i,%i,%i,%i,%i,%i\n", tr.primaryWorld->mapName.c_str(), stats.numLights, stats.numEntities, stats.numInteractions,
+						(int)( stats.sparseBytes >> 10 ), (int)( stats.denseBytes >> 10 ), stats.numLookups, stats.numFound, (int)stats.lookupMicroseconds );
+	delete logFile;
+
+	common->Printf( "%s: sparse index %i kB, dense table would be %i kB, written to %s\n", tr.primaryWorld->mapName.c_str(),
+						(int)( stats.sparseBytes >> 10 ), (int)( stats.denseBytes >> 10 ), logName );
+}
@@ -143,5 +143,7 @@ private:
 };
 
 void R_ShowInteractionMemory_f( const idCmdArgs &args );
+void R_TestInteractionIndex_f( const idCmdArgs &args );
+void R_BenchmarkInteractionIndex_f( const idCmdArgs &args );
 
 #endif /* !__INTERACTION_H__ */
@@ -41,9 +41,13 @@ idCVar idRenderModelStatic::r_slopVertex( "r_slopVertex", "0.01", CVAR_RENDERER,
 idCVar idRenderModelStatic::r_slopTexCoord( "r_slopTexCoord", "0.001", CVAR_RENDERER, "merge texture coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopNormal( "r_slopNormal", "0.02", CVAR_RENDERER, "merge normals that dot less than this" );
 
-static const byte BRM_VERSION = 108;
+static const byte BRM_VERSION = 110;
 static const unsigned int BRM_MAGIC = ( 'B' << 24 ) | ( 'R' << 16 ) | ( 'M' << 8 ) | BRM_VERSION;
 
+// version 109 stored the surface arrays element by element instead of in an aligned block
+static const byte BRM_VERSION_ELEMENTWISE = 109;
+static const unsigned int BRM_MAGIC_ELEMENTWISE = ( 'B' << 24 ) | ( 'R' << 16 ) | ( 'M' << 8 ) | BRM_VERSION_ELEMENTWISE;
+
 /*
 ================
 idRenderModelStatic::idRenderModelStatic
@@ -312,6 +316,184 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 	FinishSurfaces();
 }
 
+/*
+========================
+R_ReadElementwiseTriArrays
+
+Reads the surface arrays of a version 109 binary model.
+========================
+*/
+static void R_ReadElementwiseTriArrays( idFile * file, srfTriangles_t & tri ) {
+	bool temp;
+
+	file->ReadBig( tri.numVerts );
+	tri.verts = NULL;
+	int numInFile = 0;
+	file->ReadBig( numInFile );
+	if ( numInFile > 0 ) {
+		R_AllocStaticTriSurfVerts( &tri, tri.numVerts );
+		assert( tri.verts != NULL );
+		for ( int j = 0; j < tri.numVerts; j++ ) {
+			file->ReadVec3( tri.verts[j].xyz );
+			file->ReadBigArray( tri.verts[j].st, 2 );
+			file->ReadBigArray( tri.verts[j].normal, 4 );
+			file->ReadBigArray( tri.verts[j].tangent, 4 );
+			file->ReadBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
+			file->ReadBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
+		}
+	}
+
+	file->ReadBig( numInFile );
+	if ( numInFile == 0 ) {
+		tri.preLightShadowVertexes = NULL;
+	} else {
+		R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
+		for ( int j = 0; j < numInFile; j++ ) {
+			file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
+		}
+	} 
+
+	file->ReadBig( tri.numIndexes );
+	tri.indexes = NULL;
+	tri.silIndexes = NULL;
+	if (  tri.numIndexes > 0 ) {
+		R_AllocStaticTriSurfIndexes( &tri, tri.numIndexes );
+		file->ReadBigArray( tri.indexes, tri.numIndexes );
+	}
+	file->ReadBig( numInFile );
+	if ( numInFile > 0 ) {
+		R_AllocStaticTriSurfSilIndexes( &tri, tri.numIndexes );
+		file->ReadBigArray( tri.silIndexes, tri.numIndexes );
+	}
+
+	file->ReadBig( tri.numMirroredVerts );
+	tri.mirroredVerts = NULL;
+	if ( tri.numMirroredVerts > 0 ) {
+		R_AllocStaticTriSurfMirroredVerts( &tri, tri.numMirroredVerts );
+		file->ReadBigArray( tri.mirroredVerts, tri.numMirroredVerts );
+	}
+
+	file->ReadBig( tri.numDupVerts );
+	tri.dupVerts = NULL;
+	if ( tri.numDupVerts > 0 ) {
+		R_AllocStaticTriSurfDupVerts( &tri, tri.numDupVerts );
+		file->ReadBigArray( tri.dupVerts, tri.numDupVerts * 2 );
+	}
+
+	file->ReadBig( tri.numSilEdges );
+	tri.silEdges = NULL;
+	if ( tri.numSilEdges > 0 ) {
+		R_AllocStaticTriSurfSilEdges( &tri, tri.numSilEdges );
+		assert( tri.silEdges != NULL );
+		for ( int j = 0; j < tri.numSilEdges; j++ ) {
+			file->ReadBig( tri.silEdges[j].p1 );
+			file->ReadBig( tri.silEdges[j].p2 );
+			file->ReadBig( tri.silEdges[j].v1 );
+			file->ReadBig( tri.silEdges[j].v2 );
+		}
+	}
+
+	file->ReadBig( temp );
+	tri.dominantTris = NULL;
+	if ( temp ) {
+		R_AllocStaticTriSurfDominantTris( &tri, tri.numVerts );
+		assert( tri.dominantTris != NULL );
+		for ( int j = 0; j < tri.numVerts; j++ ) {
+			file->ReadBig( tri.dominantTris[j].v2 );
+			file->ReadBig( tri.dominantTris[j].v3 );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[0] );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[1] );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[2] );
+		}
+	}
+}
+
+/*
+========================
+R_ReadTriArrays
+
+Reads the counts of the surface arrays followed by the block they are all loaded from.
+========================
+*/
+static bool R_ReadTriArrays( idFile * file, srfTriangles_t & tri ) {
+	file->ReadBig( tri.numVerts );
+	bool verts = false;
+	file->ReadBig( verts );
+
+	int numInFile = 0;
+	file->ReadBig( numInFile );
+	if ( numInFile > 0 ) {
+		R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
+		for ( int j = 0; j < numInFile; j++ ) {
+			file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
+		}
+	}
+
+	file->ReadBig( tri.numIndexes );
+	bool silIndexes = false;
+	file->ReadBig( silIndexes );
+	file->ReadBig( tri.numMirroredVerts );
+	file->ReadBig( tri.numDupVerts );
+	file->ReadBig( tri.numSilEdges );
+	bool dominantTris = false;
+	file->ReadBig( dominantTris );
+
+	triArrayBlock_t layout;
+	R_TriArrayBlockLayout( layout, tri.numVerts, verts, tri.numIndexes, silIndexes, tri.numMirroredVerts, tri.numDupVerts, tri.numSilEdges, dominantTris );
+	if ( !R_ReadTriArrayBlock( file, layout, &tri.arrayBlock ) ) {
+		return false;
+	}
+
+	tri.verts = (idDrawVert *)layout.Array( tri.arrayBlock, TRI_ARRAY_VERTS );
+	tri.indexes = (triIndex_t *)layout.Array( tri.arrayBlock, TRI_ARRAY_INDEXES );
+	tri.silIndexes = (triIndex_t *)layout.Array( tri.arrayBlock, TRI_ARRAY_SIL_INDEXES );
+	tri.mirroredVerts = (int *)layout.Array( tri.arrayBlock, TRI_ARRAY_MIRRORED_VERTS );
+	tri.dupVerts = (int *)layout.Array( tri.arrayBlock, TRI_ARRAY_DUP_VERTS );
+	tri.silEdges = (silEdge_t *)layout.Array( tri.arrayBlock, TRI_ARRAY_SIL_EDGES );
+	tri.dominantTris = (dominantTri_t *)layout.Array( tri.arrayBlock, TRI_ARRAY_DOMINANT_TRIS );
+	return true;
+}
+
+/*
+========================
+R_WriteTriArrays
+========================
+*/
+static void R_WriteTriArrays( idFile * file, const srfTriangles_t & tri ) {
+	// shadow models use numVerts but have no verts
+	file->WriteBig( tri.numVerts );
+	file->WriteBig( tri.verts != NULL );
+
+	if ( tri.preLightShadowVertexes != NULL ) {
+		file->WriteBig( tri.numVerts * 2 );
+		for ( int j = 0; j < tri.numVerts * 2; j++ ) {
+			file->WriteVec4( tri.preLightShadowVertexes[ j ].xyzw );
+		}
+	} else {
+		file->WriteBig( ( int ) 0 );
+	}
+
+	file->WriteBig( tri.numIndexes );
+	file->WriteBig( tri.silIndexes != NULL );
+	file->WriteBig( tri.numMirroredVerts );
+	file->WriteBig( tri.numDupVerts );
+	file->WriteBig( tri.numSilEdges );
+	file->WriteBig( tri.dominantTris != NULL );
+
+	triArrayBlock_t layout;
+	R_TriArrayBlockLayout( layout, tri.numVerts, tri.verts != NULL, tri.numIndexes, tri.silIndexes != NULL, tri.numMirroredVerts, tri.numDupVerts, tri.numSilEdges, tri.dominantTris != NULL );
+
+	const void * arrays[TRI_ARRAY_COUNT];
+	arrays[TRI_ARRAY_VERTS] = tri.verts;
+	arrays[TRI_ARRAY_INDEXES] = tri.indexes;
+	arrays[TRI_ARRAY_SIL_INDEXES] = tri.silIndexes;
+	arrays[TRI_ARRAY_MIRRORED_VERTS] = tri.mirroredVerts;
+	arrays[TRI_ARRAY_DUP_VERTS] = tri.dupVerts;
+	arrays[TRI_ARRAY_SIL_EDGES] = tri.silEdges;
+	arrays[TRI_ARRAY_DOMINANT_TRIS] = tri.dominantTris;
+	R_WriteTriArrayBlock( file, layout, arrays );
+}
+
 /*
 ========================
 idRenderModelStatic::LoadBinaryModel
@@ -324,9 +506,10 @@ bool idRenderModelStatic::LoadBinaryModel( idFile * file, const ID_TIME_T source
 
 	unsigned int magic = 0;
 	file->ReadBig( magic );
-	if ( magic != BRM_MAGIC ) {
+	if ( magic != BRM_MAGIC && magic != BRM_MAGIC_ELEMENTWISE ) {
 		return false;
 	}
+	const bool elementwise = ( magic == BRM_MAGIC_ELEMENTWISE );
 	
 	file->ReadBig( timeStamp );
 
@@ -353,8 +536,6 @@ bool idRenderModelStatic::LoadBinaryModel( idFile * file, const ID_TIME_T source
 		file->ReadBig( isGeometry );
 		surfaces[i].geometry = NULL;
 		if ( isGeometry ) {
-			bool temp;
-
 			surfaces[i].geometry = R_AllocStaticTriSurf();
 			
 			// Read the contents of srfTriangles_t
@@ -370,91 +551,18 @@ bool idRenderModelStatic::LoadBinaryModel( idFile * file, const ID_TIME_T source
 			file->ReadBig( tri.perfectHull );
 			file->ReadBig( tri.referencedIndexes );
 
-			file->ReadBig( tri.numVerts );
-			tri.verts = NULL;
-			int numInFile = 0;
-			file->ReadBig( numInFile );
-			if ( numInFile > 0 ) {
-				R_AllocStaticTriSurfVerts( &tri, tri.numVerts );
-				assert( tri.verts != NULL );
-				for ( int j = 0; j < tri.numVerts; j++ ) {
-					file->ReadVec3( tri.verts[j].xyz );
-					file->ReadBigArray( tri.verts[j].st, 2 );
-					file->ReadBigArray( tri.verts[j].normal, 4 );
-					file->ReadBigArray( tri.verts[j].tangent, 4 );
-					file->ReadBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
-					file->ReadBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
-				}
-			}
-
-			file->ReadBig( numInFile );
-			if ( numInFile == 0 ) {
-				tri.preLightShadowVertexes = NULL;
-			} else {
-				R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
-				for ( int j = 0; j < numInFile; j++ ) {
-					file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
-				}
-			} 
-
-			file->ReadBig( tri.numIndexes );
-			tri.indexes = NULL;
-			tri.silIndexes = NULL;
-			if (  tri.numIndexes > 0 ) {
-				R_AllocStaticTriSurfIndexes( &tri, tri.numIndexes );
-				file->ReadBigArray( tri.indexes, tri.numIndexes );
-			}
-			file->ReadBig( numInFile );
-			if ( numInFile > 0 ) {
-				R_AllocStaticTriSurfSilIndexes( &tri, tri.numIndexes );
-				file->ReadBigArray( tri.silIndexes, tri.numIndexes );
-			}
-
-			file->ReadBig( tri.numMirroredVerts );
-			tri.mirroredVerts = NULL;
-			if ( tri.numMirroredVerts > 0 ) {
-				R_AllocStaticTriSurfMirroredVerts( &tri, tri.numMirroredVerts );
-				file->ReadBigArray( tri.mirroredVerts, tri.numMirroredVerts );
-			}
-
-			file->ReadBig( tri.numDupVerts );
-			tri.dupVerts = NULL;
-			if ( tri.numDupVerts > 0 ) {
-				R_AllocStaticTriSurfDupVerts( &tri, tri.numDupVerts );
-				file->ReadBigArray( tri.dupVerts, tri.numDupVerts * 2 );
-			}
-
-			file->ReadBig( tri.numSilEdges );
-			tri.silEdges = NULL;
-			if ( tri.numSilEdges > 0 ) {
-				R_AllocStaticTriSurfSilEdges( &tri, tri.numSilEdges );
-				assert( tri.silEdges != NULL );
-				for ( int j = 0; j < tri.numSilEdges; j++ ) {
-					file->ReadBig( tri.silEdges[j].p1 );
-					file->ReadBig( tri.silEdges[j].p2 );
-					file->ReadBig( tri.silEdges[j].v1 );
-					file->ReadBig( tri.silEdges[j].v2 );
-				}
-			}
-
-			file->ReadBig( temp );
-			tri.dominantTris = NULL;
-			if ( temp ) {
-				R_AllocStaticTriSurfDominantTris( &tri, tri.numVerts );
-				assert( tri.dominantTris != NULL );
-				for ( int j = 0; j < tri.numVerts; j++ ) {
-					file->ReadBig( tri.dominantTris[j].v2 );
-					file->ReadBig( tri.dominantTris[j].v3 );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[0] );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[1] );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[2] );
-				}
+			if ( elementwise ) {
+				R_ReadElementwiseTriArrays( file, tri );
+			} else if ( !R_ReadTriArrays( file, tri ) ) {
+				return false;
 			}
 
 			file->ReadBig( tri.numShadowIndexesNoFrontCaps );
 			file->ReadBig( tri.numShadowIndexesNoCaps );
 			file->ReadBig( tri.shadowCapPlaneBits );
 
+			tri.bvh = R_ReadTriBVH( file );
+
 			tri.ambientSurface = NULL;
 			tri.nextDeferredFree = NULL;
 			tri.indexCache = 0;
@@ -525,84 +633,13 @@ void idRenderModelStatic::WriteBinaryModel( idFile * file, ID_TIME_T *_timeStamp
 			file->WriteBig( tri.perfectHull );
 			file->WriteBig( tri.referencedIndexes );
 
-			// shadow models use numVerts but have no verts
-			file->WriteBig( tri.numVerts );
-			if ( tri.verts != NULL ) {
-				file->WriteBig( tri.numVerts );
-			} else {
-				file->WriteBig( ( int ) 0 );
-			}
-
-			if ( tri.numVerts > 0 && tri.verts != NULL ) {
-				for ( int j = 0; j < tri.numVerts; j++ ) {
-					file->WriteVec3( tri.verts[j].xyz );
-					file->WriteBigArray( tri.verts[j].st, 2 );
-					file->WriteBigArray( tri.verts[j].normal, 4 );
-					file->WriteBigArray( tri.verts[j].tangent, 4 );
-					file->WriteBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
-					file->WriteBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
-				}
-			}
-
-			if ( tri.preLightShadowVertexes != NULL ) {
-				file->WriteBig( tri.numVerts * 2 );
-				for ( int j = 0; j < tri.numVerts * 2; j++ ) {
-					file->WriteVec4( tri.preLightShadowVertexes[ j ].xyzw );
-				}
-			} else {
-				file->WriteBig( ( int ) 0 );
-			}
-
-			file->WriteBig( tri.numIndexes );
-
-			if ( tri.numIndexes > 0 ) {
-				file->WriteBigArray( tri.indexes, tri.numIndexes );
-			}
-
-			if ( tri.silIndexes != NULL ) {
-				file->WriteBig( tri.numIndexes );
-			} else {
-				file->WriteBig( ( int ) 0 );
-			}
-
-			if ( tri.numIndexes > 0 && tri.silIndexes != NULL ) {
-				file->WriteBigArray( tri.silIndexes, tri.numIndexes );
-			}
-
-			file->WriteBig( tri.numMirroredVerts );
-			if ( tri.numMirroredVerts > 0 ) {
-				file->WriteBigArray( tri.mirroredVerts, tri.numMirroredVerts );
-			}
-
-			file->WriteBig( tri.numDupVerts );
-			if ( tri.numDupVerts > 0 ) {
-				file->WriteBigArray( tri.dupVerts, tri.numDupVerts * 2 );
-			}
-
-			file->WriteBig( tri.numSilEdges );
-			if ( tri.numSilEdges > 0 ) {
-				for ( int j = 0; j < tri.numSilEdges; j++ ) {
-					file->WriteBig( tri.silEdges[j].p1 );
-					file->WriteBig( tri.silEdges[j].p2 );
-					file->WriteBig( tri.silEdges[j].v1 );
-					file->WriteBig( tri.silEdges[j].v2 );
-				}
-			}
-
-			file->WriteBig( tri.dominantTris != NULL );
-			if ( tri.dominantTris != NULL ) {
-				for ( int j = 0; j < tri.numVerts; j++ ) {
-					file->WriteBig( tri.dominantTris[j].v2 );
-					file->WriteBig( tri.dominantTris[j].v3 );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[0] );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[1] );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[2] );
-				}
-			}
+			R_WriteTriArrays( file, tri );
 
 			file->WriteBig( tri.numShadowIndexesNoFrontCaps );
 			file->WriteBig( tri.numShadowIndexesNoCaps );
 			file->WriteBig( tri.shadowCapPlaneBits );
+
+			R_WriteTriBVH( file, tri.bvh );
 		}
 	}
 
@@ -855,6 +892,8 @@ int idRenderModelStatic::NearestJoint( int surfaceNum, int a, int b, int c ) con
 //=====================================================================
 
 
+static idSysMutex surfaceAreaMutex;
+
 /*
 ================
 idRenderModelStatic::FinishSurfaces
@@ -971,11 +1010,15 @@ void idRenderModelStatic::FinishSurfaces() {
 		const modelSurface_t	*surf = &surfaces[i];
 		srfTriangles_t	*tri = surf->geometry;
 
+		float	area = 0.0f;
 		for ( int j = 0; j < tri->numIndexes; j += 3 ) {
-			float	area = idWinding::TriangleArea( tri->verts[tri->indexes[j]].xyz,
+			area += idWinding::TriangleArea( tri->verts[tri->indexes[j]].xyz,
 				 tri->verts[tri->indexes[j+1]].xyz,  tri->verts[tri->indexes[j+2]].xyz );
-			const_cast<idMaterial *>(surf->shader)->AddToSurfaceArea( area );
 		}
+
+		// the models of a map are finished in parallel and share materials
+		idScopedCriticalSection lock( surfaceAreaMutex );
+		const_cast<idMaterial *>(surf->shader)->AddToSurfaceArea( area );
 	}
 
 	// set flags for whole-model rejection
@@ -1030,6 +1073,17 @@ void idRenderModelStatic::FinishSurfaces() {
 
 		}
 	}
+
+	// build the trace hierarchies now that the triangles are final
+	if ( IsDynamicModel() == DM_STATIC ) {
+		for ( i = 0; i < surfaces.Num(); i++ ) {
+			srfTriangles_t * tri = surfaces[i].geometry;
+			if ( tri->bvh != NULL ) {
+				R_FreeTriBVH( tri->bvh );
+			}
+			tri->bvh = R_BuildTriBVH( tri );
+		}
+	}
 }
 
 /*
@@ -61,6 +61,8 @@ class idRenderModelStatic;
 struct viewDef_t;
 
 // our only drawing geometry type
+struct triBVH_t;
+
 struct srfTriangles_t {
 	srfTriangles_t() {}
 
@@ -92,6 +94,11 @@ struct srfTriangles_t {
 
 	dominantTri_t *				dominantTris;			// [numVerts] for deformed surface fast tangent calculation
 
+	triBVH_t *					bvh;					// triangle hierarchy for traces, only built for large static surfaces
+
+	byte *						arrayBlock;				// if not NULL, verts, indexes, silIndexes, mirroredVerts, dupVerts, silEdges
+														// and dominantTris all point into this single block read from a binary model
+
 	int							numShadowIndexesNoFrontCaps;	// shadow volumes with front caps omitted
 	int							numShadowIndexesNoCaps;			// shadow volumes with the front and rear caps omitted
 
@@ -72,6 +72,7 @@ private:
 	static void				ListModels_f( const idCmdArgs &args );
 	static void				ReloadModels_f( const idCmdArgs &args );
 	static void				TouchModel_f( const idCmdArgs &args );
+	static void				TestModelLoading_f( const idCmdArgs &args );
 };
 
 
@@ -179,6 +180,100 @@ void idRenderModelManagerLocal::TouchModel_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==============
+idRenderModelManagerLocal::TestModelLoading_f
+
+Loads the generated binary file of every static model in the preload manifest of a map,
+then writes each model again in the current format and times loading it from memory.
+md5 meshes are skipped, because loading them allocates static vertex cache space that is
+only reclaimed by the next level load.
+
+testModelLoading <mapName>
+==============
+*/
+void idRenderModelManagerLocal::TestModelLoading_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: testModelLoading <mapName>\n" );
+		return;
+	}
+
+	idStrStatic< MAX_OSPATH > manifestName = args.Argv( 1 );
+	manifestName.StripFileExtension();
+	if ( idStr::Icmpn( manifestName, "maps/", 5 ) != 0 ) {
+		manifestName = va( "maps/%s", manifestName.c_str() );
+	}
+	manifestName += ".preload";
+
+	idPreloadManifest manifest;
+	if ( !manifest.LoadManifest( manifestName ) ) {
+		common->Printf( "couldn't load %s\n", manifestName.c_str() );
+		return;
+	}
+
+	int numModels = 0;
+	int numSkipped = 0;
+	int numMissing = 0;
+	int64 storedBytes = 0;
+	int64 currentBytes = 0;
+	uint64 storedMicroseconds = 0;
+	uint64 currentMicroseconds = 0;
+
+	for ( int i = 0; i < manifest.NumResources(); i++ ) {
+		const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
+		if ( p.resType != PRELOAD_MODEL ) {
+			continue;
+		}
+
+		idStrStatic< MAX_OSPATH > canonical = p.resourceName;
+		canonical.ToLower();
+		idStrStatic< MAX_OSPATH > extension;
+		canonical.ExtractFileExtension( extension );
+		if ( extension.Icmp( "ase" ) != 0 && extension.Icmp( "lwo" ) != 0 && extension.Icmp( "flt" ) != 0 && extension.Icmp( "ma" ) != 0 ) {
+			numSkipped++;
+			continue;
+		}
+
+		// same name as idRenderModelManagerLocal::GetModel
+		idStrStatic< MAX_OSPATH > generatedFileName = "generated/rendermodels/";
+		generatedFileName.AppendPath( canonical );
+		generatedFileName.SetFileExtension( va( "b%s", extension.c_str() ) );
+		const ID_TIME_T sourceTimeStamp = fileSystem->GetTimestamp( canonical );
+
+		uint64 start = Sys_Microseconds();
+		idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
+		if ( file == NULL ) {
+			numMissing++;
+			continue;
+		}
+		idRenderModelStatic * model = new (TAG_MODEL) idRenderModelStatic;
+		if ( !model->LoadBinaryModel( file, sourceTimeStamp ) ) {
+			delete model;
+			numMissing++;
+			continue;
+		}
+		storedMicroseconds += Sys_Microseconds() - start;
+		storedBytes += file->Length();
+		numModels++;
+
+		idFile_Memory current( "testModelLoading" );
+		model->WriteBinaryModel( &current );
+		current.MakeReadOnly();
+		delete model;
+
+		start = Sys_Microseconds();
+		model = new (TAG_MODEL) idRenderModelStatic;
+		model->LoadBinaryModel( &current, sourceTimeStamp );
+		currentMicroseconds += Sys_Microseconds() - start;
+		currentBytes += current.Length();
+		delete model;
+	}
+
+	common->Printf( "%s: %i static models, %i md5 and other model types skipped, %i without a generated file\n", manifestName.c_str(), numModels, numSkipped, numMissing );
+	common->Printf( "stored files:   %6.1f MB in %6i msec\n", storedBytes / ( 1024.0 * 1024.0 ), (int)( storedMicroseconds / 1000 ) );
+	common->Printf( "current format: %6.1f MB in %6i msec\n", currentBytes / ( 1024.0 * 1024.0 ), (int)( currentMicroseconds / 1000 ) );
+}
+
 /*
 =================
 idRenderModelManagerLocal::WritePrecacheCommands
@@ -212,6 +307,7 @@ void idRenderModelManagerLocal::Init() {
 	cmdSystem->AddCommand( "printModel", PrintModel_f, CMD_FL_RENDERER, "prints model info", idCmdSystem::ArgCompletion_ModelName );
 	cmdSystem->AddCommand( "reloadModels", ReloadModels_f, CMD_FL_RENDERER|CMD_FL_CHEAT, "reloads models" );
 	cmdSystem->AddCommand( "touchModel", TouchModel_f, CMD_FL_RENDERER, "touches a model", idCmdSystem::ArgCompletion_ModelName );
+	cmdSystem->AddCommand( "testModelLoading", TestModelLoading_f, CMD_FL_RENDERER, "times loading the generated binary models in a map's preload manifest, usage: testModelLoading <mapName>" );
 
 	insideLevelLoad = false;
 
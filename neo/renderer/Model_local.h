@@ -202,6 +202,8 @@ public:
 
 	virtual bool				SupportsBinaryModel() { return true; }
 
+	static void					TestSkinning_f( const idCmdArgs & args );
+
 private:
 	idList<idMD5Joint, TAG_MODEL>	joints;
 	idList<idJointQuat, TAG_MODEL>	defaultPose;
@@ -41,9 +41,13 @@ static const __m128 vector_float_negInfinity		= { -idMath::INFINITY, -idMath::IN
 
 static const char *MD5_SnapshotName = "_MD5_Snapshot_";
 
-static const byte MD5B_VERSION = 106;
+static const byte MD5B_VERSION = 107;
 static const unsigned int MD5B_MAGIC = ( '5' << 24 ) | ( 'D' << 16 ) | ( 'M' << 8 ) | MD5B_VERSION;
 
+// version 106 stored the deform arrays element by element instead of in an aligned block
+static const byte MD5B_VERSION_ELEMENTWISE = 106;
+static const unsigned int MD5B_MAGIC_ELEMENTWISE = ( '5' << 24 ) | ( 'D' << 16 ) | ( 'M' << 8 ) | MD5B_VERSION_ELEMENTWISE;
+
 idCVar r_useGPUSkinning( "r_useGPUSkinning", "1", CVAR_INTEGER, "animate normals and tangents instead of deriving" );
 
 /***********************************************************************
@@ -489,7 +493,10 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 			assert( tri->verts != NULL );	// quiet analyze warning
 			memcpy( tri->verts, deformInfo->verts, deformInfo->numOutputVerts * sizeof( deformInfo->verts[0] ) );	// copy over the texture coordinates
 		}
-		TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
+		// the skinning may be deferred to be batched with the other visible models
+		if ( !R_DeferSkinning( tri, deformInfo->verts, entJointsInverted ) ) {
+			TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
+		}
 		tri->referencedVerts = false;
 	}
 	tri->tangentsCalculated = true;
@@ -632,6 +639,57 @@ void idRenderModelMD5::InitFromFile( const char *fileName ) {
 	LoadModel();
 }
 
+/*
+========================
+R_ReadElementwiseDeformArrays
+
+Reads the deform arrays of a version 106 binary model.
+========================
+*/
+static void R_ReadElementwiseDeformArrays( idFile * file, deformInfo_t & deform ) {
+	srfTriangles_t	tri;
+	memset( &tri, 0, sizeof( srfTriangles_t ) );
+	
+	if ( deform.numOutputVerts > 0 ) {
+		R_AllocStaticTriSurfVerts( &tri, deform.numOutputVerts );
+		deform.verts = tri.verts;
+		file->ReadBigArray( deform.verts, deform.numOutputVerts );
+	}
+
+	if ( deform.numIndexes > 0 ) {
+		R_AllocStaticTriSurfIndexes( &tri, deform.numIndexes );
+		R_AllocStaticTriSurfSilIndexes( &tri, deform.numIndexes );
+		deform.indexes = tri.indexes;
+		deform.silIndexes = tri.silIndexes;
+		file->ReadBigArray( deform.indexes, deform.numIndexes );
+		file->ReadBigArray( deform.silIndexes, deform.numIndexes );
+	}
+	
+	if ( deform.numMirroredVerts > 0 ) {
+		R_AllocStaticTriSurfMirroredVerts( &tri, deform.numMirroredVerts );
+		deform.mirroredVerts = tri.mirroredVerts;
+		file->ReadBigArray( deform.mirroredVerts, deform.numMirroredVerts );
+	}
+
+	if ( deform.numDupVerts > 0 ) {
+		R_AllocStaticTriSurfDupVerts( &tri, deform.numDupVerts );
+		deform.dupVerts = tri.dupVerts;
+		file->ReadBigArray( deform.dupVerts, deform.numDupVerts * 2 );
+	}
+
+	if ( deform.numSilEdges > 0 ) {
+		R_AllocStaticTriSurfSilEdges( &tri, deform.numSilEdges );
+		deform.silEdges = tri.silEdges;
+		assert( deform.silEdges != NULL );
+		for ( int j = 0; j < deform.numSilEdges; j++ ) {
+			file->ReadBig( deform.silEdges[j].p1 );
+			file->ReadBig( deform.silEdges[j].p2 );
+			file->ReadBig( deform.silEdges[j].v1 );
+			file->ReadBig( deform.silEdges[j].v2 );
+		}
+	}
+}
+
 /*
 ========================
 idRenderModelMD5::LoadBinaryModel
@@ -645,9 +703,10 @@ bool idRenderModelMD5::LoadBinaryModel( idFile * file, const ID_TIME_T sourceTim
 
 	unsigned int magic = 0;
 	file->ReadBig( magic );
-	if ( magic != MD5B_MAGIC ) {
+	if ( magic != MD5B_MAGIC && magic != MD5B_MAGIC_ELEMENTWISE ) {
 		return false;
 	}
+	const bool elementwise = ( magic == MD5B_MAGIC_ELEMENTWISE );
 
 	int tempNum;
 	file->ReadBig( tempNum );
@@ -710,46 +769,20 @@ bool idRenderModelMD5::LoadBinaryModel( idFile * file, const ID_TIME_T sourceTim
 		file->ReadBig( deform.numDupVerts );
 		file->ReadBig( deform.numSilEdges );
 
-		srfTriangles_t	tri;
-		memset( &tri, 0, sizeof( srfTriangles_t ) );
-		
-		if ( deform.numOutputVerts > 0 ) {
-			R_AllocStaticTriSurfVerts( &tri, deform.numOutputVerts );
-			deform.verts = tri.verts;
-			file->ReadBigArray( deform.verts, deform.numOutputVerts );
-		}
-
-		if ( deform.numIndexes > 0 ) {
-			R_AllocStaticTriSurfIndexes( &tri, deform.numIndexes );
-			R_AllocStaticTriSurfSilIndexes( &tri, deform.numIndexes );
-			deform.indexes = tri.indexes;
-			deform.silIndexes = tri.silIndexes;
-			file->ReadBigArray( deform.indexes, deform.numIndexes );
-			file->ReadBigArray( deform.silIndexes, deform.numIndexes );
-		}
-		
-		if ( deform.numMirroredVerts > 0 ) {
-			R_AllocStaticTriSurfMirroredVerts( &tri, deform.numMirroredVerts );
-			deform.mirroredVerts = tri.mirroredVerts;
-			file->ReadBigArray( deform.mirroredVerts, deform.numMirroredVerts );
-		}
-
-		if ( deform.numDupVerts > 0 ) {
-			R_AllocStaticTriSurfDupVerts( &tri, deform.numDupVerts );
-			deform.dupVerts = tri.dupVerts;
-			file->ReadBigArray( deform.dupVerts, deform.numDupVerts * 2 );
-		}
-
-		if ( deform.numSilEdges > 0 ) {
-			R_AllocStaticTriSurfSilEdges( &tri, deform.numSilEdges );
-			deform.silEdges = tri.silEdges;
-			assert( deform.silEdges != NULL );
-			for ( int j = 0; j < deform.numSilEdges; j++ ) {
-				file->ReadBig( deform.silEdges[j].p1 );
-				file->ReadBig( deform.silEdges[j].p2 );
-				file->ReadBig( deform.silEdges[j].v1 );
-				file->ReadBig( deform.silEdges[j].v2 );
+		if ( elementwise ) {
+			R_ReadElementwiseDeformArrays( file, deform );
+		} else {
+			triArrayBlock_t layout;
+			R_TriArrayBlockLayout( layout, deform.numOutputVerts, true, deform.numIndexes, true, deform.numMirroredVerts, deform.numDupVerts, deform.numSilEdges, false );
+			if ( !R_ReadTriArrayBlock( file, layout, &deform.arrayBlock ) ) {
+				return false;
 			}
+			deform.verts = (idDrawVert *)layout.Array( deform.arrayBlock, TRI_ARRAY_VERTS );
+			deform.indexes = (triIndex_t *)layout.Array( deform.arrayBlock, TRI_ARRAY_INDEXES );
+			deform.silIndexes = (triIndex_t *)layout.Array( deform.arrayBlock, TRI_ARRAY_SIL_INDEXES );
+			deform.mirroredVerts = (int *)layout.Array( deform.arrayBlock, TRI_ARRAY_MIRRORED_VERTS );
+			deform.dupVerts = (int *)layout.Array( deform.arrayBlock, TRI_ARRAY_DUP_VERTS );
+			deform.silEdges = (silEdge_t *)layout.Array( deform.arrayBlock, TRI_ARRAY_SIL_EDGES );
 		}
 
 		idShadowVertSkinned * shadowVerts = (idShadowVertSkinned *) Mem_Alloc( ALIGN( deform.numOutputVerts * 2 * sizeof( idShadowVertSkinned ), 16 ), TAG_MODEL );
@@ -831,31 +864,17 @@ void idRenderModelMD5::WriteBinaryModel( idFile * file, ID_TIME_T *_timeStamp )
 		file->WriteBig( deform.numDupVerts );
 		file->WriteBig( deform.numSilEdges );
 
-		if ( deform.numOutputVerts > 0 ) {
-			file->WriteBigArray( deform.verts, deform.numOutputVerts );
-		}
+		triArrayBlock_t layout;
+		R_TriArrayBlockLayout( layout, deform.numOutputVerts, true, deform.numIndexes, true, deform.numMirroredVerts, deform.numDupVerts, deform.numSilEdges, false );
 
-		if ( deform.numIndexes > 0 ) {
-			file->WriteBigArray( deform.indexes, deform.numIndexes );
-			file->WriteBigArray( deform.silIndexes, deform.numIndexes );
-		}
-
-		if ( deform.numMirroredVerts > 0 ) {
-			file->WriteBigArray( deform.mirroredVerts, deform.numMirroredVerts );
-		}
-
-		if ( deform.numDupVerts > 0 ) {
-			file->WriteBigArray( deform.dupVerts, deform.numDupVerts * 2 );
-		}
-
-		if ( deform.numSilEdges > 0 ) {
-			for ( int j = 0; j < deform.numSilEdges; j++ ) {
-				file->WriteBig( deform.silEdges[j].p1 );
-				file->WriteBig( deform.silEdges[j].p2 );
-				file->WriteBig( deform.silEdges[j].v1 );
-				file->WriteBig( deform.silEdges[j].v2 );
-			}
-		}
+		const void * arrays[TRI_ARRAY_COUNT] = {};
+		arrays[TRI_ARRAY_VERTS] = deform.verts;
+		arrays[TRI_ARRAY_INDEXES] = deform.indexes;
+		arrays[TRI_ARRAY_SIL_INDEXES] = deform.silIndexes;
+		arrays[TRI_ARRAY_MIRRORED_VERTS] = deform.mirroredVerts;
+		arrays[TRI_ARRAY_DUP_VERTS] = deform.dupVerts;
+		arrays[TRI_ARRAY_SIL_EDGES] = deform.silEdges;
+		R_WriteTriArrayBlock( file, layout, arrays );
 
 		file->WriteBig( meshes[i].surfaceNum );
 	}
@@ -1429,3 +1448,143 @@ int	idRenderModelMD5::Memory() const {
 	}
 	return total;
 }
+
+/*
+===================
+SkinnedVertsDiffer
+
+Allows for the rounding differences between the SIMD and the generic skinning paths.
+===================
+*/
+static bool SkinnedVertsDiffer( const idDrawVert & a, const idDrawVert & b ) {
+	bool error = false;
+	for ( int j = 0; j < 3; j++ ) {
+		error |= idMath::Fabs( a.xyz[j] - b.xyz[j] ) > 1e-3f + idMath::Fabs( a.xyz[j] ) * 1e-5f;
+		error |= abs( a.normal[j] - b.normal[j] ) > 1;
+		error |= abs( a.tangent[j] - b.tangent[j] ) > 1;
+	}
+	error |= a.normal[3] != b.normal[3] || a.tangent[3] != b.tangent[3];
+	error |= a.st[0] != b.st[0] || a.st[1] != b.st[1];
+	error |= *(const unsigned int *)a.color != *(const unsigned int *)b.color;
+	error |= *(const unsigned int *)a.color2 != *(const unsigned int *)b.color2;
+	return error;
+}
+
+/*
+===================
+idRenderModelMD5::TestSkinning_f
+
+Skins copies of a model with its inverted default pose per mesh, with the batched
+skinning pass and with the batched skinning pass split over jobs. The batched results
+are verified vertex by vertex against the per mesh skinning, and the jobs result has
+to match the serial batched result exactly. Also reports the vertex throughput.
+===================
+*/
+void idRenderModelMD5::TestSkinning_f( const idCmdArgs & args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: testSkinning <md5 model> [copies] [iterations]\n" );
+		return;
+	}
+
+	idRenderModelMD5 * model = dynamic_cast<idRenderModelMD5 *>( renderModelManager->FindModel( args.Argv( 1 ) ) );
+	if ( model == NULL ) {
+		common->Printf( "'%s' is not an md5 model\n", args.Argv( 1 ) );
+		return;
+	}
+	if ( model->purged ) {
+		model->LoadModel();
+	}
+
+	const int numCopies = Max( ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 64, 1 );
+	const int numIterations = Max( ( args.Argc() > 3 ) ? atoi( args.Argv( 3 ) ) : 10, 1 );
+	const idJointMat * joints = model->invertedDefaultPose.Ptr();
+
+	int numVertsPerCopy = 0;
+	for ( int i = 0; i < model->meshes.Num(); i++ ) {
+		numVertsPerCopy += model->meshes[i].deformInfo->numOutputVerts;
+	}
+	const int totalVerts = numVertsPerCopy * numCopies;
+	if ( totalVerts == 0 ) {
+		common->Printf( "'%s' has no vertices\n", model->Name() );
+		return;
+	}
+
+	idDrawVert * referenceVerts = (idDrawVert *)Mem_Alloc16( totalVerts * sizeof( idDrawVert ), TAG_TEMP );
+	idDrawVert * batchedVerts = (idDrawVert *)Mem_Alloc16( totalVerts * sizeof( idDrawVert ), TAG_TEMP );
+	idDrawVert * jobVerts = (idDrawVert *)Mem_Alloc16( totalVerts * sizeof( idDrawVert ), TAG_TEMP );
+
+	// the serial and the jobs pass each write their own copy of the vertices
+	idList< skinnedSurface_t > batchedSurfaces;
+	idList< skinnedSurface_t > jobSurfaces;
+	batchedSurfaces.SetNum( numCopies * model->meshes.Num() );
+	jobSurfaces.SetNum( numCopies * model->meshes.Num() );
+	for ( int i = 0, offset = 0; i < batchedSurfaces.Num(); i++ ) {
+		const deformInfo_t * deformInfo = model->meshes[i % model->meshes.Num()].deformInfo;
+		skinnedSurface_t & surf = batchedSurfaces[i];
+		surf.verts = batchedVerts + offset;
+		surf.cacheVerts = NULL;
+		surf.baseVerts = deformInfo->verts;
+		surf.joints = joints;
+		surf.numVerts = deformInfo->numOutputVerts;
+		jobSurfaces[i] = surf;
+		jobSurfaces[i].verts = jobVerts + offset;
+		memcpy( referenceVerts + offset, deformInfo->verts, surf.numVerts * sizeof( idDrawVert ) );
+		offset += surf.numVerts;
+	}
+
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_SKINNING_JOBS, 0, NULL );
+
+	uint64 perMeshTime = (uint64)-1;
+	uint64 batchedTime = (uint64)-1;
+	uint64 parallelTime = (uint64)-1;
+
+	for ( int iteration = 0; iteration < numIterations; iteration++ ) {
+		uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < batchedSurfaces.Num(); i++ ) {
+			const skinnedSurface_t & surf = batchedSurfaces[i];
+			TransformVertsAndTangents( referenceVerts + ( surf.verts - batchedVerts ), surf.numVerts, surf.baseVerts, surf.joints );
+		}
+		perMeshTime = Min( perMeshTime, Sys_Microseconds() - start );
+
+		memset( batchedVerts, 0, totalVerts * sizeof( idDrawVert ) );
+
+		start = Sys_Microseconds();
+		R_SkinSurfaces( batchedSurfaces.Ptr(), batchedSurfaces.Num(), NULL );
+		batchedTime = Min( batchedTime, Sys_Microseconds() - start );
+
+		memset( jobVerts, 0, totalVerts * sizeof( idDrawVert ) );
+
+		start = Sys_Microseconds();
+		R_SkinSurfaces( jobSurfaces.Ptr(), jobSurfaces.Num(), jobList );
+		parallelTime = Min( parallelTime, Sys_Microseconds() - start );
+	}
+
+	parallelJobManager->FreeJobList( jobList );
+
+	int numBatchedErrors = 0;
+	int numJobErrors = 0;
+	int numJobMismatches = 0;
+	for ( int i = 0; i < totalVerts; i++ ) {
+		if ( SkinnedVertsDiffer( referenceVerts[i], batchedVerts[i] ) ) {
+			numBatchedErrors++;
+		}
+		if ( SkinnedVertsDiffer( referenceVerts[i], jobVerts[i] ) ) {
+			numJobErrors++;
+		}
+		if ( memcmp( &batchedVerts[i], &jobVerts[i], sizeof( idDrawVert ) ) != 0 ) {
+			numJobMismatches++;
+		}
+	}
+
+	Mem_Free16( referenceVerts );
+	Mem_Free16( batchedVerts );
+	Mem_Free16( jobVerts );
+
+	common->Printf( "%d copies of %s, %d meshes, %d verts, best of %d iterations\n", numCopies, model->Name(), model->meshes.Num(), totalVerts, numIterations );
+	common->Printf( "  per mesh:  %8d usec %7.2f Mverts/sec\n", (int)perMeshTime, totalVerts / (float)Max( perMeshTime, (uint64)1 ) );
+	common->Printf( "  batched:   %8d usec %7.2f Mverts/sec\n", (int)batchedTime, totalVerts / (float)Max( batchedTime, (uint64)1 ) );
+	common->Printf( "  jobs:      %8d usec %7.2f Mverts/sec\n", (int)parallelTime, totalVerts / (float)Max( parallelTime, (uint64)1 ) );
+	common->Printf( "  batched vs per mesh: %s, %d of %d verts differ\n", ( numBatchedErrors == 0 ) ? "ok" : "X", numBatchedErrors, totalVerts );
+	common->Printf( "  jobs vs per mesh:    %s, %d of %d verts differ\n", ( numJobErrors == 0 ) ? "ok" : "X", numJobErrors, totalVerts );
+	common->Printf( "  jobs vs batched:     %s, %d of %d verts not identical\n", ( numJobMismatches == 0 ) ? "ok" : "X", numJobMismatches, totalVerts );
+}
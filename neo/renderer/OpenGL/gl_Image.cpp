@@ -42,7 +42,10 @@ idImage::SubImageUpload
 ========================
 */
 void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int height, const void * pic, int pixelPitch ) const {
-	assert( x >= 0 && y >= 0 && mipLevel >= 0 && width >= 0 && height >= 0 && mipLevel < opts.numLevels );
+	assert( x >= 0 && y >= 0 && mipLevel >= residentLevel && width >= 0 && height >= 0 && mipLevel < opts.numLevels );
+
+	// streamed images don't have their largest levels in the texture object
+	const int textureLevel = mipLevel - residentLevel;
 
 	int compressedSize = 0;
 
@@ -97,7 +100,7 @@ void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int
 	GL_CheckErrors();
 #endif
 	if ( IsCompressed() ) {
-		qglCompressedTexSubImage2DARB( uploadTarget, mipLevel, x, y, width, height, internalFormat, compressedSize, pic );
+		qglCompressedTexSubImage2DARB( uploadTarget, textureLevel, x, y, width, height, internalFormat, compressedSize, pic );
 	} else {
 
 		// make sure the pixel store alignment is correct so that lower mips get created
@@ -110,7 +113,7 @@ void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int
 			qglPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
 		}
 
-		qglTexSubImage2D( uploadTarget, mipLevel, x, y, width, height, dataFormat, dataType, pic );
+		qglTexSubImage2D( uploadTarget, textureLevel, x, y, width, height, dataFormat, dataType, pic );
 	}
 #ifdef DEBUG
 	GL_CheckErrors();
@@ -179,6 +182,12 @@ void idImage::SetTexParameters() {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
+	} else if ( opts.format == FMT_BC5 ) {
+		// present the normal the same way as CFM_NORMAL_DXT5, X in alpha and Y in green
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	} else {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
@@ -196,6 +205,12 @@ void idImage::SetTexParameters() {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_ONE );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ONE );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
+	} else if ( opts.format == FMT_BC5 ) {
+		// present the normal the same way as CFM_NORMAL_DXT5, X in alpha and Y in green
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	}
 #endif
 
@@ -349,6 +364,16 @@ void idImage::AllocImage() {
 		dataFormat = GL_RGBA;
 		dataType = GL_UNSIGNED_BYTE;
 		break;
+	case FMT_BC5:
+		internalFormat = GL_COMPRESSED_RG_RGTC2;
+		dataFormat = GL_RG;
+		dataType = GL_UNSIGNED_BYTE;
+		break;
+	case FMT_BC7:
+		internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+		dataFormat = GL_RGBA;
+		dataType = GL_UNSIGNED_BYTE;
+		break;
 	case FMT_DEPTH:
 		internalFormat = GL_DEPTH_COMPONENT;
 		dataFormat = GL_DEPTH_COMPONENT;
@@ -402,13 +427,17 @@ void idImage::AllocImage() {
 
 	qglBindTexture( target, texnum );
 
+	// streamed images only allocate the levels from residentLevel down
+	const int numLevels = opts.numLevels - residentLevel;
+	assert( numLevels > 0 );
+
 	for ( int side = 0; side < numSides; side++ ) {
-		int w = opts.width;
-		int h = opts.height;
+		int w = Max( opts.width >> residentLevel, 1 );
+		int h = Max( opts.height >> residentLevel, 1 );
 		if ( opts.textureType == TT_CUBIC ) {
 			h = w;
 		}
-		for ( int level = 0; level < opts.numLevels; level++ ) {
+		for ( int level = 0; level < numLevels; level++ ) {
 
 			// clear out any previous error
 			GL_CheckErrors();
@@ -440,7 +469,7 @@ void idImage::AllocImage() {
 		}
 	}
 
-	qglTexParameteri( target, GL_TEXTURE_MAX_LEVEL, opts.numLevels - 1 );
+	qglTexParameteri( target, GL_TEXTURE_MAX_LEVEL, numLevels - 1 );
 
 	// see if we messed anything up
 	GL_CheckErrors();
@@ -649,6 +649,10 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 		GL_BlockingSwapBuffers();
 	}
 
+	// upload the streamed textures that finished loading and queue new loads for
+	// the images the front end saw up close
+	globalImages->UpdateStreaming();
+
 	// read back the start and end timer queries from the previous frame
 	if ( glConfig.timerQueryAvailable ) {
 		uint64 drawingTimeNanoseconds = 0;
@@ -106,6 +106,8 @@ struct glconfig_t {
 	bool				multitextureAvailable;
 	bool				directStateAccess;
 	bool				textureCompressionAvailable;
+	bool				rgtcTextureCompressionAvailable;
+	bool				bptcTextureCompressionAvailable;
 	bool				anisotropicFilterAvailable;
 	bool				textureLODBiasAvailable;
 	bool				seamlessCubeMapAvailable;
@@ -225,6 +227,10 @@ public:
 	virtual void			Preload( const idPreloadManifest &manifest, const char *mapName ) = 0;
 	virtual void			LoadLevelImages() = 0;
 
+	// Waits for the texture streaming reads in flight and starts no new ones until
+	// EndLevelLoad, must be called before the resource containers are changed.
+	virtual void			SuspendImageStreaming() = 0;
+
 	virtual void			BeginAutomaticBackgroundSwaps( autoRenderIconType_t icon = AUTORENDER_DEFAULTICON ) = 0;
 	virtual void			EndAutomaticBackgroundSwaps() = 0;
 	virtual bool			AreAutomaticBackgroundSwapsRunning( autoRenderIconType_t * icon = NULL ) const = 0;
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 
 #include "tr_local.h"
+#include "Model_local.h"
 
 // Vista OpenGL wrapper check
 #include "../sys/win32/win_local.h"
@@ -135,6 +136,8 @@ idCVar r_useShadowDepthBounds( "r_useShadowDepthBounds", "1", CVAR_RENDERER | CV
 
 idCVar r_screenFraction( "r_screenFraction", "100", CVAR_RENDERER | CVAR_INTEGER, "for testing fill rate, the resolution of the entire screen can be changed" );
 idCVar r_usePortals( "r_usePortals", "1", CVAR_RENDERER | CVAR_BOOL, " 1 = use portals to perform area culling, otherwise draw everything" );
+idCVar r_usePortalFloodCache( "r_usePortalFloodCache", "0", CVAR_RENDERER | CVAR_BOOL, "reuse the portal flood of views that repeat with the same origin, frustum and portal states" );
+idCVar r_showPortalFloodCache( "r_showPortalFloodCache", "0", CVAR_RENDERER | CVAR_BOOL, "print the portal flood cache result and time for each view" );
 idCVar r_singleLight( "r_singleLight", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one light" );
 idCVar r_singleEntity( "r_singleEntity", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one entity" );
 idCVar r_singleSurface( "r_singleSurface", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one surface on each entity" );
@@ -387,6 +390,11 @@ static void R_CheckPortableExtensions() {
 		qglGetCompressedTexImageARB = (PFNGLGETCOMPRESSEDTEXIMAGEARBPROC)GLimp_ExtensionPointer( "glGetCompressedTexImageARB" );
 	}
 
+	// GL_ARB_texture_compression_rgtc + GL_ARB_texture_compression_bptc
+	// BC5 normal maps and BC7 color images, both use the same compressed upload path as S3TC
+	glConfig.rgtcTextureCompressionAvailable = glConfig.textureCompressionAvailable && ( glConfig.glVersion >= 3.0f || R_CheckExtension( "GL_ARB_texture_compression_rgtc" ) );
+	glConfig.bptcTextureCompressionAvailable = glConfig.textureCompressionAvailable && ( glConfig.glVersion >= 4.2f || R_CheckExtension( "GL_ARB_texture_compression_bptc" ) );
+
 	// GL_EXT_texture_filter_anisotropic
 	glConfig.anisotropicFilterAvailable = R_CheckExtension( "GL_EXT_texture_filter_anisotropic" );
 	if ( glConfig.anisotropicFilterAvailable ) {
@@ -1883,11 +1891,18 @@ void R_InitCommands() {
 	cmdSystem->AddCommand( "testVideo", R_TestVideo_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given cinematic", idCmdSystem::ArgCompletion_VideoName );
 	cmdSystem->AddCommand( "reportSurfaceAreas", R_ReportSurfaceAreas_f, CMD_FL_RENDERER, "lists all used materials sorted by surface area" );
 	cmdSystem->AddCommand( "showInteractionMemory", R_ShowInteractionMemory_f, CMD_FL_RENDERER, "shows memory used by interactions" );
+	cmdSystem->AddCommand( "testInteractionIndex", R_TestInteractionIndex_f, CMD_FL_RENDERER, "compares the sparse interaction index to a dense table" );
+	cmdSystem->AddCommand( "benchmarkInteractionIndex", R_BenchmarkInteractionIndex_f, CMD_FL_RENDERER, "appends the sparse interaction index numbers of the loaded map to a log file" );
 	cmdSystem->AddCommand( "vid_restart", R_VidRestart_f, CMD_FL_RENDERER, "restarts renderSystem" );
 	cmdSystem->AddCommand( "listRenderEntityDefs", R_ListRenderEntityDefs_f, CMD_FL_RENDERER, "lists the entity defs" );
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
 	cmdSystem->AddCommand( "listModes", R_ListModes_f, CMD_FL_RENDERER, "lists all video modes" );
 	cmdSystem->AddCommand( "reloadSurface", R_ReloadSurface_f, CMD_FL_RENDERER, "reloads the decl and images for selected surface" );
+	cmdSystem->AddCommand( "testSkinning", idRenderModelMD5::TestSkinning_f, CMD_FL_RENDERER, "benchmarks CPU skinning of copies of an md5 model, usage: testSkinning <model> [copies] [iterations]" );
+	cmdSystem->AddCommand( "captureDrawSurfs", R_CaptureDrawSurfs_f, CMD_FL_RENDERER, "records the draw surfaces of the next main view for testDrawSurfSort" );
+	cmdSystem->AddCommand( "testDrawSurfSort", R_TestDrawSurfSort_f, CMD_FL_RENDERER, "benchmarks the draw surface sort on the captured draw surfaces, usage: testDrawSurfSort [copies] [iterations]" );
+	cmdSystem->AddCommand( "testTraceBVH", R_TestTraceBVH_f, CMD_FL_RENDERER, "compares brute force and hierarchy traces on the static surfaces of the current map, usage: testTraceBVH [raysPerSurface] [radius]" );
+	cmdSystem->AddCommand( "testSilEdges", R_TestSilEdges_f, CMD_FL_RENDERER, "compares the original and current silhouette edge creation on the static surfaces of the current map or, with all, of every preloaded model, usage: testSilEdges [numLargest] [all]" );
 }
 
 /*
@@ -2270,6 +2285,15 @@ void idRenderSystemLocal::LoadLevelImages() {
 	globalImages->LoadLevelImages( false );
 }
 
+/*
+========================
+idRenderSystemLocal::SuspendImageStreaming
+========================
+*/
+void idRenderSystemLocal::SuspendImageStreaming() {
+	globalImages->SuspendStreaming();
+}
+
 /*
 ========================
 idRenderSystemLocal::Preload
@@ -139,9 +139,7 @@ idRenderWorldLocal::idRenderWorldLocal() {
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
 
-	interactionTable = 0;
-	interactionTableWidth = 0;
-	interactionTableHeight = 0;
+	ClearPortalFloodCache();
 
 	for ( int i = 0; i < decals.Num(); i++ ) {
 		decals[i].entityHandle = -1;
@@ -179,34 +177,6 @@ idRenderWorldLocal::~idRenderWorldLocal() {
 	RB_ClearDebugText( 0 );
 }
 
-/*
-===================
-ResizeInteractionTable
-===================
-*/
-void idRenderWorldLocal::ResizeInteractionTable() {
-	// we overflowed the interaction table, so make it larger
-	common->Printf( "idRenderWorldLocal::ResizeInteractionTable: overflowed interactionTable, resizing\n" );
-
-	const int oldInteractionTableWidth = interactionTableWidth;
-	const int oldIinteractionTableHeight = interactionTableHeight;
-	idInteraction ** oldInteractionTable = interactionTable;
-
-	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 100;
-	interactionTableHeight = lightDefs.Num() + 100;
-	const int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = (idInteraction **)R_ClearedStaticAlloc( size );
-	for ( int l = 0; l < oldIinteractionTableHeight; l++ ) {
-		for ( int e = 0; e < oldInteractionTableWidth; e++ ) {
-			interactionTable[ l * interactionTableWidth + e ] = oldInteractionTable[ l * oldInteractionTableWidth + e ];
-		}
-	}
-
-	R_StaticFree( oldInteractionTable );
-}
-
 /*
 ===================
 AddEntityDef
@@ -217,10 +187,6 @@ qhandle_t idRenderWorldLocal::AddEntityDef( const renderEntity_t *re ){
 	int entityHandle = entityDefs.FindNull();
 	if ( entityHandle == -1 ) {
 		entityHandle = entityDefs.Append( NULL );
-
-		if ( interactionTable && entityDefs.Num() > interactionTableWidth ) {
-			ResizeInteractionTable();
-		}
 	}
 
 	UpdateEntityDef( entityHandle, re );
@@ -401,9 +367,6 @@ qhandle_t idRenderWorldLocal::AddLightDef( const renderLight_t *rlight ) {
 
 	if ( lightHandle == -1 ) {
 		lightHandle = lightDefs.Append( NULL );
-		if ( interactionTable && lightDefs.Num() > interactionTableHeight ) {
-			ResizeInteractionTable();
-		}
 	}
 	UpdateLightDef( lightHandle, rlight );
 
@@ -1540,13 +1503,6 @@ void idRenderWorldLocal::GenerateAllInteractions() {
 	// try and do any view specific optimizations
 	tr.viewDef = NULL;
 
-	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 100;
-	interactionTableHeight = lightDefs.Num() + 100;
-	int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = (idInteraction **)R_ClearedStaticAlloc( size );
-
 	// itterate through all lights
 	int	count = 0;
 	for ( int i = 0; i < this->lightDefs.Num(); i++ ) {
@@ -1581,7 +1537,7 @@ void idRenderWorldLocal::GenerateAllInteractions() {
 				}
 
 				// make an interaction for this light / entity pair
-				// and add a pointer to it in the table
+				// and add a pointer to it in the light's interaction index
 				inter = idInteraction::AllocAndLink( edef, ldef );
 				count++;
 
@@ -1596,8 +1552,15 @@ void idRenderWorldLocal::GenerateAllInteractions() {
 	int end = Sys_Milliseconds();
 	int	msec = end - start;
 
+	size_t size = 0;
+	for ( int i = 0; i < this->lightDefs.Num(); i++ ) {
+		if ( this->lightDefs[i] != NULL ) {
+			size += this->lightDefs[i]->interactionIndex.Allocated();
+		}
+	}
+
 	common->Printf( "idRenderWorld::GenerateAllInteractions, msec = %i\n", msec );
-	common->Printf( "interactionTable size: %i bytes\n", size );
+	common->Printf( "interaction index size: %i bytes\n", (int)size );
 	common->Printf( "%i interactions take %i bytes\n", count, count * sizeof( idInteraction ) );
 
 	// entities flagged as noDynamicInteractions will no longer make any
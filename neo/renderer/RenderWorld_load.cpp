@@ -41,6 +41,9 @@ void idRenderWorldLocal::FreeWorld() {
 	// this will free all the lightDefs and entityDefs
 	FreeDefs();
 
+	// the cached floods reference the old areas
+	ClearPortalFloodCache();
+
 	// free all the portals and check light/model references
 	for ( int i = 0; i < numPortalAreas; i++ ) {
 		portalArea_t	*area;
@@ -123,12 +126,137 @@ idRenderModel *idRenderWorldLocal::ReadBinaryModel( idFile *fileIn ) {
 
 extern idCVar r_binaryLoadRenderModels;
 
+// models in a .proc file are parsed in order, but their texture coordinates are
+// centered and their surfaces cleaned up in parallel on the job system
+struct procModel_t {
+	idRenderModel *		model;
+	idList< float * >	surfaceVerts;		// 8 floats per vertex for each surface: xyz, st, normal
+	idFile *			fileOut;			// the binary model is written here once it is finished
+	ID_TIME_T			mapTimeStamp;
+};
+
+idCVar r_parallelMapLoad( "r_parallelMapLoad", "1", CVAR_RENDERER | CVAR_BOOL, "clean up the models of a .proc file in parallel on the job system" );
+
+/*
+================
+R_CenterIslandTexCoords
+
+Centers the texture coordinates of each connected island of triangles for maximum 16-bit precision.
+================
+*/
+static void R_CenterIslandTexCoords( const srfTriangles_t *tri, float *verts ) {
+	const triIndex_t * indexes = tri->indexes;
+
+	// find the island that each vertex belongs to
+	idTempArray<int> vertIslands( tri->numVerts );
+	idTempArray<bool> trisVisited( tri->numIndexes );
+	vertIslands.Zero();
+	trisVisited.Zero();
+	int numIslands = 0;
+	for ( int j = 0; j < tri->numIndexes; j += 3 ) {
+		if ( trisVisited[j] ) {
+			continue;
+		}
+
+		int islandNum = ++numIslands;
+		vertIslands[indexes[j + 0]] = islandNum;
+		vertIslands[indexes[j + 1]] = islandNum;
+		vertIslands[indexes[j + 2]] = islandNum;
+		trisVisited[j] = true;
+
+		idList<int> queue;
+		queue.Append( j );
+		for ( int n = 0; n < queue.Num(); n++ ) {
+			int t = queue[n];
+			for ( int k = 0; k < tri->numIndexes; k += 3 ) {
+				if ( trisVisited[k] ) {
+					continue;
+				}
+				bool connected =	indexes[t + 0] == indexes[k + 0] || indexes[t + 0] == indexes[k + 1] || indexes[t + 0] == indexes[k + 2] ||
+									indexes[t + 1] == indexes[k + 0] || indexes[t + 1] == indexes[k + 1] || indexes[t + 1] == indexes[k + 2] ||
+									indexes[t + 2] == indexes[k + 0] || indexes[t + 2] == indexes[k + 1] || indexes[t + 2] == indexes[k + 2];
+				if ( connected ) {
+					vertIslands[indexes[k + 0]] = islandNum;
+					vertIslands[indexes[k + 1]] = islandNum;
+					vertIslands[indexes[k + 2]] = islandNum;
+					trisVisited[k] = true;
+					queue.Append( k );
+				}
+			}
+		}
+	}
+
+	// center the texture coordinates for each island for maximum 16-bit precision
+	for ( int j = 1; j <= numIslands; j++ ) {
+		float minS = idMath::INFINITY;
+		float minT = idMath::INFINITY;
+		float maxS = -idMath::INFINITY;
+		float maxT = -idMath::INFINITY;
+		for ( int k = 0; k < tri->numVerts; k++ ) {
+			if ( vertIslands[k] == j ) {
+				minS = Min( minS, verts[k * 8 + 3] );
+				maxS = Max( maxS, verts[k * 8 + 3] );
+				minT = Min( minT, verts[k * 8 + 4] );
+				maxT = Max( maxT, verts[k * 8 + 4] );
+			}
+		}
+		const float averageS = idMath::Ftoi( ( minS + maxS ) * 0.5f );
+		const float averageT = idMath::Ftoi( ( minT + maxT ) * 0.5f );
+		for ( int k = 0; k < tri->numVerts; k++ ) {
+			if ( vertIslands[k] == j ) {
+				verts[k * 8 + 3] -= averageS;
+				verts[k * 8 + 4] -= averageT;
+			}
+		}
+	}
+}
+
+/*
+================
+R_FinishProcModel
+
+Only touches the model and its own output file, so any number of these can run in parallel.
+================
+*/
+static void R_FinishProcModel( procModel_t *procModel ) {
+	idRenderModel * model = procModel->model;
+
+	for ( int i = 0; i < procModel->surfaceVerts.Num(); i++ ) {
+		srfTriangles_t * tri = model->Surface( i )->geometry;
+		float * verts = procModel->surfaceVerts[i];
+
+		R_CenterIslandTexCoords( tri, verts );
+
+		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+		for ( int j = 0; j < tri->numVerts; j++ ) {
+			tri->verts[j].xyz[0] = verts[j * 8 + 0];
+			tri->verts[j].xyz[1] = verts[j * 8 + 1];
+			tri->verts[j].xyz[2] = verts[j * 8 + 2];
+			tri->verts[j].SetTexCoord( verts[j * 8 + 3], verts[j * 8 + 4] );
+			tri->verts[j].SetNormal( verts[j * 8 + 5], verts[j * 8 + 6], verts[j * 8 + 7] );
+		}
+
+		Mem_Free( verts );
+	}
+	procModel->surfaceVerts.Clear();
+
+	model->FinishSurfaces();
+
+	if ( procModel->fileOut != NULL && model->SupportsBinaryModel() && r_binaryLoadRenderModels.GetBool() ) {
+		model->WriteBinaryModel( procModel->fileOut, &procModel->mapTimeStamp );
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_FinishProcModel, "R_FinishProcModel" );
+
 /*
 ================
 idRenderWorldLocal::ParseModel
+
+The returned model still has to be finished with R_FinishProcModel.
 ================
 */
-idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src, const char *mapName, ID_TIME_T mapTimeStamp, idFile *fileOut ) {
+procModel_t *idRenderWorldLocal::ParseModel( idLexer *src, const char *mapName, ID_TIME_T mapTimeStamp, idFile *fileOut ) {
 	idToken token;
 
 	src->ExpectTokenString( "{" );
@@ -136,8 +264,11 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src, const char *mapName
 	// parse the name
 	src->ExpectAnyToken( &token );
 
-	idRenderModel * model = renderModelManager->AllocModel();
-	model->InitEmpty( token );
+	procModel_t * procModel = new (TAG_RENDER) procModel_t;
+	procModel->model = renderModelManager->AllocModel();
+	procModel->model->InitEmpty( token );
+	procModel->fileOut = fileOut;
+	procModel->mapTimeStamp = mapTimeStamp;
 
 	if ( fileOut != NULL ) {
 		// write out the type so the binary reader knows what to instantiate
@@ -166,111 +297,27 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src, const char *mapName
 		tri->numVerts = src->ParseInt();
 		tri->numIndexes = src->ParseInt();
 
-		// parse the vertices
-		idTempArray<float> verts( tri->numVerts * 8 );
+		// parse the vertices, they are converted to idDrawVerts once the texture coordinates are centered
+		float * verts = (float *)Mem_Alloc( tri->numVerts * 8 * sizeof( float ), TAG_RENDER );
 		for ( int j = 0; j < tri->numVerts; j++ ) {
 			src->Parse1DMatrix( 8, &verts[j * 8] );
 		}
+		procModel->surfaceVerts.Append( verts );
 
 		// parse the indices
-		idTempArray<triIndex_t> indexes( tri->numIndexes );
-		for ( int j = 0; j < tri->numIndexes; j++ ) {
-			indexes[j] = src->ParseInt();
-		}
-
-#if 1
-		// find the island that each vertex belongs to
-		idTempArray<int> vertIslands( tri->numVerts );
-		idTempArray<bool> trisVisited( tri->numIndexes );
-		vertIslands.Zero();
-		trisVisited.Zero();
-		int numIslands = 0;
-		for ( int j = 0; j < tri->numIndexes; j += 3 ) {
-			if ( trisVisited[j] ) {
-				continue;
-			}
-
-			int islandNum = ++numIslands;
-			vertIslands[indexes[j + 0]] = islandNum;
-			vertIslands[indexes[j + 1]] = islandNum;
-			vertIslands[indexes[j + 2]] = islandNum;
-			trisVisited[j] = true;
-
-			idList<int> queue;
-			queue.Append( j );
-			for ( int n = 0; n < queue.Num(); n++ ) {
-				int t = queue[n];
-				for ( int k = 0; k < tri->numIndexes; k += 3 ) {
-					if ( trisVisited[k] ) {
-						continue;
-					}
-					bool connected =	indexes[t + 0] == indexes[k + 0] || indexes[t + 0] == indexes[k + 1] || indexes[t + 0] == indexes[k + 2] ||
-										indexes[t + 1] == indexes[k + 0] || indexes[t + 1] == indexes[k + 1] || indexes[t + 1] == indexes[k + 2] ||
-										indexes[t + 2] == indexes[k + 0] || indexes[t + 2] == indexes[k + 1] || indexes[t + 2] == indexes[k + 2];
-					if ( connected ) {
-						vertIslands[indexes[k + 0]] = islandNum;
-						vertIslands[indexes[k + 1]] = islandNum;
-						vertIslands[indexes[k + 2]] = islandNum;
-						trisVisited[k] = true;
-						queue.Append( k );
-					}
-				}
-			}
-		}
-
-		// center the texture coordinates for each island for maximum 16-bit precision
-		for ( int j = 1; j <= numIslands; j++ ) {
-			float minS = idMath::INFINITY;
-			float minT = idMath::INFINITY;
-			float maxS = -idMath::INFINITY;
-			float maxT = -idMath::INFINITY;
-			for ( int k = 0; k < tri->numVerts; k++ ) {
-				if ( vertIslands[k] == j ) {
-					minS = Min( minS, verts[k * 8 + 3] );
-					maxS = Max( maxS, verts[k * 8 + 3] );
-					minT = Min( minT, verts[k * 8 + 4] );
-					maxT = Max( maxT, verts[k * 8 + 4] );
-				}
-			}
-			const float averageS = idMath::Ftoi( ( minS + maxS ) * 0.5f );
-			const float averageT = idMath::Ftoi( ( minT + maxT ) * 0.5f );
-			for ( int k = 0; k < tri->numVerts; k++ ) {
-				if ( vertIslands[k] == j ) {
-					verts[k * 8 + 3] -= averageS;
-					verts[k * 8 + 4] -= averageT;
-				}
-			}
-		}
-#endif
-
-		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
-		for ( int j = 0; j < tri->numVerts; j++ ) {
-			tri->verts[j].xyz[0] = verts[j * 8 + 0];
-			tri->verts[j].xyz[1] = verts[j * 8 + 1];
-			tri->verts[j].xyz[2] = verts[j * 8 + 2];
-			tri->verts[j].SetTexCoord( verts[j * 8 + 3], verts[j * 8 + 4] );
-			tri->verts[j].SetNormal( verts[j * 8 + 5], verts[j * 8 + 6], verts[j * 8 + 7] );
-		}
-
 		R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
 		for ( int j = 0; j < tri->numIndexes; j++ ) {
-			tri->indexes[j] = indexes[j];
+			tri->indexes[j] = src->ParseInt();
 		}
 		src->ExpectTokenString( "}" );
 
 		// add the completed surface to the model
-		model->AddSurface( surf );
+		procModel->model->AddSurface( surf );
 	}
 
 	src->ExpectTokenString( "}" );
 
-	model->FinishSurfaces();
-
-	if ( fileOut != NULL && model->SupportsBinaryModel() && r_binaryLoadRenderModels.GetBool() ) {
-		model->WriteBinaryModel( fileOut, &mapTimeStamp );
-	}
-
-	return model;
+	return procModel;
 }
 
 /*
@@ -678,11 +725,6 @@ dump all the interactions
 void idRenderWorldLocal::FreeDefs() {
 	generateAllInteractionsCalled = false;
 
-	if ( interactionTable ) {
-		R_StaticFree( interactionTable );
-		interactionTable = NULL;
-	}
-
 	// free all lightDefs
 	for ( int i = 0; i < lightDefs.Num(); i++ ) {
 		idRenderLightLocal * light = lightDefs[i];
@@ -712,6 +754,65 @@ void idRenderWorldLocal::FreeDefs() {
 	}
 }
 
+/*
+=================
+AddLoadStageTime
+=================
+*/
+static int AddLoadStageTime( const char *stage, int stageStart ) {
+	const int now = Sys_Milliseconds();
+	common->AddLevelLoadTime( stage, now - stageStart );
+	return now;
+}
+
+static const byte BPROC_VERSION = 2;
+static const unsigned int BPROC_MAGIC = ( 'P' << 24 ) | ( 'R' << 16 ) | ( 'O' << 8 ) | BPROC_VERSION;
+
+/*
+=================
+R_PadBinaryProc
+
+The header and every entry of a .bproc start on a 16 byte boundary. Entries are
+written to their own memory file first, so this keeps the tri array blocks they
+align relative to the start of the entry aligned in the .bproc as well.
+=================
+*/
+static void R_PadBinaryProc( idFile *file ) {
+	static const byte zeros[16] = {};
+	const int offset = file->Tell();
+	file->Write( zeros, ALIGN( offset, 16 ) - offset );
+}
+
+/*
+=================
+R_SkipBinaryProcPadding
+=================
+*/
+static void R_SkipBinaryProcPadding( idFile *file ) {
+	const int offset = file->Tell();
+	if ( ALIGN( offset, 16 ) != offset ) {
+		file->Seek( ALIGN( offset, 16 ) - offset, FS_SEEK_CUR );
+	}
+}
+
+/*
+=================
+R_WriteBinaryProc
+=================
+*/
+static void R_WriteBinaryProc( idFile *file, const char *mapName, ID_TIME_T mapTimeStamp, const idList< idFile_Memory * > & entryFiles ) {
+	int magic = BPROC_MAGIC;
+	file->WriteBig( magic );
+	file->WriteBig( entryFiles.Num() );
+	file->WriteString( mapName );
+	file->WriteBig( mapTimeStamp );
+	R_PadBinaryProc( file );
+	for ( int i = 0; i < entryFiles.Num(); i++ ) {
+		file->Write( entryFiles[i]->GetDataPtr(), entryFiles[i]->Length() );
+		R_PadBinaryProc( file );
+	}
+}
+
 /*
 =================
 idRenderWorldLocal::InitFromMap
@@ -758,11 +859,13 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		common->Printf( "idRenderWorldLocal::InitFromMap: timestamp has changed, reloading.\n" );
 	}
 
+	int stageStart = Sys_Milliseconds();
+
 	FreeWorld();
 
+	stageStart = AddLoadStageTime( "render world: free previous map", stageStart );
+
 	// see if we have a generated version of this 
-	static const byte BPROC_VERSION = 1;
-	static const unsigned int BPROC_MAGIC = ( 'P' << 24 ) | ( 'R' << 16 ) | ( 'O' << 8 ) | BPROC_VERSION;
 	bool loaded = false;
 	idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
 	if ( file != NULL ) {
@@ -773,6 +876,7 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 			file->ReadBig( numEntries );
 			file->ReadString( mapName );
 			file->ReadBig( mapTimeStamp );
+			R_SkipBinaryProcPadding( file );
 			loaded = true;
 			for ( int i = 0; i < numEntries; i++ ) {
 				idStrStatic< MAX_OSPATH > type;
@@ -801,8 +905,10 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 				} else {
 					idLib::Error( "Binary proc file failed, unexpected type %s\n", type.c_str() );
 				}
+				R_SkipBinaryProcPadding( file );
 			}
 		}
+		stageStart = AddLoadStageTime( "render world: read .bproc", stageStart );
 	}
 
 	if ( !loaded ) {
@@ -829,15 +935,11 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 			return false;
 		}
 			
-		int numEntries = 0;
+		// every entry is written to its own memory file, so the models can be finished
+		// in any order and the generated file still follows the order of the .proc file
 		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
-		if ( outputFile != NULL ) {
-			int magic = BPROC_MAGIC;
-			outputFile->WriteBig( magic );
-			outputFile->WriteBig( numEntries );
-			outputFile->WriteString( mapName );
-			outputFile->WriteBig( mapTimeStamp );
-		}
+		idList< idFile_Memory * > entryFiles;
+		idList< procModel_t * > procModels;
 
 		// parse the file
 		while ( 1 ) {
@@ -847,9 +949,16 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 			common->UpdateLevelLoadPacifier();
 
+			idFile_Memory * entryFile = NULL;
+			if ( outputFile != NULL ) {
+				entryFile = new (TAG_RENDER) idFile_Memory( generatedFileName );
+				entryFiles.Append( entryFile );
+			}
 
 			if ( token == "model" ) {
-				lastModel = ParseModel( src, name, currentTimeStamp, outputFile );
+				procModel_t * procModel = ParseModel( src, name, currentTimeStamp, entryFile );
+				procModels.Append( procModel );
+				lastModel = procModel->model;
 
 				// add it to the model manager list
 				renderModelManager->AddModel( lastModel );
@@ -857,13 +966,11 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 				// save it in the list to free when clearing this map
 				localModels.Append( lastModel );
 
-				numEntries++;
-
 				continue;
 			}
 
 			if ( token == "shadowModel" ) {
-				lastModel = ParseShadowModel( src, outputFile );
+				lastModel = ParseShadowModel( src, entryFile );
 
 				// add it to the model manager list
 				renderModelManager->AddModel( lastModel );
@@ -871,21 +978,18 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 				// save it in the list to free when clearing this map
 				localModels.Append( lastModel );
 
-				numEntries++;
 				continue;
 			}
 
 			if ( token == "interAreaPortals" ) {
-				ParseInterAreaPortals( src, outputFile );
+				ParseInterAreaPortals( src, entryFile );
 
-				numEntries++;
 				continue;
 			}
 
 			if ( token == "nodes" ) {
-				ParseNodes( src, outputFile );
+				ParseNodes( src, entryFile );
 
-				numEntries++;
 				continue;
 			}
 
@@ -894,13 +998,37 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 		delete src;
 
-		if ( outputFile != NULL ) {
-			outputFile->Seek( 0, FS_SEEK_SET );
-			int magic = BPROC_MAGIC;
-			outputFile->WriteBig( magic );
-			outputFile->WriteBig( numEntries );
+		stageStart = AddLoadStageTime( "render world: parse .proc", stageStart );
+
+		// center the texture coordinates and clean up the surfaces of all models
+		if ( r_parallelMapLoad.GetBool() && procModels.Num() > 1 ) {
+			idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, procModels.Num(), 0, NULL );
+			for ( int i = 0; i < procModels.Num(); i++ ) {
+				jobList->AddJob( (jobRun_t)R_FinishProcModel, procModels[i] );
+			}
+			jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+			// keep the load screen alive while the models are finished
+			while ( !jobList->TryWait() ) {
+				common->UpdateLevelLoadPacifier();
+				Sys_Yield();
+			}
+			parallelJobManager->FreeJobList( jobList );
+		} else {
+			for ( int i = 0; i < procModels.Num(); i++ ) {
+				common->UpdateLevelLoadPacifier();
+				R_FinishProcModel( procModels[i] );
+			}
 		}
+		procModels.DeleteContents( true );
 
+		stageStart = AddLoadStageTime( "render world: finish models", stageStart );
+
+		if ( outputFile != NULL ) {
+			R_WriteBinaryProc( outputFile, mapName, mapTimeStamp, entryFiles );
+
+			stageStart = AddLoadStageTime( "render world: write .bproc", stageStart );
+		}
+		entryFiles.DeleteContents( true );
 	}
 
 
@@ -916,6 +1044,8 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	AddWorldModelEntities();
 	ClearPortalStates();
 
+	AddLoadStageTime( "render world: area entities", stageStart );
+
 	// done!
 	return true;
 }
@@ -1028,4 +1158,86 @@ ResetLocalRenderModels
 */
 void idRenderWorldLocal::ResetLocalRenderModels() {
 	localModels.Clear();	// Clear out the list when switching between expansion packs, so InitFromMap doesn't try to delete the list whose content has already been deleted by the model manager being re-started
-}
\ No newline at end of file
+}
+/*
+=====================
+testBinaryProc
+
+Writes a .bproc with tri array blocks to memory the same way InitFromMap does and
+reads it back, so a mismatch in the padding between the writer and the reader shows up.
+=====================
+*/
+CONSOLE_COMMAND( testBinaryProc, "writes a .bproc with tri array blocks to memory and reads it back", 0 ) {
+	const int numEntries = 5;
+	idList< idFile_Memory * > entryFiles;
+	idList< idDrawVert > verts[numEntries];
+	idList< triIndex_t > indexes[numEntries];
+
+	// entries of different lengths with names of different lengths, so the
+	// entries don't start on a 16 byte boundary in the .bproc without padding
+	for ( int i = 0; i < numEntries; i++ ) {
+		const int numVerts = 3 + i * 5;
+		verts[i].SetNum( numVerts );
+		for ( int j = 0; j < numVerts; j++ ) {
+			verts[i][j].Clear();
+			verts[i][j].xyz.Set( (float) i, (float) j, (float) ( i * j ) );
+		}
+		indexes[i].SetNum( numVerts * 3 );
+		for ( int j = 0; j < indexes[i].Num(); j++ ) {
+			indexes[i][j] = (triIndex_t) ( ( j * 7 ) % numVerts );
+		}
+
+		triArrayBlock_t layout;
+		R_TriArrayBlockLayout( layout, verts[i].Num(), true, indexes[i].Num(), false, 0, 0, 0, false );
+
+		const void * arrays[TRI_ARRAY_COUNT] = {};
+		arrays[TRI_ARRAY_VERTS] = verts[i].Ptr();
+		arrays[TRI_ARRAY_INDEXES] = indexes[i].Ptr();
+
+		idFile_Memory * entryFile = new (TAG_RENDER) idFile_Memory( "testBinaryProc" );
+		entryFile->WriteString( va( "entry%d", i * 37 ) );
+		R_WriteTriArrayBlock( entryFile, layout, arrays );
+		entryFiles.Append( entryFile );
+	}
+
+	idFile_Memory bprocFile( "generated/testBinaryProc.bproc" );
+	R_WriteBinaryProc( &bprocFile, "maps/testBinaryProc", 0, entryFiles );
+	entryFiles.DeleteContents( true );
+
+	idFile_Memory file( "generated/testBinaryProc.bproc", bprocFile.GetDataPtr(), bprocFile.Length() );
+	int magic = 0;
+	int numRead = 0;
+	idStr mapName;
+	ID_TIME_T mapTimeStamp = 0;
+	file.ReadBig( magic );
+	file.ReadBig( numRead );
+	file.ReadString( mapName );
+	file.ReadBig( mapTimeStamp );
+	R_SkipBinaryProcPadding( &file );
+
+	int numFailed = 0;
+	if ( magic != BPROC_MAGIC || numRead != numEntries ) {
+		numFailed = numEntries;
+	} else {
+		for ( int i = 0; i < numEntries; i++ ) {
+			idStr name;
+			file.ReadString( name );
+
+			triArrayBlock_t layout;
+			R_TriArrayBlockLayout( layout, verts[i].Num(), true, indexes[i].Num(), false, 0, 0, 0, false );
+
+			byte * block = NULL;
+			if ( !R_ReadTriArrayBlock( &file, layout, &block ) ||
+					memcmp( layout.Array( block, TRI_ARRAY_VERTS ), verts[i].Ptr(), layout.sizes[TRI_ARRAY_VERTS] ) != 0 ||
+						memcmp( layout.Array( block, TRI_ARRAY_INDEXES ), indexes[i].Ptr(), layout.sizes[TRI_ARRAY_INDEXES] ) != 0 ) {
+				numFailed++;
+			}
+			if ( block != NULL ) {
+				Mem_Free( block );
+			}
+			R_SkipBinaryProcPadding( &file );
+		}
+	}
+
+	idLib::Printf( "testBinaryProc: %d bytes, %d of %d entries read back %s\n", bprocFile.Length(), numEntries - numFailed, numEntries, numFailed ? "FAILED" : "ok" );
+}
@@ -89,6 +89,38 @@ struct reusableOverlay_t {
 };
 
 struct portalStack_t;
+struct procModel_t;
+
+// an area reached by a view flood, with the portal stack planes and scissor rect it was reached with
+struct portalFloodVisit_t {
+	int						areaNum;
+	int						firstPlane;				// in portalFloodCacheEntry_t::visitPlanes
+	int						numPortalPlanes;
+	idScreenRect			rect;
+};
+
+// views that repeat with the same inputs and portal states, like static subviews and cameras,
+// replay the recorded visits instead of clipping the portal windings again
+static const int			MAX_PORTAL_FLOOD_VIEW_PLANES = 6;
+
+struct portalFloodCacheEntry_t {
+	uint64					key;					// view area and quantized origin, to reject most entries quickly
+	int						connectedAreaNum;		// portal state generation the flood was made with
+	int						lastUsedViewCount;		// for least recently used replacement
+	bool					valid;
+
+	// the exact inputs of the flood
+	idVec3					origin;
+	int						numPlanes;
+	idPlane					planes[MAX_PORTAL_FLOOD_VIEW_PLANES];
+	idScreenRect			scissor;
+	idScreenRect			viewport;
+	float					modelViewMatrix[16];
+	float					projectionMatrix[16];
+
+	idList<portalFloodVisit_t, TAG_RENDER>	visits;
+	idList<idPlane, TAG_RENDER>				visitPlanes;
+};
 
 class idRenderWorldLocal : public idRenderWorld {
 public:
@@ -163,6 +195,10 @@ public:
 
 	idScreenRect *			areaScreenRect;
 
+	static const int		PORTAL_FLOOD_CACHE_SIZE = 16;
+	portalFloodCacheEntry_t	portalFloodCache[PORTAL_FLOOD_CACHE_SIZE];
+	portalFloodCacheEntry_t *	portalFloodRecord;	// set while FloodViewThroughArea_r records into the cache
+
 	doublePortal_t *		doublePortals;
 	int						numInterAreaPortals;
 
@@ -182,21 +218,15 @@ public:
 	idArray<reusableDecal_t, MAX_DECAL_SURFACES>	decals;
 	idArray<reusableOverlay_t, MAX_DECAL_SURFACES>	overlays;
 
-	// all light / entity interactions are referenced here for fast lookup without
-	// having to crawl the doubly linked lists.  EnntityDefs are sequential for better
-	// cache access, because the table is accessed by light in idRenderWorldLocal::CreateLightDefInteractions()
-	// Growing this table is time consuming, so we add a pad value to the number
-	// of entityDefs and lightDefs
-	idInteraction **		interactionTable;
-	int						interactionTableWidth;		// entityDefs
-	int						interactionTableHeight;		// lightDefs
+	// all light / entity interactions are referenced from the sparse interactionIndex
+	// of each lightDef for fast lookup without having to crawl the doubly linked lists
 
 	bool					generateAllInteractionsCalled;
 
 	//-----------------------
 	// RenderWorld_load.cpp
 
-	idRenderModel *			ParseModel( idLexer *src, const char *mapName, ID_TIME_T mapTimeStamp, idFile *fileOut );
+	procModel_t *			ParseModel( idLexer *src, const char *mapName, ID_TIME_T mapTimeStamp, idFile *fileOut );
 	idRenderModel *			ParseShadowModel( idLexer *src, idFile *fileOut );
 	void					SetupAreaRefs();
 	void					ParseInterAreaPortals( idLexer *src, idFile *fileOut );
@@ -225,6 +255,10 @@ public:
 	bool					PortalIsFoggedOut( const portal_t *p );
 	void					FloodViewThroughArea_r( const idVec3 & origin, int areaNum, const portalStack_t *ps );
 	void					FlowViewThroughPortals( const idVec3 & origin, int numPlanes, const idPlane *planes );
+	portalFloodCacheEntry_t *	FindPortalFloodCacheEntry( uint64 key, const idVec3 & origin, int numPlanes, const idPlane *planes );
+	portalFloodCacheEntry_t *	AllocPortalFloodCacheEntry( uint64 key, const idVec3 & origin, int numPlanes, const idPlane *planes );
+	void					ReplayPortalFlood( const portalFloodCacheEntry_t * entry );
+	void					ClearPortalFloodCache();
 	void					BuildConnectedAreas_r( int areaNum );
 	void					BuildConnectedAreas();
 	void					FindViewLightsAndEntities();
@@ -262,8 +296,6 @@ public:
 	//--------------------------
 	// RenderWorld.cpp
 
-	void					ResizeInteractionTable();
-
 	void					AddEntityRefToArea( idRenderEntityLocal *def, portalArea_t *area );
 	void					AddLightRefToArea( idRenderLightLocal *light, portalArea_t *area );
 
@@ -286,7 +318,7 @@ public:
 };
 
 // if an entity / light combination has been evaluated and found to not genrate any surfaces or shadows,
-// the constant INTERACTION_EMPTY will be stored in the interaction table, int contrasts to NULL, which
+// the constant INTERACTION_EMPTY will be stored in the interaction index, int contrasts to NULL, which
 // means that the combination has not yet been tested for having surfaces.
 static idInteraction * const INTERACTION_EMPTY = (idInteraction *)1;
 
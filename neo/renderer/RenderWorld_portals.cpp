@@ -455,6 +455,17 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 & origin, int area
 	// cull models and lights to the current collection of planes
 	AddAreaToView( areaNum, ps );
 
+	if ( portalFloodRecord != NULL ) {
+		portalFloodVisit_t & visit = portalFloodRecord->visits.Alloc();
+		visit.areaNum = areaNum;
+		visit.firstPlane = portalFloodRecord->visitPlanes.Num();
+		visit.numPortalPlanes = ps->numPortalPlanes;
+		visit.rect = ps->rect;
+		for ( int i = 0; i < ps->numPortalPlanes; i++ ) {
+			portalFloodRecord->visitPlanes.Append( ps->portalPlanes[i] );
+		}
+	}
+
 	if ( areaScreenRect[areaNum].IsEmpty() ) {
 		areaScreenRect[areaNum] = ps->rect;
 	} else {
@@ -511,6 +522,11 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 & origin, int area
 			continue;	// portal not visible
 		}
 
+		// the fog density changes with time and the view, so the flood can't be reused
+		if ( portalFloodRecord != NULL && p->doublePortal->fogLight != NULL ) {
+			portalFloodRecord->valid = false;
+		}
+
 		// see if it is fogged out
 		if ( PortalIsFoggedOut( p ) ) {
 			continue;
@@ -565,6 +581,122 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 & origin, int area
 	}
 }
 
+/*
+=======================
+idRenderWorldLocal::FindPortalFloodCacheEntry
+
+Returns the entry that was flooded with exactly the same view inputs and
+portal states, or NULL.
+=======================
+*/
+portalFloodCacheEntry_t * idRenderWorldLocal::FindPortalFloodCacheEntry( uint64 key, const idVec3 & origin, int numPlanes, const idPlane *planes ) {
+	for ( int i = 0; i < PORTAL_FLOOD_CACHE_SIZE; i++ ) {
+		portalFloodCacheEntry_t & entry = portalFloodCache[i];
+		if ( !entry.valid || entry.key != key || entry.connectedAreaNum != connectedAreaNum ) {
+			continue;
+		}
+		if ( entry.numPlanes != numPlanes || !entry.origin.Compare( origin ) ) {
+			continue;
+		}
+		if ( memcmp( entry.planes, planes, numPlanes * sizeof( planes[0] ) ) != 0 ) {
+			continue;
+		}
+		if ( memcmp( &entry.scissor, &tr.viewDef->scissor, sizeof( entry.scissor ) ) != 0 ||
+				memcmp( &entry.viewport, &tr.viewDef->viewport, sizeof( entry.viewport ) ) != 0 ) {
+			continue;
+		}
+		if ( memcmp( entry.modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( entry.modelViewMatrix ) ) != 0 ||
+				memcmp( entry.projectionMatrix, tr.viewDef->projectionMatrix, sizeof( entry.projectionMatrix ) ) != 0 ) {
+			continue;
+		}
+		return &entry;
+	}
+	return NULL;
+}
+
+/*
+=======================
+idRenderWorldLocal::AllocPortalFloodCacheEntry
+
+Reuses the least recently used entry and stores the view inputs, the visits
+are recorded by FloodViewThroughArea_r.
+=======================
+*/
+portalFloodCacheEntry_t * idRenderWorldLocal::AllocPortalFloodCacheEntry( uint64 key, const idVec3 & origin, int numPlanes, const idPlane *planes ) {
+	portalFloodCacheEntry_t * entry = &portalFloodCache[0];
+	for ( int i = 1; i < PORTAL_FLOOD_CACHE_SIZE; i++ ) {
+		if ( !entry->valid ) {
+			break;
+		}
+		if ( !portalFloodCache[i].valid || portalFloodCache[i].lastUsedViewCount < entry->lastUsedViewCount ) {
+			entry = &portalFloodCache[i];
+		}
+	}
+
+	entry->key = key;
+	entry->connectedAreaNum = connectedAreaNum;
+	entry->lastUsedViewCount = tr.viewCount;
+	entry->valid = true;
+
+	entry->origin = origin;
+	entry->numPlanes = numPlanes;
+	memcpy( entry->planes, planes, numPlanes * sizeof( planes[0] ) );
+	entry->scissor = tr.viewDef->scissor;
+	entry->viewport = tr.viewDef->viewport;
+	memcpy( entry->modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( entry->modelViewMatrix ) );
+	memcpy( entry->projectionMatrix, tr.viewDef->projectionMatrix, sizeof( entry->projectionMatrix ) );
+
+	entry->visits.SetNum( 0 );
+	entry->visitPlanes.SetNum( 0 );
+
+	return entry;
+}
+
+/*
+=======================
+idRenderWorldLocal::ReplayPortalFlood
+
+Adds the areas of a cached flood to the view in the same order the flood reached them,
+so the viewEntity / viewLight lists and scissor rects come out the same.
+=======================
+*/
+void idRenderWorldLocal::ReplayPortalFlood( const portalFloodCacheEntry_t * entry ) {
+	portalStack_t ps;
+	ps.next = NULL;
+	ps.p = NULL;
+
+	for ( int i = 0; i < entry->visits.Num(); i++ ) {
+		const portalFloodVisit_t & visit = entry->visits[i];
+
+		ps.numPortalPlanes = visit.numPortalPlanes;
+		memcpy( ps.portalPlanes, &entry->visitPlanes[visit.firstPlane], visit.numPortalPlanes * sizeof( ps.portalPlanes[0] ) );
+		ps.rect = visit.rect;
+
+		AddAreaToView( visit.areaNum, &ps );
+
+		if ( areaScreenRect[visit.areaNum].IsEmpty() ) {
+			areaScreenRect[visit.areaNum] = ps.rect;
+		} else {
+			areaScreenRect[visit.areaNum].Union( ps.rect );
+		}
+	}
+}
+
+/*
+=======================
+idRenderWorldLocal::ClearPortalFloodCache
+=======================
+*/
+void idRenderWorldLocal::ClearPortalFloodCache() {
+	for ( int i = 0; i < PORTAL_FLOOD_CACHE_SIZE; i++ ) {
+		portalFloodCache[i].valid = false;
+		portalFloodCache[i].lastUsedViewCount = 0;
+		portalFloodCache[i].visits.Clear();
+		portalFloodCache[i].visitPlanes.Clear();
+	}
+	portalFloodRecord = NULL;
+}
+
 /*
 =======================
 idRenderWorldLocal::FlowViewThroughPortals
@@ -593,9 +725,39 @@ void idRenderWorldLocal::FlowViewThroughPortals( const idVec3 & origin, int numP
 			areaScreenRect[i] = tr.viewDef->scissor;
 			AddAreaToView( i, &ps );
 		}
-	} else {
+		return;
+	}
+
+	if ( !r_usePortalFloodCache.GetBool() || numPlanes > MAX_PORTAL_FLOOD_VIEW_PLANES ) {
 		// flood out through portals, setting area viewCount
 		FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+		return;
+	}
+
+	const uint64 start = Sys_Microseconds();
+
+	// the quantized origin only narrows the search, a hit still needs the exact same view
+	const int quantizedX = idMath::Ftoi( idMath::Floor( origin.x * ( 1.0f / 16.0f ) ) ) & 0xFFFF;
+	const int quantizedY = idMath::Ftoi( idMath::Floor( origin.y * ( 1.0f / 16.0f ) ) ) & 0xFFFF;
+	const int quantizedZ = idMath::Ftoi( idMath::Floor( origin.z * ( 1.0f / 16.0f ) ) ) & 0xFFFF;
+	const uint64 key = ( (uint64)quantizedX << 48 ) | ( (uint64)quantizedY << 32 ) | ( (uint64)quantizedZ << 16 ) | ( tr.viewDef->areaNum & 0xFFFF );
+
+	portalFloodCacheEntry_t * entry = FindPortalFloodCacheEntry( key, origin, numPlanes, planes );
+	const bool hit = ( entry != NULL );
+	if ( hit ) {
+		entry->lastUsedViewCount = tr.viewCount;
+		ReplayPortalFlood( entry );
+	} else {
+		// flood out through portals, setting area viewCount, and record the visited areas
+		entry = AllocPortalFloodCacheEntry( key, origin, numPlanes, planes );
+		portalFloodRecord = entry;
+		FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+		portalFloodRecord = NULL;
+	}
+
+	if ( r_showPortalFloodCache.GetBool() ) {
+		common->Printf( "portal flood %s: area %i, %i visits, %i usec\n", hit ? "hit" : ( entry->valid ? "miss" : "uncacheable" ),
+			tr.viewDef->areaNum, entry->visits.Num(), (int)( Sys_Microseconds() - start ) );
 	}
 }
 
@@ -980,6 +1142,7 @@ void idRenderWorldLocal::SetPortalState( qhandle_t portal, int blockTypes ) {
 
 	// leave the connectedAreaGroup the same on one side,
 	// then flood fill from the other side with a new number for each changed attribute
+	// the new connectedAreaNum also invalidates the cached view floods
 	for ( int i = 0; i < NUM_PORTAL_ATTRIBUTES; i++ ) {
 		if ( ( old ^ blockTypes ) & ( 1 << i ) ) {
 			connectedAreaNum++;
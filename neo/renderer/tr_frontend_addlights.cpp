@@ -243,7 +243,6 @@ static void R_AddSingleLight( viewLight_t * vLight ) {
 	vLight->entityInteractionState = (byte *)R_ClearedFrameAlloc( light->world->entityDefs.Num() * sizeof( vLight->entityInteractionState[0] ), FRAME_ALLOC_INTERACTION_STATE );
 
 	const bool lightCastsShadows = light->LightCastsShadows();
-	idInteraction * * const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
 
 	for ( areaReference_t * lref = light->references; lref != NULL; lref = lref->ownerNext ) {
 		portalArea_t *area = lref->area;
@@ -267,8 +266,8 @@ static void R_AddSingleLight( viewLight_t * vLight ) {
 			// until proven otherwise
 			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
 
-			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-			const idInteraction * inter = interactionTableRow[ edef->index ];
+			// The index is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
+			const idInteraction * inter = light->FindInteraction( edef->index );
 
 			const renderEntity_t & eParms = edef->parms;
 			const idRenderModel * eModel = eParms.hModel;
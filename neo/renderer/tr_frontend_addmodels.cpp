@@ -371,7 +371,7 @@ void R_AddSingleModel( viewEntity_t * vEntity ) {
 				// new code path, everything was done in AddLight
 				if ( vLight->entityInteractionState[entityIndex] == viewLight_t::INTERACTION_YES ) {
 					contactedLights[numContactedLights] = vLight;
-					staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+					staticInteractions[numContactedLights] = vLight->lightDef->FindInteraction( entityIndex );
 					if ( ++numContactedLights == MAX_CONTACTED_LIGHTS ) {
 						break;
 					}
@@ -418,7 +418,7 @@ void R_AddSingleModel( viewEntity_t * vEntity ) {
 				}
 			}
 			contactedLights[numContactedLights] = vLight;
-			staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+			staticInteractions[numContactedLights] = vLight->lightDef->FindInteraction( entityIndex );
 			if ( ++numContactedLights == MAX_CONTACTED_LIGHTS ) {
 				break;
 			}
@@ -1005,6 +1005,12 @@ void R_AddModels() {
 
 	tr.viewDef->viewEntitys = R_SortViewEntities( tr.viewDef->viewEntitys );
 
+	//-------------------------------------------------
+	// Skin all visible CPU skinned models in a single batch.
+	//-------------------------------------------------
+
+	R_InstantiateSkinnedModels();
+
 	//-------------------------------------------------
 	// Go through each view entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows).
@@ -1078,4 +1084,15 @@ void R_AddModels() {
 		}
 		vEntity->drawSurfs = NULL;
 	}
+
+	//-------------------------------------------------
+	// Let texture streaming know how large the visible surfaces are on screen.
+	//-------------------------------------------------
+
+	for ( int i = 0; i < tr.viewDef->numDrawSurfs; i++ ) {
+		const drawSurf_t * ds = tr.viewDef->drawSurfs[i];
+		if ( ds->material != NULL ) {
+			globalImages->RequestStreaming( ds->material, Max( ds->scissorRect.GetWidth(), ds->scissorRect.GetHeight() ) );
+		}
+	}
 }
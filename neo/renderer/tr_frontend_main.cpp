@@ -227,120 +227,6 @@ FONT-END RENDERING
 ==========================================================================================
 */
 
-/*
-=================
-R_SortDrawSurfs
-=================
-*/
-static void R_SortDrawSurfs( drawSurf_t ** drawSurfs, const int numDrawSurfs ) {
-#if 1
-
-	uint64 * indices = (uint64 *) _alloca16( numDrawSurfs * sizeof( indices[0] ) );
-
-	// sort the draw surfs based on:
-	// 1. sort value (largest first)
-	// 2. depth (smallest first)
-	// 3. index (largest first)
-	assert( numDrawSurfs <= 0xFFFF );
-	for ( int i = 0; i < numDrawSurfs; i++ ) {
-		float sort = SS_POST_PROCESS - drawSurfs[i]->sort;
-		assert( sort >= 0.0f );
-
-		uint64 dist = 0;
-		if ( drawSurfs[i]->frontEndGeo != NULL ) {
-			float min = 0.0f;
-			float max = 1.0f;
-			idRenderMatrix::DepthBoundsForBounds( min, max, drawSurfs[i]->space->mvp, drawSurfs[i]->frontEndGeo->bounds );
-			dist = idMath::Ftoui16( min * 0xFFFF );
-		}
-		
-		indices[i] = ( ( numDrawSurfs - i ) & 0xFFFF ) | ( dist << 16 ) | ( (uint64) ( *(uint32 *)&sort ) << 32 );
-	}
-
-	const int64 MAX_LEVELS = 128;
-	int64 lo[MAX_LEVELS];
-	int64 hi[MAX_LEVELS];
-
-	// Keep the top of the stack in registers to avoid load-hit-stores.
-	register int64 st_lo = 0;
-	register int64 st_hi = numDrawSurfs - 1;
-	register int64 level = 0;
-
-	for ( ; ; ) {
-		register int64 i = st_lo;
-		register int64 j = st_hi;
-		if ( j - i >= 4 && level < MAX_LEVELS - 1 ) {
-			register uint64 pivot = indices[( i + j ) / 2];
-			do {
-				while ( indices[i] > pivot ) i++;
-				while ( indices[j] < pivot ) j--;
-				if ( i > j ) break;
-				uint64 h = indices[i]; indices[i] = indices[j]; indices[j] = h;
-			} while ( ++i <= --j );
-
-			// No need for these iterations because we are always sorting unique values.
-			//while ( indices[j] == pivot && st_lo < j ) j--;
-			//while ( indices[i] == pivot && i < st_hi ) i++;
-
-			assert( level < MAX_LEVELS - 1 );
-			lo[level] = i;
-			hi[level] = st_hi;
-			st_hi = j;
-			level++;
-		} else {
-			for( ; i < j; j-- ) {
-				register int64 m = i;
-				for ( int64 k = i + 1; k <= j; k++ ) {
-					if ( indices[k] < indices[m] ) {
-						m = k;
-					}
-				}
-				uint64 h = indices[m]; indices[m] = indices[j]; indices[j] = h;
-			}
-			if ( --level < 0 ) {
-				break;
-			}
-			st_lo = lo[level];
-			st_hi = hi[level];
-		}
-	}
-
-	drawSurf_t ** newDrawSurfs = (drawSurf_t **) indices;
-	for ( int i = 0; i < numDrawSurfs; i++ ) {
-		newDrawSurfs[i] = drawSurfs[numDrawSurfs - ( indices[i] & 0xFFFF )];
-	}
-	memcpy( drawSurfs, newDrawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
-
-#else
-
-	struct local_t {
-		static int R_QsortSurfaces( const void *a, const void *b ) {
-			const drawSurf_t * ea = *(drawSurf_t **)a;
-			const drawSurf_t * eb = *(drawSurf_t **)b;
-			if ( ea->sort < eb->sort ) {
-				return -1;
-			}
-			if ( ea->sort > eb->sort ) {
-				return 1;
-			}
-			return 0;
-		}
-	};
-
-	// Add a sort offset so surfaces with equal sort orders still deterministically
-	// draw in the order they were added, at least within a given model.
-	float sorfOffset = 0.0f;
-	for ( int i = 0; i < numDrawSurfs; i++ ) {
-		drawSurf[i]->sort += sorfOffset;
-		sorfOffset += 0.000001f;
-	}
-
-	// sort the drawsurfs
-	qsort( drawSurfs, numDrawSurfs, sizeof( drawSurfs[0] ), local_t::R_QsortSurfaces );
-
-#endif
-}
-
 /*
 ================
 R_RenderView
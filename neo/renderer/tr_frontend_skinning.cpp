@@ -0,0 +1,489 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+
+#include "tr_local.h"
+#include "Model_local.h"
+#include "../idlib/geometry/DrawVert_intrinsics.h"
+
+extern idCVar r_useParallelAddModels;
+
+idCVar r_skinningBatch( "r_skinningBatch", "1", CVAR_RENDERER | CVAR_BOOL, "skin all visible CPU skinned models in a single batched pass when r_useGPUSkinning is 0" );
+
+/*
+==========================================================================================
+
+BATCHED CPU SKINNING
+
+When GPU skinning is disabled, every idMD5Mesh transforms its own vertices as the model
+is instantiated. Instead, the visible skinned models are instantiated up front and their
+surfaces are only recorded, after which all recorded vertices are skinned together in
+a single pass that is split evenly over the jobs. The skinned vertices are streamed
+directly into the frame vertex cache as well as into the surface vertices that are
+used by the CPU for shadows, decals and traces.
+
+==========================================================================================
+*/
+
+static const int MAX_DEFERRED_SKINNED_SURFACES	= 4096;
+static const int SKINNING_CHUNK_VERTS			= 2048;
+
+struct skinningChunk_t {
+	const skinnedSurface_t *	surfaces;
+	int							firstSurface;
+	int							firstVert;
+	int							numVerts;
+};
+
+static skinnedSurface_t			deferredSurfaces[MAX_DEFERRED_SKINNED_SURFACES];
+static idSysInterlockedInteger	numDeferredSurfaces;
+static ID_TLS					deferSkinning;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+static const __m128 vector_float_skin_zero			= { 0.0f, 0.0f, 0.0f, 0.0f };
+static const __m128 vector_float_skin_one			= { 1.0f, 1.0f, 1.0f, 1.0f };
+static const __m128 vector_float_skin_neg_one		= { -1.0f, -1.0f, -1.0f, -1.0f };
+static const __m128 vector_float_skin_half			= { 0.5f, 0.5f, 0.5f, 0.5f };
+static const __m128 vector_float_skin_three			= { 3.0f, 3.0f, 3.0f, 3.0f };
+static const __m128 vector_float_skin_tiny			= { 1e-30f, 1e-30f, 1e-30f, 1e-30f };
+static const __m128 vector_float_skin_255			= { 255.0f, 255.0f, 255.0f, 255.0f };
+static const __m128 vector_float_skin_2_over_255	= { 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f };
+static const __m128 vector_float_skin_255_over_2	= { 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f };
+static const __m128i vector_int_skin_byte_mask		= _mm_set1_epi32( 0x000000FF );
+static const __m128i vector_int_skin_last_byte_mask	= _mm_set1_epi32( 0xFF000000 );
+
+/*
+====================
+R_BlendJoints
+
+Returns the three rows of the weighted joint matrix of a single vertex.
+====================
+*/
+static ID_FORCE_INLINE void R_BlendJoints( const idDrawVert & base, const idJointMat * joints, __m128 & matX, __m128 & matY, __m128 & matZ ) {
+	const idJointMat & j0 = joints[base.color[0]];
+	const idJointMat & j1 = joints[base.color[1]];
+	const idJointMat & j2 = joints[base.color[2]];
+	const idJointMat & j3 = joints[base.color[3]];
+
+	__m128i weights_b = _mm_cvtsi32_si128( *(const unsigned int *)base.color2 );
+	__m128i weights_s = _mm_unpacklo_epi8( weights_b, vector_int_zero );
+	__m128i weights_i = _mm_unpacklo_epi16( weights_s, vector_int_zero );
+
+	__m128 weights = _mm_cvtepi32_ps( weights_i );
+	weights = _mm_mul_ps( weights, vector_float_1_over_255 );
+
+	__m128 w0 = _mm_splat_ps( weights, 0 );
+	__m128 w1 = _mm_splat_ps( weights, 1 );
+	__m128 w2 = _mm_splat_ps( weights, 2 );
+	__m128 w3 = _mm_splat_ps( weights, 3 );
+
+	matX = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 0 * 4 ), w0 );
+	matY = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 1 * 4 ), w0 );
+	matZ = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 2 * 4 ), w0 );
+
+	matX = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 0 * 4 ), w1, matX );
+	matY = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 1 * 4 ), w1, matY );
+	matZ = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 2 * 4 ), w1, matZ );
+
+	matX = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 0 * 4 ), w2, matX );
+	matY = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 1 * 4 ), w2, matY );
+	matZ = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 2 * 4 ), w2, matZ );
+
+	matX = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 0 * 4 ), w3, matX );
+	matY = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 1 * 4 ), w3, matY );
+	matZ = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 2 * 4 ), w3, matZ );
+}
+
+/*
+====================
+R_UnpackVertexBytes
+
+Decodes and normalizes the first three bytes of four packed normals or tangents.
+====================
+*/
+static ID_FORCE_INLINE void R_UnpackVertexBytes( const __m128i packed, __m128 & x, __m128 & y, __m128 & z ) {
+	x = _mm_cvtepi32_ps( _mm_and_si128( packed, vector_int_skin_byte_mask ) );
+	y = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( packed, 8 ), vector_int_skin_byte_mask ) );
+	z = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( packed, 16 ), vector_int_skin_byte_mask ) );
+
+	x = _mm_madd_ps( x, vector_float_skin_2_over_255, vector_float_skin_neg_one );
+	y = _mm_madd_ps( y, vector_float_skin_2_over_255, vector_float_skin_neg_one );
+	z = _mm_madd_ps( z, vector_float_skin_2_over_255, vector_float_skin_neg_one );
+
+	__m128 sqrLength = _mm_mul_ps( x, x );
+	sqrLength = _mm_madd_ps( y, y, sqrLength );
+	sqrLength = _mm_madd_ps( z, z, sqrLength );
+	sqrLength = _mm_max_ps( sqrLength, vector_float_skin_tiny );
+
+	// one Newton-Raphson step on the estimate
+	__m128 invLength = _mm_rsqrt_ps( sqrLength );
+	__m128 sqrInvLength = _mm_mul_ps( invLength, invLength );
+	invLength = _mm_mul_ps( _mm_mul_ps( vector_float_skin_half, invLength ), _mm_nmsub_ps( sqrLength, sqrInvLength, vector_float_skin_three ) );
+
+	x = _mm_mul_ps( x, invLength );
+	y = _mm_mul_ps( y, invLength );
+	z = _mm_mul_ps( z, invLength );
+}
+
+/*
+====================
+R_PackVertexBytes
+
+Encodes four normals or tangents the same way as VertexFloatToByte while
+preserving the fourth byte of the original packed values.
+====================
+*/
+static ID_FORCE_INLINE __m128i R_PackVertexBytes( const __m128 x, const __m128 y, const __m128 z, const __m128i original ) {
+	__m128 sx = _mm_madd_ps( _mm_add_ps( x, vector_float_skin_one ), vector_float_skin_255_over_2, vector_float_skin_half );
+	__m128 sy = _mm_madd_ps( _mm_add_ps( y, vector_float_skin_one ), vector_float_skin_255_over_2, vector_float_skin_half );
+	__m128 sz = _mm_madd_ps( _mm_add_ps( z, vector_float_skin_one ), vector_float_skin_255_over_2, vector_float_skin_half );
+
+	sx = _mm_min_ps( _mm_max_ps( sx, vector_float_skin_zero ), vector_float_skin_255 );
+	sy = _mm_min_ps( _mm_max_ps( sy, vector_float_skin_zero ), vector_float_skin_255 );
+	sz = _mm_min_ps( _mm_max_ps( sz, vector_float_skin_zero ), vector_float_skin_255 );
+
+	__m128i packed = _mm_cvtps_epi32( sx );
+	packed = _mm_or_si128( packed, _mm_slli_epi32( _mm_cvtps_epi32( sy ), 8 ) );
+	packed = _mm_or_si128( packed, _mm_slli_epi32( _mm_cvtps_epi32( sz ), 16 ) );
+	return _mm_or_si128( packed, _mm_and_si128( original, vector_int_skin_last_byte_mask ) );
+}
+
+/*
+====================
+R_SkinVerts
+
+Skins four vertices at a time, with the blended joint matrices and the vertices
+transposed to structure-of-arrays form so all components are processed in parallel.
+====================
+*/
+static void R_SkinVerts( idDrawVert * __restrict out, idDrawVert * __restrict cacheOut, const idDrawVert * __restrict base, const idJointMat * __restrict joints, const int numVerts ) {
+	assert_16_byte_aligned( out );
+	assert_16_byte_aligned( cacheOut );
+	assert_16_byte_aligned( base );
+
+	int i = 0;
+	for ( ; i + 4 <= numVerts; i += 4 ) {
+		__m128 x0, x1, x2, x3;
+		__m128 y0, y1, y2, y3;
+		__m128 z0, z1, z2, z3;
+
+		R_BlendJoints( base[i + 0], joints, x0, y0, z0 );
+		R_BlendJoints( base[i + 1], joints, x1, y1, z1 );
+		R_BlendJoints( base[i + 2], joints, x2, y2, z2 );
+		R_BlendJoints( base[i + 3], joints, x3, y3, z3 );
+
+		// transpose so that every register holds one matrix element of the four vertices
+		_MM_TRANSPOSE4_PS( x0, x1, x2, x3 );
+		_MM_TRANSPOSE4_PS( y0, y1, y2, y3 );
+		_MM_TRANSPOSE4_PS( z0, z1, z2, z3 );
+
+		const float * b0 = base[i + 0].xyz.ToFloatPtr();
+		const float * b1 = base[i + 1].xyz.ToFloatPtr();
+		const float * b2 = base[i + 2].xyz.ToFloatPtr();
+		const float * b3 = base[i + 3].xyz.ToFloatPtr();
+
+		// xyz + st
+		__m128 px = _mm_load_ps( b0 + 0 );
+		__m128 py = _mm_load_ps( b1 + 0 );
+		__m128 pz = _mm_load_ps( b2 + 0 );
+		__m128 st = _mm_load_ps( b3 + 0 );
+		_MM_TRANSPOSE4_PS( px, py, pz, st );
+
+		// normal + tangent + color + color2
+		__m128 normal = _mm_load_ps( b0 + 4 );
+		__m128 tangent = _mm_load_ps( b1 + 4 );
+		__m128 color = _mm_load_ps( b2 + 4 );
+		__m128 color2 = _mm_load_ps( b3 + 4 );
+		_MM_TRANSPOSE4_PS( normal, tangent, color, color2 );
+
+		__m128 nx, ny, nz;
+		__m128 tx, ty, tz;
+		R_UnpackVertexBytes( _mm_castps_si128( normal ), nx, ny, nz );
+		R_UnpackVertexBytes( _mm_castps_si128( tangent ), tx, ty, tz );
+
+		const __m128 ox = _mm_madd_ps( x2, pz, _mm_madd_ps( x1, py, _mm_madd_ps( x0, px, x3 ) ) );
+		const __m128 oy = _mm_madd_ps( y2, pz, _mm_madd_ps( y1, py, _mm_madd_ps( y0, px, y3 ) ) );
+		const __m128 oz = _mm_madd_ps( z2, pz, _mm_madd_ps( z1, py, _mm_madd_ps( z0, px, z3 ) ) );
+
+		const __m128 onx = _mm_madd_ps( x2, nz, _mm_madd_ps( x1, ny, _mm_mul_ps( x0, nx ) ) );
+		const __m128 ony = _mm_madd_ps( y2, nz, _mm_madd_ps( y1, ny, _mm_mul_ps( y0, nx ) ) );
+		const __m128 onz = _mm_madd_ps( z2, nz, _mm_madd_ps( z1, ny, _mm_mul_ps( z0, nx ) ) );
+
+		const __m128 otx = _mm_madd_ps( x2, tz, _mm_madd_ps( x1, ty, _mm_mul_ps( x0, tx ) ) );
+		const __m128 oty = _mm_madd_ps( y2, tz, _mm_madd_ps( y1, ty, _mm_mul_ps( y0, tx ) ) );
+		const __m128 otz = _mm_madd_ps( z2, tz, _mm_madd_ps( z1, ty, _mm_mul_ps( z0, tx ) ) );
+
+		__m128 v0 = ox;
+		__m128 v1 = oy;
+		__m128 v2 = oz;
+		__m128 v3 = st;
+		_MM_TRANSPOSE4_PS( v0, v1, v2, v3 );
+
+		__m128 a0 = _mm_castsi128_ps( R_PackVertexBytes( onx, ony, onz, _mm_castps_si128( normal ) ) );
+		__m128 a1 = _mm_castsi128_ps( R_PackVertexBytes( otx, oty, otz, _mm_castps_si128( tangent ) ) );
+		__m128 a2 = color;
+		__m128 a3 = color2;
+		_MM_TRANSPOSE4_PS( a0, a1, a2, a3 );
+
+		float * o = out[i].xyz.ToFloatPtr();
+		_mm_store_ps( o + 0 * 8 + 0, v0 );
+		_mm_store_ps( o + 0 * 8 + 4, a0 );
+		_mm_store_ps( o + 1 * 8 + 0, v1 );
+		_mm_store_ps( o + 1 * 8 + 4, a1 );
+		_mm_store_ps( o + 2 * 8 + 0, v2 );
+		_mm_store_ps( o + 2 * 8 + 4, a2 );
+		_mm_store_ps( o + 3 * 8 + 0, v3 );
+		_mm_store_ps( o + 3 * 8 + 4, a3 );
+
+		if ( cacheOut != NULL ) {
+			// the vertex cache is write-combined memory
+			float * c = cacheOut[i].xyz.ToFloatPtr();
+			_mm_stream_ps( c + 0 * 8 + 0, v0 );
+			_mm_stream_ps( c + 0 * 8 + 4, a0 );
+			_mm_stream_ps( c + 1 * 8 + 0, v1 );
+			_mm_stream_ps( c + 1 * 8 + 4, a1 );
+			_mm_stream_ps( c + 2 * 8 + 0, v2 );
+			_mm_stream_ps( c + 2 * 8 + 4, a2 );
+			_mm_stream_ps( c + 3 * 8 + 0, v3 );
+			_mm_stream_ps( c + 3 * 8 + 4, a3 );
+		}
+	}
+
+	if ( i < numVerts ) {
+		memcpy( out + i, base + i, ( numVerts - i ) * sizeof( idDrawVert ) );
+		TransformVertsAndTangents( out + i, numVerts - i, base + i, joints );
+		if ( cacheOut != NULL ) {
+			memcpy( cacheOut + i, out + i, ( numVerts - i ) * sizeof( idDrawVert ) );
+		}
+	}
+
+	if ( cacheOut != NULL ) {
+		_mm_sfence();
+	}
+}
+
+#else
+
+/*
+====================
+R_SkinVerts
+====================
+*/
+static void R_SkinVerts( idDrawVert * __restrict out, idDrawVert * __restrict cacheOut, const idDrawVert * __restrict base, const idJointMat * __restrict joints, const int numVerts ) {
+	memcpy( out, base, numVerts * sizeof( idDrawVert ) );
+	TransformVertsAndTangents( out, numVerts, base, joints );
+	if ( cacheOut != NULL ) {
+		memcpy( cacheOut, out, numVerts * sizeof( idDrawVert ) );
+	}
+}
+
+#endif
+
+/*
+====================
+R_SkinChunk
+
+Skins a contiguous range of vertices that may span several surfaces.
+====================
+*/
+static void R_SkinChunk( const skinningChunk_t * chunk ) {
+	int surfaceNum = chunk->firstSurface;
+	int firstVert = chunk->firstVert;
+	for ( int remaining = chunk->numVerts; remaining > 0; surfaceNum++ ) {
+		const skinnedSurface_t & surf = chunk->surfaces[surfaceNum];
+		const int numVerts = Min( surf.numVerts - firstVert, remaining );
+		idDrawVert * cacheVerts = ( surf.cacheVerts != NULL ) ? surf.cacheVerts + firstVert : NULL;
+		R_SkinVerts( surf.verts + firstVert, cacheVerts, surf.baseVerts + firstVert, surf.joints, numVerts );
+		remaining -= numVerts;
+		firstVert = 0;
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_SkinChunk, "R_SkinChunk" );
+
+/*
+====================
+R_SkinSurfaces
+
+Splits all vertices of the surfaces into evenly sized chunks and skins them, either
+directly or with jobs on the given job list. The chunks live on the stack because the
+jobs are waited for before returning, so the frontend and a skinning test on another
+thread never share them.
+====================
+*/
+void R_SkinSurfaces( const skinnedSurface_t * surfaces, const int numSurfaces, idParallelJobList * jobList ) {
+	SCOPED_PROFILE_EVENT( "R_SkinSurfaces" );
+
+	int totalVerts = 0;
+	for ( int i = 0; i < numSurfaces; i++ ) {
+		totalVerts += surfaces[i].numVerts;
+	}
+	if ( totalVerts == 0 ) {
+		return;
+	}
+
+	const int numChunks = Min( ( totalVerts + SKINNING_CHUNK_VERTS - 1 ) / SKINNING_CHUNK_VERTS, MAX_SKINNING_JOBS );
+	const int vertsPerChunk = ( totalVerts + numChunks - 1 ) / numChunks;
+
+	skinningChunk_t chunks[MAX_SKINNING_JOBS];
+	int surfaceNum = 0;
+	int firstVert = 0;
+	int chunkNum = 0;
+	for ( int chunkStart = 0; chunkStart < totalVerts; chunkStart += vertsPerChunk, chunkNum++ ) {
+		// skip past the surfaces that were fully covered by the previous chunks
+		while ( firstVert >= surfaces[surfaceNum].numVerts ) {
+			firstVert -= surfaces[surfaceNum].numVerts;
+			surfaceNum++;
+		}
+
+		skinningChunk_t & chunk = chunks[chunkNum];
+		chunk.surfaces = surfaces;
+		chunk.firstSurface = surfaceNum;
+		chunk.firstVert = firstVert;
+		chunk.numVerts = Min( vertsPerChunk, totalVerts - chunkStart );
+
+		firstVert += chunk.numVerts;
+	}
+
+	if ( jobList == NULL ) {
+		for ( int i = 0; i < chunkNum; i++ ) {
+			R_SkinChunk( &chunks[i] );
+		}
+	} else {
+		for ( int i = 0; i < chunkNum; i++ ) {
+			jobList->AddJob( (jobRun_t)R_SkinChunk, &chunks[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+	}
+}
+
+/*
+====================
+R_DeferSkinning
+
+Called by idMD5Mesh::UpdateSurface. Returns false if the surface has to be skinned
+right away, otherwise the surface is recorded to be skinned by R_InstantiateSkinnedModels
+and the vertex cache space for the skinned vertices is allocated.
+====================
+*/
+bool R_DeferSkinning( srfTriangles_t * tri, const idDrawVert * baseVerts, const idJointMat * joints ) {
+	if ( (ptrdiff_t)deferSkinning == 0 ) {
+		return false;
+	}
+	const int index = numDeferredSurfaces.Increment() - 1;
+	if ( index >= MAX_DEFERRED_SKINNED_SURFACES ) {
+		return false;
+	}
+
+	tri->ambientCache = vertexCache.AllocVertex( NULL, ALIGN( tri->numVerts * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
+
+	skinnedSurface_t & surf = deferredSurfaces[index];
+	surf.verts = tri->verts;
+	surf.cacheVerts = (idDrawVert *)vertexCache.MappedVertexBuffer( tri->ambientCache );
+	surf.baseVerts = baseVerts;
+	surf.joints = joints;
+	surf.numVerts = tri->numVerts;
+	return true;
+}
+
+/*
+====================
+R_InstantiateSkinnedModel
+====================
+*/
+static void R_InstantiateSkinnedModel( viewEntity_t * vEntity ) {
+	deferSkinning = 1;
+	R_EntityDefDynamicModel( vEntity->entityDef );
+	deferSkinning = 0;
+}
+
+REGISTER_PARALLEL_JOB( R_InstantiateSkinnedModel, "R_InstantiateSkinnedModel" );
+
+/*
+====================
+R_InstantiateSkinnedModels
+
+Instantiates the dynamic models of all directly visible CPU skinned entities and skins
+all their surfaces in one batch. R_AddSingleModel will pick up the cached dynamic models
+with their vertex cache allocations already in place.
+====================
+*/
+void R_InstantiateSkinnedModels() {
+	if ( r_useGPUSkinning.GetBool() || !r_skinningBatch.GetBool() ) {
+		return;
+	}
+
+	SCOPED_PROFILE_EVENT( "R_InstantiateSkinnedModels" );
+
+	const viewDef_t * viewDef = tr.viewDef;
+
+	numDeferredSurfaces.SetValue( 0 );
+
+	int numInstantiated = 0;
+	for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
+		const idRenderEntityLocal * entityDef = vEntity->entityDef;
+		if ( viewDef->isXraySubview && entityDef->parms.xrayIndex == 1 ) {
+			continue;
+		} else if ( !viewDef->isXraySubview && entityDef->parms.xrayIndex == 2 ) {
+			continue;
+		}
+		// entities only added for their shadows are left to R_AddSingleModel
+		if ( vEntity->scissorRect.IsEmpty() ) {
+			continue;
+		}
+		const idRenderModel * model = entityDef->parms.hModel;
+		if ( model == NULL || model->IsDynamicModel() != DM_CACHED || model->NumJoints() <= 0 ) {
+			continue;
+		}
+		if ( entityDef->dynamicModelFrameCount == tr.frameCount ) {
+			continue;
+		}
+		if ( r_useParallelAddModels.GetBool() ) {
+			tr.frontEndJobList->AddJob( (jobRun_t)R_InstantiateSkinnedModel, vEntity );
+		} else {
+			R_InstantiateSkinnedModel( vEntity );
+		}
+		numInstantiated++;
+	}
+
+	if ( numInstantiated == 0 ) {
+		return;
+	}
+
+	if ( r_useParallelAddModels.GetBool() ) {
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+	}
+
+	const int numSurfaces = Min( numDeferredSurfaces.GetValue(), MAX_DEFERRED_SKINNED_SURFACES );
+	R_SkinSurfaces( deferredSurfaces, numSurfaces, r_useParallelAddModels.GetBool() ? tr.frontEndJobList : NULL );
+}
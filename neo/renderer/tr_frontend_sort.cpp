@@ -0,0 +1,544 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+
+#include "tr_local.h"
+
+idCVar r_useParallelSortDrawSurfs( "r_useParallelSortDrawSurfs", "1", CVAR_RENDERER | CVAR_BOOL, "generate the draw surface sort keys and radix sort them in parallel with jobs" );
+
+/*
+==========================================================================================
+
+DRAW SURFACE SORTING
+
+The draw surfaces are sorted based on:
+1. sort value (smallest first)
+2. depth (largest first)
+3. the order in which they were added (first added first)
+
+Each surface gets a 48 bit key made from the sort value and the depth, inverted so the
+keys are sorted ascending, and the surfaces are ordered with a stable least significant
+digit radix sort on these keys. The stable sort keeps surfaces with equal keys in the
+order they were added, so the key does not need to hold the surface index and the number
+of surfaces is not limited.
+
+The key generation, which projects the bounds of every surface, and the histogram and
+scatter steps of every radix pass are split over the jobs on the frontend job list. Digits
+that are the same for all keys are skipped, which typically leaves three or four of the
+six passes. When the surfaces arrive in nearly the same order as their keys, which is
+common for views whose content is added in a coherent order from frame to frame, a
+bounded insertion sort finishes the job without any radix passes.
+
+==========================================================================================
+*/
+
+static const int SORT_KEY_BITS				= 48;
+static const int SORT_RADIX_BITS			= 8;
+static const int SORT_RADIX_SIZE			= 1 << SORT_RADIX_BITS;
+static const int SORT_NUM_PASSES			= SORT_KEY_BITS / SORT_RADIX_BITS;
+static const int SORT_CHUNK_SURFS			= 4096;
+static const int MAX_SORT_JOBS				= 64;
+static const int SORT_INSERTION_MOVES		= 8;		// per surface, before the insertion sort gives up
+
+struct sortChunk_t {
+	// key generation
+	const drawSurf_t * const *	drawSurfs;
+	int							numDrawSurfs;
+	uint64						diffBits;		// bits in which the chunk keys differ from the first key
+	int							numDescents;	// keys smaller than the key before them
+
+	// radix pass
+	const uint64 *				srcKeys;
+	const int *					srcIndexes;
+	uint64 *					dstKeys;
+	int *						dstIndexes;
+	int							shift;
+	int							first;
+	int							num;
+	int							histogram[SORT_RADIX_SIZE];	// counts, replaced by the scatter offsets
+};
+
+static sortChunk_t				sortChunks[MAX_SORT_JOBS];
+
+/*
+=================
+R_DrawSurfSortKey
+=================
+*/
+static ID_INLINE uint64 R_DrawSurfSortKey( const drawSurf_t * drawSurf ) {
+	float sort = SS_POST_PROCESS - drawSurf->sort;
+	assert( sort >= 0.0f );
+
+	uint64 dist = 0;
+	if ( drawSurf->frontEndGeo != NULL ) {
+		float min = 0.0f;
+		float max = 1.0f;
+		idRenderMatrix::DepthBoundsForBounds( min, max, drawSurf->space->mvp, drawSurf->frontEndGeo->bounds );
+		dist = idMath::Ftoui16( min * 0xFFFF );
+	}
+
+	// the largest sort and depth come first
+	const uint64 key = dist | ( (uint64)( *(uint32 *)&sort ) << 16 );
+	return ~key & ( ( (uint64)1 << SORT_KEY_BITS ) - 1 );
+}
+
+/*
+=================
+R_DrawSurfSortKeys
+=================
+*/
+static void R_DrawSurfSortKeys( sortChunk_t * chunk ) {
+	const drawSurf_t * const * drawSurfs = chunk->drawSurfs;
+	uint64 * keys = chunk->dstKeys;
+	int * indexes = chunk->dstIndexes;
+
+	uint64 diffBits = 0;
+	int numDescents = 0;
+	uint64 firstKey = R_DrawSurfSortKey( drawSurfs[chunk->first] );
+	uint64 prevKey = firstKey;
+	for ( int i = chunk->first; i < chunk->first + chunk->num; i++ ) {
+		const uint64 key = R_DrawSurfSortKey( drawSurfs[i] );
+		keys[i] = key;
+		indexes[i] = i;
+		diffBits |= key ^ firstKey;
+		numDescents += ( key < prevKey );
+		prevKey = key;
+	}
+	chunk->diffBits = diffBits;
+	chunk->numDescents = numDescents;
+}
+
+REGISTER_PARALLEL_JOB( R_DrawSurfSortKeys, "R_DrawSurfSortKeys" );
+
+/*
+=================
+R_RadixHistogram
+=================
+*/
+static void R_RadixHistogram( sortChunk_t * chunk ) {
+	memset( chunk->histogram, 0, sizeof( chunk->histogram ) );
+	const uint64 * keys = chunk->srcKeys;
+	const int shift = chunk->shift;
+	for ( int i = chunk->first; i < chunk->first + chunk->num; i++ ) {
+		chunk->histogram[( keys[i] >> shift ) & ( SORT_RADIX_SIZE - 1 )]++;
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_RadixHistogram, "R_RadixHistogram" );
+
+/*
+=================
+R_RadixScatter
+=================
+*/
+static void R_RadixScatter( sortChunk_t * chunk ) {
+	const uint64 * srcKeys = chunk->srcKeys;
+	const int * srcIndexes = chunk->srcIndexes;
+	uint64 * dstKeys = chunk->dstKeys;
+	int * dstIndexes = chunk->dstIndexes;
+	int * offsets = chunk->histogram;
+	const int shift = chunk->shift;
+	for ( int i = chunk->first; i < chunk->first + chunk->num; i++ ) {
+		const uint64 key = srcKeys[i];
+		const int offset = offsets[( key >> shift ) & ( SORT_RADIX_SIZE - 1 )]++;
+		dstKeys[offset] = key;
+		dstIndexes[offset] = srcIndexes[i];
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_RadixScatter, "R_RadixScatter" );
+
+/*
+=================
+R_RunSortJobs
+=================
+*/
+static void R_RunSortJobs( void (*function)( sortChunk_t * ), const int numChunks, idParallelJobList * jobList ) {
+	if ( jobList == NULL || numChunks == 1 ) {
+		for ( int i = 0; i < numChunks; i++ ) {
+			function( &sortChunks[i] );
+		}
+	} else {
+		for ( int i = 0; i < numChunks; i++ ) {
+			jobList->AddJob( (jobRun_t)function, &sortChunks[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+	}
+}
+
+/*
+=================
+R_InsertionSortKeys
+
+Stable insertion sort that gives up after maxMoves moves. The keys are left as a
+permutation with equal keys still in their original order, so a stable sort can
+finish the job.
+=================
+*/
+static bool R_InsertionSortKeys( uint64 * keys, int * indexes, const int num, int maxMoves ) {
+	for ( int i = 1; i < num; i++ ) {
+		const uint64 key = keys[i];
+		const int index = indexes[i];
+		int j = i - 1;
+		for ( ; j >= 0 && keys[j] > key; j-- ) {
+			keys[j + 1] = keys[j];
+			indexes[j + 1] = indexes[j];
+			maxMoves--;
+		}
+		keys[j + 1] = key;
+		indexes[j + 1] = index;
+		if ( maxMoves < 0 ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+=================
+R_SortDrawSurfsWithJobs
+
+Sorts the draw surfaces using the given job list, which may be NULL to do all the work
+on the calling thread.
+=================
+*/
+void R_SortDrawSurfsWithJobs( drawSurf_t ** drawSurfs, const int numDrawSurfs, idParallelJobList * jobList ) {
+	if ( numDrawSurfs <= 1 ) {
+		return;
+	}
+
+	SCOPED_PROFILE_EVENT( "R_SortDrawSurfs" );
+
+	idFrameArena & arena = *idFrameArena::ThreadArena();
+	idScopedFrameArenaMark arenaMark( arena );
+
+	uint64 * keys[2];
+	int * indexes[2];
+	keys[0] = arena.AllocArray< uint64 >( numDrawSurfs );
+	keys[1] = arena.AllocArray< uint64 >( numDrawSurfs );
+	indexes[0] = arena.AllocArray< int >( numDrawSurfs );
+	indexes[1] = arena.AllocArray< int >( numDrawSurfs );
+
+	const int numChunks = Min( ( numDrawSurfs + SORT_CHUNK_SURFS - 1 ) / SORT_CHUNK_SURFS, MAX_SORT_JOBS );
+	const int surfsPerChunk = ( numDrawSurfs + numChunks - 1 ) / numChunks;
+	for ( int i = 0; i < numChunks; i++ ) {
+		sortChunks[i].drawSurfs = drawSurfs;
+		sortChunks[i].dstKeys = keys[0];
+		sortChunks[i].dstIndexes = indexes[0];
+		sortChunks[i].first = i * surfsPerChunk;
+		sortChunks[i].num = Min( surfsPerChunk, numDrawSurfs - sortChunks[i].first );
+	}
+
+	R_RunSortJobs( R_DrawSurfSortKeys, numChunks, jobList );
+
+	// find the digits that differ between the keys and whether the keys are presorted
+	uint64 diffBits = 0;
+	int numDescents = 0;
+	for ( int i = 0; i < numChunks; i++ ) {
+		diffBits |= sortChunks[i].diffBits | ( keys[0][sortChunks[i].first] ^ keys[0][0] );
+		numDescents += sortChunks[i].numDescents;
+		if ( i > 0 && keys[0][sortChunks[i].first] < keys[0][sortChunks[i].first - 1] ) {
+			numDescents++;
+		}
+	}
+
+	int src = 0;
+	if ( numDescents == 0 ) {
+		return;
+	}
+	if ( numDescents * 64 > numDrawSurfs || !R_InsertionSortKeys( keys[0], indexes[0], numDrawSurfs, numDrawSurfs * SORT_INSERTION_MOVES ) ) {
+		for ( int pass = 0; pass < SORT_NUM_PASSES; pass++ ) {
+			const int shift = pass * SORT_RADIX_BITS;
+			if ( ( ( diffBits >> shift ) & ( SORT_RADIX_SIZE - 1 ) ) == 0 ) {
+				continue;
+			}
+
+			for ( int i = 0; i < numChunks; i++ ) {
+				sortChunks[i].srcKeys = keys[src];
+				sortChunks[i].srcIndexes = indexes[src];
+				sortChunks[i].dstKeys = keys[src ^ 1];
+				sortChunks[i].dstIndexes = indexes[src ^ 1];
+				sortChunks[i].shift = shift;
+			}
+
+			R_RunSortJobs( R_RadixHistogram, numChunks, jobList );
+
+			// turn the counts into the offsets at which every chunk writes each digit
+			int offset = 0;
+			for ( int digit = 0; digit < SORT_RADIX_SIZE; digit++ ) {
+				for ( int i = 0; i < numChunks; i++ ) {
+					const int count = sortChunks[i].histogram[digit];
+					sortChunks[i].histogram[digit] = offset;
+					offset += count;
+				}
+			}
+			assert( offset == numDrawSurfs );
+
+			R_RunSortJobs( R_RadixScatter, numChunks, jobList );
+
+			src ^= 1;
+		}
+	}
+
+	drawSurf_t ** sortedDrawSurfs = arena.AllocArray< drawSurf_t * >( numDrawSurfs );
+	const int * sortedIndexes = indexes[src];
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		sortedDrawSurfs[i] = drawSurfs[sortedIndexes[i]];
+	}
+	memcpy( drawSurfs, sortedDrawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
+}
+
+/*
+==========================================================================================
+
+SORT BENCHMARK
+
+captureDrawSurfs records the sort inputs of the draw surfaces of the next main view and
+testDrawSurfSort replays them through the previous single threaded quick sort and the
+radix sort, with and without jobs.
+
+==========================================================================================
+*/
+
+struct capturedDrawSurf_t {
+	float					sort;
+	int						space;			// index into capturedSpaces
+	bool					hasGeo;
+	idBounds				bounds;
+};
+
+static bool							captureDrawSurfs;
+static idList< capturedDrawSurf_t >	capturedDrawSurfs;
+static idList< idRenderMatrix >		capturedSpaces;
+
+/*
+=================
+R_CaptureDrawSurfs
+=================
+*/
+static void R_CaptureDrawSurfs( const drawSurf_t * const * drawSurfs, const int numDrawSurfs ) {
+	capturedDrawSurfs.SetNum( numDrawSurfs );
+	capturedSpaces.SetNum( 0 );
+
+	const viewEntity_t * lastSpace = NULL;
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		const drawSurf_t * drawSurf = drawSurfs[i];
+		if ( drawSurf->space != lastSpace ) {
+			capturedSpaces.Append( drawSurf->space->mvp );
+			lastSpace = drawSurf->space;
+		}
+		capturedDrawSurf_t & captured = capturedDrawSurfs[i];
+		captured.sort = drawSurf->sort;
+		captured.space = capturedSpaces.Num() - 1;
+		captured.hasGeo = ( drawSurf->frontEndGeo != NULL );
+		captured.bounds = captured.hasGeo ? drawSurf->frontEndGeo->bounds : bounds_zero;
+	}
+}
+
+/*
+=================
+R_SortDrawSurfsQuick
+
+The previous implementation, which is limited to 64k surfaces.
+=================
+*/
+static void R_SortDrawSurfsQuick( drawSurf_t ** drawSurfs, const int numDrawSurfs ) {
+	uint64 * indices = (uint64 *) _alloca16( numDrawSurfs * sizeof( indices[0] ) );
+
+	assert( numDrawSurfs <= 0xFFFF );
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		float sort = SS_POST_PROCESS - drawSurfs[i]->sort;
+		assert( sort >= 0.0f );
+
+		uint64 dist = 0;
+		if ( drawSurfs[i]->frontEndGeo != NULL ) {
+			float min = 0.0f;
+			float max = 1.0f;
+			idRenderMatrix::DepthBoundsForBounds( min, max, drawSurfs[i]->space->mvp, drawSurfs[i]->frontEndGeo->bounds );
+			dist = idMath::Ftoui16( min * 0xFFFF );
+		}
+
+		indices[i] = ( ( numDrawSurfs - i ) & 0xFFFF ) | ( dist << 16 ) | ( (uint64) ( *(uint32 *)&sort ) << 32 );
+	}
+
+	const int64 MAX_LEVELS = 128;
+	int64 lo[MAX_LEVELS];
+	int64 hi[MAX_LEVELS];
+
+	// Keep the top of the stack in registers to avoid load-hit-stores.
+	register int64 st_lo = 0;
+	register int64 st_hi = numDrawSurfs - 1;
+	register int64 level = 0;
+
+	for ( ; ; ) {
+		register int64 i = st_lo;
+		register int64 j = st_hi;
+		if ( j - i >= 4 && level < MAX_LEVELS - 1 ) {
+			register uint64 pivot = indices[( i + j ) / 2];
+			do {
+				while ( indices[i] > pivot ) i++;
+				while ( indices[j] < pivot ) j--;
+				if ( i > j ) break;
+				uint64 h = indices[i]; indices[i] = indices[j]; indices[j] = h;
+			} while ( ++i <= --j );
+
+			assert( level < MAX_LEVELS - 1 );
+			lo[level] = i;
+			hi[level] = st_hi;
+			st_hi = j;
+			level++;
+		} else {
+			for( ; i < j; j-- ) {
+				register int64 m = i;
+				for ( int64 k = i + 1; k <= j; k++ ) {
+					if ( indices[k] < indices[m] ) {
+						m = k;
+					}
+				}
+				uint64 h = indices[m]; indices[m] = indices[j]; indices[j] = h;
+			}
+			if ( --level < 0 ) {
+				break;
+			}
+			st_lo = lo[level];
+			st_hi = hi[level];
+		}
+	}
+
+	drawSurf_t ** newDrawSurfs = (drawSurf_t **) indices;
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		newDrawSurfs[i] = drawSurfs[numDrawSurfs - ( indices[i] & 0xFFFF )];
+	}
+	memcpy( drawSurfs, newDrawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
+}
+
+/*
+=================
+R_SortDrawSurfs
+=================
+*/
+void R_SortDrawSurfs( drawSurf_t ** drawSurfs, const int numDrawSurfs ) {
+	if ( captureDrawSurfs && !tr.viewDef->isSubview ) {
+		R_CaptureDrawSurfs( drawSurfs, numDrawSurfs );
+		captureDrawSurfs = false;
+		common->Printf( "captured %d draw surfaces\n", numDrawSurfs );
+	}
+
+	R_SortDrawSurfsWithJobs( drawSurfs, numDrawSurfs, r_useParallelSortDrawSurfs.GetBool() ? tr.frontEndJobList : NULL );
+}
+
+/*
+=================
+R_CaptureDrawSurfs_f
+=================
+*/
+void R_CaptureDrawSurfs_f( const idCmdArgs & args ) {
+	captureDrawSurfs = true;
+}
+
+/*
+=================
+R_TestDrawSurfSort_f
+=================
+*/
+void R_TestDrawSurfSort_f( const idCmdArgs & args ) {
+	if ( capturedDrawSurfs.Num() == 0 ) {
+		common->Printf( "no draw surfaces captured, use captureDrawSurfs first\n" );
+		return;
+	}
+	const int numCopies = Max( ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 1, 1 );
+	const int numIterations = Max( ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 10, 1 );
+
+	// the copies are appended as if the same view was added several times
+	const int numDrawSurfs = capturedDrawSurfs.Num() * numCopies;
+	viewEntity_t * spaces = (viewEntity_t *)Mem_ClearedAlloc( capturedSpaces.Num() * sizeof( viewEntity_t ), TAG_RENDER );
+	srfTriangles_t * tris = (srfTriangles_t *)Mem_ClearedAlloc( capturedDrawSurfs.Num() * sizeof( srfTriangles_t ), TAG_RENDER );
+	drawSurf_t * surfs = (drawSurf_t *)Mem_ClearedAlloc( numDrawSurfs * sizeof( drawSurf_t ), TAG_RENDER );
+	drawSurf_t ** unsorted = (drawSurf_t **)Mem_Alloc( numDrawSurfs * sizeof( drawSurf_t * ), TAG_RENDER );
+	drawSurf_t ** sorted = (drawSurf_t **)Mem_Alloc( numDrawSurfs * sizeof( drawSurf_t * ), TAG_RENDER );
+	drawSurf_t ** reference = (drawSurf_t **)Mem_Alloc( numDrawSurfs * sizeof( drawSurf_t * ), TAG_RENDER );
+
+	for ( int i = 0; i < capturedSpaces.Num(); i++ ) {
+		spaces[i].mvp = capturedSpaces[i];
+	}
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		const capturedDrawSurf_t & captured = capturedDrawSurfs[i % capturedDrawSurfs.Num()];
+		tris[i % capturedDrawSurfs.Num()].bounds = captured.bounds;
+		surfs[i].frontEndGeo = captured.hasGeo ? &tris[i % capturedDrawSurfs.Num()] : NULL;
+		surfs[i].space = &spaces[captured.space];
+		surfs[i].sort = captured.sort;
+		unsorted[i] = &surfs[i];
+	}
+
+	uint64 quickTime = (uint64)-1;
+	uint64 serialTime = (uint64)-1;
+	uint64 parallelTime = (uint64)-1;
+	bool serialValid = true;
+	bool parallelValid = true;
+	for ( int iteration = 0; iteration < numIterations; iteration++ ) {
+		if ( numDrawSurfs <= 0xFFFF ) {
+			memcpy( sorted, unsorted, numDrawSurfs * sizeof( sorted[0] ) );
+			const uint64 start = Sys_Microseconds();
+			R_SortDrawSurfsQuick( sorted, numDrawSurfs );
+			quickTime = Min( quickTime, Sys_Microseconds() - start );
+		}
+
+		memcpy( reference, unsorted, numDrawSurfs * sizeof( reference[0] ) );
+		uint64 start = Sys_Microseconds();
+		R_SortDrawSurfsWithJobs( reference, numDrawSurfs, NULL );
+		serialTime = Min( serialTime, Sys_Microseconds() - start );
+		if ( numDrawSurfs <= 0xFFFF ) {
+			serialValid &= ( memcmp( reference, sorted, numDrawSurfs * sizeof( sorted[0] ) ) == 0 );
+		}
+
+		memcpy( sorted, unsorted, numDrawSurfs * sizeof( sorted[0] ) );
+		start = Sys_Microseconds();
+		R_SortDrawSurfsWithJobs( sorted, numDrawSurfs, tr.frontEndJobList );
+		parallelTime = Min( parallelTime, Sys_Microseconds() - start );
+		parallelValid &= ( memcmp( reference, sorted, numDrawSurfs * sizeof( sorted[0] ) ) == 0 );
+	}
+
+	common->Printf( "%d draw surfaces, best of %d iterations\n", numDrawSurfs, numIterations );
+	if ( numDrawSurfs <= 0xFFFF ) {
+		common->Printf( "quick sort           %6d us\n", (int)quickTime );
+	} else {
+		common->Printf( "quick sort           n/a, more than 64k surfaces\n" );
+	}
+	common->Printf( "radix sort           %6d us%s\n", (int)serialTime, serialValid ? "" : " MISMATCH" );
+	common->Printf( "radix sort with jobs %6d us%s\n", (int)parallelTime, parallelValid ? "" : " MISMATCH" );
+
+	Mem_Free( reference );
+	Mem_Free( sorted );
+	Mem_Free( unsorted );
+	Mem_Free( surfs );
+	Mem_Free( tris );
+	Mem_Free( spaces );
+}
@@ -168,6 +168,9 @@ public:
 
 	bool					LightCastsShadows() const { return parms.forceShadows || ( !parms.noShadows && lightShader->LightCastsShadows() ); }
 
+	// returns NULL if the entityDef has no interaction with the light yet, or INTERACTION_EMPTY
+	idInteraction *			FindInteraction( const int entityIndex ) const;
+
 	renderLight_t			parms;					// specification
 
 	bool					lightHasMoved;			// the light has changed its position since it was
@@ -202,9 +205,22 @@ public:
 	idInteraction *			firstInteraction;		// doubly linked list
 	idInteraction *			lastInteraction;
 
+	// interactions by entityDef index, only holding the entities the light actually touches,
+	// instead of a row of a dense lightDefs * entityDefs table.  Updated by
+	// idInteraction::AllocAndLink(), UnlinkAndFree() and MakeEmpty(), read by the front end jobs
+	idFlatHashMap< int, idInteraction * >	interactionIndex;
+
 	struct doublePortal_s *	foggedPortals;
 };
 
+ID_INLINE idInteraction * idRenderLightLocal::FindInteraction( const int entityIndex ) const {
+	idInteraction * const * inter = NULL;
+	if ( !interactionIndex.Get( entityIndex, &inter ) ) {
+		return NULL;
+	}
+	return *inter;
+}
+
 
 class idRenderEntityLocal : public idRenderEntity {
 public:
@@ -701,6 +717,7 @@ public:
 	virtual void			BeginLevelLoad();
 	virtual void			EndLevelLoad();
 	virtual void			LoadLevelImages();
+	virtual void			SuspendImageStreaming();
 	virtual void			Preload( const idPreloadManifest &manifest, const char *mapName );
 	virtual void			BeginAutomaticBackgroundSwaps( autoRenderIconType_t icon = AUTORENDER_DEFAULTICON );
 	virtual void			EndAutomaticBackgroundSwaps();
@@ -865,6 +882,7 @@ extern idCVar r_skipPrelightShadows;		// 1 = skip the dmap generated static shad
 extern idCVar r_useCachedDynamicModels;		// 1 = cache snapshots of dynamic models
 extern idCVar r_useScissor;					// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;					// 1 = use portals to perform area culling, otherwise draw everything
+extern idCVar r_usePortalFloodCache;		// reuse the portal flood of repeated views
 extern idCVar r_useStateCaching;			// avoid redundant state changes in GL_*() calls
 extern idCVar r_useEntityCallbacks;			// if 0, issue the callback immediately at update time, rather than defering
 extern idCVar r_lightAllBackFaces;			// light all the back faces, even when they would be shadowed
@@ -941,6 +959,7 @@ extern idCVar r_testGammaBias;				// draw a grid pattern to test gamma levels
 extern idCVar r_singleLight;				// suppress all but one light
 extern idCVar r_singleEntity;				// suppress all but one entity
 extern idCVar r_singleArea;					// only draw the portal area the view is actually in
+extern idCVar r_showPortalFloodCache;		// print the portal flood cache result and time for each view
 extern idCVar r_singleSurface;				// suppress all but one surface on each entity
 extern idCVar r_shadowPolygonOffset;		// bias value added to depth test for stencil shadow drawing
 extern idCVar r_shadowPolygonFactor;		// scale value for stencil shadow drawing
@@ -959,6 +978,7 @@ extern idCVar r_debugRenderToTexture;
 
 extern idCVar stereoRender_deGhost;			// subtract from opposite eye to reduce ghosting
 
+extern idCVar r_useTraceBVH;				// trace static surfaces through their triangle hierarchy
 extern idCVar r_useGPUSkinning;
 
 /*
@@ -1148,6 +1168,43 @@ void R_LinkDrawSurfToView( drawSurf_t * drawSurf, viewDef_t * viewDef );
 
 void R_AddModels();
 
+/*
+============================================================
+
+TR_FRONTEND_SKINNING
+
+============================================================
+*/
+
+const int MAX_SKINNING_JOBS = 256;
+
+struct skinnedSurface_t {
+	idDrawVert *				verts;			// skinned vertices used by the CPU
+	idDrawVert *				cacheVerts;		// optional mapped vertex cache memory that receives a copy
+	const idDrawVert *			baseVerts;
+	const idJointMat *			joints;
+	int							numVerts;
+};
+
+void TransformVertsAndTangents( idDrawVert * targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints );
+
+bool R_DeferSkinning( srfTriangles_t * tri, const idDrawVert * baseVerts, const idJointMat * joints );
+void R_SkinSurfaces( const skinnedSurface_t * surfaces, const int numSurfaces, idParallelJobList * jobList );
+void R_InstantiateSkinnedModels();
+
+/*
+============================================================
+
+TR_FRONTEND_SORT
+
+============================================================
+*/
+
+void R_SortDrawSurfs( drawSurf_t ** drawSurfs, const int numDrawSurfs );
+void R_SortDrawSurfsWithJobs( drawSurf_t ** drawSurfs, const int numDrawSurfs, idParallelJobList * jobList );
+void R_CaptureDrawSurfs_f( const idCmdArgs & args );
+void R_TestDrawSurfSort_f( const idCmdArgs & args );
+
 /*
 =============================================================
 
@@ -1220,6 +1277,7 @@ void				R_RangeCheckIndexes( const srfTriangles_t *tri );
 void				R_CreateVertexNormals( srfTriangles_t *tri );		// also called by dmap
 void				R_CleanupTriangles( srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents );
 void				R_ReverseTriangles( srfTriangles_t *tri );
+void				R_TestSilEdges_f( const idCmdArgs &args );
 
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
 // Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
@@ -1262,6 +1320,8 @@ struct deformInfo_t {
 	int					numSilEdges;			// number of silhouette edges
 	silEdge_t *			silEdges;				// silhouette edges
 
+	byte *				arrayBlock;				// if not NULL, all of the above arrays point into this single block
+
 	vertCacheHandle_t	staticIndexCache;		// GL_INDEX_TYPE
 	vertCacheHandle_t	staticAmbientCache;		// idDrawVert
 	vertCacheHandle_t	staticShadowCache;		// idShadowCacheSkinned
@@ -1274,6 +1334,34 @@ deformInfo_t *		R_BuildDeformInfo( int numVerts, const idDrawVert *verts, int nu
 void				R_FreeDeformInfo( deformInfo_t *deformInfo );
 int					R_DeformInfoMemoryUsed( deformInfo_t *deformInfo );
 
+// binary models store all the arrays of a static surface or deformInfo_t in one block,
+// each array 16 byte aligned and in native byte order, so loading them is a single read
+// followed by pointer fixups instead of a read and byte swap per element
+enum triArray_t {
+	TRI_ARRAY_VERTS,
+	TRI_ARRAY_INDEXES,
+	TRI_ARRAY_SIL_INDEXES,
+	TRI_ARRAY_MIRRORED_VERTS,
+	TRI_ARRAY_DUP_VERTS,
+	TRI_ARRAY_SIL_EDGES,
+	TRI_ARRAY_DOMINANT_TRIS,
+	TRI_ARRAY_COUNT
+};
+
+struct triArrayBlock_t {
+	int					offsets[TRI_ARRAY_COUNT];
+	int					sizes[TRI_ARRAY_COUNT];
+	int					totalSize;
+
+	// NULL for arrays that aren't present
+	void *				Array( byte *block, triArray_t array ) const { return ( sizes[array] > 0 ) ? block + offsets[array] : NULL; }
+};
+
+void				R_TriArrayBlockLayout( triArrayBlock_t & layout, int numVerts, bool verts, int numIndexes, bool silIndexes,
+										int numMirroredVerts, int numDupVerts, int numSilEdges, bool dominantTris );
+void				R_WriteTriArrayBlock( idFile *file, const triArrayBlock_t & layout, const void * const arrays[TRI_ARRAY_COUNT] );
+bool				R_ReadTriArrayBlock( idFile *file, const triArrayBlock_t & layout, byte **block );
+
 /*
 =============================================================
 
@@ -1293,6 +1381,32 @@ struct localTrace_t {
 localTrace_t R_LocalTrace( const idVec3 &start, const idVec3 &end, const float radius, const srfTriangles_t *tri );
 void RB_ShowTrace( drawSurf_t **drawSurfs, int numDrawSurfs );
 
+// bounding volume hierarchy over the triangles of a static surface, so a trace
+// only tests the triangles near the ray instead of classifying every vertex
+struct triBVHNode_t {
+	float			mins[3];
+	int				first;			// first of the two child nodes, or first entry in triBVH_t::tris for a leaf
+	float			maxs[3];
+	int				numTris;		// zero for interior nodes
+};
+
+struct triBVH_t {
+	int				numNodes;
+	triBVHNode_t *	nodes;			// nodes[0] is the root
+	int				numTris;
+	int *			tris;			// first index of each triangle, in leaf order
+};
+
+static const int	MIN_TRI_BVH_TRIS = 32;		// smaller surfaces are traced brute force
+static const int	MAX_TRI_BVH_LEAF_TRIS = 4;
+
+triBVH_t *			R_BuildTriBVH( const srfTriangles_t *tri );
+void				R_FreeTriBVH( triBVH_t *bvh );
+int					R_TriBVHMemoryUsed( const triBVH_t *bvh );
+void				R_WriteTriBVH( idFile *file, const triBVH_t *bvh );
+triBVH_t *			R_ReadTriBVH( idFile *file );
+void				R_TestTraceBVH_f( const idCmdArgs &args );
+
 /*
 =============================================================
 
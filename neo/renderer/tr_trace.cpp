@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../idlib/geometry/DrawVert_intrinsics.h"
 
+idCVar r_useTraceBVH( "r_useTraceBVH", "1", CVAR_RENDERER | CVAR_BOOL, "trace static surfaces through their triangle hierarchy instead of testing every triangle" );
+
 /*
 ====================
 R_TracePointCullStatic
@@ -549,10 +551,10 @@ static bool R_LineIntersectsTriangleExpandedWithCircle( localTrace_t & hit, cons
 
 /*
 ====================
-R_LocalTrace
+R_LocalTraceBruteForce
 ====================
 */
-localTrace_t R_LocalTrace( const idVec3 &start, const idVec3 &end, const float radius, const srfTriangles_t *tri ) {
+static localTrace_t R_LocalTraceBruteForce( const idVec3 &start, const idVec3 &end, const float radius, const srfTriangles_t *tri ) {
 	localTrace_t hit;
 	hit.fraction = 1.0f;
 
@@ -629,3 +631,610 @@ localTrace_t R_LocalTrace( const idVec3 &start, const idVec3 &end, const float r
 
 	return hit;
 }
+
+/*
+=======================================================================
+
+Triangle bounding volume hierarchy
+
+=======================================================================
+*/
+
+static const int TRI_BVH_BINS			= 8;
+static const int TRI_BVH_MAX_DEPTH		= 60;
+static const int TRI_BVH_STACK_SIZE		= TRI_BVH_MAX_DEPTH + 2;
+
+// only reject a triangle plane in the SIMD pre-test when the ray is clearly on one side of it,
+// so the exact test always sees the triangles it would have accepted
+static const float TRI_BVH_PLANE_EPSILON	= 0.1f;
+
+struct triBVHBuild_t {
+	int		node;
+	int		first;
+	int		numTris;
+	int		depth;
+};
+
+struct triBVHStack_t {
+	int		node;
+	float	nearFraction;
+};
+
+struct triBVHRay_t {
+	ALIGNTYPE16 float	start[4];
+	ALIGNTYPE16 float	invDir[4];
+	float				radius;
+};
+
+/*
+====================
+R_BoundsHalfArea
+====================
+*/
+static float R_BoundsHalfArea( const idBounds & bounds ) {
+	const idVec3 size = bounds[1] - bounds[0];
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+/*
+====================
+R_BuildTriBVH
+
+Top down build with a binned surface area heuristic on the triangle centroids.
+Returns NULL for surfaces that are small enough to trace brute force.
+====================
+*/
+triBVH_t * R_BuildTriBVH( const srfTriangles_t *tri ) {
+	const int numTris = tri->numIndexes / 3;
+	if ( numTris < MIN_TRI_BVH_TRIS || tri->verts == NULL || tri->indexes == NULL ) {
+		return NULL;
+	}
+
+	idTempArray< idBounds > triBounds( numTris );
+	idTempArray< idVec3 > centroids( numTris );
+	idTempArray< int > tris( numTris );
+	idTempArray< triBVHNode_t > nodes( numTris * 2 - 1 );
+
+	for ( int i = 0; i < numTris; i++ ) {
+		triBounds[i].Clear();
+		triBounds[i].AddPoint( tri->verts[tri->indexes[i * 3 + 0]].xyz );
+		triBounds[i].AddPoint( tri->verts[tri->indexes[i * 3 + 1]].xyz );
+		triBounds[i].AddPoint( tri->verts[tri->indexes[i * 3 + 2]].xyz );
+		centroids[i] = triBounds[i].GetCenter();
+		tris[i] = i;
+	}
+
+	idList< triBVHBuild_t, TAG_TEMP > stack;
+	triBVHBuild_t & root = stack.Alloc();
+	root.node = 0;
+	root.first = 0;
+	root.numTris = numTris;
+	root.depth = 0;
+
+	int numNodes = 1;
+	while ( stack.Num() > 0 ) {
+		const triBVHBuild_t build = stack[stack.Num() - 1];
+		stack.SetNum( stack.Num() - 1 );
+
+		idBounds bounds;
+		idBounds centroidBounds;
+		bounds.Clear();
+		centroidBounds.Clear();
+		for ( int i = build.first; i < build.first + build.numTris; i++ ) {
+			bounds.AddBounds( triBounds[tris[i]] );
+			centroidBounds.AddPoint( centroids[tris[i]] );
+		}
+
+		triBVHNode_t & node = nodes[build.node];
+		for ( int i = 0; i < 3; i++ ) {
+			node.mins[i] = bounds[0][i];
+			node.maxs[i] = bounds[1][i];
+		}
+
+		if ( build.numTris <= MAX_TRI_BVH_LEAF_TRIS || build.depth >= TRI_BVH_MAX_DEPTH ) {
+			node.first = build.first;
+			node.numTris = build.numTris;
+			continue;
+		}
+
+		const idVec3 centroidSize = centroidBounds[1] - centroidBounds[0];
+		int axis = 0;
+		if ( centroidSize[1] > centroidSize[axis] ) {
+			axis = 1;
+		}
+		if ( centroidSize[2] > centroidSize[axis] ) {
+			axis = 2;
+		}
+
+		int mid = build.first + build.numTris / 2;
+		if ( centroidSize[axis] > 0.0f ) {
+			// bin the centroids along the axis and pick the cheapest split between two bins
+			const float binScale = TRI_BVH_BINS * 0.9999f / centroidSize[axis];
+			const float binMin = centroidBounds[0][axis];
+
+			int binCount[TRI_BVH_BINS] = { 0 };
+			idBounds binBounds[TRI_BVH_BINS];
+			for ( int i = 0; i < TRI_BVH_BINS; i++ ) {
+				binBounds[i].Clear();
+			}
+			for ( int i = build.first; i < build.first + build.numTris; i++ ) {
+				const int bin = idMath::ClampInt( 0, TRI_BVH_BINS - 1, idMath::Ftoi( ( centroids[tris[i]][axis] - binMin ) * binScale ) );
+				binCount[bin]++;
+				binBounds[bin].AddBounds( triBounds[tris[i]] );
+			}
+
+			float rightCost[TRI_BVH_BINS];
+			idBounds rightBounds;
+			rightBounds.Clear();
+			int rightCount = 0;
+			for ( int i = TRI_BVH_BINS - 1; i > 0; i-- ) {
+				rightBounds.AddBounds( binBounds[i] );
+				rightCount += binCount[i];
+				rightCost[i] = ( rightCount > 0 ) ? R_BoundsHalfArea( rightBounds ) * rightCount : 0.0f;
+			}
+
+			int bestSplit = 0;
+			float bestCost = idMath::INFINITY;
+			idBounds leftBounds;
+			leftBounds.Clear();
+			int leftCount = 0;
+			for ( int i = 1; i < TRI_BVH_BINS; i++ ) {
+				leftBounds.AddBounds( binBounds[i - 1] );
+				leftCount += binCount[i - 1];
+				if ( leftCount == 0 || leftCount == build.numTris ) {
+					continue;
+				}
+				const float cost = R_BoundsHalfArea( leftBounds ) * leftCount + rightCost[i];
+				if ( cost < bestCost ) {
+					bestCost = cost;
+					bestSplit = i;
+				}
+			}
+
+			if ( bestSplit > 0 ) {
+				int i = build.first;
+				int j = build.first + build.numTris - 1;
+				while ( i <= j ) {
+					const int bin = idMath::ClampInt( 0, TRI_BVH_BINS - 1, idMath::Ftoi( ( centroids[tris[i]][axis] - binMin ) * binScale ) );
+					if ( bin < bestSplit ) {
+						i++;
+					} else {
+						SwapValues( tris[i], tris[j] );
+						j--;
+					}
+				}
+				mid = i;
+			}
+		}
+
+		node.first = numNodes;
+		node.numTris = 0;
+
+		triBVHBuild_t & left = stack.Alloc();
+		left.node = numNodes + 0;
+		left.first = build.first;
+		left.numTris = mid - build.first;
+		left.depth = build.depth + 1;
+
+		triBVHBuild_t & right = stack.Alloc();
+		right.node = numNodes + 1;
+		right.first = mid;
+		right.numTris = build.first + build.numTris - mid;
+		right.depth = build.depth + 1;
+
+		numNodes += 2;
+	}
+
+	triBVH_t * bvh = (triBVH_t *)Mem_ClearedAlloc( sizeof( triBVH_t ), TAG_TRI_BVH );
+	bvh->numNodes = numNodes;
+	bvh->nodes = (triBVHNode_t *)Mem_Alloc16( numNodes * sizeof( triBVHNode_t ), TAG_TRI_BVH );
+	memcpy( bvh->nodes, nodes.Ptr(), numNodes * sizeof( triBVHNode_t ) );
+	bvh->numTris = numTris;
+	bvh->tris = (int *)Mem_Alloc( numTris * sizeof( int ), TAG_TRI_BVH );
+	for ( int i = 0; i < numTris; i++ ) {
+		bvh->tris[i] = tris[i] * 3;
+	}
+	return bvh;
+}
+
+/*
+====================
+R_FreeTriBVH
+====================
+*/
+void R_FreeTriBVH( triBVH_t *bvh ) {
+	if ( bvh == NULL ) {
+		return;
+	}
+	Mem_Free( bvh->nodes );
+	Mem_Free( bvh->tris );
+	Mem_Free( bvh );
+}
+
+/*
+====================
+R_TriBVHMemoryUsed
+====================
+*/
+int R_TriBVHMemoryUsed( const triBVH_t *bvh ) {
+	if ( bvh == NULL ) {
+		return 0;
+	}
+	return sizeof( *bvh ) + bvh->numNodes * sizeof( bvh->nodes[0] ) + bvh->numTris * sizeof( bvh->tris[0] );
+}
+
+/*
+====================
+R_WriteTriBVH
+====================
+*/
+void R_WriteTriBVH( idFile *file, const triBVH_t *bvh ) {
+	file->WriteBig( bvh != NULL );
+	if ( bvh == NULL ) {
+		return;
+	}
+	file->WriteBig( bvh->numNodes );
+	for ( int i = 0; i < bvh->numNodes; i++ ) {
+		const triBVHNode_t & node = bvh->nodes[i];
+		file->WriteBigArray( node.mins, 3 );
+		file->WriteBig( node.first );
+		file->WriteBigArray( node.maxs, 3 );
+		file->WriteBig( node.numTris );
+	}
+	file->WriteBig( bvh->numTris );
+	file->WriteBigArray( bvh->tris, bvh->numTris );
+}
+
+/*
+====================
+R_ReadTriBVH
+====================
+*/
+triBVH_t * R_ReadTriBVH( idFile *file ) {
+	bool hasBVH = false;
+	file->ReadBig( hasBVH );
+	if ( !hasBVH ) {
+		return NULL;
+	}
+	triBVH_t * bvh = (triBVH_t *)Mem_ClearedAlloc( sizeof( triBVH_t ), TAG_TRI_BVH );
+	file->ReadBig( bvh->numNodes );
+	bvh->nodes = (triBVHNode_t *)Mem_Alloc16( bvh->numNodes * sizeof( triBVHNode_t ), TAG_TRI_BVH );
+	for ( int i = 0; i < bvh->numNodes; i++ ) {
+		triBVHNode_t & node = bvh->nodes[i];
+		file->ReadBigArray( node.mins, 3 );
+		file->ReadBig( node.first );
+		file->ReadBigArray( node.maxs, 3 );
+		file->ReadBig( node.numTris );
+	}
+	file->ReadBig( bvh->numTris );
+	bvh->tris = (int *)Mem_Alloc( bvh->numTris * sizeof( int ), TAG_TRI_BVH );
+	file->ReadBigArray( bvh->tris, bvh->numTris );
+	return bvh;
+}
+
+/*
+====================
+R_RayIntersectsTriBVHNode
+
+Slab test of the ray against the node bounds expanded with the trace radius.
+====================
+*/
+static ID_FORCE_INLINE bool R_RayIntersectsTriBVHNode( const triBVHNode_t & node, const triBVHRay_t & ray, const float maxFraction, float & nearFraction ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 radius = _mm_set1_ps( ray.radius );
+	const __m128 start = _mm_load_ps( ray.start );
+	const __m128 invDir = _mm_load_ps( ray.invDir );
+
+	// the fourth lane holds the node first / numTris and is ignored
+	const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_loadu_ps( node.mins ), radius ), start ), invDir );
+	const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_add_ps( _mm_loadu_ps( node.maxs ), radius ), start ), invDir );
+
+	const __m128 tMin = _mm_min_ps( t0, t1 );
+	const __m128 tMax = _mm_max_ps( t0, t1 );
+
+	__m128 tNear = _mm_max_ss( _mm_max_ss( tMin, _mm_shuffle_ps( tMin, tMin, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ), _mm_shuffle_ps( tMin, tMin, _MM_SHUFFLE( 3, 1, 0, 2 ) ) );
+	__m128 tFar = _mm_min_ss( _mm_min_ss( tMax, _mm_shuffle_ps( tMax, tMax, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ), _mm_shuffle_ps( tMax, tMax, _MM_SHUFFLE( 3, 1, 0, 2 ) ) );
+
+	tNear = _mm_max_ss( tNear, _mm_setzero_ps() );
+	tFar = _mm_min_ss( tFar, _mm_load_ss( &maxFraction ) );
+
+	_mm_store_ss( &nearFraction, tNear );
+	return _mm_comile_ss( tNear, tFar ) != 0;
+
+#else
+
+	float tNear = 0.0f;
+	float tFar = maxFraction;
+	for ( int i = 0; i < 3; i++ ) {
+		const float t0 = ( node.mins[i] - ray.radius - ray.start[i] ) * ray.invDir[i];
+		const float t1 = ( node.maxs[i] + ray.radius - ray.start[i] ) * ray.invDir[i];
+		tNear = Max( tNear, Min( t0, t1 ) );
+		tFar = Min( tFar, Max( t0, t1 ) );
+	}
+	nearFraction = tNear;
+	return tNear <= tFar;
+
+#endif
+}
+
+/*
+====================
+R_TriBVHPlaneMask
+
+Returns a bit for each of up to four triangles whose plane the ray may cross from
+the front side, the remaining triangles can't be hit.
+====================
+*/
+static ID_FORCE_INLINE int R_TriBVHPlaneMask( const triBVHRay_t & ray, const idVec3 & end, const srfTriangles_t *tri, const int *tris, const int numTris ) {
+	const int allTris = ( 1 << numTris ) - 1;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	__m128 v0[4];
+	__m128 v1[4];
+	__m128 v2[4];
+	for ( int i = 0; i < 4; i++ ) {
+		const int t = tris[ ( i < numTris ) ? i : 0 ];
+		v0[i] = _mm_loadu_ps( tri->verts[tri->indexes[t + 0]].xyz.ToFloatPtr() );
+		v1[i] = _mm_loadu_ps( tri->verts[tri->indexes[t + 1]].xyz.ToFloatPtr() );
+		v2[i] = _mm_loadu_ps( tri->verts[tri->indexes[t + 2]].xyz.ToFloatPtr() );
+	}
+	_MM_TRANSPOSE4_PS( v0[0], v0[1], v0[2], v0[3] );
+	_MM_TRANSPOSE4_PS( v1[0], v1[1], v1[2], v1[3] );
+	_MM_TRANSPOSE4_PS( v2[0], v2[1], v2[2], v2[3] );
+
+	// same winding as idPlane::FromPoints
+	const __m128 e1X = _mm_sub_ps( v0[0], v1[0] );
+	const __m128 e1Y = _mm_sub_ps( v0[1], v1[1] );
+	const __m128 e1Z = _mm_sub_ps( v0[2], v1[2] );
+	const __m128 e2X = _mm_sub_ps( v2[0], v1[0] );
+	const __m128 e2Y = _mm_sub_ps( v2[1], v1[1] );
+	const __m128 e2Z = _mm_sub_ps( v2[2], v1[2] );
+
+	const __m128 nX = _mm_sub_ps( _mm_mul_ps( e1Y, e2Z ), _mm_mul_ps( e1Z, e2Y ) );
+	const __m128 nY = _mm_sub_ps( _mm_mul_ps( e1Z, e2X ), _mm_mul_ps( e1X, e2Z ) );
+	const __m128 nZ = _mm_sub_ps( _mm_mul_ps( e1X, e2Y ), _mm_mul_ps( e1Y, e2X ) );
+
+	const __m128 sX = _mm_sub_ps( _mm_set1_ps( ray.start[0] ), v1[0] );
+	const __m128 sY = _mm_sub_ps( _mm_set1_ps( ray.start[1] ), v1[1] );
+	const __m128 sZ = _mm_sub_ps( _mm_set1_ps( ray.start[2] ), v1[2] );
+	const __m128 eX = _mm_sub_ps( _mm_set1_ps( end.x ), v1[0] );
+	const __m128 eY = _mm_sub_ps( _mm_set1_ps( end.y ), v1[1] );
+	const __m128 eZ = _mm_sub_ps( _mm_set1_ps( end.z ), v1[2] );
+
+	const __m128 dStart = _mm_madd_ps( nX, sX, _mm_madd_ps( nY, sY, _mm_mul_ps( nZ, sZ ) ) );
+	const __m128 dEnd = _mm_madd_ps( nX, eX, _mm_madd_ps( nY, eY, _mm_mul_ps( nZ, eZ ) ) );
+
+	// the distances are scaled by the normal length, so compare squares against the squared length
+	const __m128 epsilonSqr = _mm_mul_ps( _mm_set1_ps( TRI_BVH_PLANE_EPSILON * TRI_BVH_PLANE_EPSILON ),
+									_mm_madd_ps( nX, nX, _mm_madd_ps( nY, nY, _mm_mul_ps( nZ, nZ ) ) ) );
+	const __m128 zero = _mm_setzero_ps();
+
+	const __m128 startBehind = _mm_and_ps( _mm_cmplt_ps( dStart, zero ), _mm_cmpgt_ps( _mm_mul_ps( dStart, dStart ), epsilonSqr ) );
+	const __m128 endInFront = _mm_and_ps( _mm_cmpgt_ps( dEnd, zero ), _mm_cmpgt_ps( _mm_mul_ps( dEnd, dEnd ), epsilonSqr ) );
+
+	return ~_mm_movemask_ps( _mm_or_ps( startBehind, endInFront ) ) & allTris;
+
+#else
+
+	return allTris;
+
+#endif
+}
+
+/*
+====================
+R_LocalTraceBVH
+====================
+*/
+static localTrace_t R_LocalTraceBVH( const idVec3 &start, const idVec3 &end, const float radius, const srfTriangles_t *tri ) {
+	localTrace_t hit;
+	hit.fraction = 1.0f;
+
+	const triBVH_t * bvh = tri->bvh;
+
+	triBVHRay_t ray;
+	const idVec3 dir = end - start;
+	for ( int i = 0; i < 3; i++ ) {
+		ray.start[i] = start[i];
+		// avoid infinities so the slab test never multiplies zero by infinity
+		if ( idMath::Fabs( dir[i] ) > 1e-20f ) {
+			ray.invDir[i] = 1.0f / dir[i];
+		} else {
+			ray.invDir[i] = ( dir[i] < 0.0f ) ? -1e20f : 1e20f;
+		}
+	}
+	ray.start[3] = 0.0f;
+	ray.invDir[3] = 0.0f;
+	ray.radius = radius;
+
+	triBVHStack_t stack[TRI_BVH_STACK_SIZE];
+	int stackDepth = 0;
+
+	float nearFraction;
+	if ( !R_RayIntersectsTriBVHNode( bvh->nodes[0], ray, hit.fraction, nearFraction ) ) {
+		return hit;
+	}
+	stack[stackDepth].node = 0;
+	stack[stackDepth].nearFraction = nearFraction;
+	stackDepth++;
+
+	while ( stackDepth > 0 ) {
+		stackDepth--;
+		if ( stack[stackDepth].nearFraction >= hit.fraction ) {
+			continue;		// already hit something closer than anything in this node
+		}
+
+		const triBVHNode_t & node = bvh->nodes[stack[stackDepth].node];
+
+		if ( node.numTris > 0 ) {
+			for ( int i = 0; i < node.numTris; i += 4 ) {
+				const int * tris = bvh->tris + node.first + i;
+				const int numTris = Min( node.numTris - i, 4 );
+				const int planeMask = R_TriBVHPlaneMask( ray, end, tri, tris, numTris );
+				for ( int j = 0; j < numTris; j++ ) {
+					if ( ( planeMask & ( 1 << j ) ) == 0 ) {
+						continue;
+					}
+					const int i0 = tri->indexes[tris[j] + 0];
+					const int i1 = tri->indexes[tris[j] + 1];
+					const int i2 = tri->indexes[tris[j] + 2];
+					if ( R_LineIntersectsTriangleExpandedWithCircle( hit, start, end, radius, tri->verts[i0].xyz, tri->verts[i1].xyz, tri->verts[i2].xyz ) ) {
+						hit.indexes[0] = i0;
+						hit.indexes[1] = i1;
+						hit.indexes[2] = i2;
+					}
+				}
+			}
+			continue;
+		}
+
+		float nearFraction0;
+		float nearFraction1;
+		const bool hit0 = R_RayIntersectsTriBVHNode( bvh->nodes[node.first + 0], ray, hit.fraction, nearFraction0 );
+		const bool hit1 = R_RayIntersectsTriBVHNode( bvh->nodes[node.first + 1], ray, hit.fraction, nearFraction1 );
+
+		if ( stackDepth + 2 > TRI_BVH_STACK_SIZE ) {
+			// only a hierarchy from a corrupt file can be this deep
+			assert( false );
+			return R_LocalTraceBruteForce( start, end, radius, tri );
+		}
+
+		// push the far child first so the near child is visited first
+		if ( hit0 && hit1 ) {
+			const int nearChild = ( nearFraction0 <= nearFraction1 ) ? 0 : 1;
+			stack[stackDepth].node = node.first + ( nearChild ^ 1 );
+			stack[stackDepth].nearFraction = ( nearChild == 0 ) ? nearFraction1 : nearFraction0;
+			stackDepth++;
+			stack[stackDepth].node = node.first + nearChild;
+			stack[stackDepth].nearFraction = ( nearChild == 0 ) ? nearFraction0 : nearFraction1;
+			stackDepth++;
+		} else if ( hit0 ) {
+			stack[stackDepth].node = node.first;
+			stack[stackDepth].nearFraction = nearFraction0;
+			stackDepth++;
+		} else if ( hit1 ) {
+			stack[stackDepth].node = node.first + 1;
+			stack[stackDepth].nearFraction = nearFraction1;
+			stackDepth++;
+		}
+	}
+
+	return hit;
+}
+
+/*
+====================
+R_LocalTrace
+====================
+*/
+localTrace_t R_LocalTrace( const idVec3 &start, const idVec3 &end, const float radius, const srfTriangles_t *tri ) {
+	// skinned surfaces move their vertices on the GPU, so the hierarchy doesn't apply
+	const bool skinned = ( tri->staticModelWithJoints != NULL && r_useGPUSkinning.GetBool() );
+	if ( tri->bvh != NULL && !skinned && r_useTraceBVH.GetBool() ) {
+		return R_LocalTraceBVH( start, end, radius, tri );
+	}
+	return R_LocalTraceBruteForce( start, end, radius, tri );
+}
+
+/*
+====================
+R_TestTraceBVH_f
+
+Traces random rays through every static surface with a hierarchy in the
+current map, brute force and through the hierarchy, and compares the results.
+
+testTraceBVH [raysPerSurface] [radius]
+====================
+*/
+void R_TestTraceBVH_f( const idCmdArgs &args ) {
+	idRenderWorldLocal * world = tr.primaryWorld;
+	if ( world == NULL ) {
+		common->Printf( "testTraceBVH: no world loaded\n" );
+		return;
+	}
+
+	const int raysPerSurface = ( args.Argc() > 1 ) ? idMath::ClampInt( 1, 1 << 16, atoi( args.Argv( 1 ) ) ) : 256;
+	const float radius = ( args.Argc() > 2 ) ? Max( 0.0f, (float)atof( args.Argv( 2 ) ) ) : 0.0f;
+
+	// the world area models and every static entity model
+	idList< const idRenderModel * > models;
+	for ( int i = 0; i < world->localModels.Num(); i++ ) {
+		models.AddUnique( world->localModels[i] );
+	}
+	for ( int i = 0; i < world->entityDefs.Num(); i++ ) {
+		const idRenderEntityLocal * def = world->entityDefs[i];
+		if ( def != NULL && def->parms.hModel != NULL && def->parms.hModel->IsDynamicModel() == DM_STATIC ) {
+			models.AddUnique( def->parms.hModel );
+		}
+	}
+
+	idRandom random( 0 );
+	idList< idVec3 > starts;
+	idList< idVec3 > ends;
+	idList< float > fractions;
+	starts.SetNum( raysPerSurface );
+	ends.SetNum( raysPerSurface );
+	fractions.SetNum( raysPerSurface );
+
+	int numSurfaces = 0;
+	int numTris = 0;
+	int numHits = 0;
+	int numMismatches = 0;
+	int bvhBytes = 0;
+	uint64 bruteForceMicroseconds = 0;
+	uint64 bvhMicroseconds = 0;
+
+	for ( int m = 0; m < models.Num(); m++ ) {
+		const idRenderModel * model = models[m];
+		for ( int s = 0; s < model->NumSurfaces(); s++ ) {
+			const srfTriangles_t * tri = model->Surface( s )->geometry;
+			if ( tri == NULL || tri->bvh == NULL ) {
+				continue;
+			}
+			numSurfaces++;
+			numTris += tri->numIndexes / 3;
+			bvhBytes += R_TriBVHMemoryUsed( tri->bvh );
+
+			// rays from a sphere around the surface towards random points inside its bounds
+			const idVec3 center = tri->bounds.GetCenter();
+			const float sphereRadius = tri->bounds.GetRadius( center ) * 1.5f + 1.0f;
+			for ( int i = 0; i < raysPerSurface; i++ ) {
+				idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+				if ( dir.Normalize() < 0.001f ) {
+					dir.Set( 0.0f, 0.0f, 1.0f );
+				}
+				starts[i] = center + dir * sphereRadius;
+				for ( int j = 0; j < 3; j++ ) {
+					ends[i][j] = tri->bounds[0][j] + random.RandomFloat() * ( tri->bounds[1][j] - tri->bounds[0][j] );
+				}
+				ends[i] += ( ends[i] - starts[i] );
+			}
+
+			uint64 start = Sys_Microseconds();
+			for ( int i = 0; i < raysPerSurface; i++ ) {
+				fractions[i] = R_LocalTraceBruteForce( starts[i], ends[i], radius, tri ).fraction;
+			}
+			bruteForceMicroseconds += Sys_Microseconds() - start;
+
+			start = Sys_Microseconds();
+			for ( int i = 0; i < raysPerSurface; i++ ) {
+				const float fraction = R_LocalTraceBVH( starts[i], ends[i], radius, tri ).fraction;
+				if ( fraction < 1.0f ) {
+					numHits++;
+				}
+				if ( idMath::Fabs( fraction - fractions[i] ) > 1e-5f ) {
+					numMismatches++;
+				}
+			}
+			bvhMicroseconds += Sys_Microseconds() - start;
+		}
+	}
+
+	const int numRays = numSurfaces * raysPerSurface;
+	common->Printf( "%i models, %i surfaces with a hierarchy, %i triangles, %i kB of hierarchy\n", models.Num(), numSurfaces, numTris, bvhBytes >> 10 );
+	common->Printf( "%i rays, radius %.1f, %i hits, %i mismatches\n", numRays, radius, numHits, numMismatches );
+	common->Printf( "brute force: %6i usec, %8.0f rays/sec\n", (int)bruteForceMicroseconds, numRays * 1000000.0 / Max( bruteForceMicroseconds, (uint64)1 ) );
+	common->Printf( "hierarchy:   %6i usec, %8.0f rays/sec\n", (int)bvhMicroseconds, numRays * 1000000.0 / Max( bvhMicroseconds, (uint64)1 ) );
+}
@@ -159,6 +159,9 @@ int R_TriSurfMemory( const srfTriangles_t *tri ) {
 	if ( tri->dupVerts != NULL ) {
 		total += tri->numDupVerts * sizeof( tri->dupVerts[0] );
 	}
+	if ( tri->bvh != NULL ) {
+		total += R_TriBVHMemoryUsed( tri->bvh );
+	}
 
 	total += sizeof( *tri );
 
@@ -190,7 +193,8 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 
 	R_FreeStaticTriSurfVertexCaches( tri );
 
-	if ( !tri->referencedVerts ) {
+	// surfaces loaded from a binary model have all their arrays in a single block
+	if ( !tri->referencedVerts && tri->arrayBlock == NULL ) {
 		if ( tri->verts != NULL ) {
 			// R_CreateLightTris points tri->verts at the verts of the ambient surface
 			if ( tri->ambientSurface == NULL || tri->verts != tri->ambientSurface->verts ) {
@@ -199,7 +203,7 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 		}
 	}
 
-	if ( !tri->referencedIndexes ) {
+	if ( !tri->referencedIndexes && tri->arrayBlock == NULL ) {
 		if ( tri->indexes != NULL ) {
 			// if a surface is completely inside a light volume R_CreateLightTris points tri->indexes at the indexes of the ambient surface
 			if ( tri->ambientSurface == NULL || tri->indexes != tri->ambientSurface->indexes ) {
@@ -229,6 +233,12 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 	if ( tri->staticShadowVertexes != NULL ) {
 		Mem_Free( tri->staticShadowVertexes );
 	}
+	if ( tri->bvh != NULL ) {
+		R_FreeTriBVH( tri->bvh );
+	}
+	if ( tri->arrayBlock != NULL ) {
+		Mem_Free( tri->arrayBlock );
+	}
 
 	// clear the tri out so we don't retain stale data
 	memset( tri, 0, sizeof( srfTriangles_t ) );
@@ -468,6 +478,24 @@ void R_BoundTriSurf( srfTriangles_t *tri ) {
 	SIMDProcessor->MinMax( tri->bounds[0], tri->bounds[1], tri->verts, tri->numVerts );
 }
 
+/*
+=================
+R_SilRemapKey
+
+Hashes the bits of a position. The sum of the integer parts that idHashIndex::GenerateKey
+uses puts most vertexes of a small, dense model in a handful of hash chains.
+=================
+*/
+static int R_SilRemapKey( const idVec3 &xyz ) {
+	unsigned int bits[3];
+	for ( int i = 0; i < 3; i++ ) {
+		// -0 and 0 compare equal, so they have to hash the same
+		bits[i] = ( xyz[i] == 0.0f ) ? 0 : *reinterpret_cast< const unsigned int * >( &xyz[i] );
+	}
+	const unsigned int hash = ( bits[0] * 73856093 ) ^ ( bits[1] * 19349663 ) ^ ( bits[2] * 83492791 );
+	return (int)( ( hash ^ ( hash >> 16 ) ) & 0x7fffffff );
+}
+
 /*
 =================
 R_CreateSilRemap
@@ -488,7 +516,9 @@ static int *R_CreateSilRemap( const srfTriangles_t *tri ) {
 		return remap;
 	}
 
-	idHashIndex		hash( 1024, tri->numVerts );
+	// only the first of each set of matching verts is added, so the remap
+	// does not depend on the hash size or the order of the hash chains
+	idHashIndex		hash( idMath::CeilPowerOfTwo( Max( tri->numVerts, 64 ) ), tri->numVerts );
 
 	c_removed = 0;
 	c_unique = 0;
@@ -496,7 +526,7 @@ static int *R_CreateSilRemap( const srfTriangles_t *tri ) {
 		v1 = &tri->verts[i];
 
 		// see if there is an earlier vert that it can map to
-		hashKey = hash.GenerateKey( v1->xyz );
+		hashKey = R_SilRemapKey( v1->xyz );
 		for ( j = hash.First( hashKey ); j >= 0; j = hash.Next( j ) ) {
 			v2 = &tri->verts[j];
 			if ( v2->xyz[0] == v1->xyz[0]
@@ -586,11 +616,10 @@ void R_CreateDupVerts( srfTriangles_t *tri ) {
 R_DefineEdge
 ===============
 */
-static int c_duplicatedEdges, c_tripledEdges;
 static const int MAX_SIL_EDGES			= 0x7ffff;
 
 static void R_DefineEdge( const int v1, const int v2, const int planeNum, const int numPlanes,
-	idList<silEdge_t> & silEdges, idHashIndex	& silEdgeHash ) {
+	idList<silEdge_t> & silEdges, idHashIndex	& silEdgeHash, int & c_duplicatedEdges, int & c_tripledEdges ) {
 	int		i, hashKey;
 
 	// check for degenerate edge
@@ -631,6 +660,44 @@ static void R_DefineEdge( const int v1, const int v2, const int planeNum, const
 	silEdges.Append( silEdge );
 }
 
+/*
+=================
+R_CreateSilEdges
+
+Pairs up the edges of the triangles. The hash is sized to the surface, a
+fixed size hash makes the edge search quadratic on large meshes.
+=================
+*/
+static void R_CreateSilEdges( const srfTriangles_t *tri, idList<silEdge_t> & silEdges ) {
+	const int numTris = tri->numIndexes / 3;
+	const int numPlanes = numTris;
+
+	// every index starts at most one edge
+	silEdges.Clear();
+	silEdges.Resize( Max( tri->numIndexes, 1 ) );
+	idHashIndex	silEdgeHash( idMath::CeilPowerOfTwo( Max( tri->numIndexes, 64 ) ), Max( tri->numIndexes, 1 ) );
+
+	int c_duplicatedEdges = 0;
+	int c_tripledEdges = 0;
+
+	for ( int i = 0; i < numTris; i++ ) {
+		int		i1, i2, i3;
+
+		i1 = tri->silIndexes[ i*3 + 0 ];
+		i2 = tri->silIndexes[ i*3 + 1 ];
+		i3 = tri->silIndexes[ i*3 + 2 ];
+
+		// create the edges
+		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+	}
+
+	if ( c_duplicatedEdges || c_tripledEdges ) {
+		common->DWarning( "%i duplicated edge directions, %i tripled edges", c_duplicatedEdges, c_tripledEdges );
+	}
+}
+
 /*
 =================
 SilEdgeSort
@@ -652,6 +719,26 @@ static int SilEdgeSort( const void *a, const void *b ) {
 	return 0;
 }
 
+/*
+=================
+R_SortSilEdges
+
+Edges are created in triangle order, so they are already sorted on the first plane and
+only the edges of a single triangle ever have to move. An insertion sort does that in
+linear time, and unlike qsort it keeps edges with the same planes in creation order.
+=================
+*/
+static void R_SortSilEdges( silEdge_t *silEdges, const int numSilEdges ) {
+	for ( int i = 1; i < numSilEdges; i++ ) {
+		const silEdge_t edge = silEdges[i];
+		int j = i;
+		for ( ; j > 0 && SilEdgeSort( &edge, &silEdges[j - 1] ) < 0; j-- ) {
+			silEdges[j] = silEdges[j - 1];
+		}
+		silEdges[j] = edge;
+	}
+}
+
 /*
 =================
 R_IdentifySilEdges
@@ -660,8 +747,9 @@ If the surface will not deform, coplanar edges (polygon interiors)
 can never create silhouette plains, and can be omited
 =================
 */
-int	c_coplanarSilEdges;
-int	c_totalSilEdges;
+// surfaces can be cleaned up in parallel while a map loads
+idSysInterlockedInteger	c_coplanarSilEdges;
+idSysInterlockedInteger	c_totalSilEdges;
 
 void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 	int		i;
@@ -669,36 +757,10 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 
 	omitCoplanarEdges = false;	// optimization doesn't work for some reason
 
-	static const int SILEDGE_HASH_SIZE		= 1024;
-
-	const int numTris = tri->numIndexes / 3;
-
-	idList<silEdge_t>	silEdges( MAX_SIL_EDGES );
-	idHashIndex	silEdgeHash( SILEDGE_HASH_SIZE, MAX_SIL_EDGES );
-	int			numPlanes = numTris;
+	const int numPlanes = tri->numIndexes / 3;
 
-
-	silEdgeHash.Clear();
-
-	c_duplicatedEdges = 0;
-	c_tripledEdges = 0;
-
-	for ( i = 0; i < numTris; i++ ) {
-		int		i1, i2, i3;
-
-		i1 = tri->silIndexes[ i*3 + 0 ];
-		i2 = tri->silIndexes[ i*3 + 1 ];
-		i3 = tri->silIndexes[ i*3 + 2 ];
-
-		// create the edges
-		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash );
-	}
-
-	if ( c_duplicatedEdges || c_tripledEdges ) {
-		common->DWarning( "%i duplicated edge directions, %i tripled edges", c_duplicatedEdges, c_tripledEdges );
-	}
+	idList<silEdge_t>	silEdges;
+	R_CreateSilEdges( tri, silEdges );
 
 	// if we know that the vertexes aren't going
 	// to deform, we can remove interior triangulation edges
@@ -748,15 +810,15 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 			}
 		}
 		if ( c_coplanarCulled ) {
-			c_coplanarSilEdges += c_coplanarCulled;
+			c_coplanarSilEdges.Add( c_coplanarCulled );
 //			common->Printf( "%i of %i sil edges coplanar culled\n", c_coplanarCulled,
 //				c_coplanarCulled + numSilEdges );
 		}
 	}
-	c_totalSilEdges += silEdges.Num();
+	c_totalSilEdges.Add( silEdges.Num() );
 
 	// sort the sil edges based on plane number
-	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
+	R_SortSilEdges( silEdges.Ptr(), silEdges.Num() );
 
 	// count up the distribution.
 	// a perfectly built model should only have shared
@@ -783,6 +845,235 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 	memcpy( tri->silEdges, silEdges.Ptr(), silEdges.Num() * sizeof( tri->silEdges[0] ) );
 }
 
+/*
+=================
+R_ReferenceSilRemap
+
+The original vertex welding with a fixed size hash, kept to verify the current one.
+=================
+*/
+static void R_ReferenceSilRemap( const srfTriangles_t *tri, int *remap ) {
+	idHashIndex hash( 1024, tri->numVerts );
+	for ( int i = 0; i < tri->numVerts; i++ ) {
+		const idDrawVert * v1 = &tri->verts[i];
+		const int hashKey = hash.GenerateKey( v1->xyz );
+		int j;
+		for ( j = hash.First( hashKey ); j >= 0; j = hash.Next( j ) ) {
+			const idDrawVert * v2 = &tri->verts[j];
+			if ( v2->xyz[0] == v1->xyz[0] && v2->xyz[1] == v1->xyz[1] && v2->xyz[2] == v1->xyz[2] ) {
+				remap[i] = j;
+				break;
+			}
+		}
+		if ( j < 0 ) {
+			remap[i] = i;
+			hash.Add( hashKey, i );
+		}
+	}
+}
+
+/*
+=================
+R_ReferenceSilEdges
+
+The original edge pairing with a fixed size hash and a qsort, kept to verify the current one.
+=================
+*/
+static void R_ReferenceSilEdges( const srfTriangles_t *tri, idList<silEdge_t> & silEdges ) {
+	const int numTris = tri->numIndexes / 3;
+	idHashIndex silEdgeHash( 1024, MAX_SIL_EDGES );
+	int c_duplicatedEdges = 0;
+	int c_tripledEdges = 0;
+
+	silEdges.Clear();
+	silEdges.SetGranularity( MAX_SIL_EDGES );
+	for ( int i = 0; i < numTris; i++ ) {
+		R_DefineEdge( tri->silIndexes[i*3+0], tri->silIndexes[i*3+1], i, numTris, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( tri->silIndexes[i*3+1], tri->silIndexes[i*3+2], i, numTris, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( tri->silIndexes[i*3+2], tri->silIndexes[i*3+0], i, numTris, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+	}
+	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
+}
+
+/*
+=================
+R_SameSilEdges
+
+qsort leaves the order of edges between the same planes unspecified,
+so runs of those only have to hold the same edges.
+=================
+*/
+static bool R_SameSilEdges( const idList<silEdge_t> & a, const idList<silEdge_t> & b ) {
+	if ( a.Num() != b.Num() ) {
+		return false;
+	}
+	for ( int i = 0; i < a.Num(); ) {
+		int end = i + 1;
+		while ( end < a.Num() && SilEdgeSort( &a[end], &a[i] ) == 0 ) {
+			end++;
+		}
+		for ( int j = i; j < end; j++ ) {
+			if ( SilEdgeSort( &b[j], &a[i] ) != 0 ) {
+				return false;
+			}
+			int k;
+			for ( k = i; k < end; k++ ) {
+				if ( b[j].v1 == a[k].v1 && b[j].v2 == a[k].v2 ) {
+					break;
+				}
+			}
+			if ( k == end ) {
+				return false;
+			}
+		}
+		i = end;
+	}
+	return true;
+}
+
+struct silEdgeTiming_t {
+	const char *	modelName;
+	int				numTris;
+	uint64			referenceMicroseconds;
+	uint64			microseconds;
+};
+
+class idSort_SilEdgeTimings : public idSort_Quick< silEdgeTiming_t, idSort_SilEdgeTimings > {
+public:
+	int Compare( const silEdgeTiming_t & a, const silEdgeTiming_t & b ) const {
+		return b.numTris - a.numTris;
+	}
+};
+
+/*
+=================
+R_TestSilEdges_f
+
+Rebuilds the silhouette indexes and edges of every static surface in the current map with
+the original and the current code, compares them, and lists the times of the largest surfaces.
+With "all" it also loads and checks every model listed in the preload manifests of the
+shipped maps.
+
+testSilEdges [numLargest] [all]
+=================
+*/
+void R_TestSilEdges_f( const idCmdArgs &args ) {
+	if ( !r_useSilRemap.GetBool() ) {
+		common->Printf( "testSilEdges: r_useSilRemap is off\n" );
+		return;
+	}
+
+	const int numLargest = ( args.Argc() > 1 ) ? Max( 0, atoi( args.Argv( 1 ) ) ) : 10;
+	const bool allModels = ( args.Argc() > 2 ) && idStr::Icmp( args.Argv( 2 ), "all" ) == 0;
+
+	idRenderWorldLocal * world = tr.primaryWorld;
+	if ( world == NULL && !allModels ) {
+		common->Printf( "testSilEdges: no world loaded\n" );
+		return;
+	}
+
+	// the world area models and every static entity model
+	idList< const idRenderModel * > models;
+	if ( world != NULL ) {
+		for ( int i = 0; i < world->localModels.Num(); i++ ) {
+			models.AddUnique( world->localModels[i] );
+		}
+		for ( int i = 0; i < world->entityDefs.Num(); i++ ) {
+			const idRenderEntityLocal * def = world->entityDefs[i];
+			if ( def != NULL && def->parms.hModel != NULL && def->parms.hModel->IsDynamicModel() == DM_STATIC ) {
+				models.AddUnique( def->parms.hModel );
+			}
+		}
+	}
+
+	// every static model the shipped maps preload
+	if ( allModels ) {
+		idFileList * manifests = fileSystem->ListFilesTree( "maps", ".preload" );
+		for ( int i = 0; i < manifests->GetNumFiles(); i++ ) {
+			idPreloadManifest manifest;
+			if ( !manifest.LoadManifest( manifests->GetFile( i ) ) ) {
+				continue;
+			}
+			for ( int j = 0; j < manifest.NumResources(); j++ ) {
+				const preloadEntry_s & p = manifest.GetPreloadByIndex( j );
+				if ( p.resType != PRELOAD_MODEL ) {
+					continue;
+				}
+				const idRenderModel * model = renderModelManager->FindModel( p.resourceName );
+				if ( model != NULL && !model->IsDefaultModel() && model->IsDynamicModel() == DM_STATIC ) {
+					models.AddUnique( model );
+				}
+			}
+		}
+		fileSystem->FreeFileList( manifests );
+	}
+
+	idList< silEdgeTiming_t > timings;
+	idList< silEdge_t > referenceEdges;
+	idList< silEdge_t > edges;
+	int numMismatches = 0;
+
+	for ( int m = 0; m < models.Num(); m++ ) {
+		const idRenderModel * model = models[m];
+		for ( int s = 0; s < model->NumSurfaces(); s++ ) {
+			const srfTriangles_t * tri = model->Surface( s )->geometry;
+			if ( tri == NULL || tri->verts == NULL || tri->indexes == NULL || tri->silEdges == NULL ) {
+				continue;
+			}
+
+			// work on a copy so the surface itself is left alone
+			srfTriangles_t test = *tri;
+			idTempArray< triIndex_t > referenceSilIndexes( tri->numIndexes );
+			idTempArray< triIndex_t > silIndexes( tri->numIndexes );
+			idTempArray< int > referenceRemap( tri->numVerts );
+
+			silEdgeTiming_t & timing = timings.Alloc();
+			timing.modelName = model->Name();
+			timing.numTris = tri->numIndexes / 3;
+
+			uint64 start = Sys_Microseconds();
+			R_ReferenceSilRemap( tri, referenceRemap.Ptr() );
+			for ( int i = 0; i < tri->numIndexes; i++ ) {
+				referenceSilIndexes[i] = referenceRemap[tri->indexes[i]];
+			}
+			test.silIndexes = referenceSilIndexes.Ptr();
+			R_ReferenceSilEdges( &test, referenceEdges );
+			timing.referenceMicroseconds = Sys_Microseconds() - start;
+
+			start = Sys_Microseconds();
+			int * remap = R_CreateSilRemap( tri );
+			for ( int i = 0; i < tri->numIndexes; i++ ) {
+				silIndexes[i] = remap[tri->indexes[i]];
+			}
+			R_StaticFree( remap );
+			test.silIndexes = silIndexes.Ptr();
+			R_CreateSilEdges( &test, edges );
+			R_SortSilEdges( edges.Ptr(), edges.Num() );
+			timing.microseconds = Sys_Microseconds() - start;
+
+			if ( memcmp( referenceSilIndexes.Ptr(), silIndexes.Ptr(), tri->numIndexes * sizeof( triIndex_t ) ) != 0 || !R_SameSilEdges( referenceEdges, edges ) ) {
+				common->Printf( "%s surface %i: sil edges differ\n", model->Name(), s );
+				numMismatches++;
+			}
+		}
+	}
+
+	timings.SortWithTemplate( idSort_SilEdgeTimings() );
+
+	uint64 referenceMicroseconds = 0;
+	uint64 microseconds = 0;
+	for ( int i = 0; i < timings.Num(); i++ ) {
+		referenceMicroseconds += timings[i].referenceMicroseconds;
+		microseconds += timings[i].microseconds;
+	}
+
+	common->Printf( "   tris  original   current model\n" );
+	for ( int i = 0; i < timings.Num() && i < numLargest; i++ ) {
+		common->Printf( "%7i %7i us %7i us %s\n", timings[i].numTris, (int)timings[i].referenceMicroseconds, (int)timings[i].microseconds, timings[i].modelName );
+	}
+	common->Printf( "%i surfaces, %i mismatches, original %i usec, current %i usec\n", timings.Num(), numMismatches, (int)referenceMicroseconds, (int)microseconds );
+}
+
 /*
 ===============
 R_FaceNegativePolarity
@@ -1837,6 +2128,12 @@ R_FreeDeformInfo
 ===================
 */
 void R_FreeDeformInfo( deformInfo_t *deformInfo ) {
+	if ( deformInfo->arrayBlock != NULL ) {
+		// all the arrays were loaded from a binary model in a single block
+		Mem_Free( deformInfo->arrayBlock );
+		R_StaticFree( deformInfo );
+		return;
+	}
 	if ( deformInfo->verts != NULL ) {
 		Mem_Free( deformInfo->verts );
 	}
@@ -1889,6 +2186,99 @@ int R_DeformInfoMemoryUsed( deformInfo_t *deformInfo ) {
 	return total;
 }
 
+static const unsigned int TRI_ARRAY_BYTE_ORDER = 0x01020304;
+
+/*
+===================
+R_TriArrayBlockLayout
+
+The offsets only depend on the counts, which are stored ahead of the block,
+so the loader can derive them again and only has to fix up the pointers.
+===================
+*/
+void R_TriArrayBlockLayout( triArrayBlock_t & layout, int numVerts, bool verts, int numIndexes, bool silIndexes,
+							int numMirroredVerts, int numDupVerts, int numSilEdges, bool dominantTris ) {
+	layout.sizes[TRI_ARRAY_VERTS] = verts ? numVerts * sizeof( idDrawVert ) : 0;
+	layout.sizes[TRI_ARRAY_INDEXES] = numIndexes * sizeof( triIndex_t );
+	layout.sizes[TRI_ARRAY_SIL_INDEXES] = silIndexes ? numIndexes * sizeof( triIndex_t ) : 0;
+	layout.sizes[TRI_ARRAY_MIRRORED_VERTS] = numMirroredVerts * sizeof( int );
+	layout.sizes[TRI_ARRAY_DUP_VERTS] = numDupVerts * 2 * sizeof( int );
+	layout.sizes[TRI_ARRAY_SIL_EDGES] = numSilEdges * sizeof( silEdge_t );
+	layout.sizes[TRI_ARRAY_DOMINANT_TRIS] = dominantTris ? numVerts * sizeof( dominantTri_t ) : 0;
+
+	layout.totalSize = 0;
+	for ( int i = 0; i < TRI_ARRAY_COUNT; i++ ) {
+		layout.offsets[i] = layout.totalSize;
+		layout.totalSize += ALIGN( layout.sizes[i], 16 );
+	}
+}
+
+/*
+===================
+R_WriteTriArrayBlock
+
+The block starts at a 16 byte aligned file offset, so a mapped view of the
+file could use the arrays in place.
+===================
+*/
+void R_WriteTriArrayBlock( idFile *file, const triArrayBlock_t & layout, const void * const arrays[TRI_ARRAY_COUNT] ) {
+	static const byte zeros[16] = {};
+
+	file->WriteBig( layout.totalSize );
+	if ( layout.totalSize == 0 ) {
+		return;
+	}
+	file->Write( &TRI_ARRAY_BYTE_ORDER, sizeof( TRI_ARRAY_BYTE_ORDER ) );
+	const int offset = file->Tell();
+	file->Write( zeros, ALIGN( offset, 16 ) - offset );
+
+	for ( int i = 0; i < TRI_ARRAY_COUNT; i++ ) {
+		if ( layout.sizes[i] == 0 ) {
+			continue;
+		}
+		assert( arrays[i] != NULL );
+		file->Write( arrays[i], layout.sizes[i] );
+		file->Write( zeros, ALIGN( layout.sizes[i], 16 ) - layout.sizes[i] );
+	}
+}
+
+/*
+===================
+R_ReadTriArrayBlock
+
+Returns false if the block doesn't match the layout or was written with a different byte order.
+===================
+*/
+bool R_ReadTriArrayBlock( idFile *file, const triArrayBlock_t & layout, byte **block ) {
+	*block = NULL;
+
+	int totalSize = 0;
+	file->ReadBig( totalSize );
+	if ( totalSize != layout.totalSize ) {
+		return false;
+	}
+	if ( totalSize == 0 ) {
+		return true;
+	}
+	unsigned int byteOrder = 0;
+	file->Read( &byteOrder, sizeof( byteOrder ) );
+	if ( byteOrder != TRI_ARRAY_BYTE_ORDER ) {
+		return false;
+	}
+	const int offset = file->Tell();
+	if ( ALIGN( offset, 16 ) != offset ) {
+		file->Seek( ALIGN( offset, 16 ) - offset, FS_SEEK_CUR );
+	}
+
+	byte * data = (byte *)Mem_Alloc16( totalSize, TAG_MODEL );
+	if ( file->Read( data, totalSize ) != totalSize ) {
+		Mem_Free( data );
+		return false;
+	}
+	*block = data;
+	return true;
+}
+
 /*
 ===================================================================================
 
@@ -56,7 +56,8 @@ enum cpuid_t {
 	CPUID_FTZ							= 0x04000,	// Flush-To-Zero mode (denormal results are flushed to zero)
 	CPUID_DAZ							= 0x08000,	// Denormals-Are-Zero mode (denormal source operands are set to zero)
 	CPUID_XENON							= 0x10000,	// Xbox 360
-	CPUID_CELL							= 0x20000	// PS3
+	CPUID_CELL							= 0x20000,	// PS3
+	CPUID_AVX2							= 0x40000	// Advanced Vector Extensions 2 with FMA3
 };
 
 enum fpuExceptions_t {
@@ -485,6 +486,7 @@ void			Sys_SetPhysicalWorkMemory( int minBytes, int maxBytes );
 
 // allows retrieving the call stack at execution points
 void			Sys_GetCallStack( address_t *callStack, const int callStackSize );
+void			Sys_CaptureCallStack( address_t *callStack, const int callStackSize );
 const char *	Sys_GetCallStackStr( const address_t *callStack, const int callStackSize );
 const char *	Sys_GetCallStackCurStr( int depth );
 const char *	Sys_GetCallStackCurAddressStr( int depth );
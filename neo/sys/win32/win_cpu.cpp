@@ -193,6 +193,33 @@ static void CPUID( int func, unsigned regs[4] ) {
 }
 
 
+/*
+================
+CPUIDEX
+
+  same as CPUID but also sets the sub-leaf in ECX
+================
+*/
+static void CPUIDEX( int func, int subFunc, unsigned regs[4] ) {
+	unsigned regEAX, regEBX, regECX, regEDX;
+
+	__asm pusha
+	__asm mov eax, func
+	__asm mov ecx, subFunc
+	__asm __emit 00fh
+	__asm __emit 0a2h
+	__asm mov regEAX, eax
+	__asm mov regEBX, ebx
+	__asm mov regECX, ecx
+	__asm mov regEDX, edx
+	__asm popa
+
+	regs[_REG_EAX] = regEAX;
+	regs[_REG_EBX] = regEBX;
+	regs[_REG_ECX] = regECX;
+	regs[_REG_EDX] = regEDX;
+}
+
 /*
 ================
 IsAMD
@@ -337,6 +364,50 @@ static bool HasSSE3() {
 	return false;
 }
 
+/*
+================
+HasAVX2
+================
+*/
+static bool HasAVX2() {
+	unsigned regs[4];
+
+	// make sure the structured extended feature leaf is available
+	CPUID( 0, regs );
+	if ( regs[_REG_EAX] < 7 ) {
+		return false;
+	}
+
+	// get CPU feature bits
+	CPUID( 1, regs );
+
+	// bit 27 of ECX denotes OSXSAVE, bit 28 AVX and bit 12 FMA
+	const unsigned avxBits = ( 1 << 27 ) | ( 1 << 28 ) | ( 1 << 12 );
+	if ( ( regs[_REG_ECX] & avxBits ) != avxBits ) {
+		return false;
+	}
+
+	// the OS has to save the XMM and YMM state on context switches
+	unsigned xcr0;
+	__asm pusha
+	__asm xor ecx, ecx
+	__asm __emit 00fh	// xgetbv
+	__asm __emit 001h
+	__asm __emit 0d0h
+	__asm mov xcr0, eax
+	__asm popa
+	if ( ( xcr0 & 6 ) != 6 ) {
+		return false;
+	}
+
+	// bit 5 of EBX of leaf 7 denotes AVX2 existence
+	CPUIDEX( 7, 0, regs );
+	if ( regs[_REG_EBX] & ( 1 << 5 ) ) {
+		return true;
+	}
+	return false;
+}
+
 /*
 ================
 LogicalProcPerPhysicalProc
@@ -746,6 +817,11 @@ cpuid_t Sys_GetCPUId() {
 		flags |= CPUID_SSE3;
 	}
 
+	// check for Advanced Vector Extensions 2 with FMA3
+	if ( HasAVX2() ) {
+		flags |= CPUID_AVX2;
+	}
+
 	// check for Hyper-Threading Technology
 	if ( HasHTT() ) {
 		flags |= CPUID_HTT;
@@ -739,6 +739,28 @@ void Sys_GetCallStack( address_t *callStack, const int callStackSize ) {
 	}
 }
 
+/*
+==================
+Sys_CaptureCallStack
+
+ same as Sys_GetCallStack but lets the OS unwind the stack so it does not depend on
+ frame pointers and also works in code built with /Oy, the addresses are return
+ addresses instead of function start addresses
+==================
+*/
+void Sys_CaptureCallStack( address_t *callStack, const int callStackSize ) {
+	// XP requires the skipped plus captured frames to stay below 63
+	PVOID frames[60];
+	const int numFrames = CaptureStackBackTrace( 2, Min( callStackSize, 60 ), frames, NULL );
+	int i;
+	for ( i = 0; i < numFrames; i++ ) {
+		callStack[i] = (address_t)frames[i];
+	}
+	while( i < callStackSize ) {
+		callStack[i++] = 0;
+	}
+}
+
 /*
 ==================
 Sys_GetCallStackStr